@@ -0,0 +1,115 @@
+/*Standard Includes*/
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+/* Custom Includes */
+#include "VectorKernelUtility.h"
+
+/**
+ * @brief Times the FFT path loops as they were written before vectorisation against each kernel variant
+ * @note Run from a release build, e.g. ./GenericBenchmarks. Times are per call averaged over many iterations.
+ */
+
+namespace
+{
+    const size_t uChunkSize = 4096;
+    const size_t uNumBins = uChunkSize / 2 + 1;
+    const unsigned uIterations = 20000;
+
+    volatile float g_fSink = 0; ///< Stops the compiler discarding benchmarked work
+
+    template <typename Function>
+    double TimeNanoseconds(Function&& BenchmarkFunction)
+    {
+        // Warm caches and the dispatch path first
+        for (unsigned uIteration = 0; uIteration < 100; uIteration++)
+            BenchmarkFunction();
+
+        auto StartTime = std::chrono::steady_clock::now();
+        for (unsigned uIteration = 0; uIteration < uIterations; uIteration++)
+            BenchmarkFunction();
+        auto EndTime = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(EndTime - StartTime).count() / uIterations;
+    }
+
+    void PrintResult(const char* pcName, const std::string& strVariant, double dNanoseconds, double dBaselineNanoseconds)
+    {
+        std::printf("%-24s %-8s %10.1f ns %8.2fx\n", pcName, strVariant.c_str(), dNanoseconds, dBaselineNanoseconds / dNanoseconds);
+    }
+}
+
+int main()
+{
+    std::vector<int16_t> vi16Samples(uChunkSize);
+    for (size_t uIndex = 0; uIndex < uChunkSize; uIndex++)
+        vi16Samples[uIndex] = (int16_t)((uIndex * 2731) % 65536 - 32768);
+
+    std::vector<std::complex<float>> vcfBins(uNumBins);
+    for (size_t uIndex = 0; uIndex < uNumBins; uIndex++)
+        vcfBins[uIndex] = { 0.5f * uIndex - 20.0f, 30.0f - 0.25f * uIndex };
+
+    std::vector<float> vfFloatScratch(uChunkSize);
+    std::vector<float> vfMagnitudes(uNumBins);
+    std::vector<std::complex<float>> vcfScaledBins = vcfBins;
+
+    // The loops FFTModule used to run
+    double dConvertBaseline = TimeNanoseconds([&]() {
+        std::vector<float> vfTimeData;
+        for (auto i16Sample : vi16Samples)
+            vfTimeData.emplace_back(i16Sample);
+        g_fSink = vfTimeData.back();
+    });
+
+    double dScaleBaseline = TimeNanoseconds([&]() {
+        for (auto& cfBin : vcfScaledBins)
+            cfBin = cfBin / (float)uNumBins * (float)uNumBins;
+        g_fSink = vcfScaledBins.back().real();
+    });
+
+    double dMagnitudeBaseline = TimeNanoseconds([&]() {
+        std::transform(vcfBins.begin(), vcfBins.end(), vfMagnitudes.begin(), [](std::complex<float> x) { return std::abs(x); });
+        g_fSink = vfMagnitudes.back();
+    });
+
+    std::printf("Chunk of %zu samples, %zu bins\n", uChunkSize, uNumBins);
+    PrintResult("Int16 to float", "Original", dConvertBaseline, dConvertBaseline);
+    PrintResult("Bin scaling", "Original", dScaleBaseline, dScaleBaseline);
+    PrintResult("Complex magnitude", "Original", dMagnitudeBaseline, dMagnitudeBaseline);
+
+    auto SupportedInstructionSet = VectorKernelUtility::GetSupportedInstructionSet();
+    for (auto InstructionSet : { VectorKernelUtility::InstructionSet::Scalar, VectorKernelUtility::InstructionSet::SSE2, VectorKernelUtility::InstructionSet::AVX2 })
+    {
+        if (InstructionSet > SupportedInstructionSet)
+            continue;
+
+        VectorKernelUtility::SetInstructionSet(InstructionSet);
+        std::string strVariant = VectorKernelUtility::GetInstructionSetName(InstructionSet);
+
+        double dConvert = TimeNanoseconds([&]() {
+            VectorKernelUtility::ConvertInt16ToFloat(vi16Samples.data(), vfFloatScratch.data(), uChunkSize);
+            g_fSink = vfFloatScratch.back();
+        });
+
+        // Scale up and back down so values stay bounded over the iterations, matching the baseline
+        double dScale = TimeNanoseconds([&]() {
+            VectorKernelUtility::Scale((float*)vcfScaledBins.data(), 2 * uNumBins, 1.0f / uNumBins);
+            VectorKernelUtility::Scale((float*)vcfScaledBins.data(), 2 * uNumBins, (float)uNumBins);
+            g_fSink = vcfScaledBins.back().real();
+        });
+
+        double dMagnitude = TimeNanoseconds([&]() {
+            VectorKernelUtility::ComplexMagnitude(vcfBins.data(), vfMagnitudes.data(), uNumBins);
+            g_fSink = vfMagnitudes.back();
+        });
+
+        PrintResult("Int16 to float", strVariant, dConvert, dConvertBaseline);
+        PrintResult("Bin scaling", strVariant, dScale, dScaleBaseline);
+        PrintResult("Complex magnitude", strVariant, dMagnitude, dMagnitudeBaseline);
+    }
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef ANGLE_SPECTRUM_DIRECTION_BIN_CHUNK
+#define ANGLE_SPECTRUM_DIRECTION_BIN_CHUNK
+
+/*Standard Includes*/
+#include <vector>
+
+/* Custom Includes */
+#include "DirectionBinChunk.h"
+
+/**
+ * @brief Direction bins which also carry the scanned angle spectrum each peak angle was picked from
+ * @note Remains a DirectionBinChunk so existing routing and serialisation are unchanged. The spectra are
+ *       therefore only kept in process, a DirectionBinChunk deserialised after a network hop arrives without them.
+ */
+class AngleSpectrumDirectionBinChunk : public DirectionBinChunk
+{
+public:
+    /**
+     * @brief Construct a new AngleSpectrumDirectionBinChunk object
+     * @param vfAngleGrid_deg Angles (deg) the spectra were scanned over
+     */
+    AngleSpectrumDirectionBinChunk(std::vector<float> vfAngleGrid_deg) : m_vfAngleGrid_deg(std::move(vfAngleGrid_deg)) {}
+
+    std::vector<float> m_vfAngleGrid_deg;              ///< Angles (deg) the spectra were scanned over
+    std::vector<std::vector<float>> m_vvfAngleSpectra; ///< Scan output of each bin over the angle grid, in bin order
+};
+
+#endif
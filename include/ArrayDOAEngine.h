@@ -0,0 +1,136 @@
+#ifndef ARRAY_DOA_ENGINE
+#define ARRAY_DOA_ENGINE
+
+/*Standard Includes*/
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Direction of arrival estimation over an arbitrary planar array using per bin cross spectral matrices
+ * @note Angles are measured from the array's y axis towards its x axis, so for elements along x this matches
+ *       the broadside angle of the two element phase difference method. Not thread safe.
+ */
+class ArrayDOAEngine
+{
+public:
+    /**
+     * @brief Running sum of the cross spectral matrix of every bin over a number of snapshots
+     */
+    struct CrossSpectra
+    {
+        unsigned uNumBins = 0;                         ///< Bins the matrices were sized for
+        unsigned uNumSnapshots = 0;                    ///< Snapshots summed so far
+        std::vector<std::complex<float>> vcfMatrices;  ///< Bin major elements x elements matrices
+    };
+
+    /**
+     * @brief Construct a new ArrayDOAEngine object
+     * @param vvdElementPositions_m x and y position of each element, one element per channel
+     * @param dPropagationVelocity_mps Propagation velocity of the signal
+     * @param strMethod One of "Bartlett", "MVDR" or "MUSIC"
+     * @param dMinAngle_deg First angle of the scan
+     * @param dMaxAngle_deg Last angle of the scan
+     * @param uNumAngles Number of angles scanned
+     * @param uNumSources Sources assumed present in each bin, only used by "MUSIC"
+     * @param fDiagonalLoading Fraction of the mean element power added to the diagonal, only used by "MVDR"
+     */
+    ArrayDOAEngine(const std::vector<std::vector<double>>& vvdElementPositions_m, double dPropagationVelocity_mps, const std::string& strMethod,
+                   double dMinAngle_deg, double dMaxAngle_deg, unsigned uNumAngles, unsigned uNumSources = 1, float fDiagonalLoading = 0.01f);
+
+    /**
+     * @brief Adds one snapshot of every bin to the running cross spectral matrices, O(bins x elements^2)
+     * @param vvcfFFTChunks Bins of each channel, one channel per element
+     * @param Spectra Matrices to add to, reset if the number of bins changes
+     */
+    void Accumulate(const std::vector<std::vector<std::complex<float>>>& vvcfFFTChunks, CrossSpectra& Spectra);
+
+    /**
+     * @brief Scans the angle grid for each requested bin
+     * @param Spectra Matrices accumulated over one or more snapshots
+     * @param vu16Bins Bins to scan
+     * @param dBinWidth_Hz Frequency spacing of the bins
+     * @param vfAngleSpectra Receives one spectrum of angle count values per requested bin
+     */
+    void ScanBins(const CrossSpectra& Spectra, const std::vector<uint16_t>& vu16Bins, double dBinWidth_Hz, std::vector<float>& vfAngleSpectra);
+
+    /**
+     * @brief Returns the angle of an index in the scan grid
+     */
+    double GetAngle_deg(unsigned uAngleIndex) const { return m_dMinAngle_deg + uAngleIndex * m_dAngleStep_deg; }
+
+    /**
+     * @brief Returns the number of angles scanned
+     */
+    unsigned GetNumAngles() const { return m_uNumAngles; }
+
+    /**
+     * @brief Returns the number of array elements
+     */
+    unsigned GetNumElements() const { return m_vvdElementPositions_m.size(); }
+
+    /**
+     * @brief Returns how many bins have had steering vectors computed, which stops growing once every detected bin has been seen
+     */
+    uint64_t GetSteeringVectorCount() const { return m_u64SteeringVectorCount; }
+
+private:
+    enum class DOAMethod { Bartlett, MVDR, MUSIC };
+
+    /**
+     * @brief Steering vectors of each bin of one frequency grid, filled in as bins are first scanned
+     */
+    struct SteeringTable
+    {
+        std::vector<std::vector<std::complex<float>>> vvcfBinSteering; ///< Angle major angles x elements vectors of each bin
+    };
+
+    std::vector<std::vector<double>> m_vvdElementPositions_m;  ///< x and y position of each element
+    double m_dPropagationVelocity_mps;                         ///< Propagation velocity of the signal
+    DOAMethod m_Method;                                        ///< Spatial spectrum estimator
+    double m_dMinAngle_deg;                                    ///< First angle of the scan
+    double m_dAngleStep_deg;                                   ///< Spacing of the scan angles
+    unsigned m_uNumAngles;                                     ///< Number of angles scanned
+    unsigned m_uNumSources;                                    ///< Signal subspace dimension for MUSIC
+    float m_fDiagonalLoading;                                  ///< MVDR diagonal loading relative to mean element power
+    std::map<std::pair<unsigned, double>, SteeringTable> m_mSteeringTables; ///< Tables keyed by bin count and bin width
+    uint64_t m_u64SteeringVectorCount = 0;                     ///< Number of bins with steering vectors computed
+
+    // Reused matrices of the bin being scanned
+    std::vector<std::complex<double>> m_vcdQuadraticForm;      ///< Matrix the steering vectors are scanned against
+    std::vector<std::complex<double>> m_vcdWorkspace;          ///< Scratch for inversion
+    std::vector<double> m_vdRealSymmetric;                     ///< Real embedding of the matrix for eigen decomposition
+    std::vector<double> m_vdEigenvectors;                      ///< Eigenvectors of the real embedding
+    std::vector<double> m_vdEigenvalues;                       ///< Eigenvalues of the real embedding
+    std::vector<unsigned> m_vuEigenvalueOrder;                 ///< Eigenvalue indices in ascending order
+
+    /**
+     * @brief Returns the steering vectors of a bin, computing them on first use
+     */
+    const std::vector<std::complex<float>>& GetSteeringVectors(unsigned uNumBins, double dBinWidth_Hz, uint16_t u16Bin);
+
+    /**
+     * @brief Turns a bin's summed cross spectral matrix into the matrix its spectrum is the inverse or value of a quadratic form of
+     * @param pcfMatrix Summed cross spectral matrix of the bin
+     * @param uNumSnapshots Snapshots in the sum
+     */
+    void PrepareQuadraticForm(const std::complex<float>* pcfMatrix, unsigned uNumSnapshots);
+
+    /**
+     * @brief Inverts the quadratic form matrix in place with Gauss-Jordan elimination
+     */
+    void InvertQuadraticForm();
+
+    /**
+     * @brief Replaces the quadratic form matrix by the projector onto its noise subspace
+     */
+    void ProjectOntoNoiseSubspace();
+};
+
+#endif
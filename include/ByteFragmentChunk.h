@@ -0,0 +1,98 @@
+#ifndef BYTE_FRAGMENT_CHUNK
+#define BYTE_FRAGMENT_CHUNK
+
+/*Standard Includes*/
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+/* Custom Includes */
+#include "ByteChunk.h"
+
+/**
+ * @brief Transmission fragment which references a slice of a shared serialised chunk instead of holding its own bytes
+ * @note Remains a ByteChunk so existing routing is unchanged. Transmission modules send the inline header and payload
+ *       slice with a single writev. m_vcDataChunk is only filled if a consumer serialises the fragment or calls Materialise.
+ */
+class ByteFragmentChunk : public ByteChunk
+{
+public:
+    static constexpr size_t m_uMaxHeaderSize = 64; ///< Largest transmission header held inline
+
+    /**
+     * @brief Construct a new ByteFragmentChunk object
+     * @param pvcPayload Serialised chunk shared by every fragment of it
+     * @param uPayloadOffset Index of the first payload byte of this fragment
+     * @param uPayloadLength Number of payload bytes in this fragment
+     */
+    ByteFragmentChunk(std::shared_ptr<const std::vector<char>> pvcPayload, size_t uPayloadOffset, size_t uPayloadLength);
+
+    /**
+     * @brief Appends bytes to the header sent before the payload slice
+     * @param pvBytes Bytes to append
+     * @param uNumBytes Number of bytes to append
+     */
+    void AppendHeader(const void* pvBytes, size_t uNumBytes);
+
+    /**
+     * @brief Returns the number of bytes sent for this fragment, header included
+     */
+    size_t GetTransmissionSize() const { return m_uHeaderSize + m_uPayloadLength; }
+
+    /**
+     * @brief Points scatter gather entries at the header and payload slice
+     * @param asIOVecs Receives the entries
+     * @return Number of entries filled
+     */
+    int FillIOVecs(iovec (&asIOVecs)[2]) const;
+
+    /**
+     * @brief Copies the header and payload slice into m_vcDataChunk for consumers which require contiguous bytes
+     */
+    void Materialise();
+
+    /**
+     * @brief Returns size of the serialised chunk in bytes, as a ByteChunk holding the fragment's bytes
+     */
+    unsigned GetSize() override;
+
+    /**
+     * @brief Converts the chunk into a byte array, as a ByteChunk holding the fragment's bytes
+     */
+    std::shared_ptr<std::vector<char>> Serialise() override;
+
+    /**
+     * @brief Writes a byte chunk to a stream socket, continuing after partial writes
+     * @param iSocket Connected socket to write to
+     * @param pByteChunk Chunk to write, fragments are written without copying their payload
+     * @return False if the socket reported an error
+     */
+    static bool WriteToSocket(int iSocket, const std::shared_ptr<ByteChunk>& pByteChunk);
+
+    /**
+     * @brief Copies the bytes of a byte chunk into a new vector without modifying the chunk
+     * @param pByteChunk Chunk to copy, fragments are copied from their header and payload slice
+     * @return Contiguous bytes as they would be sent
+     */
+    static std::shared_ptr<std::vector<char>> CopyBytes(const std::shared_ptr<ByteChunk>& pByteChunk);
+
+private:
+    std::array<char, m_uMaxHeaderSize> m_acHeader;          ///< Transmission header sent before the payload
+    size_t m_uHeaderSize = 0;                               ///< Number of header bytes in use
+    std::shared_ptr<const std::vector<char>> m_pvcPayload;  ///< Serialised chunk this fragment is a slice of
+    size_t m_uPayloadOffset;                                ///< Index of the first payload byte of this fragment
+    size_t m_uPayloadLength;                                ///< Number of payload bytes in this fragment
+
+    /**
+     * @brief Copies the header and payload slice to a buffer of at least GetTransmissionSize bytes
+     * @param pcDestination Buffer to copy into
+     */
+    void CopyTo(char* pcDestination) const;
+};
+
+#endif
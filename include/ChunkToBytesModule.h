@@ -7,7 +7,10 @@
 /* Custom Includes */
 #include "BaseModule.h"
 #include "ByteChunk.h"
+#include "ByteFragmentChunk.h"
+#include "DenseIndexMap.h"
 #include "SessionController.h"
+#include "SourceIdentifierRegistry.h"
 
 /*
  * @brief Module process converts all chunks into multiple UDP chunks
@@ -37,7 +40,8 @@ public:
 
 private:
     unsigned m_uTransmissionSize;                                                                                                   ///< size of transmisison in bytes
-    std::map<std::vector<uint8_t>, std::map<ChunkType, std::shared_ptr<SessionController>>> m_MapOfIndentifiersToChunkTypeSessions; ///< Map of each source identifier to specific chunk type being processed
+    DenseIndexMap<DenseIndexMap<std::shared_ptr<SessionController>>> m_MapOfIndentifiersToChunkTypeSessions; ///< Session of each interned source index and chunk type being processed
+    SourceIndexCache m_SourceIndexCache;                                                                                            ///< Index of the last source seen
 
     /*
      * @brief Module process to collect and format UDP data
@@ -0,0 +1,103 @@
+#ifndef DENSE_INDEX_MAP
+#define DENSE_INDEX_MAP
+
+/*Standard Includes*/
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Map keyed by small dense indices, such as interned source identifiers or chunk type values,
+ *        which stores entries in a flat table so lookups are array indexing
+ * @note Iterates in ascending index order and exposes the std::map members the modules use. Memory grows
+ *       with the largest index stored rather than the number of entries.
+ */
+template <typename T>
+class DenseIndexMap
+{
+public:
+    using value_type = std::pair<const uint32_t, T>;
+
+    /**
+     * @brief Forward iterator over stored entries which skips empty slots
+     */
+    template <typename Slots, typename Value>
+    class BasicIterator
+    {
+    public:
+        BasicIterator(Slots* pvSlots, size_t uIndex) : m_pvSlots(pvSlots), m_uIndex(uIndex) { SkipEmpty(); }
+
+        Value& operator*() const { return *(*m_pvSlots)[m_uIndex]; }
+        Value* operator->() const { return &*(*m_pvSlots)[m_uIndex]; }
+        BasicIterator& operator++() { m_uIndex++; SkipEmpty(); return *this; }
+        bool operator==(const BasicIterator& Other) const { return m_uIndex == Other.m_uIndex; }
+        bool operator!=(const BasicIterator& Other) const { return m_uIndex != Other.m_uIndex; }
+
+    private:
+        Slots* m_pvSlots;       ///< Table being iterated
+        size_t m_uIndex;        ///< Slot currently pointed to
+
+        void SkipEmpty() { while (m_uIndex < m_pvSlots->size() && !(*m_pvSlots)[m_uIndex]) m_uIndex++; }
+    };
+
+    using Slots = std::vector<std::optional<value_type>>;
+    using iterator = BasicIterator<Slots, value_type>;
+    using const_iterator = BasicIterator<const Slots, const value_type>;
+
+    /**
+     * @brief Returns the entry for an index, default constructing it if absent
+     */
+    T& operator[](uint32_t u32Index)
+    {
+        if (u32Index >= m_vSlots.size())
+            m_vSlots.resize(u32Index + 1);
+
+        auto& Slot = m_vSlots[u32Index];
+        if (!Slot)
+        {
+            Slot.emplace(u32Index, T());
+            m_uSize++;
+        }
+        return Slot->second;
+    }
+
+    iterator find(uint32_t u32Index) { return count(u32Index) ? iterator(&m_vSlots, u32Index) : end(); }
+    const_iterator find(uint32_t u32Index) const { return count(u32Index) ? const_iterator(&m_vSlots, u32Index) : end(); }
+
+    size_t count(uint32_t u32Index) const { return u32Index < m_vSlots.size() && m_vSlots[u32Index].has_value(); }
+
+    size_t erase(uint32_t u32Index)
+    {
+        if (!count(u32Index))
+            return 0;
+
+        m_vSlots[u32Index].reset();
+        m_uSize--;
+        return 1;
+    }
+
+    /**
+     * @brief Removes every entry, the table keeps its length so indices seen before are not reallocated
+     */
+    void clear()
+    {
+        for (auto& Slot : m_vSlots)
+            Slot.reset();
+        m_uSize = 0;
+    }
+
+    size_t size() const { return m_uSize; }
+    bool empty() const { return m_uSize == 0; }
+
+    iterator begin() { return iterator(&m_vSlots, 0); }
+    iterator end() { return iterator(&m_vSlots, m_vSlots.size()); }
+    const_iterator begin() const { return const_iterator(&m_vSlots, 0); }
+    const_iterator end() const { return const_iterator(&m_vSlots, m_vSlots.size()); }
+
+private:
+    Slots m_vSlots;         ///< Entry of each index, empty where nothing is stored
+    size_t m_uSize = 0;     ///< Number of stored entries
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef DETECTION_EVENT_CHUNK
+#define DETECTION_EVENT_CHUNK
+
+/*Standard Includes*/
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/* Custom Includes */
+#include "BaseChunk.h"
+
+/**
+ * @brief Whether an event describes a current detection or one which has just ended
+ */
+enum class DetectionEventState : uint32_t
+{
+    Active,
+    Lost
+};
+
+/**
+ * @brief A run of neighbouring detected bins on one channel, summarised as a single emitter
+ */
+struct DetectionEvent
+{
+    uint16_t u16ChannelIndex;   ///< Channel the event was detected on
+    uint16_t u16StartBin;       ///< First detected bin of the run
+    uint16_t u16EndBin;         ///< Last detected bin of the run
+    uint16_t u16PeakBin;        ///< Detected bin with the most power
+    float fPeakBin;             ///< Peak bin refined by parabolic interpolation
+    float fPeakFrequency_Hz;    ///< Frequency of the interpolated peak
+    float fCentreFrequency_Hz;  ///< Frequency midway between the first and last bins
+    float fBandwidth_Hz;        ///< Width of the run in Hz
+    float fPeakPower;           ///< Interpolated power of the peak
+    DetectionEventState State;  ///< Whether the event is current or has ended
+};
+
+static_assert(std::is_trivially_copyable<DetectionEvent>::value, "DetectionEvent is serialised as raw bytes");
+
+/**
+ * @brief Clustered detections of a spectrum, far smaller than every detected bin index
+ * @note Requires the DetectionEventChunk entry in the shared ChunkType enumeration
+ */
+class DetectionEventChunk : public BaseChunk
+{
+public:
+    /**
+     * @brief Construct a new DetectionEventChunk object
+     * @param dSampleRate Sample rate of the time data the spectrum was computed from
+     * @param i64TimeStamp Timestamp (us) of the spectrum
+     * @param uNumChannels Number of channels in the spectrum
+     * @param uNumBins Number of bins per channel in the spectrum
+     */
+    DetectionEventChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumChannels, unsigned uNumBins);
+    ~DetectionEventChunk() {};
+
+    /**
+     * @brief Returns chunk type
+     */
+    ChunkType GetChunkType() override { return ChunkType::DetectionEventChunk; };
+
+    /**
+     * @brief Returns size of the serialised chunk in bytes
+     */
+    unsigned GetSize() override;
+
+    /**
+     * @brief Converts the chunk into a byte array
+     */
+    std::shared_ptr<std::vector<char>> Serialise() override;
+
+    /**
+     * @brief Populates the chunk from a byte array created by Serialise
+     */
+    void Deserialise(std::shared_ptr<std::vector<char>> pvBytes) override;
+
+    double m_dSampleRate;                          ///< Sample rate of the underlying time data
+    uint64_t m_i64TimeStamp;                       ///< Timestamp (us) of the spectrum
+    unsigned m_uNumChannels;                       ///< Number of channels in the spectrum
+    unsigned m_uNumBins;                           ///< Number of bins per channel in the spectrum
+    std::vector<DetectionEvent> m_vDetectionEvents; ///< Active events ordered by channel then frequency, followed by lost events
+
+private:
+    /**
+     * @brief Returns size of the members of this class in bytes
+     */
+    unsigned GetInternalSize();
+};
+
+#endif
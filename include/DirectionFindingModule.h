@@ -3,17 +3,30 @@
 
 /*Standard Includes*/
 #include <cmath>
+#include <deque>
+#include <map>
+#include <memory>
 
 /* Custom Includes */
+#include "AngleSpectrumDirectionBinChunk.h"
+#include "ArrayDOAEngine.h"
 #include "BaseModule.h"
+#include "DenseIndexMap.h"
 #include "DetectionBinChunk.h"
+#include "DetectionEventChunk.h"
 #include "DirectionBinChunk.h"
 #include "FFTChunk.h"
+#include "SourceIdentifierRegistry.h"
+#include "TimeStampedDetectionBinChunk.h"
+#include "VectorKernelUtility.h"
 #include "kiss_fft.h"
 
 
 /**
  * @brief Converts time chunks to FFT chunks and computes FFT
+ * @note Detections are paired with the FFT chunk of the same source and exact timestamp, so both must be
+ *       derived from the same transform upstream. Plain DetectionBinChunks without a timestamp, such as after a
+ *       network hop, are paired with the oldest waiting FFT chunk of their source instead.
  */
 class DirectionFindingModule : public BaseModule
 {
@@ -35,18 +48,119 @@ public:
      */
     std::string GetModuleType() override { return "DirectionFindingModule"; };
 
+    /**
+     * @brief Estimates angles from every channel of an N element array instead of the phase difference of channels 0 and 1
+     * @param vvdElementPositions_m x and y position (m) of the element recording each channel
+     * @param strMethod One of "Bartlett", "MVDR" or "MUSIC"
+     * @param uNumSnapshots FFT chunks whose cross spectra are averaged before each estimate
+     * @param dMinAngle_deg First angle of the scan
+     * @param dMaxAngle_deg Last angle of the scan
+     * @param uNumAngles Number of angles scanned
+     * @param uNumSources Sources assumed per bin, only used by MUSIC
+     * @note Should be configured before processing is started. Emits the peak angle of each detected bin
+     *       once every uNumSnapshots FFT chunks, in an AngleSpectrumDirectionBinChunk holding the scan of each bin.
+     */
+    void EnableArrayProcessing(const std::vector<std::vector<double>>& vvdElementPositions_m, const std::string& strMethod, unsigned uNumSnapshots,
+                               double dMinAngle_deg = -90, double dMaxAngle_deg = 90, unsigned uNumAngles = 181, unsigned uNumSources = 1);
+
+    /**
+     * @brief Bounds how long FFT chunks and detections wait for their counterpart from the same source
+     * @param uMaxPendingPerSource Unmatched chunks of each kind held per source before the oldest is dropped
+     * @param dMaxJoinAge_s Unmatched chunks older than this relative to the newest chunk of the source are dropped
+     */
+    void SetJoinLimits(unsigned uMaxPendingPerSource, double dMaxJoinAge_s);
+
+    /**
+     * @brief Returns how many FFT chunks and detections were dropped without finding their counterpart
+     */
+    uint64_t GetUnmatchedEvictionCount() const { return m_u64UnmatchedEvictions; }
+
+protected:
+    /**
+     * @brief Wraps the angles estimated from an FFT chunk in a DirectionBinChunk and passes it on
+     * @param pFFTChunk Transform the angles were estimated from
+     * @param vu16Bins Bins with a valid angle
+     * @param vfAngleOfArrivals_deg Angle of each bin
+     * @note In array mode an AngleSpectrumDirectionBinChunk is passed on, carrying the latest scan of each bin
+     */
+    virtual void PassDirections(const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<uint16_t>& vu16Bins, const std::vector<float>& vfAngleOfArrivals_deg);
+
 private:
+    /**
+     * @brief Detections waiting for the FFT chunk they were made from
+     */
+    struct PendingDetections
+    {
+        uint64_t u64TimeStamp;                                  ///< Timestamp of the spectrum the detections came from
+        bool bTimeStamped;                                      ///< False when the detections arrived without a timestamp
+        std::vector<std::vector<uint16_t>> vvu16DetectionBins;  ///< Detected bins of each channel
+    };
+
+    /**
+     * @brief Chunks of one source waiting to be paired, and the source's array averaging state
+     */
+    struct SourceJoinState
+    {
+        std::deque<PendingDetections> dqDetections;             ///< Unmatched detections in arrival order
+        std::deque<std::shared_ptr<FFTChunk>> dqFFTChunks;      ///< Unmatched FFT chunks in arrival order
+        uint64_t u64NewestTimeStamp = 0;                        ///< Newest timestamp seen from the source
+        ArrayDOAEngine::CrossSpectra CrossSpectra;              ///< Cross spectra averaged in array mode
+    };
 
     double m_dPropogationVelocity_mps;
     double m_dBaselineLength_m;
-    std::vector<std::vector<uint16_t>> m_vvu16DetectionBins;
 
-    double CalculateAngleOfArrival(double differentialPhase_rads,double f_hz, double v_mps, double l_m);
+    DenseIndexMap<SourceJoinState> m_mSourceJoinStates;   ///< Join state of each interned source index
+    SourceIndexCache m_SourceIndexCache;                  ///< Index of the last source seen
+    unsigned m_uMaxPendingPerSource = 16;
+    uint64_t m_u64MaxJoinAge_us = 5000000;
+    uint64_t m_u64UnmatchedEvictions = 0;
+
+    std::unique_ptr<ArrayDOAEngine> m_pArrayDOAEngine;
+    unsigned m_uNumSnapshots = 1;
+    std::vector<float> m_vfAngleSpectra;     ///< Scan of each detected bin in the latest estimate, one row of angles per bin
+    std::vector<float> m_vfAngleGrid_deg;    ///< Angles scanned by the array engine
+
+    // Reused batch buffers of the two element method
+    std::vector<std::complex<float>> m_vcfFirstScratch;
+    std::vector<std::complex<float>> m_vcfSecondScratch;
+    std::vector<float> m_vfPhaseScratch;
 
-    float CalculateDifferentialPhase(const std::complex<float>& z1, const std::complex<float>& z2);
+    /**
+     * @brief Calculates the two element angle of arrival of a list of bins in one batch
+     * @param pFFTChunk Transform holding channels 0 and 1
+     * @param vu16Bins Bins to calculate angles for
+     * @param vfAngleOfArrivals_deg Receives the angle of each bin
+     * @param vu8Valid Receives 1 where the angle is valid, 0 where a bin has no phase reference or the phase implies |sin| > 1
+     */
+    void CalculateAnglesOfArrival(const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<uint16_t>& vu16Bins, std::vector<float>& vfAngleOfArrivals_deg, std::vector<uint8_t>& vu8Valid);
 
     void ProcessFFTChunk(std::shared_ptr<BaseChunk> pBaseChunk);
     void ProcessDetectionBinChunk(std::shared_ptr<BaseChunk> pBaseChunk);
+    void ProcessDetectionEventChunk(std::shared_ptr<BaseChunk> pBaseChunk);
+
+    /**
+     * @brief Pairs detections with a waiting FFT chunk of the same source and timestamp, or queues them
+     * @param vu8SourceIdentifier Source the detections were made for
+     * @param u64TimeStamp Timestamp of the spectrum the detections came from
+     * @param bTimeStamped False when the detections carry no timestamp, they then pair with the oldest FFT chunk of the source
+     * @param vvu16DetectionBins Detected bins of each channel
+     * @note Timestamps must match exactly, so detections and FFT chunks must come from the same transform
+     *       (FFTModule stamps its FFTChunk and FFTMagnitudeChunk identically and EnergyDetectionModule keeps that stamp)
+     */
+    void JoinDetections(const std::vector<uint8_t>& vu8SourceIdentifier, uint64_t u64TimeStamp, bool bTimeStamped, std::vector<std::vector<uint16_t>>&& vvu16DetectionBins);
+
+    /**
+     * @brief Drops unmatched entries of a source that are too old or exceed the pending limit
+     */
+    void EvictUnmatched(SourceJoinState& JoinState);
+
+    /**
+     * @brief Estimates and passes on the angles of a matched FFT chunk and its detections
+     */
+    void ProcessMatchedChunk(SourceJoinState& JoinState, const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<std::vector<uint16_t>>& vvu16DetectionBins);
+    void ProcessPhaseDifference(const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<std::vector<uint16_t>>& vvu16DetectionBins);
+    void ProcessArray(SourceJoinState& JoinState, const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<std::vector<uint16_t>>& vvu16DetectionBins);
 
 };
 
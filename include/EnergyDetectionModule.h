@@ -2,12 +2,22 @@
 #define ENERGY_DETECTION_MODULE
 
 /*Standard Includes*/
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
 
 /* Custom Includes */
 #include "BaseModule.h"
+#include "DenseIndexMap.h"
 #include "DetectionBinChunk.h"
+#include "DetectionEventChunk.h"
 #include "FFTMagnitudeChunk.h"
+#include "SourceIdentifierRegistry.h"
+#include "TimeStampedDetectionBinChunk.h"
+#include "VectorKernelUtility.h"
 #include "kiss_fft.h"
 
 
@@ -21,7 +31,8 @@ public:
     /**
      * @brief Construct a new EnergyDetectionModule object
      * @param uBufferSize size of processing input buffer
-     * @param fThresholdAboveNoiseFoor Threshold above average power to detect signals
+     * @param fThresholdAboveNoiseFoor Threshold in dB above the mean linear bin power (magnitude squared) of the channel,
+     *        or above the CFAR or tracked estimate when enabled, for a bin to be detected
      */
     EnergyDetectionModule(unsigned uBufferSize, float fThresholdAboveNoiseFoor);
 
@@ -37,42 +48,172 @@ public:
     std::string GetModuleType() override { return "EnergyDetectionModule"; };
 
     /**
-     * @brief threshold above average power to detect signals
+     * @brief Sets the threshold in dB above the mean linear bin power (magnitude squared), or above the CFAR or
+     *        tracked estimate when enabled, for a bin to be detected. 10 dB detects bins with ten times the mean power.
      */
     void SetThresholdAboveNoiseFoor(float fThresholdAboveNoiseFoor) { m_fThresholdAboveNoiseFoor_db = fThresholdAboveNoiseFoor; }
 
+    /**
+     * @brief Estimates the noise of each bin from its neighbours (CFAR) rather than the whole channel
+     * @param strCFARType Either "CellAveraging" (mean of training cells) or "OrderedStatistic" (75th percentile of training cells)
+     * @param uGuardCells Bins either side of the bin under test excluded from the estimate
+     * @param uTrainingCells Bins either side, beyond the guard cells, used for the estimate
+     * @note Should be configured before processing is started. The threshold is then relative to the local estimate.
+     */
+    void EnableCFAR(const std::string& strCFARType, unsigned uGuardCells, unsigned uTrainingCells);
+
+    /**
+     * @brief Tracks the noise floor of every bin across chunks rather than estimating it from each chunk alone
+     * @param strTrackerType Either "Exponential" (smoothed bin power) or "MinimumStatistics" (minimum of the smoothed bin power over a window)
+     * @param fSmoothingFactor Weight of each new chunk in the smoothed power, in (0, 1]
+     * @param uMinimumStatisticsWindow Chunks the minimum is tracked over, only used by "MinimumStatistics"
+     * @note Should be configured before processing is started. Each source is seeded with its first chunk's mean bin power.
+     *       Minimum statistics sits below the mean noise power so usually wants a higher threshold. Ignored while CFAR is enabled.
+     */
+    void EnableNoiseFloorTracking(const std::string& strTrackerType, float fSmoothingFactor, unsigned uMinimumStatisticsWindow = 0);
+
+    /**
+     * @brief Merges runs of detected bins into events and emits DetectionEventChunks in place of DetectionBinChunks
+     * @param uMaxGapBins Undetected bins allowed between two detections of the same event
+     * @note Should be configured before processing is started
+     */
+    void EnableEventClustering(unsigned uMaxGapBins);
+
+    /**
+     * @brief Only passes bins detected in at least M of the last N frames of their source (M-of-N gating)
+     * @param uRequiredDetections Detections (M) within the window required to pass a bin
+     * @param uWindowFrames Frames (N) in the window, at most 64
+     * @note Should be configured before processing is started. When a passed bin drops below M of N it is
+     *       reported once as a lost DetectionEvent, in a DetectionEventChunk ahead of the DetectionBinChunk
+     *       or within the DetectionEventChunk when clustering.
+     */
+    void EnablePersistenceGating(unsigned uRequiredDetections, unsigned uWindowFrames);
+
 private:
-    std::atomic<float> m_fThresholdAboveNoiseFoor_db;  ///< Threshold above average power to detect signals
+    /**
+     * @brief Detection history of each channel and bin of one source, stored channel major in flat arrays
+     */
+    struct PersistenceState
+    {
+        unsigned uNumChannels = 0;                      ///< Channels the state was sized for
+        size_t uNumBins = 0;                            ///< Bins per channel the state was sized for
+        std::vector<uint64_t> vu64DetectionHistory;     ///< Most recent frame in the lowest bit
+        std::vector<uint8_t> vu8Confirmed;              ///< Whether each bin is currently passing
+    };
+
+    /**
+     * @brief Noise floor of each channel and bin of one source, stored channel major in flat arrays
+     */
+    struct NoiseFloorState
+    {
+        unsigned uNumChannels = 0;                      ///< Channels the state was sized for
+        size_t uNumBins = 0;                            ///< Bins per channel the state was sized for
+        unsigned uChunksInWindow = 0;                   ///< Chunks seen in the current minimum statistics window
+        std::vector<float> vfNoiseFloor;                ///< Floor thresholds are relative to
+        std::vector<float> vfSmoothedPower;             ///< Smoothed bin power, minimum statistics only
+        std::vector<float> vfWindowMinimum;             ///< Minimum smoothed power of the current window
+        std::vector<float> vfPreviousWindowMinimum;     ///< Minimum smoothed power of the previous window
+    };
+
+    std::atomic<float> m_fThresholdAboveNoiseFoor_db;  ///< Threshold (dB) above the mean linear bin power to detect signals
+    std::vector<float> m_vfBinPowerScratch;             ///< Reused linear power of the channel being processed
+    std::vector<uint32_t> m_vuIndexScratch;             ///< Reused indices of bins above threshold
+    std::vector<std::vector<uint16_t>> m_vvu16DetectionBins; ///< Reused detections of each channel
+    SourceIndexCache m_SourceIndexCache;                ///< Index of the last source seen, keys the per source state below
+
+    // CFAR
+    enum class CFARType { None, CellAveraging, OrderedStatistic };
+    CFARType m_CFARType = CFARType::None;               ///< Noise estimate used per bin
+    unsigned m_uCFARGuardCells = 0;                     ///< Excluded bins either side of the bin under test
+    unsigned m_uCFARTrainingCells = 0;                  ///< Estimate bins either side beyond the guard cells
+    std::vector<double> m_vdPowerPrefixSums;            ///< Reused running sums of bin power
+    std::vector<uint32_t> m_vuBinsByPower;              ///< Reused bin indices in ascending power order
+    std::vector<uint32_t> m_vuPowerRanks;               ///< Reused rank of each bin's power
+    std::vector<uint32_t> m_vuTrainingRankCounts;       ///< Reused Fenwick tree counting training cells by power rank
+
+    // Noise floor tracking
+    enum class NoiseFloorTrackerType { None, Exponential, MinimumStatistics };
+    NoiseFloorTrackerType m_NoiseFloorTrackerType = NoiseFloorTrackerType::None; ///< How floors are carried between chunks
+    float m_fNoiseFloorSmoothingFactor = 1;             ///< Weight of each new chunk in the smoothed power
+    unsigned m_uMinimumStatisticsWindow = 0;            ///< Chunks per minimum statistics window
+    DenseIndexMap<NoiseFloorState> m_mNoiseFloorStates; ///< Tracked floors of each interned source index
+
+    // Event clustering
+    bool m_bEventClusteringEnabled = false;             ///< Whether events are emitted instead of detected bins
+    unsigned m_uEventMaxGapBins = 0;                    ///< Undetected bins allowed within an event
+
+    // Persistence gating
+    unsigned m_uPersistenceRequiredDetections = 0;      ///< Detections required within the window
+    unsigned m_uPersistenceWindowFrames = 0;            ///< Frames per window, 0 when gating is disabled
+    DenseIndexMap<PersistenceState> m_mPersistenceStates; ///< Detection history of each interned source index
+    std::vector<uint16_t> m_vu16LostBinScratch;         ///< Reused bins of one channel that stopped passing
+    std::vector<DetectionEvent> m_vLostEventScratch;    ///< Reused lost events of the chunk being processed
+
+    /**
+     * @brief Finds the bins of one channel whose power exceeds the channel noise floor by the threshold
+     * @param pfMagnitudes Bin magnitudes of the channel
+     * @param uNumBins Number of bins
+     * @param fThresholdRatio Linear power ratio above the mean bin power to consider signal detected
+     * @param vu16DetectionBins Receives the detected bin indicies
+     * @param pNoiseFloorState Tracked floors of the chunk's source, null when tracking is disabled
+     * @param uChannelIndex Channel of the source being processed
+     */
+    void DetectChannel(const float* pfMagnitudes, size_t uNumBins, float fThresholdRatio, std::vector<uint16_t>& vu16DetectionBins, NoiseFloorState* pNoiseFloorState, unsigned uChannelIndex);
+
+    /**
+     * @brief Returns the tracked floors of a source, resetting them if the chunk shape changed
+     * @param pFFTMagnitudeChunk Chunk about to be processed
+     */
+    NoiseFloorState& GetNoiseFloorState(const std::shared_ptr<FFTMagnitudeChunk>& pFFTMagnitudeChunk);
+
+    /**
+     * @brief Folds the power scratch of one channel into its tracked floor, O(bins)
+     * @param NoiseFloor Tracked floors of the source
+     * @param uChannelIndex Channel whose power is in the scratch
+     */
+    void UpdateNoiseFloor(NoiseFloorState& NoiseFloor, unsigned uChannelIndex);
+
+    /**
+     * @brief Returns the detection history of a source, resetting it if the chunk shape changed
+     * @param pFFTMagnitudeChunk Chunk about to be processed
+     */
+    PersistenceState& GetPersistenceState(const std::shared_ptr<FFTMagnitudeChunk>& pFFTMagnitudeChunk);
 
     /**
-     * @brief Calculate power (dB) in each bin for FFT chunk
-     * @param pFFTMagnitudeChunk Pointer to FFT chunk
-     * @return pointer to vector of channelvectors and their bin powers
+     * @brief Records one frame of detections and keeps only bins that have persisted, O(bins)
+     * @param Persistence Detection history of the source
+     * @param uChannelIndex Channel the detections belong to
+     * @param vu16DetectionBins Detected bins in ascending order, reduced in place to those that pass
+     * @param dBinWidth_Hz Frequency spacing of the bins, used to describe lost events
      */
-    std::shared_ptr<std::vector<std::vector<double>>> CalculateBinPowerInDBX(std::shared_ptr<FFTMagnitudeChunk> pFFTMagnitudeChunk);
+    void GateChannel(PersistenceState& Persistence, unsigned uChannelIndex, std::vector<uint16_t>& vu16DetectionBins, double dBinWidth_Hz);
 
     /**
-     * @brief Will give a average power in (dB) of each vector ccontained in the outter vector
-     * @param pvvdPower_db Vector of vectors containing bin power
-     * @return Vector containing average power of each vector passed in
+     * @brief Merges the detections of one channel into events using the power scratch of that channel
+     * @param vu16DetectionBins Detected bins of the channel in ascending order
+     * @param uNumBins Number of bins in the channel
+     * @param uChannelIndex Channel the detections belong to
+     * @param dBinWidth_Hz Frequency spacing of the bins
+     * @param vDetectionEvents Events of the channel are appended here
      */
-    std::shared_ptr<std::vector<double>> CalculateAverageBinPowerInDBX(std::shared_ptr<std::vector<std::vector<double>>> pvvdPower_db);
+    void ClusterChannel(const std::vector<uint16_t>& vu16DetectionBins, size_t uNumBins, unsigned uChannelIndex, double dBinWidth_Hz, std::vector<DetectionEvent>& vDetectionEvents);
 
     /**
-     * @brief Calculates the energy detection threshold (in dB)
-     * @param dAveragePower_db average power (dB) of a vector of bins
-     * @param dLevelAboveFloor Threshold above average (in dB) to detect energy
-     * @return The detection threshold in (dB) to consider signal detected
+     * @brief Cell averaging CFAR over the power scratch, O(bins) using prefix sums
+     * @param uNumBins Number of bins
+     * @param fThresholdRatio Linear power ratio above the local estimate to consider signal detected
+     * @param vu16DetectionBins Receives the detected bin indicies
      */
-    double CalculateThresholdInDBX(double dAveragePower_db, double dLevelAboveFloor);
+    void DetectCellAveragingCFAR(size_t uNumBins, float fThresholdRatio, std::vector<uint16_t>& vu16DetectionBins);
 
     /**
-     * @brief Calculates indicies of where power detection occurs
-     * @param pFFTMagnitudeChunk Pointer to FFT magnitude chunk
-     * @param dDetectionThreshold The detection threshold in (dB) to consider signal detected
-     * @return Vector of vectors containing detection indicies for given power vector
+     * @brief Ordered statistic CFAR over the power scratch, O(bins log bins) by ranking the bins once and
+     *        selecting the percentile of the sliding training window from a Fenwick tree of ranks
+     * @param uNumBins Number of bins
+     * @param fThresholdRatio Linear power ratio above the local estimate to consider signal detected
+     * @param vu16DetectionBins Receives the detected bin indicies
      */
-    std::shared_ptr<std::vector<std::vector<uint16_t>>> GetDetectionBinIndicies(std::shared_ptr<FFTMagnitudeChunk> pFFTMagnitudeChunk,double dDetectionThreshold);
+    void DetectOrderedStatisticCFAR(size_t uNumBins, float fThresholdRatio, std::vector<uint16_t>& vu16DetectionBins);
 };
 
 #endif
\ No newline at end of file
@@ -2,12 +2,24 @@
 #define FFT_MODULE
 
 /*Standard Includes*/
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
 
 /* Custom Includes */
 #include "BaseModule.h"
 #include "TimeChunk.h"
+#include "DenseIndexMap.h"
 #include "FFTChunk.h"
 #include "FFTMagnitudeChunk.h"
+#include "FFTPlanCache.h"
+#include "RingBuffer.h"
+#include "SourceIdentifierRegistry.h"
+#include "SpectrogramChunk.h"
+#include "VectorKernelUtility.h"
+#include "WindowFunctionUtility.h"
+#include "WorkerPool.h"
 #include "kiss_fftr.h"
 
 /**
@@ -22,6 +34,17 @@ public:
      */
     FFTModule(unsigned uBufferSize);
 
+    /**
+     * @brief Stops the processing thread before the workers and the state they use are destroyed
+     */
+    ~FFTModule();
+
+    /**
+     * @brief Check input buffer and try process data
+     * @note Chunks still being transformed by the workers are passed on once processing stops
+     */
+    void ContinuouslyTryProcess() override;
+
     /**
      * @brief Generate and fill complex time data chunk and pass on to next module
      */
@@ -38,8 +61,165 @@ public:
      */
     void SetGenerateMagnitudeData(bool bGenerateMagnitudeData) { m_bGenerateMagnitudeData = bGenerateMagnitudeData; }
 
+    /**
+     * @brief Switches the module to windowed, overlapping frames emitted as SpectrogramChunks
+     * @param uFFTLength Time samples per frame, independent of the incoming chunk size (must be even)
+     * @param uHopLength Time samples between the starts of consecutive frames
+     * @param strWindowType One of "Rectangular", "Hann" or "Blackman"
+     * @note Should be configured before processing is started
+     */
+    void EnableSTFTMode(unsigned uFFTLength, unsigned uHopLength, const std::string& strWindowType);
+
+    /**
+     * @brief Switches the module to averaging windowed periodograms (Welch's method) into FFTMagnitudeChunks
+     * @param uFFTLength Time samples per periodogram (must be even)
+     * @param uHopLength Time samples between periodogram starts, less than the FFT length for overlap
+     * @param strWindowType One of "Rectangular", "Hann" or "Blackman"
+     * @param uNumAverages Periodograms per averaging period, one FFTMagnitudeChunk is emitted per period
+     * @param fExponentialAveragingFactor Weight of each new periodogram in (0, 1], or 0 for a plain mean per period
+     * @note Magnitudes are the square root of the averaged power so share units with the normal magnitude output
+     */
+    void EnableWelchMode(unsigned uFFTLength, unsigned uHopLength, const std::string& strWindowType, unsigned uNumAverages, float fExponentialAveragingFactor = 0);
+
+    /**
+     * @brief Spreads channel transforms, and chunks from different sources, over a pool of worker threads
+     * @param uNumWorkers Number of worker threads, 0 or 1 keeps all processing on the module thread
+     * @note Should be configured before processing is started. Output order and values match the serial path.
+     *       STFT processing depends on per source history so remains on the module thread.
+     */
+    void SetParallelWorkerCount(unsigned uNumWorkers);
+
+    /**
+     * @brief Returns how many heap allocations the FFT path has made (plans and scratch growth)
+     * @note Once every chunk size has been seen this should stop increasing
+     */
+    uint64_t GetFFTPathAllocationCount() const;
+
 private:
+    /**
+     * @brief Sample history kept for each source while running in STFT mode
+     */
+    struct STFTSourceState
+    {
+        std::vector<RingBuffer<float>> vChannelHistory; ///< Most recent FFT length samples of each channel
+        unsigned uSamplesUntilNextFrame = 0;            ///< Samples still required before the next frame is due
+        double dSampleRate = 0;                         ///< Sample rate the history was recorded at
+        uint64_t u64FramesProcessed = 0;                ///< Frames transformed since the history was reset
+        std::vector<std::vector<float>> vvfPowerAccumulators; ///< Running Welch power of each channel
+    };
+
+    /**
+     * @brief Plans and scratch owned by a single worker thread, kiss_fftr plans cannot be shared between threads
+     */
+    struct WorkerFFTState
+    {
+        FFTPlanCache PlanCache;            ///< Plans used by this worker
+        std::vector<float> vfInputScratch; ///< Real input buffer used by this worker
+    };
+
+    /**
+     * @brief A chunk whose channels are being transformed by the worker pool
+     */
+    struct ParallelFFTJob
+    {
+        std::shared_ptr<TimeChunk> pTimeChunk;     ///< Chunk being transformed
+        std::shared_ptr<FFTChunk> pFFTChunk;       ///< Output each worker writes its channel into
+        std::atomic<unsigned> uChannelsRemaining;  ///< Channels not yet transformed
+    };
+
     std::atomic<bool> m_bGenerateMagnitudeData = false; ///< Whether fft magnitude chunks will be produced
+    FFTPlanCache m_FFTPlanCache;                        ///< Plans reused across chunks of the same length
+    std::vector<float> m_vfFFTInputScratch;             ///< Reused real input buffer for each channel transform
+    std::vector<float> m_vfChunkScratch;                ///< Reused float copy of an incoming channel
+    std::vector<std::complex<float>> m_vcfFFTOutputScratch; ///< Reused output bins for frames that are not stored directly
+    std::atomic<uint64_t> m_u64ScratchAllocationCount = 0; ///< Number of times a scratch buffer had to grow
+
+    // STFT
+    bool m_bSTFTModeEnabled = false;                                      ///< Whether spectrogram frames are produced instead of FFT chunks
+    unsigned m_uSTFTLength = 0;                                           ///< Time samples per frame
+    unsigned m_uSTFTHopLength = 0;                                        ///< Time samples between frame starts
+    std::vector<float> m_vfSTFTWindow;                                    ///< Window applied to each frame
+    float m_fSTFTWindowGain = 1;                                          ///< Coherent gain of the window
+    DenseIndexMap<STFTSourceState> m_mSTFTSourceStates;                   ///< Frame history of each interned source index
+    SourceIndexCache m_SourceIndexCache;                                  ///< Index of the last source seen
+
+    // Welch
+    bool m_bWelchModeEnabled = false;                                     ///< Whether frames are averaged into magnitude chunks
+    unsigned m_uWelchAverages = 0;                                        ///< Frames per averaging period
+    float m_fWelchExponentialFactor = 0;                                  ///< Exponential weight of new frames, 0 for a plain mean
+    std::vector<float> m_vfWelchFrameScratch;                             ///< Magnitudes of the frame being accumulated
+
+    // Parallel processing
+    std::vector<std::unique_ptr<WorkerFFTState>> m_vpWorkerFFTStates;     ///< State of each worker, indexed by worker
+    std::deque<std::shared_ptr<ParallelFFTJob>> m_dqParallelFFTJobs;       ///< Chunks in flight in submission order
+    std::mutex m_ParallelJobMutex;                                         ///< Guards job completion waits
+    std::condition_variable m_cvParallelJobComplete;                       ///< Signalled when a job finishes its last channel
+    std::unique_ptr<WorkerPool> m_pWorkerPool;                             ///< Workers, declared last so they stop before the state they use is destroyed
+
+    /**
+     * @brief Converts one channel to float and transforms it into the given output buffer
+     * @param pForwardFFTConfig Forward real FFT plan matching the channel length
+     * @param vfInputScratch Real input buffer owned by the calling thread
+     * @param vi16TimeData Channel samples to transform
+     * @param vcfForwardFFTOutput Output bins, must hold size/2 + 1 values
+     */
+    void TransformChannel(kiss_fftr_cfg pForwardFFTConfig, std::vector<float>& vfInputScratch, const std::vector<int16_t>& vi16TimeData, std::vector<std::complex<float>>& vcfForwardFFTOutput);
+
+    /**
+     * @brief Generates magnitudes if enabled and passes on the results of a transformed chunk
+     * @param pTimeChunk Chunk which was transformed
+     * @param pFFTChunk Completed transform of the chunk
+     */
+    void PassFFTResults(std::shared_ptr<TimeChunk> pTimeChunk, std::shared_ptr<FFTChunk> pFFTChunk);
+
+    /**
+     * @brief Queues each channel of a chunk on the worker pool and releases any completed chunks
+     * @param pTimeChunk Chunk to transform
+     * @param pFFTChunk Output chunk with channel storage already sized
+     */
+    void SubmitParallelFFT(std::shared_ptr<TimeChunk> pTimeChunk, std::shared_ptr<FFTChunk> pFFTChunk);
+
+    /**
+     * @brief Passes on completed chunks in submission order
+     * @param uMaxJobsInFlight Waits on the oldest chunk while more than this many are outstanding
+     */
+    void PassCompletedParallelJobs(size_t uMaxJobsInFlight);
+
+    /**
+     * @brief Adds a time chunk to its source history and emits any frames that became due
+     * @param pTimeChunk Time chunk to process
+     */
+    void Process_STFT(std::shared_ptr<TimeChunk> pTimeChunk);
+
+    /**
+     * @brief Windows the current history of a channel and stores the frame magnitudes
+     * @param pForwardFFTConfig Forward real FFT plan of STFT length
+     * @param History Channel history holding exactly one frame of samples
+     * @param pfMagnitudes Output for the frame magnitudes, must hold STFT length/2 + 1 values
+     */
+    void TransformSTFTFrame(kiss_fftr_cfg pForwardFFTConfig, const RingBuffer<float>& History, float* pfMagnitudes);
+
+    /**
+     * @brief Adds the power of a frame to a channel's running average
+     * @param pfMagnitudes Magnitudes of the frame
+     * @param vfPowerAccumulator Running power of the channel
+     * @param u64FrameIndex Index of the frame since the history was reset
+     * @param pfOutput Receives the averaged magnitudes if this frame completes a period, may be null otherwise
+     */
+    void AccumulateWelchFrame(const float* pfMagnitudes, std::vector<float>& vfPowerAccumulator, uint64_t u64FrameIndex, float* pfOutput);
+
+    /**
+     * @brief Grows a scratch buffer if required and records the allocation
+     */
+    template <typename T>
+    void EnsureScratchSize(std::vector<T>& vScratch, size_t uSize)
+    {
+        if (vScratch.size() >= uSize)
+            return;
+
+        vScratch.resize(uSize);
+        m_u64ScratchAllocationCount++;
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,45 @@
+#ifndef FFT_PLAN_CACHE
+#define FFT_PLAN_CACHE
+
+/*Standard Includes*/
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/* Custom Includes */
+#include "kiss_fftr.h"
+
+/**
+ * @brief Owns kiss_fftr plans so each transform length and direction is only allocated once
+ * @note Not thread safe, kiss_fftr plans hold scratch memory so each thread requires its own cache
+ */
+class FFTPlanCache
+{
+public:
+    FFTPlanCache() = default;
+    ~FFTPlanCache();
+
+    FFTPlanCache(const FFTPlanCache&) = delete;
+    FFTPlanCache& operator=(const FFTPlanCache&) = delete;
+
+    /**
+     * @brief Returns the plan for a transform, allocating it on first use
+     * @param uFFTLength Number of real time samples in the transform (must be even)
+     * @param bInverse Whether the plan computes the inverse transform
+     * @return kiss_fftr configuration owned by this cache
+     */
+    kiss_fftr_cfg GetPlan(unsigned uFFTLength, bool bInverse);
+
+    /**
+     * @brief Returns how many plans have been allocated over the lifetime of the cache
+     */
+    uint64_t GetAllocationCount() const { return m_u64AllocationCount; }
+
+private:
+    std::map<std::pair<unsigned, bool>, kiss_fftr_cfg> m_mPlans; ///< Plans keyed by FFT length and direction
+    uint64_t m_u64AllocationCount = 0;                            ///< Number of plans allocated
+};
+
+#endif
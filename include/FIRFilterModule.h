@@ -0,0 +1,91 @@
+#ifndef FIR_FILTER_MODULE
+#define FIR_FILTER_MODULE
+
+/*Standard Includes*/
+#include <complex>
+#include <map>
+
+/* Custom Includes */
+#include "BaseModule.h"
+#include "DenseIndexMap.h"
+#include "FFTPlanCache.h"
+#include "SourceIdentifierRegistry.h"
+#include "TimeChunk.h"
+#include "VectorKernelUtility.h"
+#include "json.hpp"
+#include "kiss_fftr.h"
+
+/**
+ * @brief Applies an FIR filter to every channel of time chunks using FFT
+ * overlap-save convolution
+ * @note The FFT length is fixed at nextpow2(4 x taps) on construction, so
+ * chunks are filtered in steps of FFT length - taps + 1 samples whatever their
+ * size. The last taps - 1 samples of each channel are carried to the next
+ * chunk of the same source so output is continuous. Output is not delay
+ * compensated, a linear phase filter delays by (taps - 1)/2 samples.
+ */
+class FIRFilterModule : public BaseModule {
+public:
+  /**
+   * @brief Construct a new FIRFilterModule object
+   * @param[in] uBufferSize size of processing input buffer
+   * @param[in] jsonConfig Requires "FilterCoefficients" (array of filter taps)
+   */
+  FIRFilterModule(unsigned uBufferSize,
+                  nlohmann::json_abi_v3_11_2::json jsonConfig);
+
+  /**
+   * @brief Returns module type
+   * @param[out] ModuleType of processing module
+   */
+  std::string GetModuleType() override { return "FIRFilterModule"; };
+
+private:
+  /**
+   * @brief Input carried between chunks of a source
+   */
+  struct FIRSourceState {
+    double dSampleRate = 0; ///< Sample rate the history was recorded at
+    std::vector<std::vector<float>>
+        vvfChannelHistory; ///< Last taps - 1 input samples of each channel
+  };
+
+  const std::vector<float> m_vfFilterCoefficients; ///< Filter taps
+  const unsigned m_uFFTLength;  ///< Length of every block transform
+  FFTPlanCache m_FFTPlanCache;  ///< Owns the forward and inverse plans
+  kiss_fftr_cfg m_ForwardFFTConfig; ///< Forward plan of the block length
+  kiss_fftr_cfg m_InverseFFTConfig; ///< Inverse plan of the block length
+  std::vector<std::complex<float>>
+      m_vcfFilterSpectrum; ///< Filter spectrum at the block length, includes 1/N
+  DenseIndexMap<FIRSourceState>
+      m_mSourceStates; ///< Carried input of each interned source index
+  SourceIndexCache m_SourceIndexCache; ///< Index of the last source seen
+  std::vector<float> m_vfBlockScratch; ///< History, chunk and padding of a
+                                       ///< channel, then the filtered output
+  std::vector<std::complex<float>>
+      m_vcfSpectrumScratch; ///< Spectrum of the block being filtered
+
+  /**
+   * @brief Filters every channel of a time chunk and passes on the result
+   */
+  void Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk);
+
+  /**
+   * @brief Returns the smallest power of two of at least four times the taps,
+   * which keeps the FFT cost per output sample near its minimum
+   * @param[in] uNumTaps Number of filter taps
+   */
+  static unsigned GetBlockFFTLength(size_t uNumTaps);
+
+  /**
+   * @brief Filters one step of a channel in place through the block scratch
+   * @param[in] vfHistory Last taps - 1 input samples, updated to include the step
+   * @param[in] pi16Input Input samples of the step
+   * @param[out] pi16Output Filtered samples of the step
+   * @param[in] uStepLength Number of samples in the step
+   */
+  void FilterStep(std::vector<float> &vfHistory, const int16_t *pi16Input,
+                  int16_t *pi16Output, size_t uStepLength);
+};
+
+#endif
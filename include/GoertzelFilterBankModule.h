@@ -0,0 +1,74 @@
+#ifndef GOERTZEL_FILTER_BANK_MODULE
+#define GOERTZEL_FILTER_BANK_MODULE
+
+/*Standard Includes*/
+#include <cmath>
+#include <map>
+
+/* Custom Includes */
+#include "BaseModule.h"
+#include "DenseIndexMap.h"
+#include "SourceIdentifierRegistry.h"
+#include "TimeChunk.h"
+#include "TonePowerChunk.h"
+#include "json.hpp"
+
+/**
+ * @brief Measures the power of a few known tones with a bank of Goertzel
+ * filters rather than a full FFT
+ * @note Filter state streams across chunk boundaries, so blocks need not align
+ * with chunks. Cheaper than the FFT path while fewer than about log2(block
+ * length) tones are monitored.
+ */
+class GoertzelFilterBankModule : public BaseModule {
+public:
+  /**
+   * @brief Construct a new GoertzelFilterBankModule object
+   * @param[in] uBufferSize size of processing input buffer
+   * @param[in] jsonConfig Requires "TargetFrequencies_Hz" (array of tone
+   * frequencies) and "BlockLength" (samples per power measurement)
+   */
+  GoertzelFilterBankModule(unsigned uBufferSize,
+                           nlohmann::json_abi_v3_11_2::json jsonConfig);
+
+  /**
+   * @brief Returns module type
+   * @param[out] ModuleType of processing module
+   */
+  std::string GetModuleType() override { return "GoertzelFilterBankModule"; };
+
+private:
+  /**
+   * @brief Filter state of every channel and tone of a source
+   */
+  struct GoertzelSourceState {
+    double dSampleRate = 0;          ///< Sample rate the coefficients match
+    unsigned uNumChannels = 0;       ///< Channels the state was sized for
+    unsigned uSamplesInBlock = 0;    ///< Samples already filtered this block
+    std::vector<double> vdCoefficients; ///< 2cos(w) of each tone
+    std::vector<double> vdState1;    ///< Channel major previous filter output
+    std::vector<double> vdState2;    ///< Channel major second previous output
+  };
+
+  const std::vector<float> m_vfTargetFrequencies_Hz; ///< Tones to monitor
+  const unsigned m_uBlockLength; ///< Samples per power measurement
+  DenseIndexMap<GoertzelSourceState>
+      m_mSourceStates; ///< Streaming state of each interned source index
+  SourceIndexCache m_SourceIndexCache; ///< Index of the last source seen
+
+  /**
+   * @brief Filters a time chunk and emits the powers of any completed blocks
+   */
+  void Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk);
+
+  /**
+   * @brief Clears the filter state and recomputes coefficients for a source
+   * @param[in] State State to reset
+   * @param[in] dSampleRate Sample rate of the source
+   * @param[in] uNumChannels Number of channels of the source
+   */
+  void ResetSourceState(GoertzelSourceState &State, double dSampleRate,
+                        unsigned uNumChannels);
+};
+
+#endif
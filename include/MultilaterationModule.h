@@ -0,0 +1,114 @@
+#ifndef MULTILATERATION_MODULE
+#define MULTILATERATION_MODULE
+
+/*Standard Includes*/
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Custom Includes */
+#include "BaseModule.h"
+#include "PositionChunk.h"
+#include "TDOAEstimateChunk.h"
+
+/**
+ * @brief Solves for the position of an emitter from the time differences of arrival between sensors
+ * @note Sensors are placed in a local east north frame on the WGS84 tangent plane at their mean position. The frame
+ *       is only recomputed when the geometry changes. Emitters are assumed to lie on that plane.
+ */
+class MultilaterationModule : public BaseModule
+{
+public:
+    /**
+     * @brief Construct a new MultilaterationModule object
+     * @param uBufferSize size of processing input buffer
+     * @param dPropagationVelocity_mps Propagation velocity of the signal
+     * @param fMinConfidence Pairs with a weaker correlation peak are left out of the fix
+     * @param uMaxIterations Upper bound on Gauss-Newton refinement steps
+     */
+    MultilaterationModule(unsigned uBufferSize, double dPropagationVelocity_mps = 343, float fMinConfidence = 0.1f, unsigned uMaxIterations = 10);
+
+    /**
+     * @brief Solves for the emitter position of a delay matrix and passes on the fix followed by the matrix
+     */
+    void Process_TDOAEstimateChunk(std::shared_ptr<BaseChunk> pBaseChunk);
+
+    /**
+     * @brief Returns module type
+     * @return ModuleType of processing module
+     */
+    std::string GetModuleType() override { return "MultilaterationModule"; };
+
+    /**
+     * @brief Returns how many times sensor positions have been converted to the local frame
+     */
+    uint64_t GetGeometryUpdateCount() const { return m_u64GeometryUpdateCount; }
+
+private:
+    /**
+     * @brief Range difference between two sensors derived from one delay
+     */
+    struct RangeDifference
+    {
+        unsigned uFirstSensor;       ///< Sensor the difference is measured from
+        unsigned uSecondSensor;      ///< Sensor the difference is measured to
+        double dRangeDifference_m;   ///< Distance to the second sensor minus distance to the first
+        double dWeight;              ///< Inverse variance of the difference
+    };
+
+    double m_dPropagationVelocity_mps;          ///< Propagation velocity of the signal
+    float m_fMinConfidence;                     ///< Smallest correlation peak of a pair used in a fix
+    unsigned m_uMaxIterations;                  ///< Upper bound on Gauss-Newton steps
+
+    // Geometry
+    std::vector<double> m_vdSensorLatitudes;    ///< Latitudes the local frame was computed for
+    std::vector<double> m_vdSensorLongitudes;   ///< Longitudes the local frame was computed for
+    double m_dReferenceLatitude = 0;            ///< Latitude of the local frame origin
+    double m_dReferenceLongitude = 0;           ///< Longitude of the local frame origin
+    std::vector<double> m_vdSensorEast_m;       ///< East position of each sensor
+    std::vector<double> m_vdSensorNorth_m;      ///< North position of each sensor
+    uint64_t m_u64GeometryUpdateCount = 0;      ///< Number of times the local frame was computed
+
+    // Reused per fix
+    std::vector<RangeDifference> m_vRangeDifferences; ///< Range differences of every usable pair
+
+    /**
+     * @brief Recomputes the local frame if sensor positions differ from those it was computed for
+     */
+    void UpdateGeometry(const TDOAEstimateChunk& Estimate);
+
+    /**
+     * @brief Closed form spherical intersection initialiser using range differences to one reference sensor
+     * @param uReferenceSensor Sensor the range differences are taken relative to
+     * @param dEast_m Receives the east position
+     * @param dNorth_m Receives the north position
+     * @return False when there are too few differences or the geometry is degenerate
+     */
+    bool InitialiseClosedForm(unsigned uReferenceSensor, double& dEast_m, double& dNorth_m);
+
+    /**
+     * @brief Weighted Gauss-Newton refinement over all usable pairs
+     * @param dEast_m East position to refine
+     * @param dNorth_m North position to refine
+     * @param adCovariance_m2 Receives the row major east north covariance
+     * @param dResidual_m Receives the root mean square range difference residual
+     * @return False if the normal equations became singular
+     */
+    bool RefineGaussNewton(double& dEast_m, double& dNorth_m, std::array<double, 4>& adCovariance_m2, double& dResidual_m);
+
+    /**
+     * @brief Converts a position on the WGS84 ellipsoid to earth centred earth fixed coordinates
+     */
+    static std::array<double, 3> ConvertGeodeticToECEF(double dLatitude_deg, double dLongitude_deg);
+
+    /**
+     * @brief Converts a position in the local frame back to latitude and longitude
+     */
+    void ConvertENUToGeodetic(double dEast_m, double dNorth_m, double& dLatitude_deg, double& dLongitude_deg) const;
+};
+
+#endif
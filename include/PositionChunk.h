@@ -0,0 +1,66 @@
+#ifndef POSITION_CHUNK
+#define POSITION_CHUNK
+
+/*Standard Includes*/
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/* Custom Includes */
+#include "BaseChunk.h"
+
+/**
+ * @brief Estimated position of an emitter with its uncertainty
+ * @note Requires the PositionChunk entry in the shared ChunkType enumeration
+ */
+class PositionChunk : public BaseChunk
+{
+public:
+    /**
+     * @brief Construct a new PositionChunk object
+     * @param i64TimeStamp Timestamp (us) of the window the position was estimated from
+     */
+    PositionChunk(uint64_t i64TimeStamp);
+    ~PositionChunk() {};
+
+    /**
+     * @brief Returns chunk type
+     */
+    ChunkType GetChunkType() override { return ChunkType::PositionChunk; };
+
+    /**
+     * @brief Returns size of the serialised chunk in bytes
+     */
+    unsigned GetSize() override;
+
+    /**
+     * @brief Converts the chunk into a byte array
+     */
+    std::shared_ptr<std::vector<char>> Serialise() override;
+
+    /**
+     * @brief Populates the chunk from a byte array created by Serialise
+     */
+    void Deserialise(std::shared_ptr<std::vector<char>> pvBytes) override;
+
+    uint64_t m_i64TimeStamp;                 ///< Timestamp (us) of the window the position was estimated from
+    double m_dLatitude = 0;                  ///< Latitude of the emitter in degrees
+    double m_dLongitude = 0;                 ///< Longitude of the emitter in degrees
+    double m_dReferenceLatitude = 0;         ///< Latitude of the origin of the local east north frame
+    double m_dReferenceLongitude = 0;        ///< Longitude of the origin of the local east north frame
+    double m_dEast_m = 0;                    ///< Distance east of the origin
+    double m_dNorth_m = 0;                   ///< Distance north of the origin
+    std::array<double, 4> m_adCovariance_m2 = {}; ///< Row major east north covariance
+    double m_dResidual_m = 0;                ///< Root mean square range difference residual
+    uint32_t m_u32NumMeasurements = 0;       ///< Sensor pairs used in the fix
+
+private:
+    /**
+     * @brief Returns size of the members of this class in bytes
+     */
+    unsigned GetInternalSize();
+};
+
+#endif
@@ -2,6 +2,8 @@
 #define RATE_LIMITING_MODULE
 
 #include "BaseModule.h"
+#include "DenseIndexMap.h"
+#include "SourceIdentifierRegistry.h"
 #include "chrono"
 
 /**
@@ -40,7 +42,8 @@ public:
 private:
 
     std::map<ChunkType,uint64_t> m_mapChunkTypeToRatePeriod;    ///< Map which stores which chunk should be rate limited
-    std::map<std::vector<uint8_t>,std::map<ChunkType,uint64_t>> m_mapChunkTypeToLastReportTime;  ///< Map which stores when the last chunk was sent 
+    DenseIndexMap<DenseIndexMap<uint64_t>> m_mapChunkTypeToLastReportTime;  ///< When the last chunk was sent, by interned source index then chunk type
+    SourceIndexCache m_SourceIndexCache;                        ///< Index of the last source seen
 
 };
 
@@ -0,0 +1,100 @@
+#ifndef RESAMPLER_MODULE
+#define RESAMPLER_MODULE
+
+/*Standard Includes*/
+#include <cmath>
+#include <map>
+#include <numeric>
+
+/* Custom Includes */
+#include "BaseModule.h"
+#include "DenseIndexMap.h"
+#include "SourceIdentifierRegistry.h"
+#include "TimeChunk.h"
+#include "VectorKernelUtility.h"
+#include "WindowFunctionUtility.h"
+#include "json.hpp"
+
+/**
+ * @brief Changes the sample rate of time chunks by a rational factor L/M
+ * using a polyphase FIR filter
+ * @note Only the filter phases needed for each output sample are evaluated,
+ * so decimation costs taps per phase multiplies per output sample rather than
+ * per input sample. Each channel is kept contiguous and each phase stores its
+ * taps oldest first, so an output sample is one vector dot product over the
+ * taps. Output is re-chunked to a fixed size with
+ * the sample rate and timestamps of the new rate. Timestamps are moved back
+ * by the filter delay of (taps - 1)/2 upsampled samples, so each output
+ * sample is stamped with the time of the input it represents.
+ */
+class ResamplerModule : public BaseModule {
+public:
+  /**
+   * @brief Construct a new ResamplerModule object
+   * @param[in] uBufferSize size of processing input buffer
+   * @param[in] jsonConfig Requires "InterpolationFactor" (L),
+   * "DecimationFactor" (M), "TapsPerPhase" and "OutputChunkSize"
+   */
+  ResamplerModule(unsigned uBufferSize,
+                  nlohmann::json_abi_v3_11_2::json jsonConfig);
+
+  /**
+   * @brief Returns module type
+   * @param[out] ModuleType of processing module
+   */
+  std::string GetModuleType() override { return "ResamplerModule"; };
+
+private:
+  /**
+   * @brief Filter history and partly filled output of a source
+   */
+  struct ResamplerSourceState {
+    double dSampleRate = 0;    ///< Input sample rate of the source
+    unsigned uNumChannels = 0; ///< Channels the state was sized for
+    std::vector<std::vector<float>>
+        vvfHistory; ///< Last taps per phase - 1 input samples of each channel
+    uint64_t u64NextOutputTime = 0; ///< Upsampled index of the next output
+                                    ///< relative to the next input chunk
+    std::shared_ptr<TimeChunk> pOutputChunk; ///< Output being filled
+    unsigned uOutputSamples = 0; ///< Samples written to the output chunk
+  };
+
+  unsigned m_uInterpolationFactor; ///< Upsampling factor L, reduced by the
+                                   ///< common divisor with M
+  unsigned m_uDecimationFactor;    ///< Downsampling factor M
+  const unsigned m_uTapsPerPhase;  ///< Filter taps applied per output sample
+  const unsigned m_uOutputChunkSize; ///< Samples per output chunk
+  std::vector<std::vector<float>>
+      m_vvfPolyphaseTaps; ///< Taps of each phase, oldest input first so they
+                          ///< line up with the channel samples
+  DenseIndexMap<ResamplerSourceState>
+      m_mSourceStates; ///< State of each interned source index
+  SourceIndexCache m_SourceIndexCache; ///< Index of the last source seen
+  std::vector<std::vector<float>>
+      m_vvfChannelScratch; ///< History then chunk samples of each channel
+  std::vector<float> m_vfOutputFrame; ///< Accumulator of one output frame
+  std::vector<int16_t> m_vi16OutputFrame; ///< Converted output frame
+
+  /**
+   * @brief Resamples a time chunk, passing on every output chunk it completes
+   */
+  void Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk);
+
+  /**
+   * @brief Designs the anti aliasing filter and splits it into phases
+   */
+  void DesignPolyphaseFilter();
+
+  /**
+   * @brief Appends one output frame to the source output chunk, passing the
+   * chunk on once full
+   * @param[in] State State of the source
+   * @param[in] pTimeChunk Input chunk the frame came from
+   * @param[in] i64FrameTimeStamp Timestamp (us) of the output frame
+   */
+  void AppendOutputFrame(ResamplerSourceState &State,
+                         std::shared_ptr<TimeChunk> pTimeChunk,
+                         int64_t i64FrameTimeStamp);
+};
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef RING_BUFFER
+#define RING_BUFFER
+
+/*Standard Includes*/
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Fixed capacity FIFO of samples which overwrites the oldest data once full
+ * @note Storage is allocated once on construction or reset, pushing and consuming never allocate
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+    /**
+     * @brief Construct a new RingBuffer object
+     * @param uCapacity Maximum number of elements held before the oldest are overwritten
+     */
+    RingBuffer(size_t uCapacity = 0) { Reset(uCapacity); }
+
+    /**
+     * @brief Discards all data and reallocates storage to the given capacity
+     * @param uCapacity Maximum number of elements held before the oldest are overwritten
+     */
+    void Reset(size_t uCapacity)
+    {
+        m_vBuffer.assign(uCapacity, T());
+        m_uHead = 0;
+        m_uSize = 0;
+    }
+
+    /**
+     * @brief Discards all data while keeping the allocated storage
+     */
+    void Clear()
+    {
+        m_uHead = 0;
+        m_uSize = 0;
+    }
+
+    size_t Capacity() const { return m_vBuffer.size(); }
+    size_t Size() const { return m_uSize; }
+    bool Empty() const { return m_uSize == 0; }
+    bool Full() const { return m_uSize == m_vBuffer.size(); }
+
+    /**
+     * @brief Appends elements, overwriting the oldest elements if capacity is exceeded
+     * @param pData Pointer to elements to append
+     * @param uCount Number of elements to append
+     * @return Number of old elements that were overwritten to make space
+     */
+    size_t Push(const T* pData, size_t uCount)
+    {
+        size_t uCapacity = m_vBuffer.size();
+        if (uCapacity == 0)
+            return uCount;
+
+        // When more data than capacity arrives only the most recent data is kept
+        if (uCount >= uCapacity)
+        {
+            size_t uEvicted = m_uSize + uCount - uCapacity;
+            std::copy(pData + uCount - uCapacity, pData + uCount, m_vBuffer.begin());
+            m_uHead = 0;
+            m_uSize = uCapacity;
+            return uEvicted;
+        }
+
+        size_t uEvicted = (m_uSize + uCount > uCapacity) ? m_uSize + uCount - uCapacity : 0;
+
+        // Write up to the end of storage and then wrap around to the start
+        size_t uTail = (m_uHead + m_uSize) % uCapacity;
+        size_t uFirstCopyLength = std::min(uCount, uCapacity - uTail);
+        std::copy(pData, pData + uFirstCopyLength, m_vBuffer.begin() + uTail);
+        std::copy(pData + uFirstCopyLength, pData + uCount, m_vBuffer.begin());
+
+        m_uSize += uCount;
+        if (m_uSize > uCapacity)
+        {
+            m_uHead = (m_uHead + m_uSize - uCapacity) % uCapacity;
+            m_uSize = uCapacity;
+        }
+
+        return uEvicted;
+    }
+
+    /**
+     * @brief Drops the oldest elements in constant time
+     * @param uCount Number of elements to drop, clamped to the current size
+     */
+    void Consume(size_t uCount)
+    {
+        uCount = std::min(uCount, m_uSize);
+        if (uCount == 0)
+            return;
+
+        m_uHead = (m_uHead + uCount) % m_vBuffer.size();
+        m_uSize -= uCount;
+    }
+
+    /**
+     * @brief Returns the element at a position counted from the oldest element
+     */
+    const T& operator[](size_t uIndex) const
+    {
+        assert(uIndex < m_uSize);
+        return m_vBuffer[(m_uHead + uIndex) % m_vBuffer.size()];
+    }
+
+    /**
+     * @brief Returns a zero copy view of stored elements
+     * @param uOffset Position of the first element counted from the oldest element
+     * @param uCount Number of elements to view
+     * @return Pair of contiguous spans, the second is only non empty when the view wraps around storage
+     */
+    std::pair<std::span<const T>, std::span<const T>> Peek(size_t uOffset, size_t uCount) const
+    {
+        assert(uOffset + uCount <= m_uSize);
+        if (uCount == 0)
+            return {};
+
+        size_t uStart = (m_uHead + uOffset) % m_vBuffer.size();
+        size_t uFirstLength = std::min(uCount, m_vBuffer.size() - uStart);
+        return { std::span<const T>(m_vBuffer.data() + uStart, uFirstLength),
+                 std::span<const T>(m_vBuffer.data(), uCount - uFirstLength) };
+    }
+
+    /**
+     * @brief Copies stored elements into a contiguous destination
+     * @param uOffset Position of the first element counted from the oldest element
+     * @param uCount Number of elements to copy
+     * @param pDestination Destination with space for uCount elements
+     */
+    void CopyTo(size_t uOffset, size_t uCount, T* pDestination) const
+    {
+        auto [FirstSpan, SecondSpan] = Peek(uOffset, uCount);
+        std::copy(FirstSpan.begin(), FirstSpan.end(), pDestination);
+        std::copy(SecondSpan.begin(), SecondSpan.end(), pDestination + FirstSpan.size());
+    }
+
+private:
+    std::vector<T> m_vBuffer; ///< Storage of fixed capacity
+    size_t m_uHead = 0;       ///< Index of the oldest element in storage
+    size_t m_uSize = 0;       ///< Number of valid elements
+};
+
+#endif
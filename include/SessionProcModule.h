@@ -7,8 +7,11 @@
 #include "BaseModule.h"
 #include "SessionController.h"
 #include "ByteChunk.h"
+#include "ByteFragmentChunk.h"
 #include "TimeChunk.h"
 #include "ChunkDuplicatorUtility.h"
+#include "DenseIndexMap.h"
+#include "SourceIdentifierRegistry.h"
 
 class SessionProcModule : public BaseModule
 {
@@ -31,8 +34,9 @@ public:
 
 private:
     std::map<uint32_t, std::function<void(std::shared_ptr<ByteChunk>)>> m_mFunctionCallbacksMap;             ///< Map of function callbacks called according to session type
-    std::map<std::vector<uint8_t>, std::map<ChunkType, std::shared_ptr<std::vector<char>>>> m_mSessionBytes; ///< Map of session mode intermediate bytes prior ro session completion
-    std::map<std::vector<uint8_t>, std::map<ChunkType, std::shared_ptr<SessionController>>> m_mSessionModesStatesMap;
+    DenseIndexMap<DenseIndexMap<std::shared_ptr<std::vector<char>>>> m_mSessionBytes;       ///< Session mode intermediate bytes prior ro session completion, by interned source index then chunk type
+    DenseIndexMap<DenseIndexMap<std::shared_ptr<SessionController>>> m_mSessionModesStatesMap;
+    SourceIndexCache m_SourceIndexCache;                                                    ///< Index of the last source seen
     /*
      * @brief Module process to collect and format UDP data
      */
@@ -43,9 +47,9 @@ private:
      */
     void RegisterSessionStates();
 
-    std::shared_ptr<SessionController> GetPreviousSessionState(std::vector<uint8_t> &vu8SourceIdentifier, ChunkType chunkType);
+    std::shared_ptr<SessionController> GetPreviousSessionState(uint32_t u32SourceIndex, ChunkType chunkType);
 
-    void UpdatePreviousSessionState(std::vector<uint8_t> &vu8SourceIdentifier, ChunkType chunkType, SessionController reliableSessionMode);
+    void UpdatePreviousSessionState(uint32_t u32SourceIndex, ChunkType chunkType, SessionController reliableSessionMode);
 };
 
 #endif
\ No newline at end of file
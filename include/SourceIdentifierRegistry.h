@@ -0,0 +1,94 @@
+#ifndef SOURCE_IDENTIFIER_REGISTRY
+#define SOURCE_IDENTIFIER_REGISTRY
+
+/*Standard Includes*/
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Process wide table which interns source identifiers into small dense indices
+ * @note Indices are handed out in the order identifiers are first seen and are never reused, so modules
+ *       can key per source state on them with a DenseIndexMap. Safe to use from any module thread.
+ */
+class SourceIdentifierRegistry
+{
+public:
+    /**
+     * @brief Returns the registry shared by every module in the process
+     */
+    static SourceIdentifierRegistry& GetInstance();
+
+    SourceIdentifierRegistry(const SourceIdentifierRegistry&) = delete;
+    SourceIdentifierRegistry& operator=(const SourceIdentifierRegistry&) = delete;
+
+    /**
+     * @brief Returns the index of an identifier, assigning the next free one the first time it is seen
+     * @param vu8SourceIdentifier Identifier to intern
+     * @return Dense index of the identifier
+     */
+    uint32_t Intern(const std::vector<uint8_t>& vu8SourceIdentifier);
+
+    /**
+     * @brief Returns the identifier an index was assigned to
+     * @param u32SourceIndex Index returned by Intern
+     * @return Identifier, the reference remains valid for the life of the process
+     */
+    const std::vector<uint8_t>& GetSourceIdentifier(uint32_t u32SourceIndex) const;
+
+    /**
+     * @brief Returns how many identifiers have been interned
+     */
+    size_t GetSize() const;
+
+private:
+    /**
+     * @brief FNV-1a hash over identifier bytes
+     */
+    struct IdentifierHash
+    {
+        size_t operator()(const std::vector<uint8_t>& vu8SourceIdentifier) const;
+    };
+
+    SourceIdentifierRegistry() = default;
+
+    mutable std::shared_mutex m_RegistryMutex;                                              ///< Lookups share the registry, interning is exclusive
+    std::unordered_map<std::vector<uint8_t>, uint32_t, IdentifierHash> m_mIdentifierIndices; ///< Index assigned to each identifier
+    std::deque<std::vector<uint8_t>> m_dqIdentifiers;                                        ///< Identifier of each index, a deque so references stay valid as it grows
+};
+
+/**
+ * @brief Remembers the last identifier a module interned so runs of chunks from one source skip the registry
+ * @note Chunks mostly arrive in runs from the same source, so a hit is a short byte compare without hashing or
+ *       locking. Owned by a single module thread.
+ */
+class SourceIndexCache
+{
+public:
+    /**
+     * @brief Returns the index of an identifier, going to the registry only when it differs from the last one
+     * @param vu8SourceIdentifier Identifier to intern
+     * @return Dense index of the identifier
+     */
+    uint32_t Intern(const std::vector<uint8_t>& vu8SourceIdentifier)
+    {
+        if (m_pvu8LastIdentifier && *m_pvu8LastIdentifier == vu8SourceIdentifier)
+            return m_u32LastIndex;
+
+        auto& Registry = SourceIdentifierRegistry::GetInstance();
+        m_u32LastIndex = Registry.Intern(vu8SourceIdentifier);
+        m_pvu8LastIdentifier = &Registry.GetSourceIdentifier(m_u32LastIndex);
+        return m_u32LastIndex;
+    }
+
+private:
+    const std::vector<uint8_t>* m_pvu8LastIdentifier = nullptr; ///< Registry's copy of the last identifier, valid for the life of the process
+    uint32_t m_u32LastIndex = 0;                                ///< Index of the last identifier
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SPECTROGRAM_CHUNK
+#define SPECTROGRAM_CHUNK
+
+/*Standard Includes*/
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/* Custom Includes */
+#include "BaseChunk.h"
+
+/**
+ * @brief Magnitudes of consecutive, possibly overlapping, windowed FFT frames
+ * @note Requires the SpectrogramChunk entry in the shared ChunkType enumeration
+ */
+class SpectrogramChunk : public BaseChunk
+{
+public:
+    /**
+     * @brief Construct a new SpectrogramChunk object
+     * @param dSampleRate Sample rate of the time data the frames were computed from
+     * @param i64TimeStamp Timestamp (us) of the first sample of the first frame
+     * @param uNumChannels Number of channels
+     * @param uNumFrames Number of frames per channel
+     * @param uNumBins Number of frequency bins per frame
+     * @param uFFTLength Number of time samples in each frame
+     * @param uHopLength Number of time samples between the starts of consecutive frames
+     */
+    SpectrogramChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumChannels, unsigned uNumFrames, unsigned uNumBins, unsigned uFFTLength, unsigned uHopLength);
+    ~SpectrogramChunk() {};
+
+    /**
+     * @brief Returns chunk type
+     */
+    ChunkType GetChunkType() override { return ChunkType::SpectrogramChunk; };
+
+    /**
+     * @brief Returns size of the serialised chunk in bytes
+     */
+    unsigned GetSize() override;
+
+    /**
+     * @brief Converts the chunk into a byte array
+     */
+    std::shared_ptr<std::vector<char>> Serialise() override;
+
+    /**
+     * @brief Populates the chunk from a byte array created by Serialise
+     */
+    void Deserialise(std::shared_ptr<std::vector<char>> pvBytes) override;
+
+    /**
+     * @brief Returns a pointer to the contiguous bins of one frame of one channel
+     */
+    float* GetFrame(unsigned uChannelIndex, unsigned uFrameIndex) { return &m_vfMagnitudes[((size_t)uChannelIndex * m_uNumFrames + uFrameIndex) * m_uNumBins]; }
+
+    double m_dSampleRate;              ///< Sample rate of the underlying time data
+    uint64_t m_i64TimeStamp;           ///< Timestamp (us) of the first sample of the first frame
+    unsigned m_uNumChannels;           ///< Number of channels
+    unsigned m_uNumFrames;             ///< Number of frames per channel
+    unsigned m_uNumBins;               ///< Number of bins per frame
+    unsigned m_uFFTLength;             ///< Time samples per frame
+    unsigned m_uHopLength;             ///< Time samples between frame starts
+    std::vector<float> m_vfMagnitudes; ///< Channel major matrix of frames x bins magnitudes
+
+private:
+    /**
+     * @brief Returns size of the members of this class in bytes
+     */
+    unsigned GetInternalSize();
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef TDOA_CHUNK_ACCESS_UTILITY
+#define TDOA_CHUNK_ACCESS_UTILITY
+
+/*Standard Includes*/
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/* Custom Includes */
+#include "TDOAChunk.h"
+#include "TDOAWindowChunk.h"
+
+/**
+ * @brief Reads back the per sensor data a TDOAChunk was filled with through TDOAChunk::AddData or TDOAWindowChunk::AddWindow
+ * @note TDOAChunk only defines AddData as its interface for sensor data. Consumers read the members it fills
+ *       through here so their layout is depended on in a single place. Channels are read as spans so windows
+ *       made of shared blocks are read in place.
+ */
+class TDOAChunkAccessUtility
+{
+public:
+    /**
+     * @brief Returns the number of sensors in the chunk
+     */
+    static size_t GetNumSensors(const TDOAChunk& Chunk);
+
+    /**
+     * @brief Returns the number of channels of a sensor
+     */
+    static size_t GetNumChannels(const TDOAChunk& Chunk, size_t uSensorIndex);
+
+    /**
+     * @brief Returns the number of samples in a channel of a sensor
+     */
+    static size_t GetNumSamples(const TDOAChunk& Chunk, size_t uSensorIndex, size_t uChannelIndex);
+
+    /**
+     * @brief Returns the contiguous runs a channel of a sensor is made up of, in time order
+     * @param Chunk Chunk to read
+     * @param uSensorIndex Sensor in the order it was added
+     * @param uChannelIndex Channel of the sensor
+     * @param vSpans Receives views of the runs, valid while the chunk is
+     */
+    static void GetChannelSpans(const TDOAChunk& Chunk, size_t uSensorIndex, size_t uChannelIndex, std::vector<std::span<const int16_t>>& vSpans);
+
+    /**
+     * @brief Copies the channels of each sensor in the order they were added
+     */
+    static std::vector<std::vector<std::vector<int16_t>>> CopyTimeData(const TDOAChunk& Chunk);
+
+    /**
+     * @brief Returns the base time data of a chunk, for chunk types which fill it after AddData
+     */
+    static std::vector<std::vector<std::vector<int16_t>>>& GetTimeData(TDOAChunk& Chunk);
+
+    /**
+     * @brief Returns the source identifier of each sensor in the order they were added
+     */
+    static const std::vector<std::vector<uint8_t>>& GetSourceIdentifiers(const TDOAChunk& Chunk);
+
+    /**
+     * @brief Returns the longitude of each sensor in the order they were added
+     */
+    static const std::vector<double>& GetLongitudes(const TDOAChunk& Chunk);
+
+    /**
+     * @brief Returns the latitude of each sensor in the order they were added
+     */
+    static const std::vector<double>& GetLatitudes(const TDOAChunk& Chunk);
+};
+
+#endif
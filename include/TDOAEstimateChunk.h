@@ -0,0 +1,75 @@
+#ifndef TDOA_ESTIMATE_CHUNK
+#define TDOA_ESTIMATE_CHUNK
+
+/*Standard Includes*/
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/* Custom Includes */
+#include "BaseChunk.h"
+
+/**
+ * @brief Time difference of arrival between every pair of sensors over one synchronised window
+ * @note Requires the TDOAEstimateChunk entry in the shared ChunkType enumeration
+ */
+class TDOAEstimateChunk : public BaseChunk
+{
+public:
+    /**
+     * @brief Construct a new TDOAEstimateChunk object
+     * @param dSampleRate Sample rate of the time data the delays were estimated from
+     * @param i64TimeStamp Timestamp (us) of the first sample of the window
+     * @param uNumSensors Number of sensors, the matrices are uNumSensors x uNumSensors
+     */
+    TDOAEstimateChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumSensors);
+    ~TDOAEstimateChunk() {};
+
+    /**
+     * @brief Returns chunk type
+     */
+    ChunkType GetChunkType() override { return ChunkType::TDOAEstimateChunk; };
+
+    /**
+     * @brief Returns size of the serialised chunk in bytes
+     */
+    unsigned GetSize() override;
+
+    /**
+     * @brief Converts the chunk into a byte array
+     */
+    std::shared_ptr<std::vector<char>> Serialise() override;
+
+    /**
+     * @brief Populates the chunk from a byte array created by Serialise
+     */
+    void Deserialise(std::shared_ptr<std::vector<char>> pvBytes) override;
+
+    /**
+     * @brief Returns arrival time at the second sensor minus arrival time at the first
+     */
+    float GetDelay_s(unsigned uFirstSensor, unsigned uSecondSensor) const { return m_vfDelays_s[(size_t)uFirstSensor * m_uNumSensors + uSecondSensor]; }
+
+    /**
+     * @brief Returns the normalised correlation peak of a pair, 1 for identical delayed signals and near 0 for unrelated ones
+     */
+    float GetConfidence(unsigned uFirstSensor, unsigned uSecondSensor) const { return m_vfConfidences[(size_t)uFirstSensor * m_uNumSensors + uSecondSensor]; }
+
+    double m_dSampleRate;                                  ///< Sample rate of the underlying time data
+    uint64_t m_i64TimeStamp;                               ///< Timestamp (us) of the first sample of the window
+    unsigned m_uNumSensors;                                ///< Number of sensors
+    std::vector<std::vector<uint8_t>> m_vvu8SourceIdentifiers; ///< Source identifier of each sensor
+    std::vector<double> m_vdLongitudes;                    ///< Longitude of each sensor
+    std::vector<double> m_vdLatitudes;                     ///< Latitude of each sensor
+    std::vector<float> m_vfDelays_s;                       ///< Row major antisymmetric sensors x sensors delays
+    std::vector<float> m_vfConfidences;                    ///< Row major symmetric sensors x sensors correlation peaks
+
+private:
+    /**
+     * @brief Returns size of the members of this class in bytes
+     */
+    unsigned GetInternalSize();
+};
+
+#endif
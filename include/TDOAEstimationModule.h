@@ -0,0 +1,110 @@
+#ifndef TDOA_ESTIMATION_MODULE
+#define TDOA_ESTIMATION_MODULE
+
+/*Standard Includes*/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+/* Custom Includes */
+#include "BaseModule.h"
+#include "FFTPlanCache.h"
+#include "TDOAChunk.h"
+#include "TDOAChunkAccessUtility.h"
+#include "TDOAEstimateChunk.h"
+#include "VectorKernelUtility.h"
+#include "WorkerPool.h"
+#include "kiss_fftr.h"
+
+/**
+ * @brief Estimates the time difference of arrival between every pair of sensors in a synchronised window using GCC-PHAT
+ * @note Each sensor's first channel is transformed once and reused by all of its pairs. Sensors and then pairs are
+ *       spread over the workers, and each chunk is complete before the next is processed.
+ */
+class TDOAEstimationModule : public BaseModule
+{
+public:
+    /**
+     * @brief Construct a new TDOAEstimationModule object
+     * @param uBufferSize size of processing input buffer
+     * @param uNumWorkers Threads the transforms and correlations are spread over, 1 runs them on the processing thread
+     * @param dMaxDelay_s Largest delay searched for, such as the longest baseline over the propagation velocity, 0 searches the whole window
+     */
+    TDOAEstimationModule(unsigned uBufferSize, unsigned uNumWorkers = 1, double dMaxDelay_s = 0);
+
+    /**
+     * @brief Estimates the delay matrix of a window and passes it on followed by the window
+     */
+    void Process_TDOAChunk(std::shared_ptr<BaseChunk> pBaseChunk);
+
+    /**
+     * @brief Returns module type
+     * @return ModuleType of processing module
+     */
+    std::string GetModuleType() override { return "TDOAEstimationModule"; };
+
+    /**
+     * @brief Returns the transform length used for a window, at least twice the window so correlations do not wrap
+     * @param uWindowLength Samples per channel in the window
+     * @return Smallest even length of the form 2^a 3^b 5^c which kiss_fftr transforms efficiently
+     */
+    static unsigned GetTransformLength(size_t uWindowLength);
+
+private:
+    /**
+     * @brief Plans and scratch owned by a single worker, kiss_fftr plans cannot be shared between threads
+     */
+    struct WorkerGCCState
+    {
+        FFTPlanCache PlanCache;                          ///< Forward and inverse plans used by this worker
+        std::vector<float> vfTimeScratch;                ///< Zero padded input or correlation output
+        std::vector<std::complex<float>> vcfCrossSpectrum; ///< Whitened cross spectrum of the pair being correlated
+        std::vector<std::span<const int16_t>> vSpans;    ///< Runs of the channel being transformed
+    };
+
+    double m_dMaxDelay_s;                                       ///< Largest delay searched for, 0 for the whole window
+    std::vector<std::vector<std::complex<float>>> m_vvcfSensorSpectra; ///< Spectrum of each sensor in the window being processed
+    std::vector<std::unique_ptr<WorkerGCCState>> m_vpWorkerStates;     ///< State of each worker, indexed by worker
+    std::mutex m_TaskMutex;                                     ///< Guards waiting for the tasks of a chunk
+    std::condition_variable m_cvTasksComplete;                  ///< Signalled when the last task of a batch finishes
+    std::atomic<unsigned> m_uTasksRemaining = 0;                ///< Tasks of the current batch not yet finished
+    std::unique_ptr<WorkerPool> m_pWorkerPool;                  ///< Workers, declared last so they stop before the state they use is destroyed
+
+    /**
+     * @brief Runs a batch of independent tasks over the workers and returns once all are complete
+     * @param uNumTasks Number of tasks
+     * @param Task Callable given the task index and the index of the worker running it
+     */
+    void RunTasks(unsigned uNumTasks, const std::function<void(unsigned uTaskIndex, unsigned uWorkerIndex)>& Task);
+
+    /**
+     * @brief Zero pads and transforms the first channel of one sensor
+     * @param WorkerState State of the worker running the transform
+     * @param Chunk Window the sensor is read from
+     * @param uSensorIndex Sensor to transform
+     * @param uTransformLength Transform length
+     * @param vcfSpectrum Receives uTransformLength/2 + 1 bins
+     */
+    void TransformSensor(WorkerGCCState& WorkerState, const TDOAChunk& Chunk, unsigned uSensorIndex, unsigned uTransformLength, std::vector<std::complex<float>>& vcfSpectrum);
+
+    /**
+     * @brief Whitens the cross spectrum of a pair and finds the correlation peak
+     * @param WorkerState State of the worker running the correlation
+     * @param uFirstSensor Sensor the delay is measured from
+     * @param uSecondSensor Sensor the delay is measured to
+     * @param uTransformLength Transform length
+     * @param uMaxLag Largest lag in samples searched either side of zero
+     * @param fDelay_samples Receives arrival at the second sensor minus arrival at the first, interpolated between samples
+     * @param fConfidence Receives the correlation peak normalised to 1 for a pure delay
+     */
+    void CorrelatePair(WorkerGCCState& WorkerState, unsigned uFirstSensor, unsigned uSecondSensor, unsigned uTransformLength, unsigned uMaxLag, float& fDelay_samples, float& fConfidence);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef TDOA_WINDOW_CHUNK
+#define TDOA_WINDOW_CHUNK
+
+/*Standard Includes*/
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* Custom Includes */
+#include "TDOAChunk.h"
+
+/**
+ * @brief Run of samples within a block that consecutive overlapping windows share
+ */
+struct TDOASampleBlock
+{
+    std::shared_ptr<const std::vector<int16_t>> pvi16Samples; ///< Block of samples, kept alive by every window referencing it
+    size_t uOffset = 0;                                       ///< Index of the first sample of the run within the block
+    size_t uLength = 0;                                       ///< Number of samples in the run
+};
+
+/**
+ * @brief Synchronised window whose channels reference shared sample blocks instead of holding their own copies
+ * @note Remains a TDOAChunk so existing routing is unchanged. Consumers read the blocks through TDOAChunkAccessUtility.
+ *       The base time data is only filled if a consumer serialises the chunk or calls Materialise.
+ */
+class TDOAWindowChunk : public TDOAChunk
+{
+public:
+    /**
+     * @brief Construct a new TDOAWindowChunk object
+     * @param dSampleRate Sample rate of every sensor in the window
+     * @param i64TimeStamp Timestamp (us) of the first sample of the window
+     * @param u64ChunkSize Samples per channel in the window
+     */
+    TDOAWindowChunk(double dSampleRate, uint64_t i64TimeStamp, uint64_t u64ChunkSize);
+
+    /**
+     * @brief Adds a sensor whose channels are each made up of runs of shared blocks
+     * @param dLongitude Longitude of the sensor
+     * @param dLatitude Latitude of the sensor
+     * @param vu8SourceIdentifier Source identifier of the sensor
+     * @param vvBlocks Runs making up each channel, in time order
+     */
+    void AddWindow(double dLongitude, double dLatitude, const std::vector<uint8_t>& vu8SourceIdentifier, std::vector<std::vector<TDOASampleBlock>> vvBlocks);
+
+    /**
+     * @brief Returns the runs making up each channel of each sensor in the order they were added
+     */
+    const std::vector<std::vector<std::vector<TDOASampleBlock>>>& GetBlocks() const { return m_vvvBlocks; }
+
+    /**
+     * @brief Copies the blocks into the base time data for consumers which require contiguous channels
+     */
+    void Materialise();
+
+    /**
+     * @brief Returns size of the serialised chunk in bytes, as a TDOAChunk holding the window's samples
+     */
+    unsigned GetSize() override;
+
+    /**
+     * @brief Converts the chunk into a byte array, as a TDOAChunk holding the window's samples
+     */
+    std::shared_ptr<std::vector<char>> Serialise() override;
+
+private:
+    std::vector<std::vector<std::vector<TDOASampleBlock>>> m_vvvBlocks; ///< Runs making up each channel of each sensor
+    bool m_bMaterialised = false;                                      ///< True once the base time data holds the samples
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef TIME_CHUNK_SYNCHRONISATION_MODULE
 #define TIME_CHUNK_SYNCHRONISATION_MODULE
 
+#include <deque>
 #include <map>
 #include <queue>
 #include <memory>
@@ -9,9 +10,15 @@
 #include <atomic>
 
 #include "BaseModule.h"
+#include "DenseIndexMap.h"
+#include "RingBuffer.h"
+#include "SourceIdentifierRegistry.h"
 #include "TimeChunk.h"
+#include "VectorKernelUtility.h"
+#include "WindowFunctionUtility.h"
 #include "GPSChunk.h"
 #include "TDOAChunk.h"
+#include "TDOAWindowChunk.h"
 
 class TimeChunkSynchronisationModule : public BaseModule
 {
@@ -20,7 +27,7 @@ public:
      * @brief Constructor for TimeChunkSynchronisationModule
      * @param uBufferSize The size of the buffer for storing time chunks
      * @param u64Threshold_ns The threshold in nanoseconds for time synchronization
-     * @param u64SyncInterval_ns The interval in nanoseconds between synchronization attempts
+     * @param u64SyncInterval_ns The interval in nanoseconds between realigning sources, windows are extracted whenever enough data is buffered
      */
     TimeChunkSynchronisationModule(unsigned uBufferSize, uint64_t u64Threshold_us, uint64_t u64SyncInterval_ns);
     ~TimeChunkSynchronisationModule() = default;
@@ -74,6 +81,65 @@ public:
      */
     void ClearState();
 
+    /**
+     * @brief Caps the samples buffered for each source, the oldest are dropped once it is reached
+     * @param uMaxBytesPerSource Bytes across all channels of a source, 0 to size buffers from the window alone
+     * @note Should be configured before processing is started
+     */
+    void SetSourceMemoryLimit(size_t uMaxBytesPerSource);
+
+    /**
+     * @brief Restarts sources which fall too far behind the newest data so they do not hold up the others
+     * @param dTimeout_s Largest lag of a source's most recent timestamp behind the newest, 0 disables
+     */
+    void SetStalledSourceTimeout(double dTimeout_s);
+
+    /**
+     * @brief Returns the bytes of samples currently buffered across all sources
+     */
+    uint64_t GetBufferedBytes() const { return m_u64BufferedBytes; }
+
+    /**
+     * @brief Returns how many samples have been dropped from full buffers, counted per channel
+     */
+    uint64_t GetEvictedSampleCount() const { return m_u64EvictedSamples; }
+
+    /**
+     * @brief Returns how many times a single source has been restarted after a gap, channel change or stall
+     */
+    uint64_t GetSourceResetCount() const { return m_u64SourceResets; }
+
+    /**
+     * @brief Sets the length of the synchronised windows and how far apart their starts are
+     * @param dWindowLength_s Length of each TDOA window
+     * @param dHopLength_s Time between the starts of consecutive windows, windows overlap when shorter than their length
+     * @note Should be configured before processing is started
+     */
+    void SetTDOAWindow(double dWindowLength_s, double dHopLength_s);
+
+    /**
+     * @brief Corrects the sub sample offset left between sources after alignment drops whole samples
+     * @param uNumTaps Taps of the windowed sinc interpolator (must be even), windows are read uNumTaps/2 - 1 samples later
+     * @param uNumPhases Fractions between two samples the interpolator is tabulated at, offsets are rounded to the nearest
+     * @note Should be configured before processing is started
+     */
+    void EnableFractionalDelayCorrection(unsigned uNumTaps = 32, unsigned uNumPhases = 64);
+
+    /**
+     * @brief Estimates each source's sample clock from its timestamps and resamples it onto the nominal sample times as it is stored
+     * @param uRegressionChunks Most recent chunks the timestamp against sample count regression is fitted over
+     * @param dMaxDrift_ppm Largest clock error believed, estimates beyond it are clamped
+     * @note Should be configured before processing is started
+     */
+    void EnableDriftCorrection(unsigned uRegressionChunks = 64, double dMaxDrift_ppm = 500);
+
+    /**
+     * @brief Returns how fast a source's sample clock runs relative to its nominal rate
+     * @param vu8SourceIdentifier Source to query
+     * @return Clock error in parts per million, 0 for unknown sources or when drift correction is disabled
+     */
+    double GetEstimatedDrift_ppm(const std::vector<uint8_t>& vu8SourceIdentifier) const;
+
 
 private:
 
@@ -81,19 +147,75 @@ private:
     uint64_t m_u64ChannelTimoutThreshold_us;     ///< how long a channel cannot send data before a state clearance occurs
     uint64_t m_u64SyncInterval_ns;               ///< How long to wait before trying to synchronise channels
     uint64_t m_u64ChannelDiscontinuityThreshold_us;
-    float m_TDOALength_s = 10;
+    float m_TDOALength_s = 10;                   ///< Length of each synchronised window
+    float m_TDOAHop_s = 10;                      ///< Time between the starts of consecutive windows
     std::chrono::steady_clock::time_point m_tpLastSyncAttempt;                  ///< Time stamp of last synchronisation
+    bool m_bSourcesAligned = false;                                             ///< False until every buffered source has been aligned once
 
-    // TimeChunks
-    std::map<std::vector<uint8_t>, uint64_t> m_OldestSourceTimestampMap;        ///< Time stamps from the oldest chunk received from each source   
-    std::map<std::vector<uint8_t>, uint64_t> m_MostRecentSourceTimestamp;       ///< Time stamps from the most recent chunk received from each source 
-    std::map<std::vector<uint8_t>, std::vector<std::vector<int16_t>>> m_TimeDataSourceMap;   ///< Map whioch stores each sources current time data
+    // TimeChunks, all per source state is keyed on the index interned in the SourceIdentifierRegistry
+    DenseIndexMap<uint64_t> m_OldestSourceTimestampMap;                         ///< Time stamps from the oldest chunk received from each source   
+    DenseIndexMap<double> m_mOldestTimestampRemainders_us;                      ///< Part of a microsecond each oldest time stamp is behind the samples dropped
+    DenseIndexMap<uint64_t> m_MostRecentSourceTimestamp;                        ///< Time stamps from the most recent chunk received from each source 
+    DenseIndexMap<std::vector<RingBuffer<int16_t>>> m_TimeDataSourceMap;        ///< Map which stores a fixed capacity buffer of each channel of each source
+    SourceIndexCache m_SourceIndexCache;                                        ///< Index of the last source seen
     std::atomic<std::uint16_t> m_u16NumTimeSources;                             ///< 
     std::atomic<std::uint16_t> m_u16SecondsSinceLastSync;
 
+    // Memory and recovery
+    size_t m_uMaxBytesPerSource = 0;                                            ///< Cap on buffered bytes per source, 0 when uncapped
+    uint64_t m_u64StalledSourceTimeout_us = 0;                                  ///< Lag after which a source is restarted, 0 when disabled
+    std::atomic<uint64_t> m_u64BufferedBytes = 0;                               ///< Bytes of samples buffered across all sources
+    std::atomic<uint64_t> m_u64EvictedSamples = 0;                              ///< Samples dropped from full buffers
+    std::atomic<uint64_t> m_u64SourceResets = 0;                                ///< Single source restarts
+    std::vector<uint32_t> m_vu32StalledSources;                                 ///< Sources found stalled while checking
+
+    // Fractional delay
+    unsigned m_uFractionalDelayTaps = 0;                                        ///< Interpolator length, 0 when disabled
+    std::vector<std::vector<float>> m_vvfFractionalDelayTable;                  ///< Interpolator taps of each tabulated fraction
+    DenseIndexMap<double> m_mFractionalDelays;                                  ///< Samples each source still starts early by after alignment
+    std::vector<float> m_vfFractionalDelayInput;                                ///< Float copy of the samples being interpolated
+    std::vector<float> m_vfFractionalDelayOutput;                               ///< Interpolated window
+
+    /**
+     * @brief Samples of one channel already packaged into blocks which overlapping windows share
+     */
+    struct WindowBlockCache
+    {
+        std::deque<TDOASampleBlock> dqBlocks; ///< Runs covering the channel buffer from its oldest sample onwards
+        size_t uCachedSamples = 0;            ///< Samples from the oldest sample covered by the runs
+    };
+
+    // Windows
+    DenseIndexMap<std::vector<WindowBlockCache>> m_mWindowBlockCaches;          ///< Packaged samples of each channel of each source
+
+    /**
+     * @brief Sample clock of one source and the resampler bringing it onto nominal sample times
+     */
+    struct DriftState
+    {
+        std::deque<std::pair<uint64_t, uint64_t>> dqSampleCountTimeStamps; ///< Samples received before and timestamp of recent chunks
+        uint64_t u64FirstTimeStamp_us = 0;            ///< Timestamp of the first sample, where the nominal grid starts
+        uint64_t u64InputSamples = 0;                 ///< Samples received per channel
+        uint64_t u64OutputSamples = 0;                ///< Samples stored per channel
+        double dSamplePeriod_us = 0;                  ///< Fitted period of the source's sample clock
+        std::vector<int16_t> vi16PreviousSamples;     ///< Last sample of each channel, interpolated towards the next chunk
+    };
+
+    // Drift
+    unsigned m_uDriftRegressionChunks = 0;                                      ///< Chunks the clock is fitted over, 0 when disabled
+    double m_dMaxDrift_ppm = 0;                                                 ///< Largest clock error believed
+    DenseIndexMap<DriftState> m_mDriftStates;                                   ///< Clock estimate of each source
+    std::vector<std::vector<int16_t>> m_vvi16ResampledScratch;                  ///< Resampled channels of the chunk being stored
+    std::vector<size_t> m_vuResampleIndices;                                    ///< Sample before each output, counted from the previous chunk's last sample
+    std::vector<float> m_vfResampleWeightsBefore;                               ///< Weight of the sample before each output
+    std::vector<float> m_vfResampleWeightsAfter;                                ///< Weight of the sample after each output
+    std::vector<float> m_vfResampleInput;                                       ///< Float copy of a channel behind its previous sample
+    std::vector<float> m_vfResampleBefore;                                      ///< Samples before each output, weighted and summed in place
+    std::vector<float> m_vfResampleAfter;                                       ///< Samples after each output
+
     // GPSChunk
-    std::map<std::vector<uint8_t>, double> m_dSourceLongitudesMap;               ///< 
-    std::map<std::vector<uint8_t>, double> m_dSourceLatitudesMap;                ///<
+    DenseIndexMap<double> m_dSourceLongitudesMap;                                ///< 
+    DenseIndexMap<double> m_dSourceLatitudesMap;                                 ///<
     std::atomic<std::uint16_t> m_u16NumGPSSources;                               ///< 
 
     /**
@@ -109,20 +231,28 @@ private:
 
     /**
      * @brief Check if the new timestamp is continuous with the previous one
-     * @param sourceId The identifier of the data source
+     * @param u32SourceIndex The interned index of the data source
      * @param i64NewTimestamp The new timestamp to check
      * @param uNumSamples The number of samples between the last timestamp and the new one
      * @param dSampleRate_hz The sample rate of the data source
      * @return True if the timestamp is continuous, false otherwise
      */
-    bool IsDataContinuous(const std::vector<uint8_t>& sourceId, int64_t i64NewTimestamp, size_t uNumSamples, double dSampleRate_hz);
+    bool IsDataContinuous(uint32_t u32SourceIndex, int64_t i64NewTimestamp, size_t uNumSamples, double dSampleRate_hz);
 
 
     /**
-     * @brief Creates a new TimeChunk with synchronized data from all sources
-     * @return A shared pointer to the new synchronized TimeChunk, or nullptr if no data is available
+     * @brief Creates a new window with synchronized data from all sources and advances the buffers by one hop
+     * @return A shared pointer to the new synchronized window, or nullptr if no data is available
+     * @note Each window only copies the samples since the previous one, the overlap references its blocks
      */
-    std::shared_ptr<TDOAChunk> CreateSynchronizedTimeChunk();
+    std::shared_ptr<TDOAWindowChunk> CreateSynchronizedTimeChunk();
+
+    /**
+     * @brief Drops samples from the front of a source's packaged blocks as they are dropped from its buffers
+     * @param u32SourceIndex Interned index of the source
+     * @param uNumSamples Samples dropped per channel
+     */
+    void DropWindowBlocks(uint32_t u32SourceIndex, size_t uNumSamples);
     
     /**
      * @brief Checks if any of the channels has not received data for a specified amount of time
@@ -131,9 +261,71 @@ private:
 
     /**
      * @brief Stores time data in an internal map\
+     * @param[in] u32SourceIndex interned index of the chunk's source
      * @param[in] pTimeChunk pointer to time chunk of data
      */
-    void StoreData(std::shared_ptr<TimeChunk> pTimeChunk);
+    void StoreData(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk);
+
+    /**
+     * @brief Checking if data from a source has the same number of channels, for a source already interned
+     */
+    bool IsChannelCountTheSame(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk);
+
+    /**
+     * @brief Store initial timestamps and initialise channel counts, for a source already interned
+     */
+    void TryInitialiseDataSource(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk);
+
+    /**
+     * @brief Moves a source's oldest timestamp past samples dropped from the front of its buffers
+     * @param u32SourceIndex Interned index of the source
+     * @param uNumSamples Samples dropped per channel
+     * @note Fractions of a microsecond are carried to the next advance so repeated hops do not drift
+     */
+    void AdvanceOldestTimestamp(uint32_t u32SourceIndex, size_t uNumSamples);
+
+    /**
+     * @brief Discards the buffers, timestamps and clock state of one source while keeping its position
+     * @param u32SourceIndex Interned index of the source to reset
+     */
+    void ResetSource(uint32_t u32SourceIndex);
+
+    /**
+     * @brief Resets sources whose most recent data lags the newest by more than the stall timeout
+     * @param u64NewestTimeStamp_us Timestamp of the chunk just stored
+     */
+    void EvictStalledSources(uint64_t u64NewestTimeStamp_us);
+
+    /**
+     * @brief Recounts the bytes buffered across all sources for reporting
+     */
+    void UpdateBufferedBytes();
+
+    /**
+     * @brief Returns the number of samples each channel buffer is allocated to hold
+     * @param dSampleRate_hz Sample rate of the source
+     * @param uChunkLength Number of samples per channel in each chunk from the source
+     * @return Room for a TDOA window, the alignment offset between sources and one chunk still to be aligned
+     */
+    size_t GetChannelBufferCapacity(double dSampleRate_hz, size_t uChunkLength) const;
+
+    /**
+     * @brief Updates a source's clock fit and linearly interpolates a chunk onto the nominal sample times
+     * @param u32SourceIndex Interned index of the chunk's source
+     * @param pTimeChunk Chunk to resample
+     * @param vvi16Resampled Receives the resampled channels, which may be a sample shorter or longer than the chunk
+     */
+    void ResampleOntoTimebase(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk, std::vector<std::vector<int16_t>>& vvi16Resampled);
+
+    /**
+     * @brief Reads part of a window of one channel, interpolated forward by a source's sub sample offset
+     * @param ChannelBuffer Samples of the channel, holding at least the samples read plus the interpolator length
+     * @param dFraction Sub sample offset between 0 and 1
+     * @param uOffset Position in the window of the first sample read
+     * @param uNumSamples Number of samples read
+     * @param pi16Output Receives the samples
+     */
+    void ReadFractionallyDelayedWindow(const RingBuffer<int16_t>& ChannelBuffer, double dFraction, size_t uOffset, size_t uNumSamples, int16_t* pi16Output);
 
     /**
      * @brief send reporting json messaages
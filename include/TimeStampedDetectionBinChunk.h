@@ -0,0 +1,27 @@
+#ifndef TIME_STAMPED_DETECTION_BIN_CHUNK
+#define TIME_STAMPED_DETECTION_BIN_CHUNK
+
+/*Standard Includes*/
+#include <cstdint>
+
+/* Custom Includes */
+#include "DetectionBinChunk.h"
+
+/**
+ * @brief Detection bins which also carry the timestamp of the spectrum they were detected in
+ * @note Remains a DetectionBinChunk so existing routing and serialisation are unchanged. The timestamp is
+ *       therefore only kept in process, a DetectionBinChunk deserialised after a network hop arrives without it.
+ */
+class TimeStampedDetectionBinChunk : public DetectionBinChunk
+{
+public:
+    /**
+     * @brief Construct a new TimeStampedDetectionBinChunk object
+     * @param i64TimeStamp Timestamp (us) of the spectrum the bins were detected in
+     */
+    TimeStampedDetectionBinChunk(uint64_t i64TimeStamp) : m_i64TimeStamp(i64TimeStamp) {}
+
+    uint64_t m_i64TimeStamp; ///< Timestamp (us) of the spectrum the bins were detected in
+};
+
+#endif
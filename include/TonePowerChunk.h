@@ -0,0 +1,72 @@
+#ifndef TONE_POWER_CHUNK
+#define TONE_POWER_CHUNK
+
+/*Standard Includes*/
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/* Custom Includes */
+#include "BaseChunk.h"
+
+/**
+ * @brief Power of a set of monitored tones over consecutive blocks of samples
+ * @note Requires the TonePowerChunk entry in the shared ChunkType enumeration
+ */
+class TonePowerChunk : public BaseChunk
+{
+public:
+    /**
+     * @brief Construct a new TonePowerChunk object
+     * @param dSampleRate Sample rate of the time data the powers were computed from
+     * @param i64TimeStamp Timestamp (us) of the first sample of the first block
+     * @param uNumChannels Number of channels
+     * @param uNumBlocks Number of blocks per channel
+     * @param uBlockLength Number of time samples in each block
+     * @param vfFrequencies_Hz Frequencies of the monitored tones
+     */
+    TonePowerChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumChannels, unsigned uNumBlocks, unsigned uBlockLength, const std::vector<float>& vfFrequencies_Hz);
+    ~TonePowerChunk() {};
+
+    /**
+     * @brief Returns chunk type
+     */
+    ChunkType GetChunkType() override { return ChunkType::TonePowerChunk; };
+
+    /**
+     * @brief Returns size of the serialised chunk in bytes
+     */
+    unsigned GetSize() override;
+
+    /**
+     * @brief Converts the chunk into a byte array
+     */
+    std::shared_ptr<std::vector<char>> Serialise() override;
+
+    /**
+     * @brief Populates the chunk from a byte array created by Serialise
+     */
+    void Deserialise(std::shared_ptr<std::vector<char>> pvBytes) override;
+
+    /**
+     * @brief Returns a pointer to the powers of every tone for one block of one channel
+     */
+    float* GetBlock(unsigned uChannelIndex, unsigned uBlockIndex) { return &m_vfPowers[((size_t)uChannelIndex * m_uNumBlocks + uBlockIndex) * m_vfFrequencies_Hz.size()]; }
+
+    double m_dSampleRate;                 ///< Sample rate of the underlying time data
+    uint64_t m_i64TimeStamp;              ///< Timestamp (us) of the first sample of the first block
+    unsigned m_uNumChannels;              ///< Number of channels
+    unsigned m_uNumBlocks;                ///< Number of blocks per channel
+    unsigned m_uBlockLength;              ///< Time samples per block
+    std::vector<float> m_vfFrequencies_Hz; ///< Frequency of each monitored tone
+    std::vector<float> m_vfPowers;        ///< Channel major matrix of blocks x tones power, a tone of amplitude A reads A^2
+
+private:
+    /**
+     * @brief Returns size of the members of this class in bytes
+     */
+    unsigned GetInternalSize();
+};
+
+#endif
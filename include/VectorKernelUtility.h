@@ -0,0 +1,162 @@
+#ifndef VECTOR_KERNEL_UTILITY
+#define VECTOR_KERNEL_UTILITY
+
+/*Standard Includes*/
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Vectorised kernels for the sample and bin loops of the processing modules
+ * @note Each kernel has AVX2, SSE2 and scalar variants. The widest variant the CPU
+ *       supports is selected at runtime so one binary runs on any x86 (or other) machine.
+ */
+class VectorKernelUtility
+{
+public:
+    /**
+     * @brief Variants a kernel can be executed with
+     */
+    enum class InstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @brief Returns the widest instruction set supported by the running CPU
+     */
+    static InstructionSet GetSupportedInstructionSet();
+
+    /**
+     * @brief Returns the instruction set kernels are currently executed with
+     */
+    static InstructionSet GetInstructionSet() { return s_ActiveInstructionSet; }
+
+    /**
+     * @brief Forces kernels to run with the given instruction set, used when testing and benchmarking
+     * @param InstructionSetToUse Instruction set to use, throws if the CPU does not support it
+     */
+    static void SetInstructionSet(InstructionSet InstructionSetToUse);
+
+    /**
+     * @brief Returns a printable name of an instruction set
+     */
+    static std::string GetInstructionSetName(InstructionSet InstructionSetToName);
+
+    /**
+     * @brief Converts 16 bit samples to floats
+     * @param pi16Input Samples to convert
+     * @param pfOutput Output holding at least uLength values
+     * @param uLength Number of samples
+     */
+    static void ConvertInt16ToFloat(const int16_t* pi16Input, float* pfOutput, size_t uLength);
+
+    /**
+     * @brief Rounds floats to the nearest 16 bit sample, saturating values out of range
+     * @param pfInput Values to convert
+     * @param pi16Output Output holding at least uLength samples
+     * @param uLength Number of values
+     */
+    static void ConvertFloatToInt16(const float* pfInput, int16_t* pi16Output, size_t uLength);
+
+    /**
+     * @brief Multiplies every value by a gain in place
+     * @param pfData Values to scale, complex data can be passed as 2x as many floats
+     * @param uLength Number of floats
+     * @param fGain Gain to apply
+     */
+    static void Scale(float* pfData, size_t uLength, float fGain);
+
+    /**
+     * @brief Element wise product of two vectors, output may alias either input
+     * @param pfFirst First input
+     * @param pfSecond Second input
+     * @param pfOutput Output holding at least uLength values
+     * @param uLength Number of values
+     */
+    static void Multiply(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength);
+
+    /**
+     * @brief Squares values and returns their sum in the same pass
+     * @param pfInput Values to square, such as bin magnitudes
+     * @param pfOutput Output holding at least uLength values, may alias the input
+     * @param uLength Number of values
+     * @return Sum of the squared values
+     */
+    static float SquareAndSum(const float* pfInput, float* pfOutput, size_t uLength);
+
+    /**
+     * @brief Finds the indices of values strictly greater than a threshold
+     * @param pfInput Values to compare
+     * @param uLength Number of values
+     * @param fThreshold Threshold to compare against
+     * @param puIndices Output holding at least uLength indices
+     * @return Number of indices written, in ascending order
+     */
+    static size_t FindIndicesAbove(const float* pfInput, size_t uLength, float fThreshold, uint32_t* puIndices);
+
+    /**
+     * @brief Finds the indices of values strictly greater than a per index reference times a ratio
+     * @param pfInput Values to compare
+     * @param pfReference Reference of each value, such as a tracked noise floor
+     * @param fRatio Ratio applied to the reference
+     * @param uLength Number of values
+     * @param puIndices Output holding at least uLength indices
+     * @return Number of indices written, in ascending order
+     */
+    static size_t FindIndicesAboveReference(const float* pfInput, const float* pfReference, float fRatio, size_t uLength, uint32_t* puIndices);
+
+    /**
+     * @brief Adds a scaled vector to an accumulator (axpy)
+     * @param pfInput Values to scale and add
+     * @param fGain Gain applied to the input
+     * @param pfAccumulator Accumulator holding at least uLength values
+     * @param uLength Number of values
+     */
+    static void MultiplyAccumulate(const float* pfInput, float fGain, float* pfAccumulator, size_t uLength);
+
+    /**
+     * @brief Calculates the sum of the products of two vectors
+     * @param pfFirst First values
+     * @param pfSecond Second values
+     * @param uLength Number of values
+     * @return Dot product, summed in the same order by every variant
+     */
+    static float DotProduct(const float* pfFirst, const float* pfSecond, size_t uLength);
+
+    /**
+     * @brief Calculates the magnitude of complex values
+     * @param pcfInput Complex values
+     * @param pfOutput Output holding at least uLength values
+     * @param uLength Number of complex values
+     */
+    static void ComplexMagnitude(const std::complex<float>* pcfInput, float* pfOutput, size_t uLength);
+
+    /**
+     * @brief Calculates the phase of one complex vector relative to another, arg(first x conj(second))
+     * @param pcfFirst First complex values
+     * @param pcfSecond Second complex values
+     * @param pfOutput Output holding at least uLength phases in [-pi, pi]
+     * @param uLength Number of complex values
+     * @note Polynomial approximation of atan2 with an absolute error below 1e-5 rad, zero when either value is zero
+     */
+    static void PhaseDifference(const std::complex<float>* pcfFirst, const std::complex<float>* pcfSecond, float* pfOutput, size_t uLength);
+
+    /**
+     * @brief Calculates the arc sine of values, which are clamped to [-1, 1]
+     * @param pfInput Values to convert
+     * @param pfOutput Output holding at least uLength angles in radians
+     * @param uLength Number of values
+     * @note Polynomial approximation with an absolute error below 1e-5 rad
+     */
+    static void ArcSine(const float* pfInput, float* pfOutput, size_t uLength);
+
+private:
+    static std::atomic<InstructionSet> s_ActiveInstructionSet; ///< Instruction set kernels dispatch to
+};
+
+#endif
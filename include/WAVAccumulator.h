@@ -2,6 +2,8 @@
 #define WAV_ACCUMULATOR
 
 #include "BaseModule.h"
+#include "DenseIndexMap.h"
+#include "SourceIdentifierRegistry.h"
 #include "WAVChunk.h"
 
 /**
@@ -31,10 +33,11 @@ private:
   unsigned m_dAccumulatePeriod;     ///< Maximum number of seconds with which a
                                     ///< module will make a recording
                                     ///< signal considered discontinuous
-  std::map<std::vector<uint8_t>, std::shared_ptr<BaseChunk>>
+  DenseIndexMap<std::shared_ptr<BaseChunk>>
       m_mAccumulatedWAVChunks; ///< Map of accumulated WAV chunks as a function
-                               ///< of string mac addr
-  std::map<std::vector<uint8_t>, uint64_t> m_i64PreviousTimeStamps; ///<
+                               ///< of interned source index
+  DenseIndexMap<uint64_t> m_i64PreviousTimeStamps; ///<
+  SourceIndexCache m_SourceIndexCache; ///< Index of the last source seen
 
   /*
    * @brief Module process to accumulate WAV chunks
@@ -53,10 +56,12 @@ private:
   /*
    * @brief Verifies that current chunk is continuous with currently accumulated
    * data
+   * @param[in] u32SourceIndex Interned index of the chunk's source
    * @param[in] pCurrentWAVChunk Pointer to current time chunk
    * @param[in] pAccumulatedWAVChunk  Pointer to accumulated time chunk
    */
-  bool VerifyTimeContinuity(std::shared_ptr<WAVChunk> pCurrentWAVChunk,
+  bool VerifyTimeContinuity(uint32_t u32SourceIndex,
+                            std::shared_ptr<WAVChunk> pCurrentWAVChunk,
                             std::shared_ptr<WAVChunk> pAccumulatedWAVChunk);
 
   /*
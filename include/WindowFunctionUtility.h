@@ -0,0 +1,47 @@
+#ifndef WINDOW_FUNCTION_UTILITY
+#define WINDOW_FUNCTION_UTILITY
+
+/*Standard Includes*/
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generates tapering windows used for spectral analysis and filter design
+ */
+class WindowFunctionUtility
+{
+public:
+    /**
+     * @brief Generates a periodic window suitable for overlapping FFT frames
+     * @param strWindowType One of "Rectangular", "Hann" or "Blackman"
+     * @param uLength Number of window coefficients
+     * @return Vector of window coefficients
+     */
+    static std::vector<float> GenerateWindow(const std::string& strWindowType, unsigned uLength);
+
+    /**
+     * @brief Calculates the coherent gain (mean coefficient) of a window
+     * @param vfWindow Window coefficients
+     * @return Amplitude gain the window applies to a bin centred tone
+     */
+    static float CalculateCoherentGain(const std::vector<float>& vfWindow);
+
+    /**
+     * @brief Designs a linear phase low pass FIR filter using the windowed sinc method
+     * @param uNumTaps Number of filter taps
+     * @param fCutoff Cutoff frequency in cycles per sample, between 0 and 0.5
+     * @param strWindowType One of "Rectangular", "Hann" or "Blackman"
+     * @return Filter taps normalised to unity gain at DC
+     */
+    static std::vector<float> DesignLowPassFIR(unsigned uNumTaps, float fCutoff, const std::string& strWindowType);
+
+    /**
+     * @brief Designs a Blackman windowed sinc interpolator which reads between two samples
+     * @param uNumTaps Number of filter taps (must be even)
+     * @param fFraction Position between tap uNumTaps/2 - 1 and the next one, between 0 and 1
+     * @return Filter taps normalised to unity gain at DC, a unit impulse when the fraction is 0 or 1
+     */
+    static std::vector<float> DesignFractionalDelayFIR(unsigned uNumTaps, float fFraction);
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef WORKER_POOL
+#define WORKER_POOL
+
+/*Standard Includes*/
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed number of worker threads which execute submitted tasks in submission order
+ * @note Tasks are told which worker runs them so per worker state (such as FFT plans) can be indexed without locking
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief Construct a new WorkerPool object and start its threads
+     * @param uNumWorkers Number of worker threads, at least one is created
+     */
+    WorkerPool(unsigned uNumWorkers);
+
+    /**
+     * @brief Completes all queued tasks and joins the worker threads
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Queues a task for execution on the next free worker
+     * @param Task Callable given the index of the worker executing it
+     */
+    void Submit(std::function<void(unsigned uWorkerIndex)> Task);
+
+    /**
+     * @brief Returns the number of worker threads
+     */
+    unsigned GetWorkerCount() const { return m_vWorkerThreads.size(); }
+
+private:
+    std::vector<std::thread> m_vWorkerThreads;                     ///< Threads executing tasks
+    std::deque<std::function<void(unsigned)>> m_dqTasks;            ///< Tasks waiting for a worker
+    std::mutex m_TaskMutex;                                         ///< Guards the task queue and shut down flag
+    std::condition_variable m_cvTaskAvailable;                      ///< Signalled when tasks are queued or on shut down
+    bool m_bShutDown = false;                                       ///< Whether workers should exit once the queue is empty
+
+    /**
+     * @brief Loop run by each worker thread
+     * @param uWorkerIndex Index of the worker running the loop
+     */
+    void RunWorker(unsigned uWorkerIndex);
+};
+
+#endif
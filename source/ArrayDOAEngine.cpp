@@ -0,0 +1,302 @@
+#include "ArrayDOAEngine.h"
+
+ArrayDOAEngine::ArrayDOAEngine(const std::vector<std::vector<double>>& vvdElementPositions_m, double dPropagationVelocity_mps, const std::string& strMethod,
+                               double dMinAngle_deg, double dMaxAngle_deg, unsigned uNumAngles, unsigned uNumSources, float fDiagonalLoading) :
+    m_vvdElementPositions_m(vvdElementPositions_m),
+    m_dPropagationVelocity_mps(dPropagationVelocity_mps),
+    m_Method(DOAMethod::Bartlett),
+    m_dMinAngle_deg(dMinAngle_deg),
+    m_dAngleStep_deg(uNumAngles > 1 ? (dMaxAngle_deg - dMinAngle_deg) / (uNumAngles - 1) : 0),
+    m_uNumAngles(uNumAngles),
+    m_uNumSources(uNumSources),
+    m_fDiagonalLoading(fDiagonalLoading)
+{
+    if (m_vvdElementPositions_m.size() < 2)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": At least two elements are required");
+    for (const auto& vdPosition : m_vvdElementPositions_m)
+        if (vdPosition.size() != 2)
+            throw std::runtime_error(std::string(__FUNCTION__) + ": Element positions must be x and y pairs");
+    if (uNumAngles == 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": At least one scan angle is required");
+
+    if (strMethod == "Bartlett")
+        m_Method = DOAMethod::Bartlett;
+    else if (strMethod == "MVDR")
+        m_Method = DOAMethod::MVDR;
+    else if (strMethod == "MUSIC")
+        m_Method = DOAMethod::MUSIC;
+    else
+        throw std::runtime_error(std::string(__FUNCTION__) + ": " + strMethod + " must be one of Bartlett, MVDR or MUSIC");
+
+    if (m_Method == DOAMethod::MUSIC && (uNumSources == 0 || uNumSources >= m_vvdElementPositions_m.size()))
+        throw std::runtime_error(std::string(__FUNCTION__) + ": MUSIC requires between one source and one fewer than the number of elements");
+}
+
+void ArrayDOAEngine::Accumulate(const std::vector<std::vector<std::complex<float>>>& vvcfFFTChunks, CrossSpectra& Spectra)
+{
+    unsigned uNumElements = GetNumElements();
+    if (vvcfFFTChunks.size() != uNumElements)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Expected " + std::to_string(uNumElements) + " channels but received " + std::to_string(vvcfFFTChunks.size()));
+
+    unsigned uNumBins = vvcfFFTChunks[0].size();
+    if (Spectra.uNumBins != uNumBins || Spectra.vcfMatrices.size() != (size_t)uNumBins * uNumElements * uNumElements)
+    {
+        Spectra.uNumBins = uNumBins;
+        Spectra.uNumSnapshots = 0;
+        Spectra.vcfMatrices.assign((size_t)uNumBins * uNumElements * uNumElements, 0);
+    }
+
+    // Bin major so each matrix is written contiguously
+    std::complex<float>* pcfMatrix = Spectra.vcfMatrices.data();
+    for (unsigned uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+    {
+        for (unsigned uRow = 0; uRow < uNumElements; uRow++)
+        {
+            std::complex<float> cfRow = vvcfFFTChunks[uRow][uBinIndex];
+            for (unsigned uColumn = 0; uColumn < uNumElements; uColumn++)
+                pcfMatrix[uRow * uNumElements + uColumn] += cfRow * std::conj(vvcfFFTChunks[uColumn][uBinIndex]);
+        }
+        pcfMatrix += uNumElements * uNumElements;
+    }
+
+    Spectra.uNumSnapshots++;
+}
+
+void ArrayDOAEngine::ScanBins(const CrossSpectra& Spectra, const std::vector<uint16_t>& vu16Bins, double dBinWidth_Hz, std::vector<float>& vfAngleSpectra)
+{
+    unsigned uNumElements = GetNumElements();
+    vfAngleSpectra.resize(vu16Bins.size() * m_uNumAngles);
+
+    for (size_t uDetectionIndex = 0; uDetectionIndex < vu16Bins.size(); uDetectionIndex++)
+    {
+        uint16_t u16Bin = vu16Bins[uDetectionIndex];
+        if (u16Bin >= Spectra.uNumBins || Spectra.uNumSnapshots == 0)
+            throw std::runtime_error(std::string(__FUNCTION__) + ": No cross spectra accumulated for bin " + std::to_string(u16Bin));
+
+        PrepareQuadraticForm(Spectra.vcfMatrices.data() + (size_t)u16Bin * uNumElements * uNumElements, Spectra.uNumSnapshots);
+        const auto& vcfSteering = GetSteeringVectors(Spectra.uNumBins, dBinWidth_Hz, u16Bin);
+
+        // Every method is a quadratic form a^H Q a of the steering vector, so the scan is one batched loop
+        float* pfSpectrum = vfAngleSpectra.data() + uDetectionIndex * m_uNumAngles;
+        for (unsigned uAngleIndex = 0; uAngleIndex < m_uNumAngles; uAngleIndex++)
+        {
+            const std::complex<float>* pcfSteering = vcfSteering.data() + uAngleIndex * uNumElements;
+            double dQuadraticForm = 0;
+            for (unsigned uRow = 0; uRow < uNumElements; uRow++)
+            {
+                std::complex<double> cdProduct = 0;
+                for (unsigned uColumn = 0; uColumn < uNumElements; uColumn++)
+                    cdProduct += m_vcdQuadraticForm[uRow * uNumElements + uColumn] * std::complex<double>(pcfSteering[uColumn]);
+                dQuadraticForm += std::real(std::conj(std::complex<double>(pcfSteering[uRow])) * cdProduct);
+            }
+
+            if (m_Method == DOAMethod::Bartlett)
+                pfSpectrum[uAngleIndex] = dQuadraticForm / uNumElements;
+            else
+                pfSpectrum[uAngleIndex] = 1.0 / std::max(dQuadraticForm, 1e-30);
+        }
+    }
+}
+
+const std::vector<std::complex<float>>& ArrayDOAEngine::GetSteeringVectors(unsigned uNumBins, double dBinWidth_Hz, uint16_t u16Bin)
+{
+    auto& Table = m_mSteeringTables[std::make_pair(uNumBins, dBinWidth_Hz)];
+    if (Table.vvcfBinSteering.size() != uNumBins)
+        Table.vvcfBinSteering.resize(uNumBins);
+
+    auto& vcfSteering = Table.vvcfBinSteering[u16Bin];
+    if (!vcfSteering.empty())
+        return vcfSteering;
+
+    // Element m of a plane wave from angle theta lags by its projection onto the arrival direction
+    unsigned uNumElements = GetNumElements();
+    double dWaveNumber = 2 * M_PI * u16Bin * dBinWidth_Hz / m_dPropagationVelocity_mps;
+    vcfSteering.resize((size_t)m_uNumAngles * uNumElements);
+    for (unsigned uAngleIndex = 0; uAngleIndex < m_uNumAngles; uAngleIndex++)
+    {
+        double dAngle_rad = GetAngle_deg(uAngleIndex) * M_PI / 180;
+        double dDirectionX = std::sin(dAngle_rad);
+        double dDirectionY = std::cos(dAngle_rad);
+        for (unsigned uElementIndex = 0; uElementIndex < uNumElements; uElementIndex++)
+        {
+            double dPathLength_m = m_vvdElementPositions_m[uElementIndex][0] * dDirectionX + m_vvdElementPositions_m[uElementIndex][1] * dDirectionY;
+            vcfSteering[uAngleIndex * uNumElements + uElementIndex] = std::polar(1.0, -dWaveNumber * dPathLength_m);
+        }
+    }
+
+    m_u64SteeringVectorCount++;
+    return vcfSteering;
+}
+
+void ArrayDOAEngine::PrepareQuadraticForm(const std::complex<float>* pcfMatrix, unsigned uNumSnapshots)
+{
+    unsigned uNumElements = GetNumElements();
+    m_vcdQuadraticForm.resize(uNumElements * uNumElements);
+    for (unsigned uIndex = 0; uIndex < uNumElements * uNumElements; uIndex++)
+        m_vcdQuadraticForm[uIndex] = std::complex<double>(pcfMatrix[uIndex]) / (double)uNumSnapshots;
+
+    if (m_Method == DOAMethod::MVDR)
+    {
+        // Loading keeps the inverse stable when there are fewer snapshots than elements
+        double dTrace = 0;
+        for (unsigned uIndex = 0; uIndex < uNumElements; uIndex++)
+            dTrace += std::real(m_vcdQuadraticForm[uIndex * uNumElements + uIndex]);
+        double dLoading = std::max(m_fDiagonalLoading * dTrace / uNumElements, 1e-12);
+        for (unsigned uIndex = 0; uIndex < uNumElements; uIndex++)
+            m_vcdQuadraticForm[uIndex * uNumElements + uIndex] += dLoading;
+
+        InvertQuadraticForm();
+    }
+    else if (m_Method == DOAMethod::MUSIC)
+        ProjectOntoNoiseSubspace();
+}
+
+void ArrayDOAEngine::InvertQuadraticForm()
+{
+    unsigned uNumElements = GetNumElements();
+    unsigned uWidth = 2 * uNumElements;
+
+    // Augment with the identity, reduce the left half to the identity and the right half becomes the inverse
+    m_vcdWorkspace.assign(uNumElements * uWidth, 0);
+    for (unsigned uRow = 0; uRow < uNumElements; uRow++)
+    {
+        for (unsigned uColumn = 0; uColumn < uNumElements; uColumn++)
+            m_vcdWorkspace[uRow * uWidth + uColumn] = m_vcdQuadraticForm[uRow * uNumElements + uColumn];
+        m_vcdWorkspace[uRow * uWidth + uNumElements + uRow] = 1;
+    }
+
+    for (unsigned uPivot = 0; uPivot < uNumElements; uPivot++)
+    {
+        unsigned uBestRow = uPivot;
+        for (unsigned uRow = uPivot + 1; uRow < uNumElements; uRow++)
+            if (std::abs(m_vcdWorkspace[uRow * uWidth + uPivot]) > std::abs(m_vcdWorkspace[uBestRow * uWidth + uPivot]))
+                uBestRow = uRow;
+        if (uBestRow != uPivot)
+            std::swap_ranges(m_vcdWorkspace.begin() + uPivot * uWidth, m_vcdWorkspace.begin() + (uPivot + 1) * uWidth, m_vcdWorkspace.begin() + uBestRow * uWidth);
+
+        std::complex<double> cdPivot = m_vcdWorkspace[uPivot * uWidth + uPivot];
+        if (std::abs(cdPivot) == 0)
+            throw std::runtime_error(std::string(__FUNCTION__) + ": Cross spectral matrix is singular");
+        for (unsigned uColumn = 0; uColumn < uWidth; uColumn++)
+            m_vcdWorkspace[uPivot * uWidth + uColumn] /= cdPivot;
+
+        for (unsigned uRow = 0; uRow < uNumElements; uRow++)
+        {
+            std::complex<double> cdFactor = m_vcdWorkspace[uRow * uWidth + uPivot];
+            if (uRow == uPivot || cdFactor == 0.0)
+                continue;
+            for (unsigned uColumn = 0; uColumn < uWidth; uColumn++)
+                m_vcdWorkspace[uRow * uWidth + uColumn] -= cdFactor * m_vcdWorkspace[uPivot * uWidth + uColumn];
+        }
+    }
+
+    for (unsigned uRow = 0; uRow < uNumElements; uRow++)
+        for (unsigned uColumn = 0; uColumn < uNumElements; uColumn++)
+            m_vcdQuadraticForm[uRow * uNumElements + uColumn] = m_vcdWorkspace[uRow * uWidth + uNumElements + uColumn];
+}
+
+void ArrayDOAEngine::ProjectOntoNoiseSubspace()
+{
+    // A Hermitian A + iB has the eigenvalues of the real symmetric [A -B; B A], each twice over,
+    // which lets the well behaved cyclic Jacobi method be used
+    unsigned uNumElements = GetNumElements();
+    unsigned uSize = 2 * uNumElements;
+    auto& vdMatrix = m_vdRealSymmetric;
+    auto& vdVectors = m_vdEigenvectors;
+    vdMatrix.assign(uSize * uSize, 0);
+    vdVectors.assign(uSize * uSize, 0);
+    for (unsigned uRow = 0; uRow < uNumElements; uRow++)
+    {
+        for (unsigned uColumn = 0; uColumn < uNumElements; uColumn++)
+        {
+            double dReal = std::real(m_vcdQuadraticForm[uRow * uNumElements + uColumn]);
+            double dImag = std::imag(m_vcdQuadraticForm[uRow * uNumElements + uColumn]);
+            vdMatrix[uRow * uSize + uColumn] = dReal;
+            vdMatrix[(uRow + uNumElements) * uSize + uColumn + uNumElements] = dReal;
+            vdMatrix[uRow * uSize + uColumn + uNumElements] = -dImag;
+            vdMatrix[(uRow + uNumElements) * uSize + uColumn] = dImag;
+        }
+    }
+    for (unsigned uIndex = 0; uIndex < uSize; uIndex++)
+        vdVectors[uIndex * uSize + uIndex] = 1;
+
+    double dNorm = 0;
+    for (double dValue : vdMatrix)
+        dNorm += dValue * dValue;
+
+    for (unsigned uSweep = 0; uSweep < 50; uSweep++)
+    {
+        double dOffDiagonal = 0;
+        for (unsigned uRow = 0; uRow < uSize; uRow++)
+            for (unsigned uColumn = uRow + 1; uColumn < uSize; uColumn++)
+                dOffDiagonal += vdMatrix[uRow * uSize + uColumn] * vdMatrix[uRow * uSize + uColumn];
+        if (dOffDiagonal <= 1e-24 * dNorm)
+            break;
+
+        for (unsigned uP = 0; uP < uSize; uP++)
+        {
+            for (unsigned uQ = uP + 1; uQ < uSize; uQ++)
+            {
+                double dApq = vdMatrix[uP * uSize + uQ];
+                if (std::abs(dApq) <= 1e-300)
+                    continue;
+
+                // Rotation zeroing the (p, q) element
+                double dTheta = (vdMatrix[uQ * uSize + uQ] - vdMatrix[uP * uSize + uP]) / (2 * dApq);
+                double dTan = (dTheta >= 0 ? 1.0 : -1.0) / (std::abs(dTheta) + std::sqrt(dTheta * dTheta + 1));
+                double dCos = 1 / std::sqrt(dTan * dTan + 1);
+                double dSin = dTan * dCos;
+
+                for (unsigned uK = 0; uK < uSize; uK++)
+                {
+                    double dKP = vdMatrix[uK * uSize + uP];
+                    double dKQ = vdMatrix[uK * uSize + uQ];
+                    vdMatrix[uK * uSize + uP] = dCos * dKP - dSin * dKQ;
+                    vdMatrix[uK * uSize + uQ] = dSin * dKP + dCos * dKQ;
+                }
+                for (unsigned uK = 0; uK < uSize; uK++)
+                {
+                    double dPK = vdMatrix[uP * uSize + uK];
+                    double dQK = vdMatrix[uQ * uSize + uK];
+                    vdMatrix[uP * uSize + uK] = dCos * dPK - dSin * dQK;
+                    vdMatrix[uQ * uSize + uK] = dSin * dPK + dCos * dQK;
+                }
+                for (unsigned uK = 0; uK < uSize; uK++)
+                {
+                    double dKP = vdVectors[uK * uSize + uP];
+                    double dKQ = vdVectors[uK * uSize + uQ];
+                    vdVectors[uK * uSize + uP] = dCos * dKP - dSin * dKQ;
+                    vdVectors[uK * uSize + uQ] = dSin * dKP + dCos * dKQ;
+                }
+            }
+        }
+    }
+
+    // Noise subspace is spanned by the smallest eigenvalues, two real vectors per complex one
+    m_vdEigenvalues.resize(uSize);
+    for (unsigned uIndex = 0; uIndex < uSize; uIndex++)
+        m_vdEigenvalues[uIndex] = vdMatrix[uIndex * uSize + uIndex];
+
+    auto& vuOrder = m_vuEigenvalueOrder;
+    vuOrder.resize(uSize);
+    for (unsigned uIndex = 0; uIndex < uSize; uIndex++)
+        vuOrder[uIndex] = uIndex;
+    std::sort(vuOrder.begin(), vuOrder.end(), [this](unsigned uFirst, unsigned uSecond) { return m_vdEigenvalues[uFirst] < m_vdEigenvalues[uSecond]; });
+
+    // Each complex noise vector c appears as both c and ic, so their outer products sum to twice the projector
+    std::fill(m_vcdQuadraticForm.begin(), m_vcdQuadraticForm.end(), 0);
+    unsigned uNumNoiseVectors = 2 * (uNumElements - m_uNumSources);
+    for (unsigned uVector = 0; uVector < uNumNoiseVectors; uVector++)
+    {
+        unsigned uColumn = vuOrder[uVector];
+        for (unsigned uRow = 0; uRow < uNumElements; uRow++)
+        {
+            std::complex<double> cdRow(vdVectors[uRow * uSize + uColumn], vdVectors[(uRow + uNumElements) * uSize + uColumn]);
+            for (unsigned uOther = 0; uOther < uNumElements; uOther++)
+            {
+                std::complex<double> cdOther(vdVectors[uOther * uSize + uColumn], vdVectors[(uOther + uNumElements) * uSize + uColumn]);
+                m_vcdQuadraticForm[uRow * uNumElements + uOther] += 0.5 * cdRow * std::conj(cdOther);
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include "ByteFragmentChunk.h"
+
+ByteFragmentChunk::ByteFragmentChunk(std::shared_ptr<const std::vector<char>> pvcPayload, size_t uPayloadOffset, size_t uPayloadLength) :
+    ByteChunk(0),
+    m_pvcPayload(std::move(pvcPayload)),
+    m_uPayloadOffset(uPayloadOffset),
+    m_uPayloadLength(uPayloadLength)
+{
+    if (!m_pvcPayload || m_uPayloadOffset + m_uPayloadLength > m_pvcPayload->size())
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Fragment lies outside of the serialised chunk");
+
+    m_uChunkLength = GetTransmissionSize();
+}
+
+void ByteFragmentChunk::AppendHeader(const void* pvBytes, size_t uNumBytes)
+{
+    if (m_uHeaderSize + uNumBytes > m_uMaxHeaderSize)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Header of " + std::to_string(m_uHeaderSize + uNumBytes) + " bytes exceeds inline capacity");
+
+    memcpy(m_acHeader.data() + m_uHeaderSize, pvBytes, uNumBytes);
+    m_uHeaderSize += uNumBytes;
+    m_uChunkLength = GetTransmissionSize();
+}
+
+int ByteFragmentChunk::FillIOVecs(iovec (&asIOVecs)[2]) const
+{
+    asIOVecs[0].iov_base = const_cast<char*>(m_acHeader.data());
+    asIOVecs[0].iov_len = m_uHeaderSize;
+    asIOVecs[1].iov_base = const_cast<char*>(m_pvcPayload->data() + m_uPayloadOffset);
+    asIOVecs[1].iov_len = m_uPayloadLength;
+    return 2;
+}
+
+void ByteFragmentChunk::CopyTo(char* pcDestination) const
+{
+    memcpy(pcDestination, m_acHeader.data(), m_uHeaderSize);
+    memcpy(pcDestination + m_uHeaderSize, m_pvcPayload->data() + m_uPayloadOffset, m_uPayloadLength);
+}
+
+void ByteFragmentChunk::Materialise()
+{
+    if (m_vcDataChunk.size() == GetTransmissionSize())
+        return;
+
+    m_vcDataChunk.resize(GetTransmissionSize());
+    CopyTo(m_vcDataChunk.data());
+}
+
+unsigned ByteFragmentChunk::GetSize()
+{
+    Materialise();
+    return ByteChunk::GetSize();
+}
+
+std::shared_ptr<std::vector<char>> ByteFragmentChunk::Serialise()
+{
+    // Duplicated or forwarded fragments must carry their bytes with them
+    Materialise();
+    return ByteChunk::Serialise();
+}
+
+bool ByteFragmentChunk::WriteToSocket(int iSocket, const std::shared_ptr<ByteChunk>& pByteChunk)
+{
+    iovec asIOVecs[2];
+    int iNumIOVecs = 1;
+
+    auto pByteFragmentChunk = std::dynamic_pointer_cast<ByteFragmentChunk>(pByteChunk);
+    if (pByteFragmentChunk && pByteFragmentChunk->m_vcDataChunk.empty())
+        iNumIOVecs = pByteFragmentChunk->FillIOVecs(asIOVecs);
+    else
+    {
+        asIOVecs[0].iov_base = pByteChunk->m_vcDataChunk.data();
+        asIOVecs[0].iov_len = pByteChunk->m_vcDataChunk.size();
+    }
+
+    // Stream sockets may accept only part of a write so carry on from where the last one stopped
+    iovec* pIOVec = asIOVecs;
+    while (iNumIOVecs > 0)
+    {
+        ssize_t iBytesWritten = writev(iSocket, pIOVec, iNumIOVecs);
+        if (iBytesWritten < 0)
+            return false;
+
+        while (iNumIOVecs > 0 && static_cast<size_t>(iBytesWritten) >= pIOVec->iov_len)
+        {
+            iBytesWritten -= pIOVec->iov_len;
+            pIOVec++;
+            iNumIOVecs--;
+        }
+
+        if (iNumIOVecs > 0)
+        {
+            pIOVec->iov_base = static_cast<char*>(pIOVec->iov_base) + iBytesWritten;
+            pIOVec->iov_len -= iBytesWritten;
+        }
+    }
+
+    return true;
+}
+
+std::shared_ptr<std::vector<char>> ByteFragmentChunk::CopyBytes(const std::shared_ptr<ByteChunk>& pByteChunk)
+{
+    auto pByteFragmentChunk = std::dynamic_pointer_cast<ByteFragmentChunk>(pByteChunk);
+    if (!pByteFragmentChunk || !pByteFragmentChunk->m_vcDataChunk.empty())
+        return std::make_shared<std::vector<char>>(pByteChunk->m_vcDataChunk.begin(), pByteChunk->m_vcDataChunk.end());
+
+    auto pvcBytes = std::make_shared<std::vector<char>>(pByteFragmentChunk->GetTransmissionSize());
+    pByteFragmentChunk->CopyTo(pvcBytes->data());
+    return pvcBytes;
+}
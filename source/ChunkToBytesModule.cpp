@@ -11,31 +11,28 @@ void ChunkToBytesModule::Process(std::shared_ptr<BaseChunk> pBaseChunk)
     static uint8_t m_uSessionNumber = 0;
 
     // Lets first ensure that this chiunk is in the source identifers map
-    auto vu8SourceIdentifier = pBaseChunk->GetSourceIdentifier();
+    uint32_t u32SourceIndex = m_SourceIndexCache.Intern(pBaseChunk->GetSourceIdentifier());
     auto eChunkType = pBaseChunk->GetChunkType();
+    auto& pSession = m_MapOfIndentifiersToChunkTypeSessions[u32SourceIndex][ChunkTypesNamingUtility::ToU32(eChunkType)];
 
-    bool bSourceIdentifierNotSeen = (m_MapOfIndentifiersToChunkTypeSessions.find(vu8SourceIdentifier) == m_MapOfIndentifiersToChunkTypeSessions.end());
-    bool bChunkTypeNotSeen = true;
-
-    if (!bSourceIdentifierNotSeen)
-        bChunkTypeNotSeen = m_MapOfIndentifiersToChunkTypeSessions[vu8SourceIdentifier].count(eChunkType) == 0;
-
-    // By first checking if the source identider has been seen
-    if (bSourceIdentifierNotSeen || bChunkTypeNotSeen)
+    // By first checking if the source identider and chunk type have been seen
+    if (!pSession)
     {
-        m_MapOfIndentifiersToChunkTypeSessions[vu8SourceIdentifier][eChunkType] = std::make_shared<SessionController>();
-        m_MapOfIndentifiersToChunkTypeSessions[vu8SourceIdentifier][eChunkType]->m_u32uChunkType = ChunkTypesNamingUtility::ToU32(eChunkType);
+        pSession = std::make_shared<SessionController>();
+        pSession->m_u32uChunkType = ChunkTypesNamingUtility::ToU32(eChunkType);
 
+        const auto& vu8SourceIdentifier = SourceIdentifierRegistry::GetInstance().GetSourceIdentifier(u32SourceIndex);
         for (size_t i = 0; i < vu8SourceIdentifier.size(); i++)
-            m_MapOfIndentifiersToChunkTypeSessions[vu8SourceIdentifier][eChunkType]->m_usUID[i] = vu8SourceIdentifier[i];
+            pSession->m_usUID[i] = vu8SourceIdentifier[i];
     }
 
     // Then we extract the current session state for the current chunk type and source identifier
-    auto pSessionModeHeader = m_MapOfIndentifiersToChunkTypeSessions[vu8SourceIdentifier][eChunkType];
+    auto pSessionModeHeader = pSession;
 
     // PLOG_FATAL << std::to_string(pSessionModeHeader->m_u32uChunkType);
     //  Bytes to transmit is equal to number of bytes in derived object (e.g TimeChunk)
-    auto pvcByteData = pBaseChunk->Serialise();
+    //  Serialised once, each fragment references its slice of these bytes rather than copying it
+    std::shared_ptr<const std::vector<char>> pvcByteData = pBaseChunk->Serialise();
     u_int64_t u32TransmittableDataBytes = pvcByteData->size();
 
     uint16_t uSessionDataHeaderSize = 2; // size of the footer in bytes. '\0' denotes finish if this structure
@@ -64,24 +61,15 @@ void ChunkToBytesModule::Process(std::shared_ptr<BaseChunk> pBaseChunk)
 
         // Transmission Structure is shown below
         // { | DataHeaderSize | DatagramHeader | Data | }
-        std::vector<char> vuByteData;
-        vuByteData.resize(uSessionTransmissionSize);
+        // The headers are held inline and the data is a view so transmission modules can send it with writev
+        auto pByteChunk = std::make_shared<ByteFragmentChunk>(pvcByteData, uDataBytesTransmitted, uDataBytesToTransmit);
 
         // Add in the transmission header
-        memcpy(&vuByteData[0], &uSessionTransmissionSize, uSessionDataHeaderSize);
+        pByteChunk->AppendHeader(&uSessionTransmissionSize, uSessionDataHeaderSize);
 
-        // We then add the session state info
+        // We then add the session state info, which changes with every sequence number
         auto pHeaderBytes = pSessionModeHeader->Serialise();
-        
-        memcpy(&vuByteData[uSessionDataHeaderSize], &((*pHeaderBytes)[0]), pSessionModeHeader->GetSize());
-
-        // Then lets insert the actual data byte data to transmit after the header
-        // While keeping in mind that we have to send unset bits from out data byte array
-        memcpy(&vuByteData[uSessionDataHeaderSize + pSessionModeHeader->GetSize()], &((*pvcByteData)[uDataBytesTransmitted]), uDataBytesToTransmit);
-
-        auto pByteChunk = std::make_shared<ByteChunk>(uSessionTransmissionSize);
-        pByteChunk->m_vcDataChunk = vuByteData;
-        pByteChunk->m_uChunkLength = uSessionTransmissionSize;
+        pByteChunk->AppendHeader(pHeaderBytes->data(), pSessionModeHeader->GetSize());
 
         TryPassChunk(pByteChunk);
 
@@ -90,7 +78,7 @@ void ChunkToBytesModule::Process(std::shared_ptr<BaseChunk> pBaseChunk)
         pSessionModeHeader->IncrementSequence();
     }
     
-    m_MapOfIndentifiersToChunkTypeSessions[vu8SourceIdentifier][eChunkType]->IncrementSession();
+    pSessionModeHeader->IncrementSession();
     
 }
 
@@ -0,0 +1,69 @@
+#include "DetectionEventChunk.h"
+
+DetectionEventChunk::DetectionEventChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumChannels, unsigned uNumBins) :
+    BaseChunk(),
+    m_dSampleRate(dSampleRate),
+    m_i64TimeStamp(i64TimeStamp),
+    m_uNumChannels(uNumChannels),
+    m_uNumBins(uNumBins),
+    m_vDetectionEvents()
+{
+}
+
+unsigned DetectionEventChunk::GetInternalSize()
+{
+    return sizeof(m_dSampleRate) + sizeof(m_i64TimeStamp) + 3 * sizeof(unsigned) + m_vDetectionEvents.size() * sizeof(DetectionEvent);
+}
+
+unsigned DetectionEventChunk::GetSize()
+{
+    return BaseChunk::GetSize() + GetInternalSize();
+}
+
+std::shared_ptr<std::vector<char>> DetectionEventChunk::Serialise()
+{
+    auto pvBytes = std::make_shared<std::vector<char>>(GetSize());
+    char* pcBytes = pvBytes->data();
+
+    // Serialise base class members first
+    auto pvBaseBytes = BaseChunk::Serialise();
+    memcpy(pcBytes, pvBaseBytes->data(), BaseChunk::GetSize());
+    pcBytes += BaseChunk::GetSize();
+
+    // Then the spectrum description
+    memcpy(pcBytes, &m_dSampleRate, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(pcBytes, &m_i64TimeStamp, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    unsigned uNumEvents = m_vDetectionEvents.size();
+    for (unsigned uValue : { m_uNumChannels, m_uNumBins, uNumEvents })
+    {
+        memcpy(pcBytes, &uValue, sizeof(uValue));
+        pcBytes += sizeof(uValue);
+    }
+
+    // And finally the events themselves
+    memcpy(pcBytes, m_vDetectionEvents.data(), uNumEvents * sizeof(DetectionEvent));
+
+    return pvBytes;
+}
+
+void DetectionEventChunk::Deserialise(std::shared_ptr<std::vector<char>> pvBytes)
+{
+    BaseChunk::Deserialise(pvBytes);
+    char* pcBytes = pvBytes->data() + BaseChunk::GetSize();
+
+    memcpy(&m_dSampleRate, pcBytes, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(&m_i64TimeStamp, pcBytes, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    unsigned uNumEvents = 0;
+    for (unsigned* puValue : { &m_uNumChannels, &m_uNumBins, &uNumEvents })
+    {
+        memcpy(puValue, pcBytes, sizeof(unsigned));
+        pcBytes += sizeof(unsigned);
+    }
+
+    m_vDetectionEvents.resize(uNumEvents);
+    memcpy(m_vDetectionEvents.data(), pcBytes, uNumEvents * sizeof(DetectionEvent));
+}
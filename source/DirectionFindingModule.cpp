@@ -15,6 +15,10 @@ void DirectionFindingModule::Process(std::shared_ptr<BaseChunk> pBaseChunk)
     case ChunkType::DetectionBinChunk:
         ProcessDetectionBinChunk(pBaseChunk);
         break;
+
+    case ChunkType::DetectionEventChunk:
+        ProcessDetectionEventChunk(pBaseChunk);
+        break;
     
     case ChunkType::FFTChunk:
         ProcessFFTChunk(pBaseChunk);
@@ -24,38 +28,31 @@ void DirectionFindingModule::Process(std::shared_ptr<BaseChunk> pBaseChunk)
     TryPassChunk(pBaseChunk);
 }
 
-double DirectionFindingModule::CalculateAngleOfArrival(double differentialPhase_rads,double f_hz, double v_mps, double l_m) {
-    
-    double lambda_m = v_mps / f_hz;
-
-    // Differential phase before scaling and wrapping
-    double dAOA_rad = std::asin((lambda_m*differentialPhase_rads/(2*M_PI))/l_m);
-    
-    return dAOA_rad;
-}
-
 void DirectionFindingModule::ProcessDetectionBinChunk(std::shared_ptr<BaseChunk> pBaseChunk)
 {
-    // Store data for a single client
+    // Bins are copied as the chunk itself is passed on unchanged
     auto pDetectionBinChunk = std::static_pointer_cast<DetectionBinChunk>(pBaseChunk);
-    m_vvu16DetectionBins = *pDetectionBinChunk->GetDetectionBins();
+    std::vector<std::vector<uint16_t>> vvu16DetectionBins = *pDetectionBinChunk->GetDetectionBins();
+
+    // Detections are only applied to the FFT chunk of the same source and timestamp, when they carry one
+    auto pTimeStampedDetectionBinChunk = std::dynamic_pointer_cast<TimeStampedDetectionBinChunk>(pDetectionBinChunk);
+    if (pTimeStampedDetectionBinChunk)
+        JoinDetections(pDetectionBinChunk->GetSourceIdentifier(), pTimeStampedDetectionBinChunk->m_i64TimeStamp, true, std::move(vvu16DetectionBins));
+    else
+        JoinDetections(pDetectionBinChunk->GetSourceIdentifier(), 0, false, std::move(vvu16DetectionBins));
 }
 
-float DirectionFindingModule::CalculateDifferentialPhase(const std::complex<float>& z1, const std::complex<float>& z2)
+void DirectionFindingModule::ProcessDetectionEventChunk(std::shared_ptr<BaseChunk> pBaseChunk)
 {
-        // Ensure non-zero magnitude to avoid division by zero
-        if (std::abs(z2) < std::numeric_limits<float>::epsilon()) {
-            throw std::invalid_argument("Second complex number (z2) cannot have zero magnitude");
-        }
+    // Only the peak bin of each event needs an angle, rather than every bin of a wideband emitter
+    auto pDetectionEventChunk = std::static_pointer_cast<DetectionEventChunk>(pBaseChunk);
 
-        // Calculate the phase difference
-        float phase_diff = std::atan2(std::imag(z1), std::real(z1)) -
-                            std::atan2(std::imag(z2), std::real(z2));
+    std::vector<std::vector<uint16_t>> vvu16DetectionBins(pDetectionEventChunk->m_uNumChannels);
+    for (const auto& Event : pDetectionEventChunk->m_vDetectionEvents)
+        if (Event.State == DetectionEventState::Active)
+            vvu16DetectionBins[Event.u16ChannelIndex].emplace_back(Event.u16PeakBin);
 
-        // Wrap the phase difference to the range (-pi, pi]
-        phase_diff = std::fmod(phase_diff + M_PI, 2.0f * M_PI) - M_PI;
-
-        return phase_diff;
+    JoinDetections(pDetectionEventChunk->GetSourceIdentifier(), pDetectionEventChunk->m_i64TimeStamp, true, std::move(vvu16DetectionBins));
 }
 
 void DirectionFindingModule::ProcessFFTChunk(std::shared_ptr<BaseChunk> pBaseChunk)
@@ -67,38 +64,234 @@ void DirectionFindingModule::ProcessFFTChunk(std::shared_ptr<BaseChunk> pBaseChu
     assert(pFFTChunk->m_dSampleRate != 0);
 
     if (pFFTChunk->m_vvcfFFTChunks.size() <= 1)
+        return;
+
+    auto& JoinState = m_mSourceJoinStates[m_SourceIndexCache.Intern(pFFTChunk->GetSourceIdentifier())];
+    JoinState.u64NewestTimeStamp = std::max(JoinState.u64NewestTimeStamp, pFFTChunk->m_i64TimeStamp);
+
+    // Detections usually arrive first as they are made from the magnitudes of the same transform
+    for (auto itDetections = JoinState.dqDetections.begin(); itDetections != JoinState.dqDetections.end(); ++itDetections)
     {
-        TryPassChunk(pFFTChunk);
+        if (itDetections->bTimeStamped && itDetections->u64TimeStamp != pFFTChunk->m_i64TimeStamp)
+            continue;
+
+        ProcessMatchedChunk(JoinState, pFFTChunk, itDetections->vvu16DetectionBins);
+        JoinState.dqDetections.erase(itDetections);
+        EvictUnmatched(JoinState);
         return;
     }
-    
-    // Prep the data to process
-    std::vector<float> vfAngleOfArrivals;
-    auto vu16DetectionBins0 = m_vvu16DetectionBins[0];
-    auto vu16DetectionBins1 = m_vvu16DetectionBins[1];
 
-    // Then calculate the AOA
-    for (const auto& uDetectionIndex : vu16DetectionBins0)
+    JoinState.dqFFTChunks.emplace_back(pFFTChunk);
+    EvictUnmatched(JoinState);
+}
+
+void DirectionFindingModule::JoinDetections(const std::vector<uint8_t>& vu8SourceIdentifier, uint64_t u64TimeStamp, bool bTimeStamped, std::vector<std::vector<uint16_t>>&& vvu16DetectionBins)
+{
+    auto& JoinState = m_mSourceJoinStates[m_SourceIndexCache.Intern(vu8SourceIdentifier)];
+
+    // Detections without a timestamp pair in arrival order and age from the newest chunk seen
+    if (bTimeStamped)
+        JoinState.u64NewestTimeStamp = std::max(JoinState.u64NewestTimeStamp, u64TimeStamp);
+    else
+        u64TimeStamp = JoinState.u64NewestTimeStamp;
+
+    for (auto itFFTChunk = JoinState.dqFFTChunks.begin(); itFFTChunk != JoinState.dqFFTChunks.end(); ++itFFTChunk)
     {
-        // calcaulte differential phase
-        auto cfA0 = pFFTChunk->m_vvcfFFTChunks[0][uDetectionIndex];
-        auto cfA1 = pFFTChunk->m_vvcfFFTChunks[1][uDetectionIndex];
+        if (bTimeStamped && (*itFFTChunk)->m_i64TimeStamp != u64TimeStamp)
+            continue;
+
+        auto pFFTChunk = *itFFTChunk;
+        JoinState.dqFFTChunks.erase(itFFTChunk);
+        ProcessMatchedChunk(JoinState, pFFTChunk, vvu16DetectionBins);
+        EvictUnmatched(JoinState);
+        return;
+    }
 
-        auto fDeltaA_rad = CalculateDifferentialPhase(cfA0, cfA1);
-        auto dFrequencyOfInterest_hz = uDetectionIndex*pFFTChunk->m_dSampleRate/(2.0f*(pFFTChunk->m_dChunkSize-1));
+    JoinState.dqDetections.push_back({ u64TimeStamp, bTimeStamped, std::move(vvu16DetectionBins) });
+    EvictUnmatched(JoinState);
+}
 
-        auto dAOA_rad = CalculateAngleOfArrival(fDeltaA_rad, dFrequencyOfInterest_hz, m_dPropogationVelocity_mps, m_dBaselineLength_m);
-        auto dAOA_deg = dAOA_rad*180/M_PI;
+void DirectionFindingModule::EvictUnmatched(SourceJoinState& JoinState)
+{
+    uint64_t u64OldestAllowed = JoinState.u64NewestTimeStamp > m_u64MaxJoinAge_us ? JoinState.u64NewestTimeStamp - m_u64MaxJoinAge_us : 0;
 
-        vfAngleOfArrivals.emplace_back(dAOA_deg);
+    while (!JoinState.dqDetections.empty() && (JoinState.dqDetections.size() > m_uMaxPendingPerSource || JoinState.dqDetections.front().u64TimeStamp < u64OldestAllowed))
+    {
+        JoinState.dqDetections.pop_front();
+        m_u64UnmatchedEvictions++;
     }
 
-    // And store said data
-    auto pDirectionChunk = std::make_shared<DirectionBinChunk>();
+    while (!JoinState.dqFFTChunks.empty() && (JoinState.dqFFTChunks.size() > m_uMaxPendingPerSource || JoinState.dqFFTChunks.front()->m_i64TimeStamp < u64OldestAllowed))
+    {
+        JoinState.dqFFTChunks.pop_front();
+        m_u64UnmatchedEvictions++;
+    }
+}
+
+void DirectionFindingModule::SetJoinLimits(unsigned uMaxPendingPerSource, double dMaxJoinAge_s)
+{
+    if (uMaxPendingPerSource == 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": At least one pending chunk per source is required");
+
+    m_uMaxPendingPerSource = uMaxPendingPerSource;
+    m_u64MaxJoinAge_us = dMaxJoinAge_s * 1e6;
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Holding up to " + std::to_string(uMaxPendingPerSource) + " unmatched chunks per source for " + std::to_string(dMaxJoinAge_s) + " s";
+    PLOG_INFO << strInfo;
+}
+
+void DirectionFindingModule::ProcessMatchedChunk(SourceJoinState& JoinState, const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<std::vector<uint16_t>>& vvu16DetectionBins)
+{
+    if (m_pArrayDOAEngine)
+        ProcessArray(JoinState, pFFTChunk, vvu16DetectionBins);
+    else
+        ProcessPhaseDifference(pFFTChunk, vvu16DetectionBins);
+}
+
+void DirectionFindingModule::ProcessPhaseDifference(const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<std::vector<uint16_t>>& vvu16DetectionBins)
+{
+    if (vvu16DetectionBins.empty())
+        return;
+
+    // Calculate the AOA of every detection at once
+    const auto& vu16DetectionBins0 = vvu16DetectionBins[0];
+    std::vector<float> vfAngleOfArrivals;
+    std::vector<uint8_t> vu8Valid;
+    CalculateAnglesOfArrival(pFFTChunk, vu16DetectionBins0, vfAngleOfArrivals, vu8Valid);
+
+    // Bins without a meaningful angle are dropped rather than stopping processing
+    std::vector<uint16_t> vu16ValidBins;
+    size_t uNumValid = 0;
+    for (size_t uDetectionIndex = 0; uDetectionIndex < vu16DetectionBins0.size(); uDetectionIndex++)
+    {
+        if (!vu8Valid[uDetectionIndex])
+            continue;
+        vu16ValidBins.emplace_back(vu16DetectionBins0[uDetectionIndex]);
+        vfAngleOfArrivals[uNumValid++] = vfAngleOfArrivals[uDetectionIndex];
+    }
+    vfAngleOfArrivals.resize(uNumValid);
+
+    PassDirections(pFFTChunk, vu16ValidBins, vfAngleOfArrivals);
+}
+
+void DirectionFindingModule::PassDirections(const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<uint16_t>& vu16Bins, const std::vector<float>& vfAngleOfArrivals_deg)
+{
+    std::shared_ptr<DirectionBinChunk> pDirectionChunk;
+    if (m_pArrayDOAEngine)
+    {
+        // Array estimates keep the scan each peak was picked from, rows of m_vfAngleSpectra are in bin order
+        auto pAngleSpectrumChunk = std::make_shared<AngleSpectrumDirectionBinChunk>(m_vfAngleGrid_deg);
+        size_t uNumAngles = m_vfAngleGrid_deg.size();
+        pAngleSpectrumChunk->m_vvfAngleSpectra.reserve(vu16Bins.size());
+        for (size_t uDetectionIndex = 0; uDetectionIndex < vu16Bins.size(); uDetectionIndex++)
+        {
+            auto itSpectrum = m_vfAngleSpectra.begin() + uDetectionIndex * uNumAngles;
+            pAngleSpectrumChunk->m_vvfAngleSpectra.emplace_back(itSpectrum, itSpectrum + uNumAngles);
+        }
+        pDirectionChunk = pAngleSpectrumChunk;
+    }
+    else
+        pDirectionChunk = std::make_shared<DirectionBinChunk>();
+
     pDirectionChunk->SetSourceIdentifier(pFFTChunk->GetSourceIdentifier());
-    pDirectionChunk->SetDirectionData(m_vvu16DetectionBins[0].size(), m_vvu16DetectionBins[0], vfAngleOfArrivals, pFFTChunk->m_dSampleRate);
+    pDirectionChunk->SetDirectionData(vu16Bins.size(), vu16Bins, vfAngleOfArrivals_deg, pFFTChunk->m_dSampleRate);
 
-    // Once complete, pass on the data
-    TryPassChunk(pFFTChunk);
     TryPassChunk(pDirectionChunk);
-}
\ No newline at end of file
+}
+
+void DirectionFindingModule::CalculateAnglesOfArrival(const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<uint16_t>& vu16Bins, std::vector<float>& vfAngleOfArrivals_deg, std::vector<uint8_t>& vu8Valid)
+{
+    size_t uNumBins = vu16Bins.size();
+    const auto& vcfChannel0 = pFFTChunk->m_vvcfFFTChunks[0];
+    const auto& vcfChannel1 = pFFTChunk->m_vvcfFFTChunks[1];
+
+    // Gather the detected bins so the kernels stream over contiguous values
+    m_vcfFirstScratch.resize(uNumBins);
+    m_vcfSecondScratch.resize(uNumBins);
+    m_vfPhaseScratch.resize(uNumBins);
+    vfAngleOfArrivals_deg.resize(uNumBins);
+    vu8Valid.resize(uNumBins);
+    for (size_t uIndex = 0; uIndex < uNumBins; uIndex++)
+    {
+        uint16_t u16Bin = std::min<size_t>(vu16Bins[uIndex], vcfChannel0.size() - 1);
+        m_vcfFirstScratch[uIndex] = vcfChannel0[u16Bin];
+        m_vcfSecondScratch[uIndex] = vcfChannel1[u16Bin];
+    }
+
+    // One arg(z0 conj(z1)) per bin replaces two atan2 calls and the wrap
+    VectorKernelUtility::PhaseDifference(m_vcfFirstScratch.data(), m_vcfSecondScratch.data(), m_vfPhaseScratch.data(), uNumBins);
+
+    // sin(AOA) = lambda * dPhase / (2 pi L) with lambda = v / f and f = bin * bin width
+    double dBinWidth_hz = pFFTChunk->m_dSampleRate / (2.0 * (pFFTChunk->m_dChunkSize - 1));
+    float fScale = m_dPropogationVelocity_mps / (2 * M_PI * dBinWidth_hz * m_dBaselineLength_m);
+    float fMinimumPower = std::numeric_limits<float>::epsilon() * std::numeric_limits<float>::epsilon();
+    for (size_t uIndex = 0; uIndex < uNumBins; uIndex++)
+    {
+        float fSine = fScale * m_vfPhaseScratch[uIndex] / std::max<float>(vu16Bins[uIndex], 1.0f);
+        bool bHasReference = std::norm(m_vcfFirstScratch[uIndex]) > fMinimumPower && std::norm(m_vcfSecondScratch[uIndex]) > fMinimumPower;
+        vu8Valid[uIndex] = bHasReference && vu16Bins[uIndex] > 0 && vu16Bins[uIndex] < vcfChannel0.size() && std::abs(fSine) <= 1.0f;
+        m_vfPhaseScratch[uIndex] = fSine;
+    }
+
+    VectorKernelUtility::ArcSine(m_vfPhaseScratch.data(), vfAngleOfArrivals_deg.data(), uNumBins);
+    VectorKernelUtility::Scale(vfAngleOfArrivals_deg.data(), uNumBins, 180 / M_PI);
+}
+
+void DirectionFindingModule::EnableArrayProcessing(const std::vector<std::vector<double>>& vvdElementPositions_m, const std::string& strMethod, unsigned uNumSnapshots,
+                                                   double dMinAngle_deg, double dMaxAngle_deg, unsigned uNumAngles, unsigned uNumSources)
+{
+    if (uNumSnapshots == 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": At least one snapshot is required");
+
+    m_pArrayDOAEngine = std::make_unique<ArrayDOAEngine>(vvdElementPositions_m, m_dPropogationVelocity_mps, strMethod, dMinAngle_deg, dMaxAngle_deg, uNumAngles, uNumSources);
+    m_uNumSnapshots = uNumSnapshots;
+    m_vfAngleGrid_deg.resize(m_pArrayDOAEngine->GetNumAngles());
+    for (unsigned uAngleIndex = 0; uAngleIndex < m_vfAngleGrid_deg.size(); uAngleIndex++)
+        m_vfAngleGrid_deg[uAngleIndex] = m_pArrayDOAEngine->GetAngle_deg(uAngleIndex);
+    for (auto& [u32SourceIndex, JoinState] : m_mSourceJoinStates)
+        JoinState.CrossSpectra = ArrayDOAEngine::CrossSpectra();
+
+    std::string strInfo = std::string(__FUNCTION__) + ": " + strMethod + " direction finding over " + std::to_string(vvdElementPositions_m.size()) + " elements and " + std::to_string(uNumSnapshots) + " snapshots";
+    PLOG_INFO << strInfo;
+}
+
+void DirectionFindingModule::ProcessArray(SourceJoinState& JoinState, const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<std::vector<uint16_t>>& vvu16DetectionBins)
+{
+    if (pFFTChunk->m_vvcfFFTChunks.size() != m_pArrayDOAEngine->GetNumElements())
+    {
+        std::string strWarning = std::string(__FUNCTION__) + ": Received " + std::to_string(pFFTChunk->m_vvcfFFTChunks.size()) + " channels for a " + std::to_string(m_pArrayDOAEngine->GetNumElements()) + " element array";
+        PLOG_WARNING << strWarning;
+        return;
+    }
+
+    // Cross spectra of every bin are averaged per source so estimates are ready for whichever bins are detected
+    auto& CrossSpectra = JoinState.CrossSpectra;
+    m_pArrayDOAEngine->Accumulate(pFFTChunk->m_vvcfFFTChunks, CrossSpectra);
+    if (CrossSpectra.uNumSnapshots < m_uNumSnapshots)
+        return;
+
+    // Scan only the detected bins, against steering vectors cached per bin
+    std::vector<uint16_t> vu16DetectionBins;
+    if (!vvu16DetectionBins.empty())
+        for (auto u16Bin : vvu16DetectionBins[0])
+            if (u16Bin < CrossSpectra.uNumBins)
+                vu16DetectionBins.emplace_back(u16Bin);
+
+    double dBinWidth_hz = pFFTChunk->m_dSampleRate / (2.0 * (pFFTChunk->m_dChunkSize - 1));
+    m_pArrayDOAEngine->ScanBins(CrossSpectra, vu16DetectionBins, dBinWidth_hz, m_vfAngleSpectra);
+
+    std::vector<float> vfAngleOfArrivals;
+    unsigned uNumAngles = m_pArrayDOAEngine->GetNumAngles();
+    for (size_t uDetectionIndex = 0; uDetectionIndex < vu16DetectionBins.size(); uDetectionIndex++)
+    {
+        auto itSpectrum = m_vfAngleSpectra.begin() + uDetectionIndex * uNumAngles;
+        unsigned uPeakIndex = std::max_element(itSpectrum, itSpectrum + uNumAngles) - itSpectrum;
+        vfAngleOfArrivals.emplace_back(m_pArrayDOAEngine->GetAngle_deg(uPeakIndex));
+    }
+
+    // Averaging restarts for the next estimate
+    CrossSpectra.uNumSnapshots = 0;
+    std::fill(CrossSpectra.vcfMatrices.begin(), CrossSpectra.vcfMatrices.end(), 0);
+
+    PassDirections(pFFTChunk, vu16DetectionBins, vfAngleOfArrivals);
+}
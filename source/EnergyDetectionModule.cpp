@@ -11,78 +11,469 @@ void EnergyDetectionModule::Process_FFTMagnitudeChunk(std::shared_ptr<BaseChunk>
     // Now we prepare the chunk for processing
     auto pFFTMagnitudeChunk = std::static_pointer_cast<FFTMagnitudeChunk>(pBaseChunk);
 
-    // Run detection algorithim
-    auto pvvdPower_db = CalculateBinPowerInDBX(pFFTMagnitudeChunk);
-    auto pvdAveragePower_db = CalculateAverageBinPowerInDBX(pvvdPower_db);
-    auto dDetectionThreshold = CalculateThresholdInDBX(pvdAveragePower_db->at(0), m_fThresholdAboveNoiseFoor_db);
-    auto pvvu16DetectionBins = GetDetectionBinIndicies(pFFTMagnitudeChunk, dDetectionThreshold);
+    // Threshold is compared in the linear domain so no bin needs a log
+    float fThresholdRatio = std::pow(10.0f, m_fThresholdAboveNoiseFoor_db / 10.0f);
+
+    // Floors carried over from earlier chunks of this source, CFAR estimates are always local so take precedence
+    NoiseFloorState* pNoiseFloorState = nullptr;
+    if (m_NoiseFloorTrackerType != NoiseFloorTrackerType::None && m_CFARType == CFARType::None)
+        pNoiseFloorState = &GetNoiseFloorState(pFFTMagnitudeChunk);
+
+    // Bins only pass once they have persisted, with the history of each bin kept per source
+    PersistenceState* pPersistenceState = nullptr;
+    if (m_uPersistenceWindowFrames)
+        pPersistenceState = &GetPersistenceState(pFFTMagnitudeChunk);
+
+    double dBinWidth_Hz = 0;
+    if (pFFTMagnitudeChunk->m_dChunkSize > 1)
+        dBinWidth_Hz = pFFTMagnitudeChunk->m_dSampleRate / (2.0 * (pFFTMagnitudeChunk->m_dChunkSize - 1));
+
+    // Events are built while each channel's power is still in the scratch buffer
+    std::shared_ptr<DetectionEventChunk> pDetectionEventChunk;
+    if (m_bEventClusteringEnabled)
+    {
+        pDetectionEventChunk = std::make_shared<DetectionEventChunk>(pFFTMagnitudeChunk->m_dSampleRate, pFFTMagnitudeChunk->m_i64TimeStamp, pFFTMagnitudeChunk->m_uNumChannels, pFFTMagnitudeChunk->m_dChunkSize);
+        pDetectionEventChunk->SetSourceIdentifier(pFFTMagnitudeChunk->GetSourceIdentifier());
+    }
+
+    // Run detection algorithim on each channel
+    m_vvu16DetectionBins.resize(pFFTMagnitudeChunk->m_uNumChannels);
+    m_vLostEventScratch.clear();
+    for (unsigned uChannelIndex = 0; uChannelIndex < pFFTMagnitudeChunk->m_uNumChannels; uChannelIndex++)
+    {
+        DetectChannel(pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[uChannelIndex].data(), pFFTMagnitudeChunk->m_dChunkSize, fThresholdRatio, m_vvu16DetectionBins[uChannelIndex], pNoiseFloorState, uChannelIndex);
+        if (pPersistenceState)
+            GateChannel(*pPersistenceState, uChannelIndex, m_vvu16DetectionBins[uChannelIndex], dBinWidth_Hz);
+        if (pDetectionEventChunk)
+            ClusterChannel(m_vvu16DetectionBins[uChannelIndex], pFFTMagnitudeChunk->m_dChunkSize, uChannelIndex, dBinWidth_Hz, pDetectionEventChunk->m_vDetectionEvents);
+    }
+
+    if (pNoiseFloorState && ++pNoiseFloorState->uChunksInWindow >= m_uMinimumStatisticsWindow)
+        pNoiseFloorState->uChunksInWindow = 0;
+
+    // Ended detections always travel as events, alongside the active ones when clustering
+    if (!pDetectionEventChunk && !m_vLostEventScratch.empty())
+    {
+        pDetectionEventChunk = std::make_shared<DetectionEventChunk>(pFFTMagnitudeChunk->m_dSampleRate, pFFTMagnitudeChunk->m_i64TimeStamp, pFFTMagnitudeChunk->m_uNumChannels, pFFTMagnitudeChunk->m_dChunkSize);
+        pDetectionEventChunk->SetSourceIdentifier(pFFTMagnitudeChunk->GetSourceIdentifier());
+    }
+    if (pDetectionEventChunk)
+        pDetectionEventChunk->m_vDetectionEvents.insert(pDetectionEventChunk->m_vDetectionEvents.end(), m_vLostEventScratch.begin(), m_vLostEventScratch.end());
+
+    if (m_bEventClusteringEnabled)
+    {
+        TryPassChunk(pDetectionEventChunk);
+        TryPassChunk(pFFTMagnitudeChunk);
+        return;
+    }
 
     // Generate chunk
-    auto pDetecionChunk = std::make_shared<DetectionBinChunk>();
+    auto pDetecionChunk = std::make_shared<TimeStampedDetectionBinChunk>(pFFTMagnitudeChunk->m_i64TimeStamp);
     pDetecionChunk->SetSourceIdentifier(pFFTMagnitudeChunk->GetSourceIdentifier());
-    pDetecionChunk->SetDetectionBins((*pvvu16DetectionBins) );
+    pDetecionChunk->SetDetectionBins(m_vvu16DetectionBins);
 
-    // try pass
+    // try pass, lost events first so consumers of detected bins see the current bins last
+    if (pDetectionEventChunk)
+        TryPassChunk(pDetectionEventChunk);
     TryPassChunk(pDetecionChunk);
     TryPassChunk(pFFTMagnitudeChunk);
 }
 
-std::shared_ptr<std::vector<std::vector<double>>> EnergyDetectionModule::CalculateBinPowerInDBX(std::shared_ptr<FFTMagnitudeChunk> pFFTMagnitudeChunk)
+void EnergyDetectionModule::DetectChannel(const float* pfMagnitudes, size_t uNumBins, float fThresholdRatio, std::vector<uint16_t>& vu16DetectionBins, NoiseFloorState* pNoiseFloorState, unsigned uChannelIndex)
 {
-    auto pvvdPower_db = std::make_shared<std::vector<std::vector<double>>>(pFFTMagnitudeChunk->m_uNumChannels);
-    for (unsigned uCurrentChannelIndex = 0; uCurrentChannelIndex < pFFTMagnitudeChunk->m_uNumChannels; uCurrentChannelIndex++)
+    if (m_vfBinPowerScratch.size() < uNumBins)
+    {
+        m_vfBinPowerScratch.resize(uNumBins);
+        m_vuIndexScratch.resize(uNumBins);
+    }
+
+    // Power and the noise floor (mean bin power) come from a single pass over the magnitudes
+    float fSumOfPowers = VectorKernelUtility::SquareAndSum(pfMagnitudes, m_vfBinPowerScratch.data(), uNumBins);
+    float fNoiseFloor = uNumBins ? fSumOfPowers / uNumBins : 0.0f;
+
+    // Local noise estimates replace the channel floor when CFAR is enabled
+    if (m_CFARType == CFARType::CellAveraging)
+        return DetectCellAveragingCFAR(uNumBins, fThresholdRatio, vu16DetectionBins);
+    if (m_CFARType == CFARType::OrderedStatistic)
+        return DetectOrderedStatisticCFAR(uNumBins, fThresholdRatio, vu16DetectionBins);
+
+    if (pNoiseFloorState)
     {
-        for (unsigned uCurrentSampleIndex = 0; uCurrentSampleIndex < pFFTMagnitudeChunk->m_dChunkSize; uCurrentSampleIndex++)
+        float* pfNoiseFloor = pNoiseFloorState->vfNoiseFloor.data() + uChannelIndex * uNumBins;
+
+        // A new source has no history so starts from a flat floor at its mean power
+        if (uNumBins && std::isnan(pfNoiseFloor[0]))
         {
-            auto mag = pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[uCurrentChannelIndex][uCurrentSampleIndex];
-            (*pvvdPower_db)[uCurrentChannelIndex].emplace_back(std::log(std::pow(mag, 2.0))/std::log(10));
+            std::fill(pfNoiseFloor, pfNoiseFloor + uNumBins, fNoiseFloor);
+            if (m_NoiseFloorTrackerType == NoiseFloorTrackerType::MinimumStatistics)
+            {
+                size_t uOffset = uChannelIndex * uNumBins;
+                std::fill_n(pNoiseFloorState->vfSmoothedPower.begin() + uOffset, uNumBins, fNoiseFloor);
+                std::fill_n(pNoiseFloorState->vfWindowMinimum.begin() + uOffset, uNumBins, fNoiseFloor);
+                std::fill_n(pNoiseFloorState->vfPreviousWindowMinimum.begin() + uOffset, uNumBins, fNoiseFloor);
+            }
         }
+
+        // Compared against the floor of earlier chunks so a new signal is detected before it is absorbed
+        size_t uNumDetections = VectorKernelUtility::FindIndicesAboveReference(m_vfBinPowerScratch.data(), pfNoiseFloor, fThresholdRatio, uNumBins, m_vuIndexScratch.data());
+        vu16DetectionBins.assign(m_vuIndexScratch.begin(), m_vuIndexScratch.begin() + uNumDetections);
+
+        UpdateNoiseFloor(*pNoiseFloorState, uChannelIndex);
+        return;
     }
 
-    return pvvdPower_db;
+    // Then a compare only sweep over the cached powers, which skips quiet stretches a register at a time
+    size_t uNumDetections = VectorKernelUtility::FindIndicesAbove(m_vfBinPowerScratch.data(), uNumBins, fNoiseFloor * fThresholdRatio, m_vuIndexScratch.data());
+    vu16DetectionBins.assign(m_vuIndexScratch.begin(), m_vuIndexScratch.begin() + uNumDetections);
+}
+
+void EnergyDetectionModule::EnableCFAR(const std::string& strCFARType, unsigned uGuardCells, unsigned uTrainingCells)
+{
+    if (uTrainingCells == 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": At least one training cell is required");
+
+    if (strCFARType == "CellAveraging")
+        m_CFARType = CFARType::CellAveraging;
+    else if (strCFARType == "OrderedStatistic")
+        m_CFARType = CFARType::OrderedStatistic;
+    else
+        throw std::runtime_error(std::string(__FUNCTION__) + ": " + strCFARType + " must be either CellAveraging or OrderedStatistic");
+
+    m_uCFARGuardCells = uGuardCells;
+    m_uCFARTrainingCells = uTrainingCells;
+
+    std::string strInfo = std::string(__FUNCTION__) + ": " + strCFARType + " CFAR enabled with " + std::to_string(uGuardCells) + " guard and " + std::to_string(uTrainingCells) + " training cells";
+    PLOG_INFO << strInfo;
 }
 
-std::shared_ptr<std::vector<double>> EnergyDetectionModule::CalculateAverageBinPowerInDBX(std::shared_ptr<std::vector<std::vector<double>>> pvvdPower_db)
+void EnergyDetectionModule::DetectCellAveragingCFAR(size_t uNumBins, float fThresholdRatio, std::vector<uint16_t>& vu16DetectionBins)
 {
-    auto pvdAveragePower_db = std::make_shared<std::vector<double>>(pvvdPower_db->size());
-    for (unsigned uCurrentChannelIndex = 0; uCurrentChannelIndex < pvvdPower_db->size(); uCurrentChannelIndex++)
+    // Prefix sums make the sum over any window two lookups
+    m_vdPowerPrefixSums.resize(uNumBins + 1);
+    m_vdPowerPrefixSums[0] = 0;
+    for (size_t uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+        m_vdPowerPrefixSums[uBinIndex + 1] = m_vdPowerPrefixSums[uBinIndex] + m_vfBinPowerScratch[uBinIndex];
+
+    int64_t i64NumBins = uNumBins;
+    int64_t i64Guard = m_uCFARGuardCells;
+    int64_t i64Training = m_uCFARTrainingCells;
+
+    vu16DetectionBins.clear();
+    for (int64_t i64BinIndex = 0; i64BinIndex < i64NumBins; i64BinIndex++)
     {
-        // divide becomes minus in log
-        auto dAveragePower_db = std::log(std::accumulate((*pvvdPower_db)[uCurrentChannelIndex].begin(), (*pvvdPower_db)[uCurrentChannelIndex].end(), 0.0))/std::log(10) - std::log((*pvvdPower_db)[uCurrentChannelIndex].size())/std::log(10);
-        (*pvdAveragePower_db)[uCurrentChannelIndex] = dAveragePower_db;
+        // Windows are truncated at the spectrum edges, leaving one sided estimates there
+        int64_t i64LeftStart = std::max<int64_t>(0, i64BinIndex - i64Guard - i64Training);
+        int64_t i64LeftEnd = std::max<int64_t>(0, i64BinIndex - i64Guard);
+        int64_t i64RightStart = std::min(i64NumBins, i64BinIndex + i64Guard + 1);
+        int64_t i64RightEnd = std::min(i64NumBins, i64BinIndex + i64Guard + i64Training + 1);
+
+        int64_t i64NumCells = (i64LeftEnd - i64LeftStart) + (i64RightEnd - i64RightStart);
+        if (i64NumCells == 0)
+            continue;
+
+        double dCellSum = (m_vdPowerPrefixSums[i64LeftEnd] - m_vdPowerPrefixSums[i64LeftStart]) + (m_vdPowerPrefixSums[i64RightEnd] - m_vdPowerPrefixSums[i64RightStart]);
+        if (m_vfBinPowerScratch[i64BinIndex] > fThresholdRatio * dCellSum / i64NumCells)
+            vu16DetectionBins.emplace_back(i64BinIndex);
     }
+}
+
+void EnergyDetectionModule::DetectOrderedStatisticCFAR(size_t uNumBins, float fThresholdRatio, std::vector<uint16_t>& vu16DetectionBins)
+{
+    int64_t i64NumBins = uNumBins;
+    int64_t i64Guard = m_uCFARGuardCells;
+    int64_t i64Training = m_uCFARTrainingCells;
+    const float* pfPower = m_vfBinPowerScratch.data();
+
+    // Rank every bin by power once, ties broken by bin so ranks are distinct
+    auto& vuBinsByPower = m_vuBinsByPower;
+    auto& vuPowerRanks = m_vuPowerRanks;
+    vuBinsByPower.resize(uNumBins);
+    vuPowerRanks.resize(uNumBins);
+    std::iota(vuBinsByPower.begin(), vuBinsByPower.end(), 0);
+    std::sort(vuBinsByPower.begin(), vuBinsByPower.end(), [pfPower](uint32_t uFirst, uint32_t uSecond) {
+        return pfPower[uFirst] < pfPower[uSecond] || (pfPower[uFirst] == pfPower[uSecond] && uFirst < uSecond);
+    });
+    for (size_t uRank = 0; uRank < uNumBins; uRank++)
+        vuPowerRanks[vuBinsByPower[uRank]] = uRank;
 
-    return pvdAveragePower_db;
+    // Fenwick tree over ranks counts the training cells, so entering and leaving cells cost O(log bins)
+    auto& vuRankCounts = m_vuTrainingRankCounts;
+    vuRankCounts.assign(uNumBins + 1, 0);
+    size_t uTrainingCells = 0;
+    auto UpdateCell = [&vuRankCounts, &vuPowerRanks, &uTrainingCells, uNumBins](int64_t i64Cell, int32_t i32Change) {
+        for (size_t uNode = vuPowerRanks[i64Cell] + 1; uNode <= uNumBins; uNode += uNode & (~uNode + 1))
+            vuRankCounts[uNode] += i32Change;
+        uTrainingCells += i32Change;
+    };
+
+    // Descends the tree to the cell of a given rank within the window
+    size_t uHighestStep = std::bit_floor(uNumBins);
+    auto SelectCell = [&vuRankCounts, &vuBinsByPower, uNumBins, uHighestStep](size_t uWindowRank) {
+        size_t uNode = 0;
+        for (size_t uStep = uHighestStep; uStep > 0; uStep >>= 1)
+        {
+            if (uNode + uStep <= uNumBins && vuRankCounts[uNode + uStep] <= uWindowRank)
+            {
+                uNode += uStep;
+                uWindowRank -= vuRankCounts[uNode];
+            }
+        }
+        return vuBinsByPower[uNode];
+    };
+
+    // Training window of the first bin is only the right hand side
+    for (int64_t i64Cell = i64Guard + 1; i64Cell <= i64Guard + i64Training && i64Cell < i64NumBins; i64Cell++)
+        UpdateCell(i64Cell, 1);
+
+    vu16DetectionBins.clear();
+    for (int64_t i64BinIndex = 0; i64BinIndex < i64NumBins; i64BinIndex++)
+    {
+        if (uTrainingCells)
+        {
+            // 75th percentile is robust to a strong neighbour occupying a few training cells
+            float fNoiseEstimate = pfPower[SelectCell((uTrainingCells * 3) / 4)];
+            if (pfPower[i64BinIndex] > fThresholdRatio * fNoiseEstimate)
+                vu16DetectionBins.emplace_back(i64BinIndex);
+        }
+
+        // Slide both halves of the window one bin to the right
+        int64_t i64LeftEntering = i64BinIndex - i64Guard;
+        int64_t i64LeftLeaving = i64BinIndex - i64Guard - i64Training;
+        int64_t i64RightLeaving = i64BinIndex + i64Guard + 1;
+        int64_t i64RightEntering = i64BinIndex + i64Guard + i64Training + 1;
+
+        if (i64LeftEntering >= 0 && i64LeftEntering < i64NumBins)
+            UpdateCell(i64LeftEntering, 1);
+        if (i64LeftLeaving >= 0)
+            UpdateCell(i64LeftLeaving, -1);
+        if (i64RightLeaving < i64NumBins)
+            UpdateCell(i64RightLeaving, -1);
+        if (i64RightEntering < i64NumBins)
+            UpdateCell(i64RightEntering, 1);
+    }
 }
 
-double EnergyDetectionModule::CalculateThresholdInDBX(double dAveragePower_db, double dLevelAboveFloor)
+void EnergyDetectionModule::EnableNoiseFloorTracking(const std::string& strTrackerType, float fSmoothingFactor, unsigned uMinimumStatisticsWindow)
 {
-    // Wrapper for simple calculation at this point. more complex implementations coming in future
-    return dAveragePower_db + dLevelAboveFloor;
+    if (!(fSmoothingFactor > 0 && fSmoothingFactor <= 1))
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Smoothing factor must be in (0, 1]");
+
+    if (strTrackerType == "Exponential")
+        m_NoiseFloorTrackerType = NoiseFloorTrackerType::Exponential;
+    else if (strTrackerType == "MinimumStatistics")
+    {
+        if (uMinimumStatisticsWindow == 0)
+            throw std::runtime_error(std::string(__FUNCTION__) + ": Minimum statistics requires a window of at least one chunk");
+        m_NoiseFloorTrackerType = NoiseFloorTrackerType::MinimumStatistics;
+    }
+    else
+        throw std::runtime_error(std::string(__FUNCTION__) + ": " + strTrackerType + " must be either Exponential or MinimumStatistics");
+
+    m_fNoiseFloorSmoothingFactor = fSmoothingFactor;
+    m_uMinimumStatisticsWindow = uMinimumStatisticsWindow;
+    m_mNoiseFloorStates.clear();
+
+    std::string strInfo = std::string(__FUNCTION__) + ": " + strTrackerType + " noise floor tracking enabled with smoothing factor " + std::to_string(fSmoothingFactor);
+    if (m_NoiseFloorTrackerType == NoiseFloorTrackerType::MinimumStatistics)
+        strInfo += " over " + std::to_string(uMinimumStatisticsWindow) + " chunk windows";
+    PLOG_INFO << strInfo;
 }
 
-std::shared_ptr<std::vector<std::vector<uint16_t>>> EnergyDetectionModule::GetDetectionBinIndicies(std::shared_ptr<FFTMagnitudeChunk> pFFTMagnitudeChunk, double dDetectionThreshold)
+EnergyDetectionModule::NoiseFloorState& EnergyDetectionModule::GetNoiseFloorState(const std::shared_ptr<FFTMagnitudeChunk>& pFFTMagnitudeChunk)
 {
-    auto pvvu16DetectionBins = std::make_shared<std::vector<std::vector<uint16_t>>>();
-    pvvu16DetectionBins->resize(pFFTMagnitudeChunk->m_uNumChannels);
+    auto& NoiseFloor = m_mNoiseFloorStates[m_SourceIndexCache.Intern(pFFTMagnitudeChunk->GetSourceIdentifier())];
 
-    // try pass
-    // Iterate and store indicies of threshold
-    for (unsigned uCurrentChannelIndex = 0; uCurrentChannelIndex < pFFTMagnitudeChunk->m_uNumChannels; uCurrentChannelIndex++)
+    unsigned uNumChannels = pFFTMagnitudeChunk->m_uNumChannels;
+    size_t uNumBins = pFFTMagnitudeChunk->m_dChunkSize;
+    if (NoiseFloor.uNumChannels == uNumChannels && NoiseFloor.uNumBins == uNumBins)
+        return NoiseFloor;
+
+    // Floors of a different resolution cannot be carried over, NaN marks each channel as unseeded
+    size_t uSize = (size_t)uNumChannels * uNumBins;
+    NoiseFloor.uNumChannels = uNumChannels;
+    NoiseFloor.uNumBins = uNumBins;
+    NoiseFloor.uChunksInWindow = 0;
+    NoiseFloor.vfNoiseFloor.assign(uSize, std::numeric_limits<float>::quiet_NaN());
+    if (m_NoiseFloorTrackerType == NoiseFloorTrackerType::MinimumStatistics)
+    {
+        NoiseFloor.vfSmoothedPower.assign(uSize, 0);
+        NoiseFloor.vfWindowMinimum.assign(uSize, 0);
+        NoiseFloor.vfPreviousWindowMinimum.assign(uSize, 0);
+    }
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Tracking noise floor of " + std::to_string(uNumChannels) + " channels with " + std::to_string(uNumBins) + " bins";
+    PLOG_INFO << strInfo;
+
+    return NoiseFloor;
+}
+
+void EnergyDetectionModule::UpdateNoiseFloor(NoiseFloorState& NoiseFloor, unsigned uChannelIndex)
+{
+    size_t uNumBins = NoiseFloor.uNumBins;
+    size_t uOffset = uChannelIndex * uNumBins;
+    const float* pfPower = m_vfBinPowerScratch.data();
+    float* pfNoiseFloor = NoiseFloor.vfNoiseFloor.data() + uOffset;
+    float fAlpha = m_fNoiseFloorSmoothingFactor;
+
+    if (m_NoiseFloorTrackerType == NoiseFloorTrackerType::Exponential)
     {
+        for (size_t uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+            pfNoiseFloor[uBinIndex] += fAlpha * (pfPower[uBinIndex] - pfNoiseFloor[uBinIndex]);
+        return;
+    }
+
+    // Minimum statistics, a signal occupying a bin for less than a window never raises its floor
+    float* pfSmoothed = NoiseFloor.vfSmoothedPower.data() + uOffset;
+    float* pfWindowMinimum = NoiseFloor.vfWindowMinimum.data() + uOffset;
+    float* pfPreviousMinimum = NoiseFloor.vfPreviousWindowMinimum.data() + uOffset;
 
-        for (unsigned uCurrentSampleIndex = 0; uCurrentSampleIndex < pFFTMagnitudeChunk->m_dChunkSize; uCurrentSampleIndex++)
+    // Two alternating windows let the floor rise again after at most two windows without a per bin history
+    bool bWindowComplete = NoiseFloor.uChunksInWindow + 1 >= m_uMinimumStatisticsWindow;
+    for (size_t uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+    {
+        pfSmoothed[uBinIndex] += fAlpha * (pfPower[uBinIndex] - pfSmoothed[uBinIndex]);
+        pfWindowMinimum[uBinIndex] = std::min(pfWindowMinimum[uBinIndex], pfSmoothed[uBinIndex]);
+        pfNoiseFloor[uBinIndex] = std::min(pfWindowMinimum[uBinIndex], pfPreviousMinimum[uBinIndex]);
+
+        if (bWindowComplete)
         {
+            pfPreviousMinimum[uBinIndex] = pfWindowMinimum[uBinIndex];
+            pfWindowMinimum[uBinIndex] = pfSmoothed[uBinIndex];
+        }
+    }
+}
+
+void EnergyDetectionModule::EnableEventClustering(unsigned uMaxGapBins)
+{
+    m_bEventClusteringEnabled = true;
+    m_uEventMaxGapBins = uMaxGapBins;
 
-            auto mag = pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[uCurrentChannelIndex][uCurrentSampleIndex];
-            auto pow = std::log(std::pow(mag, 2.0))/std::log(10);
+    std::string strInfo = std::string(__FUNCTION__) + ": Event clustering enabled allowing gaps of " + std::to_string(uMaxGapBins) + " bins";
+    PLOG_INFO << strInfo;
+}
+
+void EnergyDetectionModule::ClusterChannel(const std::vector<uint16_t>& vu16DetectionBins, size_t uNumBins, unsigned uChannelIndex, double dBinWidth_Hz, std::vector<DetectionEvent>& vDetectionEvents)
+{
+    const float* pfPower = m_vfBinPowerScratch.data();
 
-            // Now check and store
-            if (pow > dDetectionThreshold)
-                (*pvvu16DetectionBins)[uCurrentChannelIndex].emplace_back(uCurrentSampleIndex);
-            
+    size_t uRunStart = 0;
+    while (uRunStart < vu16DetectionBins.size())
+    {
+        // Extend the run while the next detection is within the allowed gap, tracking its strongest bin
+        size_t uRunEnd = uRunStart;
+        uint16_t u16PeakBin = vu16DetectionBins[uRunStart];
+        while (uRunEnd + 1 < vu16DetectionBins.size() && vu16DetectionBins[uRunEnd + 1] - vu16DetectionBins[uRunEnd] <= m_uEventMaxGapBins + 1)
+        {
+            uRunEnd++;
+            if (pfPower[vu16DetectionBins[uRunEnd]] > pfPower[u16PeakBin])
+                u16PeakBin = vu16DetectionBins[uRunEnd];
+        }
+
+        DetectionEvent Event;
+        Event.u16ChannelIndex = uChannelIndex;
+        Event.u16StartBin = vu16DetectionBins[uRunStart];
+        Event.u16EndBin = vu16DetectionBins[uRunEnd];
+        Event.u16PeakBin = u16PeakBin;
+        Event.fPeakBin = u16PeakBin;
+        Event.fPeakPower = pfPower[u16PeakBin];
+        Event.State = DetectionEventState::Active;
+
+        // Parabola through the log power of the peak and its neighbours, exact for a Gaussian shaped peak
+        if (u16PeakBin > 0 && u16PeakBin + 1 < uNumBins && pfPower[u16PeakBin - 1] > 0 && pfPower[u16PeakBin + 1] > 0)
+        {
+            float fAlpha = std::log(pfPower[u16PeakBin - 1]);
+            float fBeta = std::log(pfPower[u16PeakBin]);
+            float fGamma = std::log(pfPower[u16PeakBin + 1]);
+            float fCurvature = fAlpha - 2 * fBeta + fGamma;
+            if (fCurvature < 0)
+            {
+                float fOffset = 0.5f * (fAlpha - fGamma) / fCurvature;
+                Event.fPeakBin += fOffset;
+                Event.fPeakPower = std::exp(fBeta - 0.25f * (fAlpha - fGamma) * fOffset);
+            }
+        }
+
+        Event.fPeakFrequency_Hz = Event.fPeakBin * dBinWidth_Hz;
+        Event.fCentreFrequency_Hz = 0.5 * (Event.u16StartBin + Event.u16EndBin) * dBinWidth_Hz;
+        Event.fBandwidth_Hz = (Event.u16EndBin - Event.u16StartBin + 1) * dBinWidth_Hz;
+        vDetectionEvents.push_back(Event);
+
+        uRunStart = uRunEnd + 1;
+    }
+}
+
+void EnergyDetectionModule::EnablePersistenceGating(unsigned uRequiredDetections, unsigned uWindowFrames)
+{
+    if (uWindowFrames == 0 || uWindowFrames > 64)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Window must be between 1 and 64 frames");
+    if (uRequiredDetections == 0 || uRequiredDetections > uWindowFrames)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Required detections must be between 1 and the window length");
+
+    m_uPersistenceRequiredDetections = uRequiredDetections;
+    m_uPersistenceWindowFrames = uWindowFrames;
+    m_mPersistenceStates.clear();
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Detections gated on " + std::to_string(uRequiredDetections) + " of " + std::to_string(uWindowFrames) + " frames";
+    PLOG_INFO << strInfo;
+}
+
+EnergyDetectionModule::PersistenceState& EnergyDetectionModule::GetPersistenceState(const std::shared_ptr<FFTMagnitudeChunk>& pFFTMagnitudeChunk)
+{
+    auto& Persistence = m_mPersistenceStates[m_SourceIndexCache.Intern(pFFTMagnitudeChunk->GetSourceIdentifier())];
+
+    unsigned uNumChannels = pFFTMagnitudeChunk->m_uNumChannels;
+    size_t uNumBins = pFFTMagnitudeChunk->m_dChunkSize;
+    if (Persistence.uNumChannels == uNumChannels && Persistence.uNumBins == uNumBins)
+        return Persistence;
+
+    // Histories of a different resolution cannot be carried over
+    Persistence.uNumChannels = uNumChannels;
+    Persistence.uNumBins = uNumBins;
+    Persistence.vu64DetectionHistory.assign((size_t)uNumChannels * uNumBins, 0);
+    Persistence.vu8Confirmed.assign((size_t)uNumChannels * uNumBins, 0);
+
+    return Persistence;
+}
+
+void EnergyDetectionModule::GateChannel(PersistenceState& Persistence, unsigned uChannelIndex, std::vector<uint16_t>& vu16DetectionBins, double dBinWidth_Hz)
+{
+    size_t uNumBins = Persistence.uNumBins;
+    uint64_t* pu64History = Persistence.vu64DetectionHistory.data() + uChannelIndex * uNumBins;
+    uint8_t* pu8Confirmed = Persistence.vu8Confirmed.data() + uChannelIndex * uNumBins;
+    uint64_t u64WindowMask = m_uPersistenceWindowFrames == 64 ? ~0ull : (1ull << m_uPersistenceWindowFrames) - 1;
+    unsigned uRequired = m_uPersistenceRequiredDetections;
+
+    // One sequential sweep shifts every bin's history, detections are sorted so are merged in as it goes
+    size_t uNumDetections = vu16DetectionBins.size();
+    size_t uNextDetection = 0;
+    size_t uNumPassed = 0;
+    m_vu16LostBinScratch.clear();
+    for (size_t uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+    {
+        bool bDetected = uNextDetection < uNumDetections && vu16DetectionBins[uNextDetection] == uBinIndex;
+        uNextDetection += bDetected;
+
+        uint64_t u64History = ((pu64History[uBinIndex] << 1) | bDetected) & u64WindowMask;
+        pu64History[uBinIndex] = u64History;
+
+        if ((unsigned)std::popcount(u64History) >= uRequired)
+        {
+            pu8Confirmed[uBinIndex] = 1;
+            // Passed bins are a subset of the detections in the same order so are compacted in place
+            if (bDetected)
+                vu16DetectionBins[uNumPassed++] = uBinIndex;
+        }
+        else if (pu8Confirmed[uBinIndex])
+        {
+            pu8Confirmed[uBinIndex] = 0;
+            m_vu16LostBinScratch.emplace_back(uBinIndex);
         }
     }
+    vu16DetectionBins.resize(uNumPassed);
 
-    return pvvu16DetectionBins;
-}
\ No newline at end of file
+    // Ended bins are grouped the same way as detections, so a lost emitter is usually one event
+    size_t uFirstLostEvent = m_vLostEventScratch.size();
+    ClusterChannel(m_vu16LostBinScratch, uNumBins, uChannelIndex, dBinWidth_Hz, m_vLostEventScratch);
+    for (size_t uEventIndex = uFirstLostEvent; uEventIndex < m_vLostEventScratch.size(); uEventIndex++)
+        m_vLostEventScratch[uEventIndex].State = DetectionEventState::Lost;
+}
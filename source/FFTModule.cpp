@@ -5,45 +5,72 @@ FFTModule::FFTModule(unsigned uBufferSize) : BaseModule(uBufferSize)
     RegisterChunkCallbackFunction(ChunkType::TimeChunk, &FFTModule::Process_TimeChunk,(BaseModule*)this); 
 }
 
+FFTModule::~FFTModule()
+{
+    // The processing thread uses the worker pool and job queue so is stopped before they are destroyed
+    m_bShutDown = true;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void FFTModule::ContinuouslyTryProcess()
+{
+    while (!m_bShutDown)
+    {
+        std::shared_ptr<BaseChunk> pBaseChunk;
+        if (TakeFromBuffer(pBaseChunk))
+            Process(pBaseChunk);
+        else
+        {
+            // Wait to be notified that there is data available
+            std::unique_lock<std::mutex> BufferAccessLock(m_BufferStateMutex);
+            m_cvDataInBuffer.wait_for(BufferAccessLock, std::chrono::milliseconds(1),  [this] {return (!m_cbBaseChunkBuffer.empty() || m_bShutDown);});
+        }
+    }
+
+    // Chunks already handed to the workers are completed and passed on from this thread rather than dropped
+    if (m_pWorkerPool)
+        PassCompletedParallelJobs(0);
+}
+
 void FFTModule::Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk)
 {
     auto pTimeChunk = std::static_pointer_cast<TimeChunk>(pBaseChunk);
+
+    // Spectrogram and Welch frames are decoupled from the chunk size so are handled separately
+    if (m_bSTFTModeEnabled)
+    {
+        Process_STFT(pTimeChunk);
+        return;
+    }
+
     auto pFFTChunk = std::make_shared<FFTChunk>(pTimeChunk->m_dChunkSize/2 + 1, pTimeChunk->m_dSampleRate, pTimeChunk->m_i64TimeStamp, pTimeChunk->m_uNumChannels);
     pFFTChunk->SetSourceIdentifier(pTimeChunk->GetSourceIdentifier());
 
-    // Forward FFT configuration
-    kiss_fftr_cfg ForwardFFTConfig = kiss_fftr_alloc(pTimeChunk->m_dChunkSize, 0, NULL, NULL);
-
     // Convert to complex vector
     pFFTChunk->m_vvcfFFTChunks.resize(pTimeChunk->m_uNumChannels);
-
-    // Iterate through data channel
     for (uint16_t uChannelIndex = 0; uChannelIndex < pTimeChunk->m_uNumChannels; uChannelIndex++)
-    {
-
-        std::vector<float> vcfForwardFFTInput;
-        std::vector<std::complex<float>> vcfForwardFFTOutput(pTimeChunk->m_dChunkSize/2 +1, 0.0);
-
-        // And stoire time data in FFTChunk 
-        for (auto i16SubChunkSample : pTimeChunk->m_vvi16TimeChunks[uChannelIndex])
-            // Creating a complex value with only real component
-            vcfForwardFFTInput.emplace_back(i16SubChunkSample);
-
-        // And then take FFT
-        kiss_fftr(ForwardFFTConfig, vcfForwardFFTInput.data(), (kiss_fft_cpx*)&vcfForwardFFTOutput[0]);
+        pFFTChunk->m_vvcfFFTChunks[uChannelIndex].resize(pTimeChunk->m_dChunkSize/2 + 1);
 
-        // Rescale according to FFT gain
-        for (size_t i = 0; i < vcfForwardFFTOutput.size(); ++i)
-            vcfForwardFFTOutput[i] /= vcfForwardFFTOutput.size(); // Scale each element by 5
-
-        // And store data
-        pFFTChunk->m_vvcfFFTChunks[uChannelIndex] = vcfForwardFFTOutput;
+    // Hand the channels to the workers if running in parallel
+    if (m_pWorkerPool)
+    {
+        SubmitParallelFFT(pTimeChunk, pFFTChunk);
+        return;
     }
 
-    // Now free up memory
-    free(ForwardFFTConfig);
+    // Forward FFT configuration, allocated once per chunk size
+    kiss_fftr_cfg ForwardFFTConfig = m_FFTPlanCache.GetPlan(pTimeChunk->m_dChunkSize, false);
+
+    // Iterate through data channel and transform straight into the chunk
+    for (uint16_t uChannelIndex = 0; uChannelIndex < pTimeChunk->m_uNumChannels; uChannelIndex++)
+        TransformChannel(ForwardFFTConfig, m_vfFFTInputScratch, pTimeChunk->m_vvi16TimeChunks[uChannelIndex], pFFTChunk->m_vvcfFFTChunks[uChannelIndex]);
 
+    PassFFTResults(pTimeChunk, pFFTChunk);
+}
 
+void FFTModule::PassFFTResults(std::shared_ptr<TimeChunk> pTimeChunk, std::shared_ptr<FFTChunk> pFFTChunk)
+{
     if (m_bGenerateMagnitudeData) {
 
         // Create the chunk with attention to soruce identifier
@@ -52,8 +79,8 @@ void FFTModule::Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk)
 
         // Compute FFT magnitudes
         for (uint16_t uChannelIndex = 0; uChannelIndex < pTimeChunk->m_uNumChannels; ++uChannelIndex) {
-            std::transform(pFFTChunk->m_vvcfFFTChunks[uChannelIndex].begin(), pFFTChunk->m_vvcfFFTChunks[uChannelIndex].end(), pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[uChannelIndex].begin(),
-                [](std::complex<float> x) { return std::abs(x); });
+            const auto& vcfFFTBins = pFFTChunk->m_vvcfFFTChunks[uChannelIndex];
+            VectorKernelUtility::ComplexMagnitude(vcfFFTBins.data(), pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[uChannelIndex].data(), vcfFFTBins.size());
         }
 
         TryPassChunk(pFFTMagnitudeChunk);
@@ -61,4 +88,316 @@ void FFTModule::Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk)
     
     TryPassChunk(pTimeChunk);
     TryPassChunk(pFFTChunk);
+}
+
+void FFTModule::SetParallelWorkerCount(unsigned uNumWorkers)
+{
+    // Release anything still in flight before the workers are replaced
+    PassCompletedParallelJobs(0);
+    m_pWorkerPool.reset();
+
+    if (uNumWorkers <= 1)
+        return;
+
+    m_vpWorkerFFTStates.clear();
+    for (unsigned uWorkerIndex = 0; uWorkerIndex < uNumWorkers; uWorkerIndex++)
+        m_vpWorkerFFTStates.emplace_back(std::make_unique<WorkerFFTState>());
+
+    m_pWorkerPool = std::make_unique<WorkerPool>(uNumWorkers);
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Parallel FFT enabled with " + std::to_string(uNumWorkers) + " workers";
+    PLOG_INFO << strInfo;
+}
+
+void FFTModule::SubmitParallelFFT(std::shared_ptr<TimeChunk> pTimeChunk, std::shared_ptr<FFTChunk> pFFTChunk)
+{
+    auto pParallelFFTJob = std::make_shared<ParallelFFTJob>();
+    pParallelFFTJob->pTimeChunk = pTimeChunk;
+    pParallelFFTJob->pFFTChunk = pFFTChunk;
+    pParallelFFTJob->uChannelsRemaining = pTimeChunk->m_uNumChannels;
+
+    {
+        std::unique_lock<std::mutex> JobLock(m_ParallelJobMutex);
+        m_dqParallelFFTJobs.push_back(pParallelFFTJob);
+    }
+
+    // Each channel is an independent task so channels of one chunk and chunks of different sources overlap
+    for (uint16_t uChannelIndex = 0; uChannelIndex < pTimeChunk->m_uNumChannels; uChannelIndex++)
+    {
+        m_pWorkerPool->Submit([this, pParallelFFTJob, uChannelIndex](unsigned uWorkerIndex)
+        {
+            auto& WorkerState = *m_vpWorkerFFTStates[uWorkerIndex];
+            const auto& pJobTimeChunk = pParallelFFTJob->pTimeChunk;
+
+            kiss_fftr_cfg ForwardFFTConfig = WorkerState.PlanCache.GetPlan(pJobTimeChunk->m_dChunkSize, false);
+            TransformChannel(ForwardFFTConfig, WorkerState.vfInputScratch, pJobTimeChunk->m_vvi16TimeChunks[uChannelIndex], pParallelFFTJob->pFFTChunk->m_vvcfFFTChunks[uChannelIndex]);
+
+            if (--pParallelFFTJob->uChannelsRemaining == 0)
+            {
+                std::unique_lock<std::mutex> JobLock(m_ParallelJobMutex);
+                m_cvParallelJobComplete.notify_all();
+            }
+        });
+    }
+
+    // Keep the number of chunks in flight bounded and flush everything once the input buffer runs dry
+    bool bInputBufferEmpty;
+    {
+        std::unique_lock<std::mutex> BufferAccessLock(m_BufferStateMutex);
+        bInputBufferEmpty = m_cbBaseChunkBuffer.empty();
+    }
+    PassCompletedParallelJobs(bInputBufferEmpty ? 0 : 2 * m_pWorkerPool->GetWorkerCount());
+}
+
+void FFTModule::PassCompletedParallelJobs(size_t uMaxJobsInFlight)
+{
+    while (true)
+    {
+        std::shared_ptr<ParallelFFTJob> pParallelFFTJob;
+        {
+            std::unique_lock<std::mutex> JobLock(m_ParallelJobMutex);
+            if (m_dqParallelFFTJobs.empty())
+                return;
+
+            // Results are only released from the front so per source order is kept
+            auto& pOldestJob = m_dqParallelFFTJobs.front();
+            if (m_dqParallelFFTJobs.size() > uMaxJobsInFlight)
+                m_cvParallelJobComplete.wait(JobLock, [&pOldestJob] { return pOldestJob->uChannelsRemaining == 0; });
+            else if (pOldestJob->uChannelsRemaining != 0)
+                return;
+
+            pParallelFFTJob = std::move(pOldestJob);
+            m_dqParallelFFTJobs.pop_front();
+        }
+
+        PassFFTResults(pParallelFFTJob->pTimeChunk, pParallelFFTJob->pFFTChunk);
+    }
+}
+
+uint64_t FFTModule::GetFFTPathAllocationCount() const
+{
+    uint64_t u64AllocationCount = m_FFTPlanCache.GetAllocationCount() + m_u64ScratchAllocationCount;
+    for (const auto& pWorkerFFTState : m_vpWorkerFFTStates)
+        u64AllocationCount += pWorkerFFTState->PlanCache.GetAllocationCount();
+
+    return u64AllocationCount;
+}
+
+void FFTModule::TransformChannel(kiss_fftr_cfg pForwardFFTConfig, std::vector<float>& vfInputScratch, const std::vector<int16_t>& vi16TimeData, std::vector<std::complex<float>>& vcfForwardFFTOutput)
+{
+    // Only grow the scratch buffer when a larger chunk arrives
+    EnsureScratchSize(vfInputScratch, vi16TimeData.size());
+
+    // Creating real values from the time data
+    VectorKernelUtility::ConvertInt16ToFloat(vi16TimeData.data(), vfInputScratch.data(), vi16TimeData.size());
+
+    // And then take FFT
+    kiss_fftr(pForwardFFTConfig, vfInputScratch.data(), (kiss_fft_cpx*)vcfForwardFFTOutput.data());
+
+    // Rescale according to FFT gain
+    float fScale = 1.0f / vcfForwardFFTOutput.size();
+    VectorKernelUtility::Scale((float*)vcfForwardFFTOutput.data(), 2 * vcfForwardFFTOutput.size(), fScale);
+}
+
+void FFTModule::EnableSTFTMode(unsigned uFFTLength, unsigned uHopLength, const std::string& strWindowType)
+{
+    if (uFFTLength == 0 || uFFTLength % 2 != 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": FFT length must be even and non zero");
+
+    if (uHopLength == 0 || uHopLength > uFFTLength)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Hop length must be between 1 and the FFT length");
+
+    m_uSTFTLength = uFFTLength;
+    m_uSTFTHopLength = uHopLength;
+    m_vfSTFTWindow = WindowFunctionUtility::GenerateWindow(strWindowType, uFFTLength);
+    m_fSTFTWindowGain = WindowFunctionUtility::CalculateCoherentGain(m_vfSTFTWindow);
+    m_mSTFTSourceStates.clear();
+    m_bSTFTModeEnabled = true;
+    m_bWelchModeEnabled = false;
+
+    std::string strInfo = std::string(__FUNCTION__) + ": STFT mode enabled with " + strWindowType + " window, FFT length " + std::to_string(uFFTLength) + " and hop " + std::to_string(uHopLength);
+    PLOG_INFO << strInfo;
+}
+
+void FFTModule::EnableWelchMode(unsigned uFFTLength, unsigned uHopLength, const std::string& strWindowType, unsigned uNumAverages, float fExponentialAveragingFactor)
+{
+    if (uNumAverages == 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Number of averages must be non zero");
+
+    if (fExponentialAveragingFactor < 0 || fExponentialAveragingFactor > 1)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Exponential averaging factor must be between 0 and 1");
+
+    // Welch framing is identical to the STFT, only what is done with each frame differs
+    EnableSTFTMode(uFFTLength, uHopLength, strWindowType);
+    m_uWelchAverages = uNumAverages;
+    m_fWelchExponentialFactor = fExponentialAveragingFactor;
+    m_bWelchModeEnabled = true;
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Welch mode enabled averaging " + std::to_string(uNumAverages) + " frames" + (fExponentialAveragingFactor > 0 ? " exponentially" : "");
+    PLOG_INFO << strInfo;
+}
+
+void FFTModule::Process_STFT(std::shared_ptr<TimeChunk> pTimeChunk)
+{
+    auto& STFTSourceState = m_mSTFTSourceStates[m_SourceIndexCache.Intern(pTimeChunk->GetSourceIdentifier())];
+    unsigned uNumChannels = pTimeChunk->m_uNumChannels;
+    unsigned uNumBins = m_uSTFTLength/2 + 1;
+    size_t uChunkLength = pTimeChunk->m_dChunkSize;
+
+    // A new source or a change in its format invalidates the history
+    if (STFTSourceState.vChannelHistory.size() != uNumChannels || STFTSourceState.dSampleRate != pTimeChunk->m_dSampleRate)
+    {
+        STFTSourceState.vChannelHistory.assign(uNumChannels, RingBuffer<float>(m_uSTFTLength));
+        STFTSourceState.uSamplesUntilNextFrame = m_uSTFTLength;
+        STFTSourceState.dSampleRate = pTimeChunk->m_dSampleRate;
+        STFTSourceState.u64FramesProcessed = 0;
+        STFTSourceState.vvfPowerAccumulators.assign(m_bWelchModeEnabled ? uNumChannels : 0, std::vector<float>(uNumBins, 0.0f));
+    }
+
+    // Work out how many frames become due in this chunk so the output can be filled in place
+    unsigned uNumFrames = 0;
+    if (STFTSourceState.uSamplesUntilNextFrame <= uChunkLength)
+        uNumFrames = 1 + (uChunkLength - STFTSourceState.uSamplesUntilNextFrame) / m_uSTFTHopLength;
+
+    std::shared_ptr<SpectrogramChunk> pSpectrogramChunk;
+    std::vector<std::shared_ptr<FFTMagnitudeChunk>> vpWelchChunks;
+    if (uNumFrames)
+    {
+        // The first frame ends within this chunk so may start in an earlier one
+        int64_t i64FirstFrameOffset = (int64_t)STFTSourceState.uSamplesUntilNextFrame - (int64_t)m_uSTFTLength;
+        int64_t i64FirstFrameTimeStamp = (int64_t)pTimeChunk->m_i64TimeStamp + (int64_t)(1e6 * i64FirstFrameOffset / pTimeChunk->m_dSampleRate);
+
+        if (!m_bWelchModeEnabled)
+        {
+            pSpectrogramChunk = std::make_shared<SpectrogramChunk>(pTimeChunk->m_dSampleRate, i64FirstFrameTimeStamp, uNumChannels, uNumFrames, uNumBins, m_uSTFTLength, m_uSTFTHopLength);
+            pSpectrogramChunk->SetSourceIdentifier(pTimeChunk->GetSourceIdentifier());
+        }
+        else
+        {
+            // One output per averaging period completed in this chunk, stamped with the start of its first frame
+            uint64_t u64FirstPeriod = STFTSourceState.u64FramesProcessed / m_uWelchAverages;
+            uint64_t u64EndPeriod = (STFTSourceState.u64FramesProcessed + uNumFrames) / m_uWelchAverages;
+            for (uint64_t u64Period = u64FirstPeriod; u64Period < u64EndPeriod; u64Period++)
+            {
+                int64_t i64FramesFromFirst = (int64_t)(u64Period * m_uWelchAverages) - (int64_t)STFTSourceState.u64FramesProcessed;
+                int64_t i64PeriodTimeStamp = i64FirstFrameTimeStamp + (int64_t)(1e6 * i64FramesFromFirst * m_uSTFTHopLength / pTimeChunk->m_dSampleRate);
+
+                auto pWelchChunk = std::make_shared<FFTMagnitudeChunk>(uNumBins, pTimeChunk->m_dSampleRate, i64PeriodTimeStamp, uNumChannels);
+                pWelchChunk->SetSourceIdentifier(pTimeChunk->GetSourceIdentifier());
+                vpWelchChunks.push_back(pWelchChunk);
+            }
+            EnsureScratchSize(m_vfWelchFrameScratch, uNumBins);
+        }
+    }
+
+    kiss_fftr_cfg ForwardFFTConfig = m_FFTPlanCache.GetPlan(m_uSTFTLength, false);
+    EnsureScratchSize(m_vfChunkScratch, uChunkLength);
+
+    // Every channel history holds the same number of samples so each can be stepped through independently
+    unsigned uSamplesUntilNextFrame = STFTSourceState.uSamplesUntilNextFrame;
+    for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels; uChannelIndex++)
+    {
+        auto& History = STFTSourceState.vChannelHistory[uChannelIndex];
+        const auto& vi16TimeData = pTimeChunk->m_vvi16TimeChunks[uChannelIndex];
+        VectorKernelUtility::ConvertInt16ToFloat(vi16TimeData.data(), m_vfChunkScratch.data(), uChunkLength);
+
+        size_t uSampleIndex = 0;
+        unsigned uFrameIndex = 0;
+        unsigned uWelchChunkIndex = 0;
+        uSamplesUntilNextFrame = STFTSourceState.uSamplesUntilNextFrame;
+
+        while (uSampleIndex < uChunkLength)
+        {
+            // Push samples up to the end of the next frame
+            size_t uSamplesToPush = std::min<size_t>(uSamplesUntilNextFrame, uChunkLength - uSampleIndex);
+            History.Push(&m_vfChunkScratch[uSampleIndex], uSamplesToPush);
+            uSampleIndex += uSamplesToPush;
+            uSamplesUntilNextFrame -= uSamplesToPush;
+
+            if (uSamplesUntilNextFrame == 0)
+            {
+                if (!m_bWelchModeEnabled)
+                    TransformSTFTFrame(ForwardFFTConfig, History, pSpectrogramChunk->GetFrame(uChannelIndex, uFrameIndex));
+                else
+                {
+                    TransformSTFTFrame(ForwardFFTConfig, History, m_vfWelchFrameScratch.data());
+
+                    // Only frames closing a period produce output
+                    uint64_t u64FrameIndex = STFTSourceState.u64FramesProcessed + uFrameIndex;
+                    float* pfOutput = nullptr;
+                    if ((u64FrameIndex + 1) % m_uWelchAverages == 0)
+                        pfOutput = vpWelchChunks[uWelchChunkIndex++]->m_vvfFFTMagnitudeChunks[uChannelIndex].data();
+
+                    AccumulateWelchFrame(m_vfWelchFrameScratch.data(), STFTSourceState.vvfPowerAccumulators[uChannelIndex], u64FrameIndex, pfOutput);
+                }
+
+                uFrameIndex++;
+                uSamplesUntilNextFrame = m_uSTFTHopLength;
+            }
+        }
+
+        assert(uFrameIndex == uNumFrames);
+    }
+    STFTSourceState.uSamplesUntilNextFrame = uSamplesUntilNextFrame;
+    STFTSourceState.u64FramesProcessed += uNumFrames;
+
+    TryPassChunk(pTimeChunk);
+    if (pSpectrogramChunk)
+        TryPassChunk(pSpectrogramChunk);
+    for (auto& pWelchChunk : vpWelchChunks)
+        TryPassChunk(pWelchChunk);
+}
+
+void FFTModule::AccumulateWelchFrame(const float* pfMagnitudes, std::vector<float>& vfPowerAccumulator, uint64_t u64FrameIndex, float* pfOutput)
+{
+    unsigned uNumBins = vfPowerAccumulator.size();
+
+    if (m_fWelchExponentialFactor > 0)
+    {
+        // Exponential averaging carries across periods, seeded by the very first frame
+        float fWeight = (u64FrameIndex == 0) ? 1.0f : m_fWelchExponentialFactor;
+        for (unsigned uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+        {
+            float fPower = pfMagnitudes[uBinIndex] * pfMagnitudes[uBinIndex];
+            vfPowerAccumulator[uBinIndex] += fWeight * (fPower - vfPowerAccumulator[uBinIndex]);
+        }
+
+        if (pfOutput)
+            for (unsigned uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+                pfOutput[uBinIndex] = std::sqrt(vfPowerAccumulator[uBinIndex]);
+        return;
+    }
+
+    // Plain mean, the accumulator is a running sum cleared at the end of each period
+    for (unsigned uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+        vfPowerAccumulator[uBinIndex] += pfMagnitudes[uBinIndex] * pfMagnitudes[uBinIndex];
+
+    if (pfOutput)
+    {
+        float fNormalisation = 1.0f / m_uWelchAverages;
+        for (unsigned uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++)
+        {
+            pfOutput[uBinIndex] = std::sqrt(vfPowerAccumulator[uBinIndex] * fNormalisation);
+            vfPowerAccumulator[uBinIndex] = 0.0f;
+        }
+    }
+}
+
+void FFTModule::TransformSTFTFrame(kiss_fftr_cfg pForwardFFTConfig, const RingBuffer<float>& History, float* pfMagnitudes)
+{
+    EnsureScratchSize(m_vfFFTInputScratch, m_uSTFTLength);
+    EnsureScratchSize(m_vcfFFTOutputScratch, m_uSTFTLength/2 + 1);
+
+    // Unroll the history while applying the window
+    auto [FirstSpan, SecondSpan] = History.Peek(0, m_uSTFTLength);
+    VectorKernelUtility::Multiply(FirstSpan.data(), m_vfSTFTWindow.data(), m_vfFFTInputScratch.data(), FirstSpan.size());
+    VectorKernelUtility::Multiply(SecondSpan.data(), m_vfSTFTWindow.data() + FirstSpan.size(), m_vfFFTInputScratch.data() + FirstSpan.size(), SecondSpan.size());
+
+    kiss_fftr(pForwardFFTConfig, m_vfFFTInputScratch.data(), (kiss_fft_cpx*)m_vcfFFTOutputScratch.data());
+
+    // Same scaling as the FFT chunks, corrected for the window attenuation
+    unsigned uNumBins = m_uSTFTLength/2 + 1;
+    float fScale = 1.0f / (uNumBins * m_fSTFTWindowGain);
+    VectorKernelUtility::ComplexMagnitude(m_vcfFFTOutputScratch.data(), pfMagnitudes, uNumBins);
+    VectorKernelUtility::Scale(pfMagnitudes, uNumBins, fScale);
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "FFTPlanCache.h"
+
+FFTPlanCache::~FFTPlanCache()
+{
+    for (auto& [PlanKey, pPlan] : m_mPlans)
+        kiss_fftr_free(pPlan);
+}
+
+kiss_fftr_cfg FFTPlanCache::GetPlan(unsigned uFFTLength, bool bInverse)
+{
+    auto PlanKey = std::make_pair(uFFTLength, bInverse);
+    auto itPlan = m_mPlans.find(PlanKey);
+    if (itPlan != m_mPlans.end())
+        return itPlan->second;
+
+    // kiss_fftr only supports even real transform lengths and returns null otherwise
+    kiss_fftr_cfg pPlan = kiss_fftr_alloc(uFFTLength, bInverse ? 1 : 0, NULL, NULL);
+    if (pPlan == NULL)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Unable to allocate FFT plan of length " + std::to_string(uFFTLength));
+
+    m_u64AllocationCount++;
+    m_mPlans[PlanKey] = pPlan;
+    return pPlan;
+}
@@ -0,0 +1,126 @@
+#include "FIRFilterModule.h"
+
+FIRFilterModule::FIRFilterModule(unsigned uBufferSize,
+                                 nlohmann::json_abi_v3_11_2::json jsonConfig)
+    : BaseModule(uBufferSize),
+      m_vfFilterCoefficients(CheckAndThrowJSON<std::vector<float>>(
+          jsonConfig, "FilterCoefficients")),
+      m_uFFTLength(GetBlockFFTLength(m_vfFilterCoefficients.size())) {
+
+  if (m_vfFilterCoefficients.empty())
+    throw std::runtime_error(std::string(__FUNCTION__) +
+                             ": At least one filter coefficient is required");
+
+  // Plans, spectrum and scratch depend only on the taps so are made once here
+  m_ForwardFFTConfig = m_FFTPlanCache.GetPlan(m_uFFTLength, false);
+  m_InverseFFTConfig = m_FFTPlanCache.GetPlan(m_uFFTLength, true);
+  m_vfBlockScratch.resize(m_uFFTLength);
+  m_vcfSpectrumScratch.resize(m_uFFTLength / 2 + 1);
+
+  // Zero pad the taps to the block length and transform once
+  std::vector<float> vfPaddedTaps(m_uFFTLength, 0.0f);
+  std::copy(m_vfFilterCoefficients.begin(), m_vfFilterCoefficients.end(),
+            vfPaddedTaps.begin());
+  m_vcfFilterSpectrum.resize(m_uFFTLength / 2 + 1);
+  kiss_fftr(m_ForwardFFTConfig, vfPaddedTaps.data(),
+            (kiss_fft_cpx *)m_vcfFilterSpectrum.data());
+
+  // The inverse transform is unnormalised so fold its 1/N in here
+  VectorKernelUtility::Scale((float *)m_vcfFilterSpectrum.data(),
+                             2 * m_vcfFilterSpectrum.size(),
+                             1.0f / m_uFFTLength);
+
+  RegisterChunkCallbackFunction(ChunkType::TimeChunk,
+                                &FIRFilterModule::Process_TimeChunk,
+                                (BaseModule *)this);
+}
+
+unsigned FIRFilterModule::GetBlockFFTLength(size_t uNumTaps) {
+  unsigned uFFTLength = 2;
+  while (uFFTLength < 4 * uNumTaps)
+    uFFTLength <<= 1;
+  return uFFTLength;
+}
+
+void FIRFilterModule::Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk) {
+  auto pTimeChunk = std::static_pointer_cast<TimeChunk>(pBaseChunk);
+  auto &State = m_mSourceStates[m_SourceIndexCache.Intern(pTimeChunk->GetSourceIdentifier())];
+  unsigned uNumChannels = pTimeChunk->m_uNumChannels;
+  size_t uChunkLength = pTimeChunk->m_dChunkSize;
+  size_t uHistoryLength = m_vfFilterCoefficients.size() - 1;
+
+  // A new source or a change in its format starts from silence
+  if (State.vvfChannelHistory.size() != uNumChannels ||
+      State.dSampleRate != pTimeChunk->m_dSampleRate) {
+    State.vvfChannelHistory.assign(uNumChannels,
+                                   std::vector<float>(uHistoryLength, 0.0f));
+    State.dSampleRate = pTimeChunk->m_dSampleRate;
+  }
+
+  // Output shares the metadata of the input but none of its samples
+  auto pFilteredChunk = std::make_shared<TimeChunk>(
+      pTimeChunk->m_dChunkSize, pTimeChunk->m_dSampleRate,
+      pTimeChunk->m_i64TimeStamp, pTimeChunk->m_uNumBytes * 8,
+      pTimeChunk->m_uNumBytes, uNumChannels);
+  pFilteredChunk->SetSourceIdentifier(pTimeChunk->GetSourceIdentifier());
+  pFilteredChunk->m_vvi16TimeChunks.resize(uNumChannels);
+
+  // Each block yields FFT length - taps + 1 outputs free of circular wrap
+  size_t uMaxStepLength = m_uFFTLength - uHistoryLength;
+  for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels;
+       uChannelIndex++) {
+    const auto &vi16InputData = pTimeChunk->m_vvi16TimeChunks[uChannelIndex];
+    auto &vi16FilteredData = pFilteredChunk->m_vvi16TimeChunks[uChannelIndex];
+    vi16FilteredData.resize(uChunkLength);
+
+    for (size_t uStepStart = 0; uStepStart < uChunkLength;
+         uStepStart += uMaxStepLength)
+      FilterStep(State.vvfChannelHistory[uChannelIndex],
+                 vi16InputData.data() + uStepStart,
+                 vi16FilteredData.data() + uStepStart,
+                 std::min(uMaxStepLength, uChunkLength - uStepStart));
+  }
+
+  TryPassChunk(pFilteredChunk);
+}
+
+void FIRFilterModule::FilterStep(std::vector<float> &vfHistory,
+                                 const int16_t *pi16Input, int16_t *pi16Output,
+                                 size_t uStepLength) {
+  size_t uHistoryLength = vfHistory.size();
+  unsigned uNumBins = m_uFFTLength / 2 + 1;
+  float *pfBlock = m_vfBlockScratch.data();
+
+  // Block is [history | step | zeros], zeros never reach valid outputs
+  std::copy(vfHistory.begin(), vfHistory.end(), pfBlock);
+  VectorKernelUtility::ConvertInt16ToFloat(pi16Input, pfBlock + uHistoryLength,
+                                           uStepLength);
+  std::fill(pfBlock + uHistoryLength + uStepLength, pfBlock + m_uFFTLength,
+            0.0f);
+
+  // Carry the newest samples before the block is reused for output
+  std::copy(pfBlock + uStepLength, pfBlock + uStepLength + uHistoryLength,
+            vfHistory.begin());
+
+  kiss_fftr(m_ForwardFFTConfig, pfBlock,
+            (kiss_fft_cpx *)m_vcfSpectrumScratch.data());
+
+  // Explicit complex product avoids the NaN handling of std::complex
+  float *pfSpectrum = (float *)m_vcfSpectrumScratch.data();
+  const float *pfFilterSpectrum = (const float *)m_vcfFilterSpectrum.data();
+  for (unsigned uBinIndex = 0; uBinIndex < uNumBins; uBinIndex++) {
+    float fReal = pfSpectrum[2 * uBinIndex];
+    float fImag = pfSpectrum[2 * uBinIndex + 1];
+    float fFilterReal = pfFilterSpectrum[2 * uBinIndex];
+    float fFilterImag = pfFilterSpectrum[2 * uBinIndex + 1];
+    pfSpectrum[2 * uBinIndex] = fReal * fFilterReal - fImag * fFilterImag;
+    pfSpectrum[2 * uBinIndex + 1] = fReal * fFilterImag + fImag * fFilterReal;
+  }
+
+  kiss_fftri(m_InverseFFTConfig, (kiss_fft_cpx *)m_vcfSpectrumScratch.data(),
+             pfBlock);
+
+  // Outputs before the end of the history are corrupted by circular wrap
+  VectorKernelUtility::ConvertFloatToInt16(pfBlock + uHistoryLength, pi16Output,
+                                           uStepLength);
+}
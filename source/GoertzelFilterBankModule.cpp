@@ -0,0 +1,118 @@
+#include "GoertzelFilterBankModule.h"
+
+GoertzelFilterBankModule::GoertzelFilterBankModule(
+    unsigned uBufferSize, nlohmann::json_abi_v3_11_2::json jsonConfig)
+    : BaseModule(uBufferSize),
+      m_vfTargetFrequencies_Hz(CheckAndThrowJSON<std::vector<float>>(
+          jsonConfig, "TargetFrequencies_Hz")),
+      m_uBlockLength(CheckAndThrowJSON<unsigned>(jsonConfig, "BlockLength")) {
+
+  if (m_vfTargetFrequencies_Hz.empty())
+    throw std::runtime_error(std::string(__FUNCTION__) +
+                             ": At least one target frequency is required");
+
+  if (m_uBlockLength == 0)
+    throw std::runtime_error(std::string(__FUNCTION__) +
+                             ": Block length must be non zero");
+
+  RegisterChunkCallbackFunction(ChunkType::TimeChunk,
+                                &GoertzelFilterBankModule::Process_TimeChunk,
+                                (BaseModule *)this);
+}
+
+void GoertzelFilterBankModule::ResetSourceState(GoertzelSourceState &State,
+                                                double dSampleRate,
+                                                unsigned uNumChannels) {
+  unsigned uNumTones = m_vfTargetFrequencies_Hz.size();
+
+  State.dSampleRate = dSampleRate;
+  State.uNumChannels = uNumChannels;
+  State.uSamplesInBlock = 0;
+  State.vdState1.assign((size_t)uNumChannels * uNumTones, 0.0);
+  State.vdState2.assign((size_t)uNumChannels * uNumTones, 0.0);
+
+  // Tones need not sit on a bin centre, the coefficient uses the exact
+  // frequency
+  State.vdCoefficients.resize(uNumTones);
+  for (unsigned uToneIndex = 0; uToneIndex < uNumTones; uToneIndex++)
+    State.vdCoefficients[uToneIndex] =
+        2.0 * std::cos(2.0 * M_PI * m_vfTargetFrequencies_Hz[uToneIndex] /
+                       dSampleRate);
+}
+
+void GoertzelFilterBankModule::Process_TimeChunk(
+    std::shared_ptr<BaseChunk> pBaseChunk) {
+  auto pTimeChunk = std::static_pointer_cast<TimeChunk>(pBaseChunk);
+  auto &State = m_mSourceStates[m_SourceIndexCache.Intern(pTimeChunk->GetSourceIdentifier())];
+  unsigned uNumChannels = pTimeChunk->m_uNumChannels;
+  unsigned uNumTones = m_vfTargetFrequencies_Hz.size();
+  size_t uChunkLength = pTimeChunk->m_dChunkSize;
+
+  // A new source or a change in its format invalidates the filters
+  if (State.uNumChannels != uNumChannels ||
+      State.dSampleRate != pTimeChunk->m_dSampleRate)
+    ResetSourceState(State, pTimeChunk->m_dSampleRate, uNumChannels);
+
+  // Size the output for the blocks which complete within this chunk
+  unsigned uNumBlocks = (State.uSamplesInBlock + uChunkLength) / m_uBlockLength;
+  std::shared_ptr<TonePowerChunk> pTonePowerChunk;
+  if (uNumBlocks) {
+    // The first block may have started in an earlier chunk
+    int64_t i64FirstBlockTimeStamp =
+        (int64_t)pTimeChunk->m_i64TimeStamp -
+        (int64_t)(1e6 * State.uSamplesInBlock / pTimeChunk->m_dSampleRate);
+
+    pTonePowerChunk = std::make_shared<TonePowerChunk>(
+        pTimeChunk->m_dSampleRate, i64FirstBlockTimeStamp, uNumChannels,
+        uNumBlocks, m_uBlockLength, m_vfTargetFrequencies_Hz);
+    pTonePowerChunk->SetSourceIdentifier(pTimeChunk->GetSourceIdentifier());
+  }
+
+  // Normalised so a tone of amplitude A centred on the filter reads A^2
+  double dPowerScale = 4.0 / ((double)m_uBlockLength * m_uBlockLength);
+
+  unsigned uSamplesInBlock = State.uSamplesInBlock;
+  for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels;
+       uChannelIndex++) {
+    const auto &vi16TimeData = pTimeChunk->m_vvi16TimeChunks[uChannelIndex];
+    double *pdState1 = &State.vdState1[(size_t)uChannelIndex * uNumTones];
+    double *pdState2 = &State.vdState2[(size_t)uChannelIndex * uNumTones];
+    const double *pdCoefficients = State.vdCoefficients.data();
+
+    unsigned uBlockIndex = 0;
+    uSamplesInBlock = State.uSamplesInBlock;
+    for (size_t uSampleIndex = 0; uSampleIndex < uChunkLength;
+         uSampleIndex++) {
+      // The tones are independent recurrences so the inner loop pipelines well
+      double dSample = vi16TimeData[uSampleIndex];
+      for (unsigned uToneIndex = 0; uToneIndex < uNumTones; uToneIndex++) {
+        double dState0 = dSample + pdCoefficients[uToneIndex] *
+                                       pdState1[uToneIndex] -
+                         pdState2[uToneIndex];
+        pdState2[uToneIndex] = pdState1[uToneIndex];
+        pdState1[uToneIndex] = dState0;
+      }
+
+      if (++uSamplesInBlock < m_uBlockLength)
+        continue;
+
+      // Block complete, read out the power and restart the filters
+      float *pfPowers = pTonePowerChunk->GetBlock(uChannelIndex, uBlockIndex++);
+      for (unsigned uToneIndex = 0; uToneIndex < uNumTones; uToneIndex++) {
+        double dPower = pdState1[uToneIndex] * pdState1[uToneIndex] +
+                        pdState2[uToneIndex] * pdState2[uToneIndex] -
+                        pdCoefficients[uToneIndex] * pdState1[uToneIndex] *
+                            pdState2[uToneIndex];
+        pfPowers[uToneIndex] = dPower * dPowerScale;
+        pdState1[uToneIndex] = 0.0;
+        pdState2[uToneIndex] = 0.0;
+      }
+      uSamplesInBlock = 0;
+    }
+  }
+  State.uSamplesInBlock = uSamplesInBlock;
+
+  TryPassChunk(pTimeChunk);
+  if (pTonePowerChunk)
+    TryPassChunk(pTonePowerChunk);
+}
@@ -1,5 +1,5 @@
 #include "LinuxMultiClientTCPTxModule.h"
-#include "ByteChunk.h"
+#include "ByteFragmentChunk.h"
 #include <cstdint>
 #include <signal.h>
 
@@ -164,12 +164,11 @@ void LinuxMultiClientTCPTxModule::RunClientThread(
       if (TakeFromBuffer(pBaseChunk)) {
         // Cast it back to a UDP chunk
         auto pByteChunk = std::static_pointer_cast<ByteChunk>(pBaseChunk);
-        const auto pvcData = pByteChunk->m_vcDataChunk;
-        size_t length = pvcData.size();
 
-        // And then transmit (wohoo!!!)
-        int bytes_sent = send(clientSocket, &pvcData[0], length, 0);
-        if (bytes_sent < 0) {
+        // And then transmit (wohoo!!!), fragments go out straight from the
+        // shared serialised chunk
+        bool bSent = ByteFragmentChunk::WriteToSocket(clientSocket, pByteChunk);
+        if (!bSent) {
           std::string strInfo = std::string(__FUNCTION__) +
                                 ": No data transmitted on port " +
                                 std::to_string(u16AllocatedPortNumber);
@@ -0,0 +1,330 @@
+#include "MultilaterationModule.h"
+
+namespace
+{
+    // WGS84 ellipsoid
+    constexpr double dSemiMajorAxis_m = 6378137.0;
+    constexpr double dFlattening = 1.0 / 298.257223563;
+    constexpr double dEccentricitySquared = dFlattening * (2 - dFlattening);
+    constexpr double dDegreesToRadians = M_PI / 180.0;
+}
+
+MultilaterationModule::MultilaterationModule(unsigned uBufferSize, double dPropagationVelocity_mps, float fMinConfidence, unsigned uMaxIterations) :
+    BaseModule(uBufferSize),
+    m_dPropagationVelocity_mps(dPropagationVelocity_mps),
+    m_fMinConfidence(fMinConfidence),
+    m_uMaxIterations(uMaxIterations)
+{
+    if (dPropagationVelocity_mps <= 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Propagation velocity must be positive");
+
+    RegisterChunkCallbackFunction(ChunkType::TDOAEstimateChunk, &MultilaterationModule::Process_TDOAEstimateChunk, (BaseModule*)this);
+}
+
+void MultilaterationModule::Process_TDOAEstimateChunk(std::shared_ptr<BaseChunk> pBaseChunk)
+{
+    auto pTDOAEstimateChunk = std::static_pointer_cast<TDOAEstimateChunk>(pBaseChunk);
+    unsigned uNumSensors = pTDOAEstimateChunk->m_uNumSensors;
+
+    UpdateGeometry(*pTDOAEstimateChunk);
+
+    // A delay is only known to within its sample period, and less well when the correlation peak is weak
+    double dSampleRangeDeviation_m = m_dPropagationVelocity_mps / (pTDOAEstimateChunk->m_dSampleRate * std::sqrt(12.0));
+
+    m_vRangeDifferences.clear();
+    std::vector<float> vfTotalConfidence(uNumSensors, 0.0f);
+    for (unsigned uFirstSensor = 0; uFirstSensor < uNumSensors; uFirstSensor++)
+    {
+        for (unsigned uSecondSensor = uFirstSensor + 1; uSecondSensor < uNumSensors; uSecondSensor++)
+        {
+            float fConfidence = pTDOAEstimateChunk->GetConfidence(uFirstSensor, uSecondSensor);
+            if (fConfidence < m_fMinConfidence || fConfidence <= 0)
+                continue;
+
+            double dDeviation_m = dSampleRangeDeviation_m / fConfidence;
+            double dRangeDifference_m = m_dPropagationVelocity_mps * pTDOAEstimateChunk->GetDelay_s(uFirstSensor, uSecondSensor);
+            m_vRangeDifferences.push_back({ uFirstSensor, uSecondSensor, dRangeDifference_m, 1.0 / (dDeviation_m * dDeviation_m) });
+
+            vfTotalConfidence[uFirstSensor] += fConfidence;
+            vfTotalConfidence[uSecondSensor] += fConfidence;
+        }
+    }
+
+    // Two independent differences are the least that fix a point on the plane
+    if (m_vRangeDifferences.size() < 2)
+    {
+        std::string strWarning = std::string(__FUNCTION__) + ": Too few confident sensor pairs for a position fix";
+        PLOG_WARNING << strWarning;
+        TryPassChunk(pTDOAEstimateChunk);
+        return;
+    }
+
+    // The best correlated sensor anchors the closed form solution, falling back to the middle of the array
+    unsigned uReferenceSensor = std::max_element(vfTotalConfidence.begin(), vfTotalConfidence.end()) - vfTotalConfidence.begin();
+    double dEast_m = 0;
+    double dNorth_m = 0;
+    if (!InitialiseClosedForm(uReferenceSensor, dEast_m, dNorth_m))
+    {
+        dEast_m = 0;
+        dNorth_m = 0;
+    }
+
+    auto pPositionChunk = std::make_shared<PositionChunk>(pTDOAEstimateChunk->m_i64TimeStamp);
+    pPositionChunk->SetSourceIdentifier(pTDOAEstimateChunk->GetSourceIdentifier());
+    if (!RefineGaussNewton(dEast_m, dNorth_m, pPositionChunk->m_adCovariance_m2, pPositionChunk->m_dResidual_m))
+    {
+        std::string strWarning = std::string(__FUNCTION__) + ": Sensor geometry does not constrain the position, no fix produced";
+        PLOG_WARNING << strWarning;
+        TryPassChunk(pTDOAEstimateChunk);
+        return;
+    }
+
+    pPositionChunk->m_dEast_m = dEast_m;
+    pPositionChunk->m_dNorth_m = dNorth_m;
+    pPositionChunk->m_dReferenceLatitude = m_dReferenceLatitude;
+    pPositionChunk->m_dReferenceLongitude = m_dReferenceLongitude;
+    pPositionChunk->m_u32NumMeasurements = m_vRangeDifferences.size();
+    ConvertENUToGeodetic(dEast_m, dNorth_m, pPositionChunk->m_dLatitude, pPositionChunk->m_dLongitude);
+
+    TryPassChunk(pPositionChunk);
+    TryPassChunk(pTDOAEstimateChunk);
+}
+
+void MultilaterationModule::UpdateGeometry(const TDOAEstimateChunk& Estimate)
+{
+    if (Estimate.m_vdLatitudes == m_vdSensorLatitudes && Estimate.m_vdLongitudes == m_vdSensorLongitudes)
+        return;
+
+    m_vdSensorLatitudes = Estimate.m_vdLatitudes;
+    m_vdSensorLongitudes = Estimate.m_vdLongitudes;
+    unsigned uNumSensors = m_vdSensorLatitudes.size();
+
+    // Origin at the mean sensor position keeps the tangent plane close to every sensor
+    m_dReferenceLatitude = 0;
+    m_dReferenceLongitude = 0;
+    for (unsigned uSensorIndex = 0; uSensorIndex < uNumSensors; uSensorIndex++)
+    {
+        m_dReferenceLatitude += m_vdSensorLatitudes[uSensorIndex] / uNumSensors;
+        m_dReferenceLongitude += m_vdSensorLongitudes[uSensorIndex] / uNumSensors;
+    }
+
+    double dSinLatitude = std::sin(m_dReferenceLatitude * dDegreesToRadians);
+    double dCosLatitude = std::cos(m_dReferenceLatitude * dDegreesToRadians);
+    double dSinLongitude = std::sin(m_dReferenceLongitude * dDegreesToRadians);
+    double dCosLongitude = std::cos(m_dReferenceLongitude * dDegreesToRadians);
+    auto adReferenceECEF = ConvertGeodeticToECEF(m_dReferenceLatitude, m_dReferenceLongitude);
+
+    m_vdSensorEast_m.resize(uNumSensors);
+    m_vdSensorNorth_m.resize(uNumSensors);
+    for (unsigned uSensorIndex = 0; uSensorIndex < uNumSensors; uSensorIndex++)
+    {
+        auto adSensorECEF = ConvertGeodeticToECEF(m_vdSensorLatitudes[uSensorIndex], m_vdSensorLongitudes[uSensorIndex]);
+        double dX = adSensorECEF[0] - adReferenceECEF[0];
+        double dY = adSensorECEF[1] - adReferenceECEF[1];
+        double dZ = adSensorECEF[2] - adReferenceECEF[2];
+
+        m_vdSensorEast_m[uSensorIndex] = -dSinLongitude * dX + dCosLongitude * dY;
+        m_vdSensorNorth_m[uSensorIndex] = -dSinLatitude * dCosLongitude * dX - dSinLatitude * dSinLongitude * dY + dCosLatitude * dZ;
+    }
+
+    m_u64GeometryUpdateCount++;
+    std::string strInfo = std::string(__FUNCTION__) + ": Local frame updated for " + std::to_string(uNumSensors) + " sensors";
+    PLOG_INFO << strInfo;
+}
+
+bool MultilaterationModule::InitialiseClosedForm(unsigned uReferenceSensor, double& dEast_m, double& dNorth_m)
+{
+    double dReferenceEast_m = m_vdSensorEast_m[uReferenceSensor];
+    double dReferenceNorth_m = m_vdSensorNorth_m[uReferenceSensor];
+
+    // With the reference at the origin each difference r_i to sensor (x_i, y_i) gives the linear equation
+    // x_i x + y_i y + r_i r0 = (x_i^2 + y_i^2 - r_i^2) / 2, where r0 is the range to the reference.
+    // Solving for (x, y) in terms of r0 and applying x^2 + y^2 = r0^2 leaves a quadratic in r0.
+    double dM00 = 0, dM01 = 0, dM11 = 0;
+    double dH0 = 0, dH1 = 0, dG0 = 0, dG1 = 0;
+    unsigned uNumDifferences = 0;
+    for (const auto& Difference : m_vRangeDifferences)
+    {
+        bool bFromReference = Difference.uFirstSensor == uReferenceSensor;
+        if (!bFromReference && Difference.uSecondSensor != uReferenceSensor)
+            continue;
+
+        unsigned uOtherSensor = bFromReference ? Difference.uSecondSensor : Difference.uFirstSensor;
+        double dRange_m = bFromReference ? Difference.dRangeDifference_m : -Difference.dRangeDifference_m;
+        double dX = m_vdSensorEast_m[uOtherSensor] - dReferenceEast_m;
+        double dY = m_vdSensorNorth_m[uOtherSensor] - dReferenceNorth_m;
+        double dHalfConstant = 0.5 * (dX * dX + dY * dY - dRange_m * dRange_m);
+
+        dM00 += Difference.dWeight * dX * dX;
+        dM01 += Difference.dWeight * dX * dY;
+        dM11 += Difference.dWeight * dY * dY;
+        dH0 += Difference.dWeight * dX * dHalfConstant;
+        dH1 += Difference.dWeight * dY * dHalfConstant;
+        dG0 += Difference.dWeight * dX * dRange_m;
+        dG1 += Difference.dWeight * dY * dRange_m;
+        uNumDifferences++;
+    }
+
+    double dDeterminant = dM00 * dM11 - dM01 * dM01;
+    if (uNumDifferences < 2 || std::abs(dDeterminant) <= 1e-9 * (dM00 * dM11 + 1e-300))
+        return false;
+
+    // (x, y) = a + b r0
+    double dA0 = (dM11 * dH0 - dM01 * dH1) / dDeterminant;
+    double dA1 = (dM00 * dH1 - dM01 * dH0) / dDeterminant;
+    double dB0 = -(dM11 * dG0 - dM01 * dG1) / dDeterminant;
+    double dB1 = -(dM00 * dG1 - dM01 * dG0) / dDeterminant;
+
+    double dQuadratic = dB0 * dB0 + dB1 * dB1 - 1;
+    double dLinear = 2 * (dA0 * dB0 + dA1 * dB1);
+    double dConstant = dA0 * dA0 + dA1 * dA1;
+
+    // Ranges are non negative, and noise can remove the real roots so the closest approach is kept as well
+    std::vector<double> vdCandidateRanges_m;
+    double dDiscriminant = dLinear * dLinear - 4 * dQuadratic * dConstant;
+    if (std::abs(dQuadratic) > 1e-12)
+    {
+        if (dDiscriminant >= 0)
+        {
+            vdCandidateRanges_m.push_back((-dLinear + std::sqrt(dDiscriminant)) / (2 * dQuadratic));
+            vdCandidateRanges_m.push_back((-dLinear - std::sqrt(dDiscriminant)) / (2 * dQuadratic));
+        }
+        vdCandidateRanges_m.push_back(-dLinear / (2 * dQuadratic));
+    }
+    else if (std::abs(dLinear) > 1e-12)
+        vdCandidateRanges_m.push_back(-dConstant / dLinear);
+
+    // Pick the candidate agreeing best with every pair, not just those of the reference
+    double dBestCost = std::numeric_limits<double>::infinity();
+    for (double dRange_m : vdCandidateRanges_m)
+    {
+        if (!(dRange_m >= 0))
+            continue;
+
+        double dCandidateEast_m = dReferenceEast_m + dA0 + dB0 * dRange_m;
+        double dCandidateNorth_m = dReferenceNorth_m + dA1 + dB1 * dRange_m;
+        double dCost = 0;
+        for (const auto& Difference : m_vRangeDifferences)
+        {
+            double dFirstRange_m = std::hypot(dCandidateEast_m - m_vdSensorEast_m[Difference.uFirstSensor], dCandidateNorth_m - m_vdSensorNorth_m[Difference.uFirstSensor]);
+            double dSecondRange_m = std::hypot(dCandidateEast_m - m_vdSensorEast_m[Difference.uSecondSensor], dCandidateNorth_m - m_vdSensorNorth_m[Difference.uSecondSensor]);
+            double dError_m = Difference.dRangeDifference_m - (dSecondRange_m - dFirstRange_m);
+            dCost += Difference.dWeight * dError_m * dError_m;
+        }
+
+        if (dCost < dBestCost)
+        {
+            dBestCost = dCost;
+            dEast_m = dCandidateEast_m;
+            dNorth_m = dCandidateNorth_m;
+        }
+    }
+
+    return std::isfinite(dBestCost);
+}
+
+bool MultilaterationModule::RefineGaussNewton(double& dEast_m, double& dNorth_m, std::array<double, 4>& adCovariance_m2, double& dResidual_m)
+{
+    double dN00 = 0, dN01 = 0, dN11 = 0;
+    double dWeightedSquaredError = 0;
+    double dSquaredError = 0;
+
+    // The final pass only evaluates the normal equations at the solution for the covariance
+    for (unsigned uIteration = 0; uIteration <= m_uMaxIterations; uIteration++)
+    {
+        dN00 = 0, dN01 = 0, dN11 = 0;
+        double dR0 = 0, dR1 = 0;
+        dWeightedSquaredError = 0;
+        dSquaredError = 0;
+
+        for (const auto& Difference : m_vRangeDifferences)
+        {
+            double dFirstEast_m = dEast_m - m_vdSensorEast_m[Difference.uFirstSensor];
+            double dFirstNorth_m = dNorth_m - m_vdSensorNorth_m[Difference.uFirstSensor];
+            double dSecondEast_m = dEast_m - m_vdSensorEast_m[Difference.uSecondSensor];
+            double dSecondNorth_m = dNorth_m - m_vdSensorNorth_m[Difference.uSecondSensor];
+            double dFirstRange_m = std::hypot(dFirstEast_m, dFirstNorth_m);
+            double dSecondRange_m = std::hypot(dSecondEast_m, dSecondNorth_m);
+
+            // The gradient of a range is undefined on top of its sensor
+            double dFirstScale = dFirstRange_m > 1e-9 ? 1 / dFirstRange_m : 0;
+            double dSecondScale = dSecondRange_m > 1e-9 ? 1 / dSecondRange_m : 0;
+            double dJ0 = dSecondEast_m * dSecondScale - dFirstEast_m * dFirstScale;
+            double dJ1 = dSecondNorth_m * dSecondScale - dFirstNorth_m * dFirstScale;
+            double dError_m = Difference.dRangeDifference_m - (dSecondRange_m - dFirstRange_m);
+
+            dN00 += Difference.dWeight * dJ0 * dJ0;
+            dN01 += Difference.dWeight * dJ0 * dJ1;
+            dN11 += Difference.dWeight * dJ1 * dJ1;
+            dR0 += Difference.dWeight * dJ0 * dError_m;
+            dR1 += Difference.dWeight * dJ1 * dError_m;
+            dWeightedSquaredError += Difference.dWeight * dError_m * dError_m;
+            dSquaredError += dError_m * dError_m;
+        }
+
+        double dDeterminant = dN00 * dN11 - dN01 * dN01;
+        if (!(std::abs(dDeterminant) > 1e-12 * (dN00 * dN11 + 1e-300)))
+            return false;
+
+        if (uIteration == m_uMaxIterations)
+            break;
+
+        double dStepEast_m = (dN11 * dR0 - dN01 * dR1) / dDeterminant;
+        double dStepNorth_m = (dN00 * dR1 - dN01 * dR0) / dDeterminant;
+        dEast_m += dStepEast_m;
+        dNorth_m += dStepNorth_m;
+
+        // Once converged one more pass evaluates the covariance at the solution
+        if (std::hypot(dStepEast_m, dStepNorth_m) < 1e-4)
+            uIteration = m_uMaxIterations - 1;
+    }
+
+    // Inflate the a priori covariance when the residuals show the delays are noisier than assumed
+    double dDeterminant = dN00 * dN11 - dN01 * dN01;
+    unsigned uNumDifferences = m_vRangeDifferences.size();
+    double dVarianceFactor = uNumDifferences > 2 ? std::max(1.0, dWeightedSquaredError / (uNumDifferences - 2)) : 1.0;
+    adCovariance_m2 = { dVarianceFactor * dN11 / dDeterminant, -dVarianceFactor * dN01 / dDeterminant,
+                        -dVarianceFactor * dN01 / dDeterminant, dVarianceFactor * dN00 / dDeterminant };
+    dResidual_m = std::sqrt(dSquaredError / uNumDifferences);
+
+    return std::isfinite(dEast_m) && std::isfinite(dNorth_m);
+}
+
+std::array<double, 3> MultilaterationModule::ConvertGeodeticToECEF(double dLatitude_deg, double dLongitude_deg)
+{
+    double dLatitude_rad = dLatitude_deg * dDegreesToRadians;
+    double dLongitude_rad = dLongitude_deg * dDegreesToRadians;
+    double dSinLatitude = std::sin(dLatitude_rad);
+    double dPrimeVerticalRadius_m = dSemiMajorAxis_m / std::sqrt(1 - dEccentricitySquared * dSinLatitude * dSinLatitude);
+
+    return { dPrimeVerticalRadius_m * std::cos(dLatitude_rad) * std::cos(dLongitude_rad),
+             dPrimeVerticalRadius_m * std::cos(dLatitude_rad) * std::sin(dLongitude_rad),
+             dPrimeVerticalRadius_m * (1 - dEccentricitySquared) * dSinLatitude };
+}
+
+void MultilaterationModule::ConvertENUToGeodetic(double dEast_m, double dNorth_m, double& dLatitude_deg, double& dLongitude_deg) const
+{
+    double dSinLatitude = std::sin(m_dReferenceLatitude * dDegreesToRadians);
+    double dCosLatitude = std::cos(m_dReferenceLatitude * dDegreesToRadians);
+    double dSinLongitude = std::sin(m_dReferenceLongitude * dDegreesToRadians);
+    double dCosLongitude = std::cos(m_dReferenceLongitude * dDegreesToRadians);
+    auto adECEF = ConvertGeodeticToECEF(m_dReferenceLatitude, m_dReferenceLongitude);
+
+    // Back along the tangent plane to earth centred coordinates
+    adECEF[0] += -dSinLongitude * dEast_m - dSinLatitude * dCosLongitude * dNorth_m;
+    adECEF[1] += dCosLongitude * dEast_m - dSinLatitude * dSinLongitude * dNorth_m;
+    adECEF[2] += dCosLatitude * dNorth_m;
+
+    // Then onto the ellipsoid, latitude converges to well below a millimetre in a few iterations
+    double dHorizontal_m = std::hypot(adECEF[0], adECEF[1]);
+    double dLatitude_rad = std::atan2(adECEF[2], dHorizontal_m * (1 - dEccentricitySquared));
+    for (unsigned uIteration = 0; uIteration < 5; uIteration++)
+    {
+        double dSinLatitudeEstimate = std::sin(dLatitude_rad);
+        double dPrimeVerticalRadius_m = dSemiMajorAxis_m / std::sqrt(1 - dEccentricitySquared * dSinLatitudeEstimate * dSinLatitudeEstimate);
+        dLatitude_rad = std::atan2(adECEF[2] + dEccentricitySquared * dPrimeVerticalRadius_m * dSinLatitudeEstimate, dHorizontal_m);
+    }
+
+    dLatitude_deg = dLatitude_rad / dDegreesToRadians;
+    dLongitude_deg = std::atan2(adECEF[1], adECEF[0]) / dDegreesToRadians;
+}
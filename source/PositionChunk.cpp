@@ -0,0 +1,58 @@
+#include "PositionChunk.h"
+
+PositionChunk::PositionChunk(uint64_t i64TimeStamp) :
+    BaseChunk(),
+    m_i64TimeStamp(i64TimeStamp)
+{
+}
+
+unsigned PositionChunk::GetInternalSize()
+{
+    return sizeof(m_i64TimeStamp) + 7 * sizeof(double) + sizeof(m_adCovariance_m2) + sizeof(m_u32NumMeasurements);
+}
+
+unsigned PositionChunk::GetSize()
+{
+    return BaseChunk::GetSize() + GetInternalSize();
+}
+
+std::shared_ptr<std::vector<char>> PositionChunk::Serialise()
+{
+    auto pvBytes = std::make_shared<std::vector<char>>(GetSize());
+    char* pcBytes = pvBytes->data();
+
+    // Serialise base class members first
+    auto pvBaseBytes = BaseChunk::Serialise();
+    memcpy(pcBytes, pvBaseBytes->data(), BaseChunk::GetSize());
+    pcBytes += BaseChunk::GetSize();
+
+    memcpy(pcBytes, &m_i64TimeStamp, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    for (double dValue : { m_dLatitude, m_dLongitude, m_dReferenceLatitude, m_dReferenceLongitude, m_dEast_m, m_dNorth_m, m_dResidual_m })
+    {
+        memcpy(pcBytes, &dValue, sizeof(dValue));
+        pcBytes += sizeof(dValue);
+    }
+    memcpy(pcBytes, m_adCovariance_m2.data(), sizeof(m_adCovariance_m2));
+    pcBytes += sizeof(m_adCovariance_m2);
+    memcpy(pcBytes, &m_u32NumMeasurements, sizeof(m_u32NumMeasurements));
+
+    return pvBytes;
+}
+
+void PositionChunk::Deserialise(std::shared_ptr<std::vector<char>> pvBytes)
+{
+    BaseChunk::Deserialise(pvBytes);
+    char* pcBytes = pvBytes->data() + BaseChunk::GetSize();
+
+    memcpy(&m_i64TimeStamp, pcBytes, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    for (double* pdValue : { &m_dLatitude, &m_dLongitude, &m_dReferenceLatitude, &m_dReferenceLongitude, &m_dEast_m, &m_dNorth_m, &m_dResidual_m })
+    {
+        memcpy(pdValue, pcBytes, sizeof(double));
+        pcBytes += sizeof(double);
+    }
+    memcpy(m_adCovariance_m2.data(), pcBytes, sizeof(m_adCovariance_m2));
+    pcBytes += sizeof(m_adCovariance_m2);
+    memcpy(&m_u32NumMeasurements, pcBytes, sizeof(m_u32NumMeasurements));
+}
@@ -8,17 +8,18 @@ RateLimitingModule::RateLimitingModule(unsigned uBufferSize) : BaseModule(uBuffe
 void RateLimitingModule::Process_Chunk(std::shared_ptr<BaseChunk> pBaseChunk)
 {
     // First check if we need to rate limit this chunk
-    auto vu8SourceIdentifier = pBaseChunk->GetSourceIdentifier();
+    uint32_t u32SourceIndex = m_SourceIndexCache.Intern(pBaseChunk->GetSourceIdentifier());
     auto eChunkType = pBaseChunk->GetChunkType();
+    auto& u64LastReportTime = m_mapChunkTypeToLastReportTime[u32SourceIndex][ChunkTypesNamingUtility::ToU32(eChunkType)];
 
     // If we do then check the period
     auto u64Now = std::chrono::system_clock::now().time_since_epoch().count();
-    auto u64elapsedTime_ns = u64Now - m_mapChunkTypeToLastReportTime[vu8SourceIdentifier][eChunkType];
+    auto u64elapsedTime_ns = u64Now - u64LastReportTime;
 
     // and see when last we sent it
     if(u64elapsedTime_ns >= m_mapChunkTypeToRatePeriod[eChunkType])
     {
-        m_mapChunkTypeToLastReportTime[vu8SourceIdentifier][eChunkType] = u64Now;
+        u64LastReportTime = u64Now;
         TryPassChunk(pBaseChunk);
     }
 }
@@ -0,0 +1,163 @@
+#include "ResamplerModule.h"
+
+ResamplerModule::ResamplerModule(unsigned uBufferSize,
+                                 nlohmann::json_abi_v3_11_2::json jsonConfig)
+    : BaseModule(uBufferSize),
+      m_uInterpolationFactor(
+          CheckAndThrowJSON<unsigned>(jsonConfig, "InterpolationFactor")),
+      m_uDecimationFactor(
+          CheckAndThrowJSON<unsigned>(jsonConfig, "DecimationFactor")),
+      m_uTapsPerPhase(CheckAndThrowJSON<unsigned>(jsonConfig, "TapsPerPhase")),
+      m_uOutputChunkSize(
+          CheckAndThrowJSON<unsigned>(jsonConfig, "OutputChunkSize")) {
+
+  if (m_uInterpolationFactor == 0 || m_uDecimationFactor == 0 ||
+      m_uTapsPerPhase == 0 || m_uOutputChunkSize == 0)
+    throw std::runtime_error(std::string(__FUNCTION__) +
+                             ": Resampling factors, taps per phase and output "
+                             "chunk size must be non zero");
+
+  // 4/6 is the same resampler as 2/3 with half the phases
+  unsigned uCommonDivisor =
+      std::gcd(m_uInterpolationFactor, m_uDecimationFactor);
+  m_uInterpolationFactor /= uCommonDivisor;
+  m_uDecimationFactor /= uCommonDivisor;
+
+  DesignPolyphaseFilter();
+
+  RegisterChunkCallbackFunction(ChunkType::TimeChunk,
+                                &ResamplerModule::Process_TimeChunk,
+                                (BaseModule *)this);
+}
+
+void ResamplerModule::DesignPolyphaseFilter() {
+  unsigned uNumPhases = m_uInterpolationFactor;
+  unsigned uNumTaps = uNumPhases * m_uTapsPerPhase;
+
+  // Cut off at the lower of the input and output Nyquist, at the upsampled
+  // rate
+  float fCutoff =
+      0.5f / std::max(m_uInterpolationFactor, m_uDecimationFactor);
+  auto vfTaps =
+      WindowFunctionUtility::DesignLowPassFIR(uNumTaps, fCutoff, "Blackman");
+
+  // Zero stuffing divides the signal by L so each phase is scaled back up.
+  // Tap k of a phase applies to the input k samples in the past, so reverse
+  // them to run oldest first alongside the samples
+  m_vvfPolyphaseTaps.assign(uNumPhases, std::vector<float>(m_uTapsPerPhase));
+  for (unsigned uPhase = 0; uPhase < uNumPhases; uPhase++)
+    for (unsigned uTap = 0; uTap < m_uTapsPerPhase; uTap++)
+      m_vvfPolyphaseTaps[uPhase][m_uTapsPerPhase - 1 - uTap] =
+          uNumPhases * vfTaps[uPhase + uTap * uNumPhases];
+}
+
+void ResamplerModule::Process_TimeChunk(std::shared_ptr<BaseChunk> pBaseChunk) {
+  auto pTimeChunk = std::static_pointer_cast<TimeChunk>(pBaseChunk);
+  auto &State = m_mSourceStates[m_SourceIndexCache.Intern(pTimeChunk->GetSourceIdentifier())];
+  unsigned uNumChannels = pTimeChunk->m_uNumChannels;
+  size_t uChunkLength = pTimeChunk->m_dChunkSize;
+  size_t uHistoryFrames = m_uTapsPerPhase - 1;
+
+  // A new source or a change in its format starts from silence
+  if (State.uNumChannels != uNumChannels ||
+      State.dSampleRate != pTimeChunk->m_dSampleRate) {
+    State = ResamplerSourceState();
+    State.dSampleRate = pTimeChunk->m_dSampleRate;
+    State.uNumChannels = uNumChannels;
+    State.vvfHistory.assign(uNumChannels,
+                            std::vector<float>(uHistoryFrames, 0.0f));
+  }
+
+  // Each channel is laid out as [history | chunk] so any window of taps is
+  // contiguous
+  size_t uTotalFrames = uHistoryFrames + uChunkLength;
+  if (m_vvfChannelScratch.size() < uNumChannels)
+    m_vvfChannelScratch.resize(uNumChannels);
+  for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels;
+       uChannelIndex++) {
+    auto &vfChannelScratch = m_vvfChannelScratch[uChannelIndex];
+    if (vfChannelScratch.size() < uTotalFrames)
+      vfChannelScratch.resize(uTotalFrames);
+    std::copy(State.vvfHistory[uChannelIndex].begin(),
+              State.vvfHistory[uChannelIndex].end(), vfChannelScratch.begin());
+    VectorKernelUtility::ConvertInt16ToFloat(
+        pTimeChunk->m_vvi16TimeChunks[uChannelIndex].data(),
+        vfChannelScratch.data() + uHistoryFrames, uChunkLength);
+  }
+
+  m_vfOutputFrame.resize(uNumChannels);
+  m_vi16OutputFrame.resize(uNumChannels);
+
+  // Output n sits at upsampled index t, filtered from input t/L with phase
+  // t%L. The linear phase filter output at t represents the input (taps -
+  // 1)/2 upsampled samples earlier
+  double dUpsampledSampleRate =
+      m_uInterpolationFactor * pTimeChunk->m_dSampleRate;
+  double dGroupDelay =
+      (m_uInterpolationFactor * m_uTapsPerPhase - 1) / 2.0;
+  uint64_t u64ChunkUpsampledLength =
+      (uint64_t)uChunkLength * m_uInterpolationFactor;
+  uint64_t u64OutputTime = State.u64NextOutputTime;
+  for (; u64OutputTime < u64ChunkUpsampledLength;
+       u64OutputTime += m_uDecimationFactor) {
+    // The newest input is chunk sample t/L, and the taps - 1 history frames
+    // before it put the start of its window at index t/L
+    size_t uOldestFrame = u64OutputTime / m_uInterpolationFactor;
+    const auto &vfPhaseTaps =
+        m_vvfPolyphaseTaps[u64OutputTime % m_uInterpolationFactor];
+
+    for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels;
+         uChannelIndex++)
+      m_vfOutputFrame[uChannelIndex] = VectorKernelUtility::DotProduct(
+          vfPhaseTaps.data(),
+          m_vvfChannelScratch[uChannelIndex].data() + uOldestFrame,
+          m_uTapsPerPhase);
+
+    int64_t i64FrameTimeStamp =
+        (int64_t)pTimeChunk->m_i64TimeStamp +
+        std::llround(1e6 * (u64OutputTime - dGroupDelay) /
+                     dUpsampledSampleRate);
+    AppendOutputFrame(State, pTimeChunk, i64FrameTimeStamp);
+  }
+  State.u64NextOutputTime = u64OutputTime - u64ChunkUpsampledLength;
+
+  // Carry the newest samples for the next chunk
+  for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels;
+       uChannelIndex++)
+    std::copy(m_vvfChannelScratch[uChannelIndex].begin() + uChunkLength,
+              m_vvfChannelScratch[uChannelIndex].begin() + uTotalFrames,
+              State.vvfHistory[uChannelIndex].begin());
+}
+
+void ResamplerModule::AppendOutputFrame(ResamplerSourceState &State,
+                                        std::shared_ptr<TimeChunk> pTimeChunk,
+                                        int64_t i64FrameTimeStamp) {
+  unsigned uNumChannels = State.uNumChannels;
+
+  // Output chunks are stamped with the time of their first sample
+  if (!State.pOutputChunk) {
+    double dOutputSampleRate = State.dSampleRate * m_uInterpolationFactor /
+                               m_uDecimationFactor;
+    State.pOutputChunk = std::make_shared<TimeChunk>(
+        m_uOutputChunkSize, dOutputSampleRate, i64FrameTimeStamp,
+        pTimeChunk->m_uNumBytes * 8, pTimeChunk->m_uNumBytes, uNumChannels);
+    State.pOutputChunk->SetSourceIdentifier(pTimeChunk->GetSourceIdentifier());
+    State.pOutputChunk->m_vvi16TimeChunks.resize(uNumChannels);
+    for (auto &vi16ChannelData : State.pOutputChunk->m_vvi16TimeChunks)
+      vi16ChannelData.resize(m_uOutputChunkSize);
+    State.uOutputSamples = 0;
+  }
+
+  VectorKernelUtility::ConvertFloatToInt16(
+      m_vfOutputFrame.data(), m_vi16OutputFrame.data(), uNumChannels);
+  for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels;
+       uChannelIndex++)
+    State.pOutputChunk->m_vvi16TimeChunks[uChannelIndex][State.uOutputSamples] =
+        m_vi16OutputFrame[uChannelIndex];
+
+  if (++State.uOutputSamples < m_uOutputChunkSize)
+    return;
+
+  TryPassChunk(State.pOutputChunk);
+  State.pOutputChunk.reset();
+}
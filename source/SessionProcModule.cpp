@@ -19,15 +19,26 @@ void SessionProcModule::Process_ByteChunk(std::shared_ptr<BaseChunk> pBaseChunk)
     uint32_t u32ChunkType;
     auto pByteChunk = std::static_pointer_cast<ByteChunk>(pBaseChunk);
 
-    auto pvcByteData = std::make_shared<std::vector<char>>(pByteChunk->m_vcDataChunk.begin(), pByteChunk->m_vcDataChunk.end());
+    // Fragments from a local ChunkToBytesModule may not hold their bytes in m_vcDataChunk, so work on a copy throughout
+    auto pvcByteData = ByteFragmentChunk::CopyBytes(pByteChunk);
     auto pChunkHeaderState = std::make_shared<SessionController>();
+
+    // A chunk must at least hold the session header and footer
+    if (pvcByteData->size() < pChunkHeaderState->GetSize() + 2u)
+    {
+        std::string strWarning = std::string(__FUNCTION__) + " - Session chunk of " + std::to_string(pvcByteData->size()) + " bytes is too short, dropping \n";
+        PLOG_WARNING << strWarning;
+        return;
+    }
+
     pChunkHeaderState->Deserialise(pvcByteData);
 
     // Then we can map keys
     ChunkType SessionChunkType = ChunkTypesNamingUtility::FromU32(pChunkHeaderState->m_u32uChunkType);
-    auto vu8SourceIdentifier = pChunkHeaderState->m_usUID;
+    uint32_t u32SourceIndex = m_SourceIndexCache.Intern(pChunkHeaderState->m_usUID);
+    auto& pSessionBytes = m_mSessionBytes[u32SourceIndex][ChunkTypesNamingUtility::ToU32(SessionChunkType)];
 
-    auto pPreviousChunkHeaderState = GetPreviousSessionState(vu8SourceIdentifier, SessionChunkType);
+    auto pPreviousChunkHeaderState = GetPreviousSessionState(u32SourceIndex, SessionChunkType);
 
     // Now we can check all state variables
     // Are we the first message in a sequence ?
@@ -51,56 +62,56 @@ void SessionProcModule::Process_ByteChunk(std::shared_ptr<BaseChunk> pBaseChunk)
 
         // If this is the start create a vector to store data
         if (bStartSequence)
-            m_mSessionBytes[vu8SourceIdentifier][SessionChunkType] = std::make_shared<std::vector<char>>();
+            pSessionBytes = std::make_shared<std::vector<char>>();
 
         // lets get the start and end of the data and store the bytes
-        auto DataStart = pByteChunk->m_vcDataChunk.begin() + pChunkHeaderState->GetSize();
-        auto DataEnd = pByteChunk->m_vcDataChunk.end() - 2;
-        std::copy(DataStart, DataEnd, std::back_inserter(*m_mSessionBytes[vu8SourceIdentifier][SessionChunkType]));
+        auto DataStart = pvcByteData->begin() + pChunkHeaderState->GetSize();
+        auto DataEnd = pvcByteData->end() - 2;
+        std::copy(DataStart, DataEnd, std::back_inserter(*pSessionBytes));
 
         // Creating a TimeChunk into which data shall go
-        auto pByteData = m_mSessionBytes[vu8SourceIdentifier][SessionChunkType];
+        auto pByteData = pSessionBytes;
         auto pBaseChunk = ChunkDuplicatorUtility::DeserialiseDerivedChunk(pByteData, SessionChunkType);
 
         // Pass pointer to data on and clear stored data and state information for current session
         TryPassChunk(pBaseChunk);
-        m_mSessionModesStatesMap[vu8SourceIdentifier][SessionChunkType] = std::make_shared<SessionController>();
-        m_mSessionBytes[vu8SourceIdentifier][SessionChunkType] = std::make_shared<std::vector<char>>();
+        m_mSessionModesStatesMap[u32SourceIndex][ChunkTypesNamingUtility::ToU32(SessionChunkType)] = std::make_shared<SessionController>();
+        pSessionBytes = std::make_shared<std::vector<char>>();
     }
     else if (bStartSequence || (SameSesession && !bLastInSequence && bSequenceContinuous))
     {
         // If this is the start create a vector to store data
         if (bStartSequence)
-            m_mSessionBytes[vu8SourceIdentifier][SessionChunkType] = std::make_shared<std::vector<char>>();
+            pSessionBytes = std::make_shared<std::vector<char>>();
 
         // lets get the start and end of the data and store the bytes
-        auto DataStart = pByteChunk->m_vcDataChunk.begin() + pChunkHeaderState->GetSize();
-        auto DataEnd = pByteChunk->m_vcDataChunk.end() - 2;
+        auto DataStart = pvcByteData->begin() + pChunkHeaderState->GetSize();
+        auto DataEnd = pvcByteData->end() - 2;
 
         // Verify session has not connected to client which is already transmitting data
-        if(m_mSessionBytes[vu8SourceIdentifier][SessionChunkType])
-            std::copy(DataStart, DataEnd, std::back_inserter(*m_mSessionBytes[vu8SourceIdentifier][SessionChunkType]));
+        if(pSessionBytes)
+            std::copy(DataStart, DataEnd, std::back_inserter(*pSessionBytes));
     }
     else if (bLastInSequence && SameSesession && bSequenceContinuous)
     {
         // lets get the start and end of the data and store the bytes
-        auto DataStart = pByteChunk->m_vcDataChunk.begin() + pChunkHeaderState->GetSize();
-        auto DataEnd = pByteChunk->m_vcDataChunk.end() - 2;
+        auto DataStart = pvcByteData->begin() + pChunkHeaderState->GetSize();
+        auto DataEnd = pvcByteData->end() - 2;
 
         // Verify session has not connected to client which is already transmitting data
-        if(m_mSessionBytes[vu8SourceIdentifier][SessionChunkType])
+        if(pSessionBytes)
         {
-            std::copy(DataStart, DataEnd, std::back_inserter(*m_mSessionBytes[vu8SourceIdentifier][SessionChunkType]));
+            std::copy(DataStart, DataEnd, std::back_inserter(*pSessionBytes));
 
             // Creating a TimeChunk into which data shall go
-            auto pByteData = m_mSessionBytes[vu8SourceIdentifier][SessionChunkType];
+            auto pByteData = pSessionBytes;
             auto pBaseChunk = ChunkDuplicatorUtility::DeserialiseDerivedChunk(pByteData, SessionChunkType);
 
             // Pass pointer to data on and clear stored data and state information for current session
             TryPassChunk(pBaseChunk);
-            m_mSessionModesStatesMap[vu8SourceIdentifier][SessionChunkType] = std::make_shared<SessionController>();
+            m_mSessionModesStatesMap[u32SourceIndex][ChunkTypesNamingUtility::ToU32(SessionChunkType)] = std::make_shared<SessionController>();
 
-            m_mSessionBytes[vu8SourceIdentifier][SessionChunkType] = std::make_shared<std::vector<char>>(); 
+            pSessionBytes = std::make_shared<std::vector<char>>(); 
         } 
     }
     else
@@ -109,34 +120,27 @@ void SessionProcModule::Process_ByteChunk(std::shared_ptr<BaseChunk> pBaseChunk)
         PLOG_WARNING << strWarning;
 
         pChunkHeaderState = std::make_shared<SessionController>();
-        m_mSessionBytes[vu8SourceIdentifier][SessionChunkType] = std::make_shared<std::vector<char>>();
+        pSessionBytes = std::make_shared<std::vector<char>>();
     }
 
-    UpdatePreviousSessionState(vu8SourceIdentifier, SessionChunkType, *pChunkHeaderState);
+    UpdatePreviousSessionState(u32SourceIndex, SessionChunkType, *pChunkHeaderState);
 }
 
-std::shared_ptr<SessionController> SessionProcModule::GetPreviousSessionState(std::vector<uint8_t> &vu8SourceIdentifier, ChunkType chunkType)
+std::shared_ptr<SessionController> SessionProcModule::GetPreviousSessionState(uint32_t u32SourceIndex, ChunkType chunkType)
 {
-    bool bProcessedBefore = false;
-
-    // If this unique identifier has been seen
-    if (m_mSessionModesStatesMap.count(vu8SourceIdentifier))
-    {
-        // And the chunk type has been processed before
-        if (m_mSessionModesStatesMap[vu8SourceIdentifier].count(chunkType))
-            // We can then return its session state
-            return std::static_pointer_cast<SessionController>(m_mSessionModesStatesMap[vu8SourceIdentifier][chunkType]);
-    }
+    auto& pSessionState = m_mSessionModesStatesMap[u32SourceIndex][ChunkTypesNamingUtility::ToU32(chunkType)];
 
     // If we have never seen this source identifier and chunk type
     // then lets establish a session mode for it
-    m_mSessionModesStatesMap[vu8SourceIdentifier][chunkType] = std::make_shared<SessionController>();
-    return std::static_pointer_cast<SessionController>(m_mSessionModesStatesMap[vu8SourceIdentifier][chunkType]);
+    if (!pSessionState)
+        pSessionState = std::make_shared<SessionController>();
+
+    return pSessionState;
 }
 
-void SessionProcModule::UpdatePreviousSessionState(std::vector<uint8_t> &vu8SourceIdentifier, ChunkType chunkType, SessionController reliableSessionMode)
+void SessionProcModule::UpdatePreviousSessionState(uint32_t u32SourceIndex, ChunkType chunkType, SessionController reliableSessionMode)
 {
-    m_mSessionModesStatesMap[vu8SourceIdentifier][chunkType] = std::make_shared<SessionController>(reliableSessionMode);
+    m_mSessionModesStatesMap[u32SourceIndex][ChunkTypesNamingUtility::ToU32(chunkType)] = std::make_shared<SessionController>(reliableSessionMode);
 }
 
 void SessionProcModule::StartReportingLoop()
@@ -0,0 +1,52 @@
+#include "SourceIdentifierRegistry.h"
+
+SourceIdentifierRegistry& SourceIdentifierRegistry::GetInstance()
+{
+    static SourceIdentifierRegistry Registry;
+    return Registry;
+}
+
+size_t SourceIdentifierRegistry::IdentifierHash::operator()(const std::vector<uint8_t>& vu8SourceIdentifier) const
+{
+    uint64_t u64Hash = 14695981039346656037ull;
+    for (uint8_t u8Byte : vu8SourceIdentifier)
+    {
+        u64Hash ^= u8Byte;
+        u64Hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(u64Hash);
+}
+
+uint32_t SourceIdentifierRegistry::Intern(const std::vector<uint8_t>& vu8SourceIdentifier)
+{
+    // Every identifier after the first chunk of a source is already known, so look up under a shared lock first
+    {
+        std::shared_lock<std::shared_mutex> ReadLock(m_RegistryMutex);
+        auto itIndex = m_mIdentifierIndices.find(vu8SourceIdentifier);
+        if (itIndex != m_mIdentifierIndices.end())
+            return itIndex->second;
+    }
+
+    // Another thread may have interned it between the locks
+    std::unique_lock<std::shared_mutex> WriteLock(m_RegistryMutex);
+    auto [itIndex, bInserted] = m_mIdentifierIndices.try_emplace(vu8SourceIdentifier, static_cast<uint32_t>(m_dqIdentifiers.size()));
+    if (bInserted)
+        m_dqIdentifiers.push_back(vu8SourceIdentifier);
+
+    return itIndex->second;
+}
+
+const std::vector<uint8_t>& SourceIdentifierRegistry::GetSourceIdentifier(uint32_t u32SourceIndex) const
+{
+    std::shared_lock<std::shared_mutex> ReadLock(m_RegistryMutex);
+    if (u32SourceIndex >= m_dqIdentifiers.size())
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Source index " + std::to_string(u32SourceIndex) + " has not been interned");
+
+    return m_dqIdentifiers[u32SourceIndex];
+}
+
+size_t SourceIdentifierRegistry::GetSize() const
+{
+    std::shared_lock<std::shared_mutex> ReadLock(m_RegistryMutex);
+    return m_dqIdentifiers.size();
+}
@@ -0,0 +1,70 @@
+#include "SpectrogramChunk.h"
+
+SpectrogramChunk::SpectrogramChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumChannels, unsigned uNumFrames, unsigned uNumBins, unsigned uFFTLength, unsigned uHopLength) :
+    BaseChunk(),
+    m_dSampleRate(dSampleRate),
+    m_i64TimeStamp(i64TimeStamp),
+    m_uNumChannels(uNumChannels),
+    m_uNumFrames(uNumFrames),
+    m_uNumBins(uNumBins),
+    m_uFFTLength(uFFTLength),
+    m_uHopLength(uHopLength),
+    m_vfMagnitudes((size_t)uNumChannels * uNumFrames * uNumBins, 0.0f)
+{
+}
+
+unsigned SpectrogramChunk::GetInternalSize()
+{
+    return sizeof(m_dSampleRate) + sizeof(m_i64TimeStamp) + 5 * sizeof(unsigned) + m_vfMagnitudes.size() * sizeof(float);
+}
+
+unsigned SpectrogramChunk::GetSize()
+{
+    return BaseChunk::GetSize() + GetInternalSize();
+}
+
+std::shared_ptr<std::vector<char>> SpectrogramChunk::Serialise()
+{
+    auto pvBytes = std::make_shared<std::vector<char>>(GetSize());
+    char* pcBytes = pvBytes->data();
+
+    // Serialise base class members first
+    auto pvBaseBytes = BaseChunk::Serialise();
+    memcpy(pcBytes, pvBaseBytes->data(), BaseChunk::GetSize());
+    pcBytes += BaseChunk::GetSize();
+
+    // Then the frame description
+    memcpy(pcBytes, &m_dSampleRate, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(pcBytes, &m_i64TimeStamp, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    for (unsigned uValue : { m_uNumChannels, m_uNumFrames, m_uNumBins, m_uFFTLength, m_uHopLength })
+    {
+        memcpy(pcBytes, &uValue, sizeof(uValue));
+        pcBytes += sizeof(uValue);
+    }
+
+    // And finally the contiguous magnitude matrix
+    memcpy(pcBytes, m_vfMagnitudes.data(), m_vfMagnitudes.size() * sizeof(float));
+
+    return pvBytes;
+}
+
+void SpectrogramChunk::Deserialise(std::shared_ptr<std::vector<char>> pvBytes)
+{
+    BaseChunk::Deserialise(pvBytes);
+    char* pcBytes = pvBytes->data() + BaseChunk::GetSize();
+
+    memcpy(&m_dSampleRate, pcBytes, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(&m_i64TimeStamp, pcBytes, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    for (unsigned* puValue : { &m_uNumChannels, &m_uNumFrames, &m_uNumBins, &m_uFFTLength, &m_uHopLength })
+    {
+        memcpy(puValue, pcBytes, sizeof(unsigned));
+        pcBytes += sizeof(unsigned);
+    }
+
+    m_vfMagnitudes.resize((size_t)m_uNumChannels * m_uNumFrames * m_uNumBins);
+    memcpy(m_vfMagnitudes.data(), pcBytes, m_vfMagnitudes.size() * sizeof(float));
+}
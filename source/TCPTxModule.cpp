@@ -1,7 +1,7 @@
 #include "TCPTxModule.h"
 #include <cstdint>
 
-#include "ByteChunk.h"
+#include "ByteFragmentChunk.h"
 #include <signal.h>
 
 TCPTxModule::TCPTxModule(unsigned uMaxInputBufferSize,
@@ -161,12 +161,11 @@ void TCPTxModule::RunClientThread(int &clientSocket) {
       if (TakeFromBuffer(pBaseChunk)) {
         // Cast it back to a UDP chunk
         auto udpChunk = std::static_pointer_cast<ByteChunk>(pBaseChunk);
-        const auto pvcData = udpChunk->m_vcDataChunk;
-        size_t length = pvcData.size();
 
-        // And then transmit (wohoo!!!)
-        int bytes_sent = send(clientSocket, &pvcData[0], length, 0);
-        if (bytes_sent < 0) {
+        // And then transmit (wohoo!!!), fragments go out straight from the
+        // shared serialised chunk
+        bool bSent = ByteFragmentChunk::WriteToSocket(clientSocket, udpChunk);
+        if (!bSent) {
           PLOG_WARNING << "Server closed connection abruptly";
           break;
         }
@@ -0,0 +1,77 @@
+#include "TDOAChunkAccessUtility.h"
+
+size_t TDOAChunkAccessUtility::GetNumSensors(const TDOAChunk& Chunk)
+{
+    return Chunk.m_vvvi16TimeData.size();
+}
+
+size_t TDOAChunkAccessUtility::GetNumChannels(const TDOAChunk& Chunk, size_t uSensorIndex)
+{
+    if (auto pWindowChunk = dynamic_cast<const TDOAWindowChunk*>(&Chunk))
+        return pWindowChunk->GetBlocks()[uSensorIndex].size();
+
+    return Chunk.m_vvvi16TimeData[uSensorIndex].size();
+}
+
+size_t TDOAChunkAccessUtility::GetNumSamples(const TDOAChunk& Chunk, size_t uSensorIndex, size_t uChannelIndex)
+{
+    if (auto pWindowChunk = dynamic_cast<const TDOAWindowChunk*>(&Chunk))
+    {
+        size_t uNumSamples = 0;
+        for (const auto& Block : pWindowChunk->GetBlocks()[uSensorIndex][uChannelIndex])
+            uNumSamples += Block.uLength;
+        return uNumSamples;
+    }
+
+    return Chunk.m_vvvi16TimeData[uSensorIndex][uChannelIndex].size();
+}
+
+void TDOAChunkAccessUtility::GetChannelSpans(const TDOAChunk& Chunk, size_t uSensorIndex, size_t uChannelIndex, std::vector<std::span<const int16_t>>& vSpans)
+{
+    vSpans.clear();
+    if (auto pWindowChunk = dynamic_cast<const TDOAWindowChunk*>(&Chunk))
+    {
+        for (const auto& Block : pWindowChunk->GetBlocks()[uSensorIndex][uChannelIndex])
+            vSpans.emplace_back(Block.pvi16Samples->data() + Block.uOffset, Block.uLength);
+        return;
+    }
+
+    vSpans.emplace_back(Chunk.m_vvvi16TimeData[uSensorIndex][uChannelIndex]);
+}
+
+std::vector<std::vector<std::vector<int16_t>>> TDOAChunkAccessUtility::CopyTimeData(const TDOAChunk& Chunk)
+{
+    std::vector<std::vector<std::vector<int16_t>>> vvvi16TimeData(GetNumSensors(Chunk));
+    std::vector<std::span<const int16_t>> vSpans;
+    for (size_t uSensorIndex = 0; uSensorIndex < vvvi16TimeData.size(); uSensorIndex++)
+    {
+        vvvi16TimeData[uSensorIndex].resize(GetNumChannels(Chunk, uSensorIndex));
+        for (size_t uChannelIndex = 0; uChannelIndex < vvvi16TimeData[uSensorIndex].size(); uChannelIndex++)
+        {
+            GetChannelSpans(Chunk, uSensorIndex, uChannelIndex, vSpans);
+            for (const auto& Span : vSpans)
+                vvvi16TimeData[uSensorIndex][uChannelIndex].insert(vvvi16TimeData[uSensorIndex][uChannelIndex].end(), Span.begin(), Span.end());
+        }
+    }
+    return vvvi16TimeData;
+}
+
+std::vector<std::vector<std::vector<int16_t>>>& TDOAChunkAccessUtility::GetTimeData(TDOAChunk& Chunk)
+{
+    return Chunk.m_vvvi16TimeData;
+}
+
+const std::vector<std::vector<uint8_t>>& TDOAChunkAccessUtility::GetSourceIdentifiers(const TDOAChunk& Chunk)
+{
+    return Chunk.m_vvu8SourceIdentifiers;
+}
+
+const std::vector<double>& TDOAChunkAccessUtility::GetLongitudes(const TDOAChunk& Chunk)
+{
+    return Chunk.m_vdLongitudes;
+}
+
+const std::vector<double>& TDOAChunkAccessUtility::GetLatitudes(const TDOAChunk& Chunk)
+{
+    return Chunk.m_vdLatitudes;
+}
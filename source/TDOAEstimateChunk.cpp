@@ -0,0 +1,106 @@
+#include "TDOAEstimateChunk.h"
+
+TDOAEstimateChunk::TDOAEstimateChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumSensors) :
+    BaseChunk(),
+    m_dSampleRate(dSampleRate),
+    m_i64TimeStamp(i64TimeStamp),
+    m_uNumSensors(uNumSensors),
+    m_vvu8SourceIdentifiers(uNumSensors),
+    m_vdLongitudes(uNumSensors, 0.0),
+    m_vdLatitudes(uNumSensors, 0.0),
+    m_vfDelays_s((size_t)uNumSensors * uNumSensors, 0.0f),
+    m_vfConfidences((size_t)uNumSensors * uNumSensors, 0.0f)
+{
+}
+
+unsigned TDOAEstimateChunk::GetInternalSize()
+{
+    // Each identifier is prefixed by its length
+    unsigned uIdentifierSize = 0;
+    for (const auto& vu8SourceIdentifier : m_vvu8SourceIdentifiers)
+        uIdentifierSize += sizeof(unsigned) + vu8SourceIdentifier.size();
+
+    return sizeof(m_dSampleRate) + sizeof(m_i64TimeStamp) + sizeof(m_uNumSensors) + uIdentifierSize
+        + 2 * m_uNumSensors * sizeof(double) + (m_vfDelays_s.size() + m_vfConfidences.size()) * sizeof(float);
+}
+
+unsigned TDOAEstimateChunk::GetSize()
+{
+    return BaseChunk::GetSize() + GetInternalSize();
+}
+
+std::shared_ptr<std::vector<char>> TDOAEstimateChunk::Serialise()
+{
+    auto pvBytes = std::make_shared<std::vector<char>>(GetSize());
+    char* pcBytes = pvBytes->data();
+
+    // Serialise base class members first
+    auto pvBaseBytes = BaseChunk::Serialise();
+    memcpy(pcBytes, pvBaseBytes->data(), BaseChunk::GetSize());
+    pcBytes += BaseChunk::GetSize();
+
+    // Then the window description
+    memcpy(pcBytes, &m_dSampleRate, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(pcBytes, &m_i64TimeStamp, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    memcpy(pcBytes, &m_uNumSensors, sizeof(m_uNumSensors));
+    pcBytes += sizeof(m_uNumSensors);
+
+    // Then each sensor
+    for (const auto& vu8SourceIdentifier : m_vvu8SourceIdentifiers)
+    {
+        unsigned uIdentifierLength = vu8SourceIdentifier.size();
+        memcpy(pcBytes, &uIdentifierLength, sizeof(uIdentifierLength));
+        pcBytes += sizeof(uIdentifierLength);
+        memcpy(pcBytes, vu8SourceIdentifier.data(), uIdentifierLength);
+        pcBytes += uIdentifierLength;
+    }
+    memcpy(pcBytes, m_vdLongitudes.data(), m_uNumSensors * sizeof(double));
+    pcBytes += m_uNumSensors * sizeof(double);
+    memcpy(pcBytes, m_vdLatitudes.data(), m_uNumSensors * sizeof(double));
+    pcBytes += m_uNumSensors * sizeof(double);
+
+    // And finally the contiguous pair matrices
+    memcpy(pcBytes, m_vfDelays_s.data(), m_vfDelays_s.size() * sizeof(float));
+    pcBytes += m_vfDelays_s.size() * sizeof(float);
+    memcpy(pcBytes, m_vfConfidences.data(), m_vfConfidences.size() * sizeof(float));
+
+    return pvBytes;
+}
+
+void TDOAEstimateChunk::Deserialise(std::shared_ptr<std::vector<char>> pvBytes)
+{
+    BaseChunk::Deserialise(pvBytes);
+    char* pcBytes = pvBytes->data() + BaseChunk::GetSize();
+
+    memcpy(&m_dSampleRate, pcBytes, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(&m_i64TimeStamp, pcBytes, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    memcpy(&m_uNumSensors, pcBytes, sizeof(m_uNumSensors));
+    pcBytes += sizeof(m_uNumSensors);
+
+    m_vvu8SourceIdentifiers.resize(m_uNumSensors);
+    for (auto& vu8SourceIdentifier : m_vvu8SourceIdentifiers)
+    {
+        unsigned uIdentifierLength = 0;
+        memcpy(&uIdentifierLength, pcBytes, sizeof(uIdentifierLength));
+        pcBytes += sizeof(uIdentifierLength);
+        vu8SourceIdentifier.assign(pcBytes, pcBytes + uIdentifierLength);
+        pcBytes += uIdentifierLength;
+    }
+
+    m_vdLongitudes.resize(m_uNumSensors);
+    memcpy(m_vdLongitudes.data(), pcBytes, m_uNumSensors * sizeof(double));
+    pcBytes += m_uNumSensors * sizeof(double);
+    m_vdLatitudes.resize(m_uNumSensors);
+    memcpy(m_vdLatitudes.data(), pcBytes, m_uNumSensors * sizeof(double));
+    pcBytes += m_uNumSensors * sizeof(double);
+
+    m_vfDelays_s.resize((size_t)m_uNumSensors * m_uNumSensors);
+    memcpy(m_vfDelays_s.data(), pcBytes, m_vfDelays_s.size() * sizeof(float));
+    pcBytes += m_vfDelays_s.size() * sizeof(float);
+    m_vfConfidences.resize((size_t)m_uNumSensors * m_uNumSensors);
+    memcpy(m_vfConfidences.data(), pcBytes, m_vfConfidences.size() * sizeof(float));
+}
@@ -0,0 +1,214 @@
+#include "TDOAEstimationModule.h"
+
+TDOAEstimationModule::TDOAEstimationModule(unsigned uBufferSize, unsigned uNumWorkers, double dMaxDelay_s) :
+    BaseModule(uBufferSize),
+    m_dMaxDelay_s(dMaxDelay_s)
+{
+    if (dMaxDelay_s < 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Maximum delay must not be negative");
+
+    if (uNumWorkers == 0)
+        uNumWorkers = 1;
+
+    for (unsigned uWorkerIndex = 0; uWorkerIndex < uNumWorkers; uWorkerIndex++)
+        m_vpWorkerStates.emplace_back(std::make_unique<WorkerGCCState>());
+
+    // A single worker runs on the processing thread rather than handing off to another
+    if (uNumWorkers > 1)
+        m_pWorkerPool = std::make_unique<WorkerPool>(uNumWorkers);
+
+    RegisterChunkCallbackFunction(ChunkType::TDOAChunk, &TDOAEstimationModule::Process_TDOAChunk, (BaseModule*)this);
+}
+
+unsigned TDOAEstimationModule::GetTransformLength(size_t uWindowLength)
+{
+    // Zero padding to twice the window keeps every lag of the window free of circular wrap around
+    unsigned uMinimumLength = std::max<size_t>(2 * uWindowLength, 2);
+    for (unsigned uLength = uMinimumLength + uMinimumLength % 2; ; uLength += 2)
+    {
+        unsigned uRemainder = uLength;
+        for (unsigned uFactor : { 2, 3, 5 })
+            while (uRemainder % uFactor == 0)
+                uRemainder /= uFactor;
+
+        if (uRemainder == 1)
+            return uLength;
+    }
+}
+
+void TDOAEstimationModule::Process_TDOAChunk(std::shared_ptr<BaseChunk> pBaseChunk)
+{
+    auto pTDOAChunk = std::static_pointer_cast<TDOAChunk>(pBaseChunk);
+    const TDOAChunk& Chunk = *pTDOAChunk;
+    unsigned uNumSensors = TDOAChunkAccessUtility::GetNumSensors(Chunk);
+
+    // Every sensor needs data and the same number of samples for the pairs to line up
+    size_t uWindowLength = 0;
+    for (unsigned uSensorIndex = 0; uSensorIndex < uNumSensors; uSensorIndex++)
+    {
+        size_t uSensorLength = TDOAChunkAccessUtility::GetNumChannels(Chunk, uSensorIndex) ? TDOAChunkAccessUtility::GetNumSamples(Chunk, uSensorIndex, 0) : 0;
+        if (uSensorIndex == 0)
+            uWindowLength = uSensorLength;
+        else if (uSensorLength != uWindowLength)
+            uWindowLength = 0;
+    }
+
+    if (uNumSensors < 2 || uWindowLength < 2)
+    {
+        std::string strWarning = std::string(__FUNCTION__) + ": At least two sensors with equal, non trivial windows are required, skipping chunk";
+        PLOG_WARNING << strWarning;
+        TryPassChunk(pTDOAChunk);
+        return;
+    }
+
+    unsigned uTransformLength = GetTransformLength(uWindowLength);
+    double dSampleRate = pTDOAChunk->m_dSampleRate;
+
+    // Lags beyond the window only hold the zero padding
+    unsigned uMaxLag = uWindowLength - 1;
+    if (m_dMaxDelay_s > 0)
+        uMaxLag = std::min<unsigned>(uMaxLag, std::ceil(m_dMaxDelay_s * dSampleRate));
+
+    // Each sensor is transformed once and shared by the N - 1 pairs it is part of
+    m_vvcfSensorSpectra.resize(uNumSensors);
+    RunTasks(uNumSensors, [this, &Chunk, uTransformLength](unsigned uSensorIndex, unsigned uWorkerIndex)
+    {
+        TransformSensor(*m_vpWorkerStates[uWorkerIndex], Chunk, uSensorIndex, uTransformLength, m_vvcfSensorSpectra[uSensorIndex]);
+    });
+
+    auto pTDOAEstimateChunk = std::make_shared<TDOAEstimateChunk>(dSampleRate, pTDOAChunk->m_i64TimeStamp, uNumSensors);
+    pTDOAEstimateChunk->SetSourceIdentifier(pTDOAChunk->GetSourceIdentifier());
+    pTDOAEstimateChunk->m_vvu8SourceIdentifiers = TDOAChunkAccessUtility::GetSourceIdentifiers(*pTDOAChunk);
+    pTDOAEstimateChunk->m_vdLongitudes = TDOAChunkAccessUtility::GetLongitudes(*pTDOAChunk);
+    pTDOAEstimateChunk->m_vdLatitudes = TDOAChunkAccessUtility::GetLatitudes(*pTDOAChunk);
+
+    // Then the N(N - 1)/2 unique pairs are correlated, each writing only its own matrix entries
+    std::vector<std::pair<unsigned, unsigned>> vPairs;
+    for (unsigned uFirstSensor = 0; uFirstSensor < uNumSensors; uFirstSensor++)
+        for (unsigned uSecondSensor = uFirstSensor + 1; uSecondSensor < uNumSensors; uSecondSensor++)
+            vPairs.emplace_back(uFirstSensor, uSecondSensor);
+
+    RunTasks(vPairs.size(), [this, &vPairs, &pTDOAEstimateChunk, uTransformLength, uMaxLag, uNumSensors, dSampleRate](unsigned uPairIndex, unsigned uWorkerIndex)
+    {
+        auto [uFirstSensor, uSecondSensor] = vPairs[uPairIndex];
+        float fDelay_samples = 0;
+        float fConfidence = 0;
+        CorrelatePair(*m_vpWorkerStates[uWorkerIndex], uFirstSensor, uSecondSensor, uTransformLength, uMaxLag, fDelay_samples, fConfidence);
+
+        float fDelay_s = fDelay_samples / dSampleRate;
+        pTDOAEstimateChunk->m_vfDelays_s[uFirstSensor * uNumSensors + uSecondSensor] = fDelay_s;
+        pTDOAEstimateChunk->m_vfDelays_s[uSecondSensor * uNumSensors + uFirstSensor] = -fDelay_s;
+        pTDOAEstimateChunk->m_vfConfidences[uFirstSensor * uNumSensors + uSecondSensor] = fConfidence;
+        pTDOAEstimateChunk->m_vfConfidences[uSecondSensor * uNumSensors + uFirstSensor] = fConfidence;
+    });
+
+    for (unsigned uSensorIndex = 0; uSensorIndex < uNumSensors; uSensorIndex++)
+        pTDOAEstimateChunk->m_vfConfidences[uSensorIndex * uNumSensors + uSensorIndex] = 1.0f;
+
+    TryPassChunk(pTDOAEstimateChunk);
+    TryPassChunk(pTDOAChunk);
+}
+
+void TDOAEstimationModule::RunTasks(unsigned uNumTasks, const std::function<void(unsigned uTaskIndex, unsigned uWorkerIndex)>& Task)
+{
+    if (!m_pWorkerPool)
+    {
+        for (unsigned uTaskIndex = 0; uTaskIndex < uNumTasks; uTaskIndex++)
+            Task(uTaskIndex, 0);
+        return;
+    }
+
+    if (uNumTasks == 0)
+        return;
+
+    m_uTasksRemaining = uNumTasks;
+    for (unsigned uTaskIndex = 0; uTaskIndex < uNumTasks; uTaskIndex++)
+    {
+        m_pWorkerPool->Submit([this, &Task, uTaskIndex](unsigned uWorkerIndex)
+        {
+            Task(uTaskIndex, uWorkerIndex);
+
+            if (--m_uTasksRemaining == 0)
+            {
+                std::unique_lock<std::mutex> TaskLock(m_TaskMutex);
+                m_cvTasksComplete.notify_all();
+            }
+        });
+    }
+
+    // Tasks reference state of this call so it cannot return until they have all run
+    std::unique_lock<std::mutex> TaskLock(m_TaskMutex);
+    m_cvTasksComplete.wait(TaskLock, [this] { return m_uTasksRemaining == 0; });
+}
+
+void TDOAEstimationModule::TransformSensor(WorkerGCCState& WorkerState, const TDOAChunk& Chunk, unsigned uSensorIndex, unsigned uTransformLength, std::vector<std::complex<float>>& vcfSpectrum)
+{
+    // Windows made of shared blocks are converted run by run straight into the transform input
+    WorkerState.vfTimeScratch.resize(uTransformLength);
+    TDOAChunkAccessUtility::GetChannelSpans(Chunk, uSensorIndex, 0, WorkerState.vSpans);
+    size_t uNumSamples = 0;
+    for (const auto& Span : WorkerState.vSpans)
+    {
+        VectorKernelUtility::ConvertInt16ToFloat(Span.data(), WorkerState.vfTimeScratch.data() + uNumSamples, Span.size());
+        uNumSamples += Span.size();
+    }
+    std::fill(WorkerState.vfTimeScratch.begin() + uNumSamples, WorkerState.vfTimeScratch.end(), 0.0f);
+
+    vcfSpectrum.resize(uTransformLength/2 + 1);
+    kiss_fftr_cfg ForwardFFTConfig = WorkerState.PlanCache.GetPlan(uTransformLength, false);
+    kiss_fftr(ForwardFFTConfig, WorkerState.vfTimeScratch.data(), (kiss_fft_cpx*)vcfSpectrum.data());
+}
+
+void TDOAEstimationModule::CorrelatePair(WorkerGCCState& WorkerState, unsigned uFirstSensor, unsigned uSecondSensor, unsigned uTransformLength, unsigned uMaxLag, float& fDelay_samples, float& fConfidence)
+{
+    const auto& vcfFirstSpectrum = m_vvcfSensorSpectra[uFirstSensor];
+    const auto& vcfSecondSpectrum = m_vvcfSensorSpectra[uSecondSensor];
+    unsigned uNumBins = vcfFirstSpectrum.size();
+
+    // PHAT weighting keeps only the phase of the cross spectrum so the correlation collapses to a sharp peak.
+    // Second x conj(first) peaks at the arrival time of the second sensor minus that of the first.
+    // DC carries sensor offsets rather than the signal so is left out.
+    auto& vcfCrossSpectrum = WorkerState.vcfCrossSpectrum;
+    vcfCrossSpectrum.resize(uNumBins);
+    vcfCrossSpectrum[0] = 0;
+    for (unsigned uBin = 1; uBin < uNumBins; uBin++)
+    {
+        const auto& cfFirst = vcfFirstSpectrum[uBin];
+        const auto& cfSecond = vcfSecondSpectrum[uBin];
+        float fReal = cfSecond.real() * cfFirst.real() + cfSecond.imag() * cfFirst.imag();
+        float fImag = cfSecond.imag() * cfFirst.real() - cfSecond.real() * cfFirst.imag();
+        float fMagnitude = std::sqrt(fReal * fReal + fImag * fImag);
+        float fWeight = fMagnitude > 0 ? 1.0f / fMagnitude : 0.0f;
+        vcfCrossSpectrum[uBin] = std::complex<float>(fReal * fWeight, fImag * fWeight);
+    }
+
+    auto& vfCorrelation = WorkerState.vfTimeScratch;
+    vfCorrelation.resize(uTransformLength);
+    kiss_fftr_cfg InverseFFTConfig = WorkerState.PlanCache.GetPlan(uTransformLength, true);
+    kiss_fftri(InverseFFTConfig, (kiss_fft_cpx*)vcfCrossSpectrum.data(), vfCorrelation.data());
+
+    // Negative lags sit at the end of the circular correlation
+    auto GetCorrelation = [&vfCorrelation, uTransformLength](int iLag) { return vfCorrelation[(iLag + (int)uTransformLength) % (int)uTransformLength]; };
+
+    int iPeakLag = 0;
+    float fPeakValue = GetCorrelation(0);
+    for (int iLag = -(int)uMaxLag; iLag <= (int)uMaxLag; iLag++)
+    {
+        float fValue = GetCorrelation(iLag);
+        if (fValue > fPeakValue)
+        {
+            fPeakValue = fValue;
+            iPeakLag = iLag;
+        }
+    }
+
+    // Parabola through the peak and its neighbours places the delay between samples
+    float fBefore = GetCorrelation(iPeakLag - 1);
+    float fAfter = GetCorrelation(iPeakLag + 1);
+    float fCurvature = fBefore - 2 * fPeakValue + fAfter;
+    float fOffset = fCurvature < 0 ? 0.5f * (fBefore - fAfter) / fCurvature : 0.0f;
+
+    // An unscaled inverse of unit magnitude bins peaks at the transform length for a pure delay
+    fDelay_samples = iPeakLag + std::clamp(fOffset, -0.5f, 0.5f);
+    fConfidence = fPeakValue / uTransformLength;
+}
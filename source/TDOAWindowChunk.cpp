@@ -0,0 +1,56 @@
+#include "TDOAWindowChunk.h"
+#include "TDOAChunkAccessUtility.h"
+
+TDOAWindowChunk::TDOAWindowChunk(double dSampleRate, uint64_t i64TimeStamp, uint64_t u64ChunkSize) :
+    TDOAChunk(dSampleRate, i64TimeStamp, u64ChunkSize)
+{
+}
+
+void TDOAWindowChunk::AddWindow(double dLongitude, double dLatitude, const std::vector<uint8_t>& vu8SourceIdentifier, std::vector<std::vector<TDOASampleBlock>> vvBlocks)
+{
+    for (const auto& vBlocks : vvBlocks)
+        for (const auto& Block : vBlocks)
+            if (!Block.pvi16Samples || Block.uOffset + Block.uLength > Block.pvi16Samples->size())
+                throw std::runtime_error(std::string(__FUNCTION__) + ": Run lies outside of its sample block");
+
+    // The sensor is registered with empty channels so positions and identifiers stay in step with the blocks
+    AddData(dLongitude, dLatitude, vu8SourceIdentifier, {});
+    m_vvvBlocks.push_back(std::move(vvBlocks));
+    m_bMaterialised = false;
+}
+
+void TDOAWindowChunk::Materialise()
+{
+    if (m_bMaterialised)
+        return;
+
+    auto& vvvi16TimeData = TDOAChunkAccessUtility::GetTimeData(*this);
+    for (size_t uSensorIndex = 0; uSensorIndex < m_vvvBlocks.size() && uSensorIndex < vvvi16TimeData.size(); uSensorIndex++)
+    {
+        const auto& vvBlocks = m_vvvBlocks[uSensorIndex];
+        auto& vvi16SensorData = vvvi16TimeData[uSensorIndex];
+        vvi16SensorData.resize(vvBlocks.size());
+        for (size_t uChannelIndex = 0; uChannelIndex < vvBlocks.size(); uChannelIndex++)
+        {
+            auto& vi16ChannelData = vvi16SensorData[uChannelIndex];
+            vi16ChannelData.clear();
+            for (const auto& Block : vvBlocks[uChannelIndex])
+                vi16ChannelData.insert(vi16ChannelData.end(), Block.pvi16Samples->begin() + Block.uOffset, Block.pvi16Samples->begin() + Block.uOffset + Block.uLength);
+        }
+    }
+
+    m_bMaterialised = true;
+}
+
+unsigned TDOAWindowChunk::GetSize()
+{
+    Materialise();
+    return TDOAChunk::GetSize();
+}
+
+std::shared_ptr<std::vector<char>> TDOAWindowChunk::Serialise()
+{
+    // Duplicated or transmitted windows must carry their samples with them
+    Materialise();
+    return TDOAChunk::Serialise();
+}
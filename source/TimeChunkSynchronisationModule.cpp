@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <limits>
 #include <chrono>
+#include <cmath>
 
 TimeChunkSynchronisationModule::TimeChunkSynchronisationModule(unsigned uBufferSize, uint64_t u64Threshold_us, uint64_t u64SyncInterval_ns)
     : BaseModule(uBufferSize), m_u64ChannelDiscontinuityThreshold_us(u64Threshold_us), m_u64SyncInterval_ns(u64SyncInterval_ns),
@@ -11,9 +12,9 @@ TimeChunkSynchronisationModule::TimeChunkSynchronisationModule(unsigned uBufferS
     RegisterChunkCallbackFunction(ChunkType::GPSChunk, &TimeChunkSynchronisationModule::Process_GPSChunk, (BaseModule*)this);
 }
 
-bool TimeChunkSynchronisationModule::IsDataContinuous(const std::vector<uint8_t>& sourceId, int64_t i64MostRecentTimeStamp, size_t uNumSamples, double dSampleRate_hz)
+bool TimeChunkSynchronisationModule::IsDataContinuous(uint32_t u32SourceIndex, int64_t i64MostRecentTimeStamp, size_t uNumSamples, double dSampleRate_hz)
 {
-    auto it = m_MostRecentSourceTimestamp.find(sourceId);
+    auto it = m_MostRecentSourceTimestamp.find(u32SourceIndex);
     if (it == m_MostRecentSourceTimestamp.end())
         return true;
 
@@ -25,7 +26,7 @@ bool TimeChunkSynchronisationModule::IsDataContinuous(const std::vector<uint8_t>
     bool bIsDataContinuous = std::abs(i64MostRecentTimeStamp - i64ExpectedTimestamp_us) <= i64ErrorBound_us;
 
     if (!bIsDataContinuous)
-        PLOG_WARNING << "Data is not continuous for source " << sourceId << ". Expected timestamp: " << i64ExpectedTimestamp_us << " ns, but received: " << i64MostRecentTimeStamp << " ns.";
+        PLOG_WARNING << "Data is not continuous for source " << SourceIdentifierRegistry::GetInstance().GetSourceIdentifier(u32SourceIndex) << ". Expected timestamp: " << i64ExpectedTimestamp_us << " ns, but received: " << i64MostRecentTimeStamp << " ns.";
 
     return bIsDataContinuous;
 }
@@ -33,13 +34,13 @@ bool TimeChunkSynchronisationModule::IsDataContinuous(const std::vector<uint8_t>
 void TimeChunkSynchronisationModule::Process_GPSChunk(std::shared_ptr<BaseChunk> pBaseChunk)
 {
     auto pGPSChunk  = std::static_pointer_cast<GPSChunk>(pBaseChunk);
-    auto vu8SourceIdentifier = pGPSChunk->GetSourceIdentifier();
+    uint32_t u32SourceIndex = m_SourceIndexCache.Intern(pGPSChunk->GetSourceIdentifier());
 
     auto dLong = pGPSChunk->m_dLongitude;
     auto dLat = pGPSChunk->m_dLatitude;
 
-    m_dSourceLongitudesMap[vu8SourceIdentifier] = dLong;
-    m_dSourceLatitudesMap[vu8SourceIdentifier] = dLat;
+    m_dSourceLongitudesMap[u32SourceIndex] = dLong;
+    m_dSourceLatitudesMap[u32SourceIndex] = dLat;
 
 }
 
@@ -47,34 +48,39 @@ void TimeChunkSynchronisationModule::Process_TimeChunk(std::shared_ptr<BaseChunk
 {
     auto pTimeChunk = std::static_pointer_cast<TimeChunk>(pBaseChunk);
 
-    const auto& vu8SourceId = pTimeChunk->GetSourceIdentifier();
+    // Interned once so every per source lookup below is a table index
+    uint32_t u32SourceIndex = m_SourceIndexCache.Intern(pTimeChunk->GetSourceIdentifier());
     double dSampleRate = pTimeChunk->m_dSampleRate;
     const auto& vi16FirstChannelData = pTimeChunk->m_vvi16TimeChunks[0];
 
     // Check if this is the first piece of data for this source
     // So we can make sure the channels are time aligned
-    TryInitialiseDataSource(pTimeChunk);
+    TryInitialiseDataSource(u32SourceIndex, pTimeChunk);
 
     int64_t i64MostRecentTimeStamp = pTimeChunk->m_i64TimeStamp;
-    auto it = m_OldestSourceTimestampMap.find(vu8SourceId);
+    auto it = m_OldestSourceTimestampMap.find(u32SourceIndex);
     if (it == m_OldestSourceTimestampMap.end())
     {
         PLOG_ERROR << "    Settingv Time_stamps    " << i64MostRecentTimeStamp;
-        m_OldestSourceTimestampMap[vu8SourceId] = i64MostRecentTimeStamp;
+        m_OldestSourceTimestampMap[u32SourceIndex] = i64MostRecentTimeStamp;
     }
         
 
-    bool bDataContinuous = IsDataContinuous(vu8SourceId, i64MostRecentTimeStamp, vi16FirstChannelData.size(), dSampleRate);
-    bool bChannelCountConsistent = IsChannelCountTheSame(pTimeChunk);
+    bool bDataContinuous = IsDataContinuous(u32SourceIndex, i64MostRecentTimeStamp, vi16FirstChannelData.size(), dSampleRate);
+    bool bChannelCountConsistent = IsChannelCountTheSame(u32SourceIndex, pTimeChunk);
     bool dataValid = bDataContinuous && bChannelCountConsistent;
     
+    // Only the source with the gap is restarted, it is realigned with the others at the next synchronisation
     if (!dataValid)
     {
-        ClearState();
-        return;
+        ResetSource(u32SourceIndex);
+        TryInitialiseDataSource(u32SourceIndex, pTimeChunk);
+        m_OldestSourceTimestampMap[u32SourceIndex] = i64MostRecentTimeStamp;
     }
 
-    StoreData(pTimeChunk);
+    StoreData(u32SourceIndex, pTimeChunk);
+    EvictStalledSources(i64MostRecentTimeStamp);
+    UpdateBufferedBytes();
 
     //Check if we have not received from other channels
     // if (HasChannelTimeoutOccured())
@@ -85,28 +91,30 @@ void TimeChunkSynchronisationModule::Process_TimeChunk(std::shared_ptr<BaseChunk
 
     bool bWeHaveEnoughData =  CheckQueuesHaveDataForMultilateration();
     bool bWeHaveAllGPSPositions = CheckWeHaveEnoughGPSData();
-    bool bWeHaveWaitedLongEnoughToSync = ShouldWeTrySynchronise();
 
-    if (!(bWeHaveEnoughData && bWeHaveAllGPSPositions && bWeHaveWaitedLongEnoughToSync))
-        return
+    if (!(bWeHaveEnoughData && bWeHaveAllGPSPositions))
+        return;
 
-    SynchronizeChannels();
-    
-    // Check if we have enough data in all queues (e.g., 1 second worth of data)
-    if (!CheckQueuesHaveEnoughData())
+    // Sources that have just started are aligned straight away, the rest are only realigned every sync interval
+    bool bWeHaveWaitedLongEnoughToSync = ShouldWeTrySynchronise();
+    if (!m_bSourcesAligned || bWeHaveWaitedLongEnoughToSync)
     {
-        return;
+        SynchronizeChannels();
+        m_bSourcesAligned = true;
     }
-    else
+    
+    // Windows are extracted on every chunk so buffers drain each hop however long the sync interval is,
+    // a short hop can make more than one window due per chunk
+    while (CheckQueuesHaveEnoughData())
     {
-        PLOG_WARNING << "Extracting TDOA data";
-    }
-   
-    // Package send and clear state
-    auto pTDOATimeChunk = CreateSynchronizedTimeChunk();
-    assert(pTDOATimeChunk != nullptr);
+        PLOG_DEBUG << "Extracting TDOA data";
 
-    TryPassChunk(pTDOATimeChunk);  
+        // Package send and advance by one hop
+        auto pTDOATimeChunk = CreateSynchronizedTimeChunk();
+        assert(pTDOATimeChunk != nullptr);
+
+        TryPassChunk(pTDOATimeChunk);
+    }
 }
 
 bool TimeChunkSynchronisationModule::HasChannelTimeoutOccured()
@@ -121,7 +129,7 @@ bool TimeChunkSynchronisationModule::HasChannelTimeoutOccured()
 
         if (i64TimeSinceLastData_us > m_u64ChannelDiscontinuityThreshold_us)
         {
-            PLOG_WARNING << "No data on channel " << SourceTimeStampPair.first << " for " << i64TimeSinceLastData_us/1e6 << " seconds. Clearing state.";
+            PLOG_WARNING << "No data on channel " << SourceIdentifierRegistry::GetInstance().GetSourceIdentifier(SourceTimeStampPair.first) << " for " << i64TimeSinceLastData_us/1e6 << " seconds. Clearing state.";
             return true;
         }       
     }
@@ -169,11 +177,12 @@ bool TimeChunkSynchronisationModule::CheckQueuesHaveEnoughData()
         return false;
     m_u16NumTimeSources = m_TimeDataSourceMap.size();
 
-    size_t uSamplesRequired = static_cast<size_t>(m_TDOALength_s * m_dSampleRate_hz);
+    // Interpolation reads past both ends of the window
+    size_t uSamplesRequired = static_cast<size_t>(m_TDOALength_s * m_dSampleRate_hz) + m_uFractionalDelayTaps;
 
     for (const auto& queuePair : m_TimeDataSourceMap)
     {
-        if (queuePair.second[0].size() <= uSamplesRequired)
+        if (queuePair.second[0].Size() <= uSamplesRequired)
             return false;
     }
 
@@ -186,14 +195,15 @@ bool TimeChunkSynchronisationModule::CheckWeHaveEnoughGPSData()
     if (m_dSourceLongitudesMap.empty() || m_dSourceLatitudesMap.empty())
         return false;
         
-    // Just a rudimentary check to start
+    // Every source with time data needs a position, sources that were reset keep theirs
     m_u16NumGPSSources = m_dSourceLatitudesMap.size();
-    bool bChannelCountSameAsLong = m_OldestSourceTimestampMap.size() == m_dSourceLongitudesMap.size();
-    bool bChannelCountSameAsLat = m_OldestSourceTimestampMap.size() == m_dSourceLatitudesMap.size();
-
-    bool bEnoughGPSData = bChannelCountSameAsLong && bChannelCountSameAsLat;
+    for (const auto& SourceTimeStampPair : m_OldestSourceTimestampMap)
+    {
+        if (!m_dSourceLongitudesMap.count(SourceTimeStampPair.first) || !m_dSourceLatitudesMap.count(SourceTimeStampPair.first))
+            return false;
+    }
 
-    return bEnoughGPSData;
+    return true;
 }
 
 void TimeChunkSynchronisationModule::SynchronizeChannels()
@@ -206,18 +216,41 @@ void TimeChunkSynchronisationModule::SynchronizeChannels()
     // Calculate and remove excess samples from each channel
     for (auto& pair : m_TimeDataSourceMap)
     {
-        const auto& vu8SourceId = pair.first;
+        uint32_t u32SourceIndex = pair.first;
         auto& vvi16TimeData = pair.second;
 
-        int64_t i64TimeDifference = u64MostRecentStaterTimestamp - m_OldestSourceTimestampMap[vu8SourceId];
-        auto u32SamplesToRemove = (uint32_t)(m_dSampleRate_hz*i64TimeDifference/ 1e6);
+        int64_t i64TimeDifference = u64MostRecentStaterTimestamp - m_OldestSourceTimestampMap[u32SourceIndex];
+        double dSamplesToRemove = m_dSampleRate_hz*i64TimeDifference/ 1e6;
+
+        // A source realigned after another was reset already starts early by its previous fraction
+        if (m_uFractionalDelayTaps > 0)
+        {
+            auto itFractionalDelay = m_mFractionalDelays.find(u32SourceIndex);
+            if (itFractionalDelay != m_mFractionalDelays.end())
+                dSamplesToRemove += itFractionalDelay->second;
+        }
+        auto u32SamplesToRemove = (uint32_t)dSamplesToRemove;
 
-        for (auto &vi16TimeData : vvi16TimeData)
+        // Whole samples are dropped and the remaining fraction is interpolated out as windows are read
+        if (m_uFractionalDelayTaps > 0 && i64TimeDifference > 0 && !vvi16TimeData.empty() && u32SamplesToRemove < vvi16TimeData[0].Size())
         {
-            if (u32SamplesToRemove > 0 && u32SamplesToRemove < vi16TimeData.size())
+            m_OldestSourceTimestampMap[u32SourceIndex] = u64MostRecentStaterTimestamp;
+            m_mOldestTimestampRemainders_us.erase(u32SourceIndex);
+            m_mFractionalDelays[u32SourceIndex] = dSamplesToRemove - u32SamplesToRemove;
+            m_mWindowBlockCaches.erase(u32SourceIndex);
+            for (auto &ChannelBuffer : vvi16TimeData)
+                ChannelBuffer.Consume(u32SamplesToRemove);
+            continue;
+        }
+
+        for (auto &ChannelBuffer : vvi16TimeData)
+        {
+            if (u32SamplesToRemove > 0 && u32SamplesToRemove < ChannelBuffer.Size())
             {
-                m_OldestSourceTimestampMap[vu8SourceId] = u64MostRecentStaterTimestamp;
-                vi16TimeData.erase(vi16TimeData.begin(), vi16TimeData.begin() + u32SamplesToRemove);
+                m_OldestSourceTimestampMap[u32SourceIndex] = u64MostRecentStaterTimestamp;
+                m_mOldestTimestampRemainders_us.erase(u32SourceIndex);
+                m_mWindowBlockCaches.erase(u32SourceIndex);
+                ChannelBuffer.Consume(u32SamplesToRemove);
             }
         }
         
@@ -228,60 +261,86 @@ void TimeChunkSynchronisationModule::ClearState()
 {
     m_TimeDataSourceMap.clear();
     m_OldestSourceTimestampMap.clear();
+    m_mOldestTimestampRemainders_us.clear();
     m_MostRecentSourceTimestamp.clear();
+    m_mFractionalDelays.clear();
+    m_mWindowBlockCaches.clear();
+    m_mDriftStates.clear();
     m_dSampleRate_hz = 0;
+    m_bSourcesAligned = false;
     m_tpLastSyncAttempt = std::chrono::steady_clock::now();
 
     m_dSourceLatitudesMap.clear();
     m_dSourceLongitudesMap.clear();
+    m_u64BufferedBytes = 0;
 }
 
-std::shared_ptr<TDOAChunk> TimeChunkSynchronisationModule::CreateSynchronizedTimeChunk()
+std::shared_ptr<TDOAWindowChunk> TimeChunkSynchronisationModule::CreateSynchronizedTimeChunk()
 {
     if (m_TimeDataSourceMap.empty())
         return nullptr;
 
     // Determine the number of samples and channels
     size_t numSamples = static_cast<size_t>(m_TDOALength_s * m_dSampleRate_hz);
-    size_t numChannels = m_TimeDataSourceMap.size();
+    size_t uHopSamples = std::max<size_t>(static_cast<size_t>(m_TDOAHop_s * m_dSampleRate_hz), 1);
 
     if (numSamples == 0)
         return nullptr;
 
-    auto pTDOAChunk = std::make_shared<TDOAChunk>(
+    // Interpolated windows start half the interpolator later so it has history to read
+    unsigned uInterpolatorDelay = m_uFractionalDelayTaps ? m_uFractionalDelayTaps/2 - 1 : 0;
+    auto pTDOAChunk = std::make_shared<TDOAWindowChunk>(
         m_dSampleRate_hz,
-        m_OldestSourceTimestampMap.begin()->second,
+        m_OldestSourceTimestampMap.begin()->second + static_cast<uint64_t>(1e6 * uInterpolatorDelay / m_dSampleRate_hz),
         numSamples
     );
 
 
     pTDOAChunk->SetSourceIdentifier({1,1,1});
 
-    // Fill the TimeChunk with synchronized data
-    for (auto& [vu8SourceId, vvi16SourceData] : m_TimeDataSourceMap)
+    // Fill the window with synchronized data. Only samples no earlier window has packaged are copied out of the
+    // ring buffers, into a new block, the rest of the window references the blocks the windows before it made.
+    for (auto& [u32SourceIndex, vvi16SourceData] : m_TimeDataSourceMap)
     {
+        auto& vWindowBlockCaches = m_mWindowBlockCaches[u32SourceIndex];
+        vWindowBlockCaches.resize(vvi16SourceData.size());
 
-        std::vector<std::vector<int16_t>> vvu16TmpVec;
-        vvu16TmpVec.resize(vvi16SourceData.size());
-
+        std::vector<std::vector<TDOASampleBlock>> vvBlocks(vvi16SourceData.size());
         for (size_t i = 0; i < vvi16SourceData.size(); i++)
         {
-            vvu16TmpVec[i] = std::vector(vvi16SourceData[i].begin(), vvi16SourceData[i].begin()+numSamples);
-            vvi16SourceData[i].erase(vvi16SourceData[i].begin(), vvi16SourceData[i].begin()+numSamples);
+            auto& WindowBlockCache = vWindowBlockCaches[i];
+            if (WindowBlockCache.uCachedSamples < numSamples)
+            {
+                size_t uNewSamples = numSamples - WindowBlockCache.uCachedSamples;
+                auto pvi16Block = std::make_shared<std::vector<int16_t>>(uNewSamples);
+                if (m_uFractionalDelayTaps > 0)
+                    ReadFractionallyDelayedWindow(vvi16SourceData[i], m_mFractionalDelays[u32SourceIndex], WindowBlockCache.uCachedSamples, uNewSamples, pvi16Block->data());
+                else
+                    vvi16SourceData[i].CopyTo(WindowBlockCache.uCachedSamples, uNewSamples, pvi16Block->data());
+
+                WindowBlockCache.dqBlocks.push_back({ std::move(pvi16Block), 0, uNewSamples });
+                WindowBlockCache.uCachedSamples = numSamples;
+            }
+
+            vvBlocks[i].assign(WindowBlockCache.dqBlocks.begin(), WindowBlockCache.dqBlocks.end());
+            vvi16SourceData[i].Consume(uHopSamples);
         }
-        
 
-        pTDOAChunk->AddData(
-                        m_dSourceLongitudesMap[vu8SourceId],
-                        m_dSourceLatitudesMap[vu8SourceId],
-                        vu8SourceId, 
-                        vvu16TmpVec);
+        // Only the hop is dropped so the rest of the window is referenced again by the next, buffers now start a hop later
+        DropWindowBlocks(u32SourceIndex, uHopSamples);
+        AdvanceOldestTimestamp(u32SourceIndex, uHopSamples);
+
+        pTDOAChunk->AddWindow(
+                        m_dSourceLongitudesMap[u32SourceIndex],
+                        m_dSourceLatitudesMap[u32SourceIndex],
+                        SourceIdentifierRegistry::GetInstance().GetSourceIdentifier(u32SourceIndex), 
+                        std::move(vvBlocks));
     }
 
     // Set the source identifier (assuming we want to use the first source's identifier)
     if (!m_TimeDataSourceMap.empty())
     {
-        auto vu8firstSource = m_TimeDataSourceMap.begin()->first;
+        auto vu8firstSource = SourceIdentifierRegistry::GetInstance().GetSourceIdentifier(m_TimeDataSourceMap.begin()->first);
         pTDOAChunk->SetSourceIdentifier(vu8firstSource);
     }
     else
@@ -290,10 +349,43 @@ std::shared_ptr<TDOAChunk> TimeChunkSynchronisationModule::CreateSynchronizedTim
     return pTDOAChunk;
 }
 
+void TimeChunkSynchronisationModule::DropWindowBlocks(uint32_t u32SourceIndex, size_t uNumSamples)
+{
+    auto itWindowBlockCaches = m_mWindowBlockCaches.find(u32SourceIndex);
+    if (itWindowBlockCaches == m_mWindowBlockCaches.end())
+        return;
+
+    for (auto& WindowBlockCache : itWindowBlockCaches->second)
+    {
+        size_t uSamplesToDrop = std::min(uNumSamples, WindowBlockCache.uCachedSamples);
+        WindowBlockCache.uCachedSamples -= uSamplesToDrop;
+
+        // Whole blocks are released once no window still to come references them, the first may be cut part way
+        auto& dqBlocks = WindowBlockCache.dqBlocks;
+        while (uSamplesToDrop > 0 && !dqBlocks.empty())
+        {
+            if (dqBlocks.front().uLength <= uSamplesToDrop)
+            {
+                uSamplesToDrop -= dqBlocks.front().uLength;
+                dqBlocks.pop_front();
+                continue;
+            }
+
+            dqBlocks.front().uOffset += uSamplesToDrop;
+            dqBlocks.front().uLength -= uSamplesToDrop;
+            uSamplesToDrop = 0;
+        }
+    }
+}
+
 bool TimeChunkSynchronisationModule::IsChannelCountTheSame(std::shared_ptr<TimeChunk> pTimeChunk)
 {
-    auto vu8SourceIdentifier = pTimeChunk->GetSourceIdentifier();
-    auto &vvi16StoredTimeData = m_TimeDataSourceMap[vu8SourceIdentifier];
+    return IsChannelCountTheSame(m_SourceIndexCache.Intern(pTimeChunk->GetSourceIdentifier()), pTimeChunk);
+}
+
+bool TimeChunkSynchronisationModule::IsChannelCountTheSame(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk)
+{
+    auto &vvi16StoredTimeData = m_TimeDataSourceMap[u32SourceIndex];
 
     bool bChannelCountTheSame = true;
     if (vvi16StoredTimeData.size() != pTimeChunk->m_vvi16TimeChunks.size())
@@ -304,36 +396,350 @@ bool TimeChunkSynchronisationModule::IsChannelCountTheSame(std::shared_ptr<TimeC
 
 void TimeChunkSynchronisationModule::TryInitialiseDataSource(std::shared_ptr<TimeChunk> pTimeChunk)
 {
-    const auto& vu8SourceId = pTimeChunk->GetSourceIdentifier();
+    TryInitialiseDataSource(m_SourceIndexCache.Intern(pTimeChunk->GetSourceIdentifier()), pTimeChunk);
+}
+
+void TimeChunkSynchronisationModule::TryInitialiseDataSource(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk)
+{
     int64_t i64MostRecentTimeStamp = pTimeChunk->m_i64TimeStamp;
 
-    if (!m_TimeDataSourceMap[vu8SourceId].empty())
+    if (!m_TimeDataSourceMap[u32SourceIndex].empty())
         return;
     
-    m_MostRecentSourceTimestamp[vu8SourceId] = i64MostRecentTimeStamp;
+    m_MostRecentSourceTimestamp[u32SourceIndex] = i64MostRecentTimeStamp;
 
+    // Storage is allocated once per source so storing and aligning never allocate or move samples
     auto stChannelCount = pTimeChunk->m_vvi16TimeChunks.size();
-    m_TimeDataSourceMap[vu8SourceId].resize(stChannelCount);
+    size_t uChunkLength = stChannelCount ? pTimeChunk->m_vvi16TimeChunks[0].size() : 0;
+    size_t uCapacity = GetChannelBufferCapacity(pTimeChunk->m_dSampleRate, uChunkLength);
+
+    // A memory cap trades the ability to hold a whole window for bounded growth when other sources stall
+    if (m_uMaxBytesPerSource > 0 && stChannelCount > 0)
+    {
+        size_t uCappedCapacity = m_uMaxBytesPerSource / (stChannelCount * sizeof(int16_t));
+        size_t uWindowCapacity = static_cast<size_t>(m_TDOALength_s * pTimeChunk->m_dSampleRate) + m_uFractionalDelayTaps + uChunkLength;
+        if (uCappedCapacity < uWindowCapacity)
+        {
+            std::string strWarning = std::string(__FUNCTION__) + ": Memory limit cannot hold a TDOA window of this source";
+            PLOG_WARNING << strWarning;
+        }
+        uCapacity = std::min(uCapacity, uCappedCapacity);
+    }
+
+    m_TimeDataSourceMap[u32SourceIndex].assign(stChannelCount, RingBuffer<int16_t>(uCapacity));
+    m_bSourcesAligned = false;
 
 }
 
-void TimeChunkSynchronisationModule::StoreData(std::shared_ptr<TimeChunk> pTimeChunk)
+size_t TimeChunkSynchronisationModule::GetChannelBufferCapacity(double dSampleRate_hz, size_t uChunkLength) const
 {
-    auto vu8SourceIdentifier = pTimeChunk->GetSourceIdentifier();
+    // One window to extract, up to another window of offset between the sources being aligned and a chunk on top
+    size_t uWindowLength = static_cast<size_t>(std::ceil(m_TDOALength_s * dSampleRate_hz));
+    return 2 * uWindowLength + 2 * uChunkLength + m_uFractionalDelayTaps;
+}
+
+void TimeChunkSynchronisationModule::SetSourceMemoryLimit(size_t uMaxBytesPerSource)
+{
+    // Buffers are sized as sources are first seen so are reallocated
+    m_uMaxBytesPerSource = uMaxBytesPerSource;
+    ClearState();
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Sources limited to " + std::to_string(uMaxBytesPerSource) + " bytes";
+    PLOG_INFO << strInfo;
+}
 
-    m_MostRecentSourceTimestamp[vu8SourceIdentifier] = pTimeChunk->m_i64TimeStamp;
+void TimeChunkSynchronisationModule::SetStalledSourceTimeout(double dTimeout_s)
+{
+    if (dTimeout_s < 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Timeout must not be negative");
+
+    m_u64StalledSourceTimeout_us = static_cast<uint64_t>(dTimeout_s * 1e6);
+}
+
+void TimeChunkSynchronisationModule::ResetSource(uint32_t u32SourceIndex)
+{
+    m_TimeDataSourceMap.erase(u32SourceIndex);
+    m_OldestSourceTimestampMap.erase(u32SourceIndex);
+    m_mOldestTimestampRemainders_us.erase(u32SourceIndex);
+    m_MostRecentSourceTimestamp.erase(u32SourceIndex);
+    m_mFractionalDelays.erase(u32SourceIndex);
+    m_mWindowBlockCaches.erase(u32SourceIndex);
+    m_mDriftStates.erase(u32SourceIndex);
+    m_bSourcesAligned = false;
+    m_u64SourceResets++;
+
+    PLOG_WARNING << "Resetting source " << SourceIdentifierRegistry::GetInstance().GetSourceIdentifier(u32SourceIndex) << ", other sources keep their data";
+}
+
+void TimeChunkSynchronisationModule::AdvanceOldestTimestamp(uint32_t u32SourceIndex, size_t uNumSamples)
+{
+    // Only whole microseconds are added, the rest is kept so the timestamp stays within a microsecond of the samples
+    double& dRemainder_us = m_mOldestTimestampRemainders_us[u32SourceIndex];
+    double dAdvance_us = 1e6 * uNumSamples / m_dSampleRate_hz + dRemainder_us;
+    uint64_t u64WholeAdvance_us = static_cast<uint64_t>(std::floor(dAdvance_us));
+    dRemainder_us = dAdvance_us - u64WholeAdvance_us;
+    m_OldestSourceTimestampMap[u32SourceIndex] += u64WholeAdvance_us;
+}
+
+void TimeChunkSynchronisationModule::EvictStalledSources(uint64_t u64NewestTimeStamp_us)
+{
+    if (m_u64StalledSourceTimeout_us == 0)
+        return;
+
+    // Sources are judged against the newest data rather than the wall clock so replayed data behaves the same
+    for (const auto& [u32SourceIndex, u64TimeStamp_us] : m_MostRecentSourceTimestamp)
+    {
+        if (u64NewestTimeStamp_us > u64TimeStamp_us && u64NewestTimeStamp_us - u64TimeStamp_us > m_u64StalledSourceTimeout_us)
+            m_vu32StalledSources.push_back(u32SourceIndex);
+    }
+
+    for (uint32_t u32SourceIndex : m_vu32StalledSources)
+        ResetSource(u32SourceIndex);
+    m_vu32StalledSources.clear();
+}
+
+void TimeChunkSynchronisationModule::UpdateBufferedBytes()
+{
+    uint64_t u64BufferedBytes = 0;
+    for (const auto& [u32SourceIndex, vChannelBuffers] : m_TimeDataSourceMap)
+        for (const auto& ChannelBuffer : vChannelBuffers)
+            u64BufferedBytes += ChannelBuffer.Size() * sizeof(int16_t);
+
+    m_u64BufferedBytes = u64BufferedBytes;
+}
+
+void TimeChunkSynchronisationModule::SetTDOAWindow(double dWindowLength_s, double dHopLength_s)
+{
+    if (dWindowLength_s <= 0 || dHopLength_s <= 0 || dHopLength_s > dWindowLength_s)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Window and hop must be positive with the hop no longer than the window");
+
+    // Buffers are sized for the window so are reallocated
+    m_TDOALength_s = dWindowLength_s;
+    m_TDOAHop_s = dHopLength_s;
+    ClearState();
+
+    std::string strInfo = std::string(__FUNCTION__) + ": TDOA windows of " + std::to_string(dWindowLength_s) + " s every " + std::to_string(dHopLength_s) + " s";
+    PLOG_INFO << strInfo;
+}
+
+void TimeChunkSynchronisationModule::EnableFractionalDelayCorrection(unsigned uNumTaps, unsigned uNumPhases)
+{
+    if (uNumTaps < 2 || uNumTaps % 2 != 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Number of taps must be even and at least 2");
+
+    if (uNumPhases == 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Number of phases must be non zero");
+
+    // Tabulated once so reading a window is only a sum of scaled, shifted copies
+    m_vvfFractionalDelayTable.resize(uNumPhases + 1);
+    for (unsigned uPhase = 0; uPhase <= uNumPhases; uPhase++)
+        m_vvfFractionalDelayTable[uPhase] = WindowFunctionUtility::DesignFractionalDelayFIR(uNumTaps, (float)uPhase / uNumPhases);
+
+    m_uFractionalDelayTaps = uNumTaps;
+    ClearState();
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Fractional delay correction enabled with " + std::to_string(uNumTaps) + " taps and " + std::to_string(uNumPhases) + " phases";
+    PLOG_INFO << strInfo;
+}
+
+void TimeChunkSynchronisationModule::ReadFractionallyDelayedWindow(const RingBuffer<int16_t>& ChannelBuffer, double dFraction, size_t uOffset, size_t uNumSamples, int16_t* pi16Output)
+{
+    unsigned uNumPhases = m_vvfFractionalDelayTable.size() - 1;
+    unsigned uPhase = std::min<unsigned>(std::lround(dFraction * uNumPhases), uNumPhases);
+    const auto& vfTaps = m_vvfFractionalDelayTable[uPhase];
+
+    // Sources without an offset only need the delay every other source sees
+    if (uPhase == 0)
+    {
+        ChannelBuffer.CopyTo(uOffset + m_uFractionalDelayTaps/2 - 1, uNumSamples, pi16Output);
+        return;
+    }
+
+    // Convert straight out of the ring buffer, in two parts when it wraps
+    size_t uInputLength = uNumSamples + m_uFractionalDelayTaps - 1;
+    m_vfFractionalDelayInput.resize(uInputLength);
+    auto [FirstSpan, SecondSpan] = ChannelBuffer.Peek(uOffset, uInputLength);
+    VectorKernelUtility::ConvertInt16ToFloat(FirstSpan.data(), m_vfFractionalDelayInput.data(), FirstSpan.size());
+    VectorKernelUtility::ConvertInt16ToFloat(SecondSpan.data(), m_vfFractionalDelayInput.data() + FirstSpan.size(), SecondSpan.size());
+
+    // Each tap adds a shifted copy of the input across the whole window, which vectorises regardless of tap count
+    m_vfFractionalDelayOutput.assign(uNumSamples, 0.0f);
+    for (unsigned uTap = 0; uTap < m_uFractionalDelayTaps; uTap++)
+        VectorKernelUtility::MultiplyAccumulate(m_vfFractionalDelayInput.data() + uTap, vfTaps[uTap], m_vfFractionalDelayOutput.data(), uNumSamples);
+
+    VectorKernelUtility::ConvertFloatToInt16(m_vfFractionalDelayOutput.data(), pi16Output, uNumSamples);
+}
+
+void TimeChunkSynchronisationModule::StoreData(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk)
+{
+    m_MostRecentSourceTimestamp[u32SourceIndex] = pTimeChunk->m_i64TimeStamp;
     m_dSampleRate_hz = pTimeChunk->m_dSampleRate;
 
-    auto count = 0;
-    for (auto vi16Data :  pTimeChunk->m_vvi16TimeChunks) 
+    // Drifting clocks are brought onto the nominal sample times before they are buffered
+    const std::vector<std::vector<int16_t>>* pvvi16ChannelData = &pTimeChunk->m_vvi16TimeChunks;
+    if (m_uDriftRegressionChunks > 0)
     {
-        m_TimeDataSourceMap[vu8SourceIdentifier][count].insert( 
-                                                            m_TimeDataSourceMap[vu8SourceIdentifier][count].end(), 
-                                                            vi16Data.begin(), 
-                                                            vi16Data.end());
-        count++;
+        ResampleOntoTimebase(u32SourceIndex, pTimeChunk, m_vvi16ResampledScratch);
+        pvvi16ChannelData = &m_vvi16ResampledScratch;
     }
-    
+
+    auto& vChannelBuffers = m_TimeDataSourceMap[u32SourceIndex];
+    size_t uEvicted = 0;
+    for (size_t uChannelIndex = 0; uChannelIndex < vChannelBuffers.size(); uChannelIndex++)
+    {
+        const auto& vi16Data = (*pvvi16ChannelData)[uChannelIndex];
+        uEvicted = vChannelBuffers[uChannelIndex].Push(vi16Data.data(), vi16Data.size());
+    }
+
+    // A source that is not being extracted overwrites its oldest samples, so its buffer now starts later
+    if (uEvicted > 0)
+    {
+        m_u64EvictedSamples += uEvicted * vChannelBuffers.size();
+        DropWindowBlocks(u32SourceIndex, uEvicted);
+        AdvanceOldestTimestamp(u32SourceIndex, uEvicted);
+        PLOG_WARNING << "Source " << SourceIdentifierRegistry::GetInstance().GetSourceIdentifier(u32SourceIndex) << " buffer full, dropped " << uEvicted << " oldest samples per channel";
+    }
+
+}
+
+void TimeChunkSynchronisationModule::EnableDriftCorrection(unsigned uRegressionChunks, double dMaxDrift_ppm)
+{
+    if (uRegressionChunks < 2)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": At least two chunks are required to fit a clock");
+
+    if (dMaxDrift_ppm <= 0)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Maximum drift must be positive");
+
+    m_uDriftRegressionChunks = uRegressionChunks;
+    m_dMaxDrift_ppm = dMaxDrift_ppm;
+    ClearState();
+
+    std::string strInfo = std::string(__FUNCTION__) + ": Drift correction enabled over " + std::to_string(uRegressionChunks) + " chunks";
+    PLOG_INFO << strInfo;
+}
+
+double TimeChunkSynchronisationModule::GetEstimatedDrift_ppm(const std::vector<uint8_t>& vu8SourceIdentifier) const
+{
+    auto itDriftState = m_mDriftStates.find(SourceIdentifierRegistry::GetInstance().Intern(vu8SourceIdentifier));
+    if (itDriftState == m_mDriftStates.end() || itDriftState->second.dSamplePeriod_us <= 0 || m_dSampleRate_hz <= 0)
+        return 0;
+
+    return (1e6 / (itDriftState->second.dSamplePeriod_us * m_dSampleRate_hz) - 1) * 1e6;
+}
+
+void TimeChunkSynchronisationModule::ResampleOntoTimebase(uint32_t u32SourceIndex, std::shared_ptr<TimeChunk> pTimeChunk, std::vector<std::vector<int16_t>>& vvi16Resampled)
+{
+    auto& State = m_mDriftStates[u32SourceIndex];
+    const auto& vvi16ChannelData = pTimeChunk->m_vvi16TimeChunks;
+    size_t uNumChannels = vvi16ChannelData.size();
+    size_t uChunkLength = uNumChannels ? vvi16ChannelData[0].size() : 0;
+    double dNominalPeriod_us = 1e6 / pTimeChunk->m_dSampleRate;
+
+    // The nominal grid starts at the first sample of the source
+    if (State.u64InputSamples == 0)
+    {
+        State.u64FirstTimeStamp_us = pTimeChunk->m_i64TimeStamp;
+        State.vi16PreviousSamples.assign(uNumChannels, 0);
+    }
+
+    State.dqSampleCountTimeStamps.emplace_back(State.u64InputSamples, pTimeChunk->m_i64TimeStamp);
+    if (State.dqSampleCountTimeStamps.size() > m_uDriftRegressionChunks)
+        State.dqSampleCountTimeStamps.pop_front();
+
+    // Least squares line of timestamp against sample count, relative to the oldest point to keep precision
+    const auto& [u64OriginCount, u64OriginTimeStamp_us] = State.dqSampleCountTimeStamps.front();
+    double dMeanCount = 0, dMeanTime_us = 0;
+    for (const auto& [u64Count, u64TimeStamp_us] : State.dqSampleCountTimeStamps)
+    {
+        dMeanCount += (double)(u64Count - u64OriginCount);
+        dMeanTime_us += (double)((int64_t)(u64TimeStamp_us - u64OriginTimeStamp_us));
+    }
+    dMeanCount /= State.dqSampleCountTimeStamps.size();
+    dMeanTime_us /= State.dqSampleCountTimeStamps.size();
+
+    double dCovariance = 0, dVariance = 0;
+    for (const auto& [u64Count, u64TimeStamp_us] : State.dqSampleCountTimeStamps)
+    {
+        double dCount = (double)(u64Count - u64OriginCount) - dMeanCount;
+        dCovariance += dCount * ((double)((int64_t)(u64TimeStamp_us - u64OriginTimeStamp_us)) - dMeanTime_us);
+        dVariance += dCount * dCount;
+    }
+
+    // A single chunk says nothing about the clock so the nominal period is assumed until the second arrives
+    double dSamplePeriod_us = dVariance > 0 ? dCovariance / dVariance : dNominalPeriod_us;
+    double dMaxDeviation = m_dMaxDrift_ppm * 1e-6;
+    dSamplePeriod_us = std::clamp(dSamplePeriod_us, dNominalPeriod_us / (1 + dMaxDeviation), dNominalPeriod_us / (1 - dMaxDeviation));
+    double dInterceptTime_us = dVariance > 0 ? dMeanTime_us - dSamplePeriod_us * dMeanCount : 0;
+    State.dSamplePeriod_us = dSamplePeriod_us;
+
+    // Each nominal sample time maps to an absolute position in the input so fit updates never accumulate error.
+    // Positions are relative to this chunk, -1 being the last sample of the previous chunk.
+    double dFirstOffset_us = (double)((int64_t)(State.u64FirstTimeStamp_us - u64OriginTimeStamp_us)) - dInterceptTime_us - dSamplePeriod_us * (double)(State.u64InputSamples - u64OriginCount);
+
+    vvi16Resampled.resize(uNumChannels);
+    for (auto& vi16Resampled : vvi16Resampled)
+        vi16Resampled.clear();
+
+    if (uChunkLength == 0)
+        return;
+
+    // Sample positions are shared by every channel so are found once, as indices into the chunk with the previous
+    // sample in front of it. Clocks near their nominal rate give about one output per input.
+    m_vuResampleIndices.clear();
+    m_vfResampleWeightsAfter.clear();
+    m_vuResampleIndices.reserve(uChunkLength + 1);
+    m_vfResampleWeightsAfter.reserve(uChunkLength + 1);
+    while (true)
+    {
+        double dPosition = (dFirstOffset_us + State.u64OutputSamples * dNominalPeriod_us) / dSamplePeriod_us;
+        if (dPosition > (double)uChunkLength - 1)
+            break;
+
+        dPosition = std::max(dPosition, -1.0);
+        int iBefore = (int)std::floor(dPosition);
+        float fFraction = dPosition - iBefore;
+        if (iBefore == (int)uChunkLength - 1)
+        {
+            iBefore--;
+            fFraction = 1.0f;
+        }
+
+        m_vuResampleIndices.push_back(iBefore + 1);
+        m_vfResampleWeightsAfter.push_back(fFraction);
+        State.u64OutputSamples++;
+    }
+
+    size_t uNumOutputs = m_vuResampleIndices.size();
+    m_vfResampleWeightsBefore.resize(uNumOutputs);
+    for (size_t uOutputIndex = 0; uOutputIndex < uNumOutputs; uOutputIndex++)
+        m_vfResampleWeightsBefore[uOutputIndex] = 1.0f - m_vfResampleWeightsAfter[uOutputIndex];
+
+    // Each channel is a gather of the neighbouring samples followed by a weighted sum on whole vectors
+    m_vfResampleInput.resize(uChunkLength + 1);
+    m_vfResampleBefore.resize(uNumOutputs);
+    m_vfResampleAfter.resize(uNumOutputs);
+    for (size_t uChannelIndex = 0; uChannelIndex < uNumChannels; uChannelIndex++)
+    {
+        m_vfResampleInput[0] = State.vi16PreviousSamples[uChannelIndex];
+        VectorKernelUtility::ConvertInt16ToFloat(vvi16ChannelData[uChannelIndex].data(), m_vfResampleInput.data() + 1, uChunkLength);
+
+        for (size_t uOutputIndex = 0; uOutputIndex < uNumOutputs; uOutputIndex++)
+        {
+            m_vfResampleBefore[uOutputIndex] = m_vfResampleInput[m_vuResampleIndices[uOutputIndex]];
+            m_vfResampleAfter[uOutputIndex] = m_vfResampleInput[m_vuResampleIndices[uOutputIndex] + 1];
+        }
+
+        VectorKernelUtility::Multiply(m_vfResampleWeightsBefore.data(), m_vfResampleBefore.data(), m_vfResampleBefore.data(), uNumOutputs);
+        VectorKernelUtility::Multiply(m_vfResampleWeightsAfter.data(), m_vfResampleAfter.data(), m_vfResampleAfter.data(), uNumOutputs);
+        VectorKernelUtility::MultiplyAccumulate(m_vfResampleAfter.data(), 1.0f, m_vfResampleBefore.data(), uNumOutputs);
+
+        vvi16Resampled[uChannelIndex].resize(uNumOutputs);
+        VectorKernelUtility::ConvertFloatToInt16(m_vfResampleBefore.data(), vvi16Resampled[uChannelIndex].data(), uNumOutputs);
+    }
+
+    for (size_t uChannelIndex = 0; uChannelIndex < uNumChannels; uChannelIndex++)
+        State.vi16PreviousSamples[uChannelIndex] = vvi16ChannelData[uChannelIndex].back();
+    State.u64InputSamples += uChunkLength;
 }
 
  void TimeChunkSynchronisationModule::StartReportingLoop()
@@ -353,7 +759,10 @@ void TimeChunkSynchronisationModule::StoreData(std::shared_ptr<TimeChunk> pTimeC
                         {"QueueLength", std::to_string(u16CurrentBufferSize)},
                         {"NumTimeSources", std::to_string(m_u16NumTimeSources)},
                         {"NumGPSSources", std::to_string(m_u16NumGPSSources)},
-                        {"SecondsSinceLastTimeSync", std::to_string(m_u16NumGPSSources)}
+                        {"SecondsSinceLastTimeSync", std::to_string(m_u16NumGPSSources)},
+                        {"BufferedBytes", std::to_string(m_u64BufferedBytes)},
+                        {"EvictedSamples", std::to_string(m_u64EvictedSamples)},
+                        {"SourceResets", std::to_string(m_u64SourceResets)}
                     }}
                 }}
             };
@@ -0,0 +1,77 @@
+#include "TonePowerChunk.h"
+
+TonePowerChunk::TonePowerChunk(double dSampleRate, uint64_t i64TimeStamp, unsigned uNumChannels, unsigned uNumBlocks, unsigned uBlockLength, const std::vector<float>& vfFrequencies_Hz) :
+    BaseChunk(),
+    m_dSampleRate(dSampleRate),
+    m_i64TimeStamp(i64TimeStamp),
+    m_uNumChannels(uNumChannels),
+    m_uNumBlocks(uNumBlocks),
+    m_uBlockLength(uBlockLength),
+    m_vfFrequencies_Hz(vfFrequencies_Hz),
+    m_vfPowers((size_t)uNumChannels * uNumBlocks * vfFrequencies_Hz.size(), 0.0f)
+{
+}
+
+unsigned TonePowerChunk::GetInternalSize()
+{
+    return sizeof(m_dSampleRate) + sizeof(m_i64TimeStamp) + 4 * sizeof(unsigned) + (m_vfFrequencies_Hz.size() + m_vfPowers.size()) * sizeof(float);
+}
+
+unsigned TonePowerChunk::GetSize()
+{
+    return BaseChunk::GetSize() + GetInternalSize();
+}
+
+std::shared_ptr<std::vector<char>> TonePowerChunk::Serialise()
+{
+    auto pvBytes = std::make_shared<std::vector<char>>(GetSize());
+    char* pcBytes = pvBytes->data();
+
+    // Serialise base class members first
+    auto pvBaseBytes = BaseChunk::Serialise();
+    memcpy(pcBytes, pvBaseBytes->data(), BaseChunk::GetSize());
+    pcBytes += BaseChunk::GetSize();
+
+    // Then the block description
+    memcpy(pcBytes, &m_dSampleRate, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(pcBytes, &m_i64TimeStamp, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    unsigned uNumTones = m_vfFrequencies_Hz.size();
+    for (unsigned uValue : { m_uNumChannels, m_uNumBlocks, m_uBlockLength, uNumTones })
+    {
+        memcpy(pcBytes, &uValue, sizeof(uValue));
+        pcBytes += sizeof(uValue);
+    }
+
+    // And finally the tone frequencies followed by the contiguous power matrix
+    memcpy(pcBytes, m_vfFrequencies_Hz.data(), m_vfFrequencies_Hz.size() * sizeof(float));
+    pcBytes += m_vfFrequencies_Hz.size() * sizeof(float);
+    memcpy(pcBytes, m_vfPowers.data(), m_vfPowers.size() * sizeof(float));
+
+    return pvBytes;
+}
+
+void TonePowerChunk::Deserialise(std::shared_ptr<std::vector<char>> pvBytes)
+{
+    BaseChunk::Deserialise(pvBytes);
+    char* pcBytes = pvBytes->data() + BaseChunk::GetSize();
+
+    memcpy(&m_dSampleRate, pcBytes, sizeof(m_dSampleRate));
+    pcBytes += sizeof(m_dSampleRate);
+    memcpy(&m_i64TimeStamp, pcBytes, sizeof(m_i64TimeStamp));
+    pcBytes += sizeof(m_i64TimeStamp);
+    unsigned uNumTones = 0;
+    for (unsigned* puValue : { &m_uNumChannels, &m_uNumBlocks, &m_uBlockLength, &uNumTones })
+    {
+        memcpy(puValue, pcBytes, sizeof(unsigned));
+        pcBytes += sizeof(unsigned);
+    }
+
+    m_vfFrequencies_Hz.resize(uNumTones);
+    memcpy(m_vfFrequencies_Hz.data(), pcBytes, uNumTones * sizeof(float));
+    pcBytes += uNumTones * sizeof(float);
+
+    m_vfPowers.resize((size_t)m_uNumChannels * m_uNumBlocks * uNumTones);
+    memcpy(m_vfPowers.data(), pcBytes, m_vfPowers.size() * sizeof(float));
+}
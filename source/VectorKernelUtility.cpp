@@ -0,0 +1,806 @@
+#include "VectorKernelUtility.h"
+
+/*Standard Includes*/
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Minimax odd polynomial for atan on [0, 1] and Abramowitz and Stegun 4.4.46 for asin on [0, 1],
+    // shared by every variant so they agree to rounding
+    constexpr float fAtan1 = 0.99997726f, fAtan3 = -0.33262347f, fAtan5 = 0.19354346f, fAtan7 = -0.11643287f, fAtan9 = 0.05265332f, fAtan11 = -0.01172120f;
+    constexpr float fAsin0 = 1.5707963050f, fAsin1 = -0.2145988016f, fAsin2 = 0.0889789874f, fAsin3 = -0.0501743046f;
+    constexpr float fAsin4 = 0.0308918810f, fAsin5 = -0.0170881256f, fAsin6 = 0.0066700901f, fAsin7 = -0.0012624911f;
+    constexpr float fHalfPi = 1.57079632679f, fPi = 3.14159265359f;
+
+    // Scalar fallbacks, also used for the tails of the vector variants
+
+    void ConvertInt16ToFloat_Scalar(const int16_t* pi16Input, float* pfOutput, size_t uLength)
+    {
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+            pfOutput[uIndex] = pi16Input[uIndex];
+    }
+
+    void ConvertFloatToInt16_Scalar(const float* pfInput, int16_t* pi16Output, size_t uLength)
+    {
+        // Clamp first then round half to even, as the vector conversions do
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+            pi16Output[uIndex] = (int16_t)std::nearbyint(std::clamp(pfInput[uIndex], -32768.0f, 32767.0f));
+    }
+
+    void Scale_Scalar(float* pfData, size_t uLength, float fGain)
+    {
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+            pfData[uIndex] *= fGain;
+    }
+
+    void Multiply_Scalar(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength)
+    {
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+            pfOutput[uIndex] = pfFirst[uIndex] * pfSecond[uIndex];
+    }
+
+    float SquareAndSum_Scalar(const float* pfInput, float* pfOutput, size_t uLength)
+    {
+        float fSum = 0;
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+        {
+            pfOutput[uIndex] = pfInput[uIndex] * pfInput[uIndex];
+            fSum += pfOutput[uIndex];
+        }
+        return fSum;
+    }
+
+    size_t FindIndicesAbove_Scalar(const float* pfInput, size_t uStartIndex, size_t uLength, float fThreshold, uint32_t* puIndices)
+    {
+        size_t uNumFound = 0;
+        for (size_t uIndex = uStartIndex; uIndex < uLength; uIndex++)
+            if (pfInput[uIndex] > fThreshold)
+                puIndices[uNumFound++] = uIndex;
+        return uNumFound;
+    }
+
+    size_t FindIndicesAboveReference_Scalar(const float* pfInput, const float* pfReference, float fRatio, size_t uStartIndex, size_t uLength, uint32_t* puIndices)
+    {
+        size_t uNumFound = 0;
+        for (size_t uIndex = uStartIndex; uIndex < uLength; uIndex++)
+            if (pfInput[uIndex] > fRatio * pfReference[uIndex])
+                puIndices[uNumFound++] = uIndex;
+        return uNumFound;
+    }
+
+    void MultiplyAccumulate_Scalar(const float* pfInput, float fGain, float* pfAccumulator, size_t uLength)
+    {
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+            pfAccumulator[uIndex] += fGain * pfInput[uIndex];
+    }
+
+    float ReducePartialSums(const float (&afPartialSums)[8])
+    {
+        return ((afPartialSums[0] + afPartialSums[4]) + (afPartialSums[2] + afPartialSums[6])) + ((afPartialSums[1] + afPartialSums[5]) + (afPartialSums[3] + afPartialSums[7]));
+    }
+
+    float DotProductTail_Scalar(const float* pfFirst, const float* pfSecond, size_t uLength)
+    {
+        float fSum = 0.0f;
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+            fSum += pfFirst[uIndex] * pfSecond[uIndex];
+        return fSum;
+    }
+
+    float DotProduct_Scalar(const float* pfFirst, const float* pfSecond, size_t uLength)
+    {
+        // Eight partial sums in the lane order of the vector variants so every variant rounds identically
+        float afPartialSums[8] = {};
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+            for (unsigned uLane = 0; uLane < 8; uLane++)
+                afPartialSums[uLane] += pfFirst[uIndex + uLane] * pfSecond[uIndex + uLane];
+        return ReducePartialSums(afPartialSums) + DotProductTail_Scalar(pfFirst + uIndex, pfSecond + uIndex, uLength - uIndex);
+    }
+
+    void ComplexMagnitude_Scalar(const float* pfInterleaved, float* pfOutput, size_t uLength)
+    {
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+        {
+            float fReal = pfInterleaved[2 * uIndex];
+            float fImag = pfInterleaved[2 * uIndex + 1];
+            pfOutput[uIndex] = std::sqrt(fReal * fReal + fImag * fImag);
+        }
+    }
+
+    void PhaseDifference_Scalar(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength)
+    {
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+        {
+            // Argument of first x conj(second)
+            float fReal = pfFirst[2 * uIndex] * pfSecond[2 * uIndex] + pfFirst[2 * uIndex + 1] * pfSecond[2 * uIndex + 1];
+            float fImag = pfFirst[2 * uIndex + 1] * pfSecond[2 * uIndex] - pfFirst[2 * uIndex] * pfSecond[2 * uIndex + 1];
+
+            float fAbsReal = std::fabs(fReal);
+            float fAbsImag = std::fabs(fImag);
+            float fMax = std::max(fAbsReal, fAbsImag);
+            float fRatio = fMax > 0 ? std::min(fAbsReal, fAbsImag) / fMax : 0.0f;
+            float fRatioSquared = fRatio * fRatio;
+            float fAngle = fRatio * (fAtan1 + fRatioSquared * (fAtan3 + fRatioSquared * (fAtan5 + fRatioSquared * (fAtan7 + fRatioSquared * (fAtan9 + fRatioSquared * fAtan11)))));
+
+            if (fAbsImag > fAbsReal)
+                fAngle = fHalfPi - fAngle;
+            if (fReal < 0)
+                fAngle = fPi - fAngle;
+            pfOutput[uIndex] = std::copysign(fAngle, fImag);
+        }
+    }
+
+    void ArcSine_Scalar(const float* pfInput, float* pfOutput, size_t uLength)
+    {
+        for (size_t uIndex = 0; uIndex < uLength; uIndex++)
+        {
+            float fAbs = std::min(std::fabs(pfInput[uIndex]), 1.0f);
+            float fPolynomial = fAsin0 + fAbs * (fAsin1 + fAbs * (fAsin2 + fAbs * (fAsin3 + fAbs * (fAsin4 + fAbs * (fAsin5 + fAbs * (fAsin6 + fAbs * fAsin7))))));
+            pfOutput[uIndex] = std::copysign(fHalfPi - std::sqrt(1.0f - fAbs) * fPolynomial, pfInput[uIndex]);
+        }
+    }
+
+#ifdef VECTOR_KERNELS_X86
+
+    // SSE2, four floats per register
+
+    __attribute__((target("sse2")))
+    void ConvertInt16ToFloat_SSE2(const int16_t* pi16Input, float* pfOutput, size_t uLength)
+    {
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m128i i16Samples = _mm_loadu_si128((const __m128i*)(pi16Input + uIndex));
+            // Sign extend by unpacking into the upper halves and shifting back down
+            __m128i i32Low = _mm_srai_epi32(_mm_unpacklo_epi16(i16Samples, i16Samples), 16);
+            __m128i i32High = _mm_srai_epi32(_mm_unpackhi_epi16(i16Samples, i16Samples), 16);
+            _mm_storeu_ps(pfOutput + uIndex, _mm_cvtepi32_ps(i32Low));
+            _mm_storeu_ps(pfOutput + uIndex + 4, _mm_cvtepi32_ps(i32High));
+        }
+        ConvertInt16ToFloat_Scalar(pi16Input + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("sse2")))
+    void ConvertFloatToInt16_SSE2(const float* pfInput, int16_t* pi16Output, size_t uLength)
+    {
+        // Clamping before conversion stops large values wrapping to the int32 indefinite value
+        __m128 fMinimum = _mm_set1_ps(-32768.0f);
+        __m128 fMaximum = _mm_set1_ps(32767.0f);
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m128i i32Low = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pfInput + uIndex), fMinimum), fMaximum));
+            __m128i i32High = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pfInput + uIndex + 4), fMinimum), fMaximum));
+            _mm_storeu_si128((__m128i*)(pi16Output + uIndex), _mm_packs_epi32(i32Low, i32High));
+        }
+        ConvertFloatToInt16_Scalar(pfInput + uIndex, pi16Output + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("sse2")))
+    void Scale_SSE2(float* pfData, size_t uLength, float fGain)
+    {
+        __m128 fGains = _mm_set1_ps(fGain);
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+            _mm_storeu_ps(pfData + uIndex, _mm_mul_ps(_mm_loadu_ps(pfData + uIndex), fGains));
+        Scale_Scalar(pfData + uIndex, uLength - uIndex, fGain);
+    }
+
+    __attribute__((target("sse2")))
+    void Multiply_SSE2(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength)
+    {
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+            _mm_storeu_ps(pfOutput + uIndex, _mm_mul_ps(_mm_loadu_ps(pfFirst + uIndex), _mm_loadu_ps(pfSecond + uIndex)));
+        Multiply_Scalar(pfFirst + uIndex, pfSecond + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("sse2")))
+    float SquareAndSum_SSE2(const float* pfInput, float* pfOutput, size_t uLength)
+    {
+        __m128 fSums = _mm_setzero_ps();
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+        {
+            __m128 fValues = _mm_loadu_ps(pfInput + uIndex);
+            __m128 fSquares = _mm_mul_ps(fValues, fValues);
+            _mm_storeu_ps(pfOutput + uIndex, fSquares);
+            fSums = _mm_add_ps(fSums, fSquares);
+        }
+
+        alignas(16) float afSums[4];
+        _mm_store_ps(afSums, fSums);
+        return (afSums[0] + afSums[1]) + (afSums[2] + afSums[3]) + SquareAndSum_Scalar(pfInput + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("sse2")))
+    size_t FindIndicesAbove_SSE2(const float* pfInput, size_t uLength, float fThreshold, uint32_t* puIndices)
+    {
+        // Most bins are below threshold so whole registers are usually skipped with one test
+        __m128 fThresholds = _mm_set1_ps(fThreshold);
+        size_t uNumFound = 0;
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+        {
+            int iMask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(pfInput + uIndex), fThresholds));
+            while (iMask)
+            {
+                puIndices[uNumFound++] = uIndex + __builtin_ctz(iMask);
+                iMask &= iMask - 1;
+            }
+        }
+        return uNumFound + FindIndicesAbove_Scalar(pfInput, uIndex, uLength, fThreshold, puIndices + uNumFound);
+    }
+
+    __attribute__((target("sse2")))
+    size_t FindIndicesAboveReference_SSE2(const float* pfInput, const float* pfReference, float fRatio, size_t uLength, uint32_t* puIndices)
+    {
+        __m128 fRatios = _mm_set1_ps(fRatio);
+        size_t uNumFound = 0;
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+        {
+            __m128 fThresholds = _mm_mul_ps(fRatios, _mm_loadu_ps(pfReference + uIndex));
+            int iMask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(pfInput + uIndex), fThresholds));
+            while (iMask)
+            {
+                puIndices[uNumFound++] = uIndex + __builtin_ctz(iMask);
+                iMask &= iMask - 1;
+            }
+        }
+        return uNumFound + FindIndicesAboveReference_Scalar(pfInput, pfReference, fRatio, uIndex, uLength, puIndices + uNumFound);
+    }
+
+    __attribute__((target("sse2")))
+    void MultiplyAccumulate_SSE2(const float* pfInput, float fGain, float* pfAccumulator, size_t uLength)
+    {
+        __m128 fGains = _mm_set1_ps(fGain);
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+            _mm_storeu_ps(pfAccumulator + uIndex, _mm_add_ps(_mm_loadu_ps(pfAccumulator + uIndex), _mm_mul_ps(_mm_loadu_ps(pfInput + uIndex), fGains)));
+        MultiplyAccumulate_Scalar(pfInput + uIndex, fGain, pfAccumulator + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("sse2")))
+    float DotProduct_SSE2(const float* pfFirst, const float* pfSecond, size_t uLength)
+    {
+        // Two registers hold the same eight partial sums as the other variants
+        __m128 fLowSums = _mm_setzero_ps();
+        __m128 fHighSums = _mm_setzero_ps();
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            fLowSums = _mm_add_ps(fLowSums, _mm_mul_ps(_mm_loadu_ps(pfFirst + uIndex), _mm_loadu_ps(pfSecond + uIndex)));
+            fHighSums = _mm_add_ps(fHighSums, _mm_mul_ps(_mm_loadu_ps(pfFirst + uIndex + 4), _mm_loadu_ps(pfSecond + uIndex + 4)));
+        }
+
+        float afPartialSums[8];
+        _mm_storeu_ps(afPartialSums, fLowSums);
+        _mm_storeu_ps(afPartialSums + 4, fHighSums);
+        return ReducePartialSums(afPartialSums) + DotProductTail_Scalar(pfFirst + uIndex, pfSecond + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("sse2")))
+    void ComplexMagnitude_SSE2(const float* pfInterleaved, float* pfOutput, size_t uLength)
+    {
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+        {
+            __m128 fFirstPair = _mm_loadu_ps(pfInterleaved + 2 * uIndex);
+            __m128 fSecondPair = _mm_loadu_ps(pfInterleaved + 2 * uIndex + 4);
+            // De-interleave into real and imaginary registers
+            __m128 fReal = _mm_shuffle_ps(fFirstPair, fSecondPair, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 fImag = _mm_shuffle_ps(fFirstPair, fSecondPair, _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 fPower = _mm_add_ps(_mm_mul_ps(fReal, fReal), _mm_mul_ps(fImag, fImag));
+            _mm_storeu_ps(pfOutput + uIndex, _mm_sqrt_ps(fPower));
+        }
+        ComplexMagnitude_Scalar(pfInterleaved + 2 * uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    // SSE2 has no blend, so selects are built from and, andnot and or
+    __attribute__((target("sse2")))
+    inline __m128 Select_SSE2(__m128 fMask, __m128 fIfTrue, __m128 fIfFalse)
+    {
+        return _mm_or_ps(_mm_and_ps(fMask, fIfTrue), _mm_andnot_ps(fMask, fIfFalse));
+    }
+
+    __attribute__((target("sse2")))
+    void PhaseDifference_SSE2(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength)
+    {
+        const __m128 fSignMask = _mm_set1_ps(-0.0f);
+        const __m128 fZero = _mm_setzero_ps();
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+        {
+            __m128 fFirstA = _mm_loadu_ps(pfFirst + 2 * uIndex);
+            __m128 fFirstB = _mm_loadu_ps(pfFirst + 2 * uIndex + 4);
+            __m128 fSecondA = _mm_loadu_ps(pfSecond + 2 * uIndex);
+            __m128 fSecondB = _mm_loadu_ps(pfSecond + 2 * uIndex + 4);
+            __m128 fFirstReal = _mm_shuffle_ps(fFirstA, fFirstB, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 fFirstImag = _mm_shuffle_ps(fFirstA, fFirstB, _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 fSecondReal = _mm_shuffle_ps(fSecondA, fSecondB, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 fSecondImag = _mm_shuffle_ps(fSecondA, fSecondB, _MM_SHUFFLE(3, 1, 3, 1));
+
+            __m128 fReal = _mm_add_ps(_mm_mul_ps(fFirstReal, fSecondReal), _mm_mul_ps(fFirstImag, fSecondImag));
+            __m128 fImag = _mm_sub_ps(_mm_mul_ps(fFirstImag, fSecondReal), _mm_mul_ps(fFirstReal, fSecondImag));
+
+            __m128 fAbsReal = _mm_andnot_ps(fSignMask, fReal);
+            __m128 fAbsImag = _mm_andnot_ps(fSignMask, fImag);
+            __m128 fMax = _mm_max_ps(fAbsReal, fAbsImag);
+            __m128 fRatio = _mm_and_ps(_mm_div_ps(_mm_min_ps(fAbsReal, fAbsImag), fMax), _mm_cmpgt_ps(fMax, fZero));
+            __m128 fRatioSquared = _mm_mul_ps(fRatio, fRatio);
+
+            __m128 fPolynomial = _mm_set1_ps(fAtan11);
+            for (float fCoefficient : { fAtan9, fAtan7, fAtan5, fAtan3, fAtan1 })
+                fPolynomial = _mm_add_ps(_mm_mul_ps(fPolynomial, fRatioSquared), _mm_set1_ps(fCoefficient));
+            __m128 fAngle = _mm_mul_ps(fPolynomial, fRatio);
+
+            fAngle = Select_SSE2(_mm_cmpgt_ps(fAbsImag, fAbsReal), _mm_sub_ps(_mm_set1_ps(fHalfPi), fAngle), fAngle);
+            fAngle = Select_SSE2(_mm_cmplt_ps(fReal, fZero), _mm_sub_ps(_mm_set1_ps(fPi), fAngle), fAngle);
+            fAngle = _mm_or_ps(fAngle, _mm_and_ps(fImag, fSignMask));
+            _mm_storeu_ps(pfOutput + uIndex, fAngle);
+        }
+        PhaseDifference_Scalar(pfFirst + 2 * uIndex, pfSecond + 2 * uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("sse2")))
+    void ArcSine_SSE2(const float* pfInput, float* pfOutput, size_t uLength)
+    {
+        const __m128 fSignMask = _mm_set1_ps(-0.0f);
+        const __m128 fOne = _mm_set1_ps(1.0f);
+        size_t uIndex = 0;
+        for (; uIndex + 4 <= uLength; uIndex += 4)
+        {
+            __m128 fInput = _mm_loadu_ps(pfInput + uIndex);
+            __m128 fAbs = _mm_min_ps(_mm_andnot_ps(fSignMask, fInput), fOne);
+
+            __m128 fPolynomial = _mm_set1_ps(fAsin7);
+            for (float fCoefficient : { fAsin6, fAsin5, fAsin4, fAsin3, fAsin2, fAsin1, fAsin0 })
+                fPolynomial = _mm_add_ps(_mm_mul_ps(fPolynomial, fAbs), _mm_set1_ps(fCoefficient));
+
+            __m128 fAngle = _mm_sub_ps(_mm_set1_ps(fHalfPi), _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(fOne, fAbs)), fPolynomial));
+            _mm_storeu_ps(pfOutput + uIndex, _mm_or_ps(fAngle, _mm_and_ps(fInput, fSignMask)));
+        }
+        ArcSine_Scalar(pfInput + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    // AVX2, eight floats per register
+
+    __attribute__((target("avx2")))
+    void ConvertInt16ToFloat_AVX2(const int16_t* pi16Input, float* pfOutput, size_t uLength)
+    {
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m256i i32Samples = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(pi16Input + uIndex)));
+            _mm256_storeu_ps(pfOutput + uIndex, _mm256_cvtepi32_ps(i32Samples));
+        }
+        ConvertInt16ToFloat_Scalar(pi16Input + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    void ConvertFloatToInt16_AVX2(const float* pfInput, int16_t* pi16Output, size_t uLength)
+    {
+        __m256 fMinimum = _mm256_set1_ps(-32768.0f);
+        __m256 fMaximum = _mm256_set1_ps(32767.0f);
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m256i i32Samples = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(pfInput + uIndex), fMinimum), fMaximum));
+            // Packing works within 128 bit lanes, so pack the two halves together directly
+            __m128i i16Samples = _mm_packs_epi32(_mm256_castsi256_si128(i32Samples), _mm256_extracti128_si256(i32Samples, 1));
+            _mm_storeu_si128((__m128i*)(pi16Output + uIndex), i16Samples);
+        }
+        ConvertFloatToInt16_Scalar(pfInput + uIndex, pi16Output + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    void Scale_AVX2(float* pfData, size_t uLength, float fGain)
+    {
+        __m256 fGains = _mm256_set1_ps(fGain);
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+            _mm256_storeu_ps(pfData + uIndex, _mm256_mul_ps(_mm256_loadu_ps(pfData + uIndex), fGains));
+        Scale_Scalar(pfData + uIndex, uLength - uIndex, fGain);
+    }
+
+    __attribute__((target("avx2")))
+    void Multiply_AVX2(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength)
+    {
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+            _mm256_storeu_ps(pfOutput + uIndex, _mm256_mul_ps(_mm256_loadu_ps(pfFirst + uIndex), _mm256_loadu_ps(pfSecond + uIndex)));
+        Multiply_Scalar(pfFirst + uIndex, pfSecond + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    float SquareAndSum_AVX2(const float* pfInput, float* pfOutput, size_t uLength)
+    {
+        __m256 fSums = _mm256_setzero_ps();
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m256 fValues = _mm256_loadu_ps(pfInput + uIndex);
+            __m256 fSquares = _mm256_mul_ps(fValues, fValues);
+            _mm256_storeu_ps(pfOutput + uIndex, fSquares);
+            fSums = _mm256_add_ps(fSums, fSquares);
+        }
+
+        alignas(32) float afSums[8];
+        _mm256_store_ps(afSums, fSums);
+        float fSum = ((afSums[0] + afSums[1]) + (afSums[2] + afSums[3])) + ((afSums[4] + afSums[5]) + (afSums[6] + afSums[7]));
+        return fSum + SquareAndSum_Scalar(pfInput + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    size_t FindIndicesAbove_AVX2(const float* pfInput, size_t uLength, float fThreshold, uint32_t* puIndices)
+    {
+        __m256 fThresholds = _mm256_set1_ps(fThreshold);
+        size_t uNumFound = 0;
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            int iMask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(pfInput + uIndex), fThresholds, _CMP_GT_OQ));
+            while (iMask)
+            {
+                puIndices[uNumFound++] = uIndex + __builtin_ctz(iMask);
+                iMask &= iMask - 1;
+            }
+        }
+        return uNumFound + FindIndicesAbove_Scalar(pfInput, uIndex, uLength, fThreshold, puIndices + uNumFound);
+    }
+
+    __attribute__((target("avx2")))
+    size_t FindIndicesAboveReference_AVX2(const float* pfInput, const float* pfReference, float fRatio, size_t uLength, uint32_t* puIndices)
+    {
+        __m256 fRatios = _mm256_set1_ps(fRatio);
+        size_t uNumFound = 0;
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m256 fThresholds = _mm256_mul_ps(fRatios, _mm256_loadu_ps(pfReference + uIndex));
+            int iMask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(pfInput + uIndex), fThresholds, _CMP_GT_OQ));
+            while (iMask)
+            {
+                puIndices[uNumFound++] = uIndex + __builtin_ctz(iMask);
+                iMask &= iMask - 1;
+            }
+        }
+        return uNumFound + FindIndicesAboveReference_Scalar(pfInput, pfReference, fRatio, uIndex, uLength, puIndices + uNumFound);
+    }
+
+    __attribute__((target("avx2")))
+    void MultiplyAccumulate_AVX2(const float* pfInput, float fGain, float* pfAccumulator, size_t uLength)
+    {
+        // Separate multiply and add (no FMA) so results match the other variants exactly
+        __m256 fGains = _mm256_set1_ps(fGain);
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+            _mm256_storeu_ps(pfAccumulator + uIndex, _mm256_add_ps(_mm256_loadu_ps(pfAccumulator + uIndex), _mm256_mul_ps(_mm256_loadu_ps(pfInput + uIndex), fGains)));
+        MultiplyAccumulate_Scalar(pfInput + uIndex, fGain, pfAccumulator + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    float DotProduct_AVX2(const float* pfFirst, const float* pfSecond, size_t uLength)
+    {
+        __m256 fSums = _mm256_setzero_ps();
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+            fSums = _mm256_add_ps(fSums, _mm256_mul_ps(_mm256_loadu_ps(pfFirst + uIndex), _mm256_loadu_ps(pfSecond + uIndex)));
+
+        float afPartialSums[8];
+        _mm256_storeu_ps(afPartialSums, fSums);
+        return ReducePartialSums(afPartialSums) + DotProductTail_Scalar(pfFirst + uIndex, pfSecond + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    void ComplexMagnitude_AVX2(const float* pfInterleaved, float* pfOutput, size_t uLength)
+    {
+        // Shuffling within lanes leaves values in 0 1 4 5 2 3 6 7 order, this puts them back
+        const __m256i i32LaneOrder = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m256 fFirstPairs = _mm256_loadu_ps(pfInterleaved + 2 * uIndex);
+            __m256 fSecondPairs = _mm256_loadu_ps(pfInterleaved + 2 * uIndex + 8);
+            __m256 fReal = _mm256_shuffle_ps(fFirstPairs, fSecondPairs, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 fImag = _mm256_shuffle_ps(fFirstPairs, fSecondPairs, _MM_SHUFFLE(3, 1, 3, 1));
+            __m256 fPower = _mm256_add_ps(_mm256_mul_ps(fReal, fReal), _mm256_mul_ps(fImag, fImag));
+            __m256 fMagnitude = _mm256_permutevar8x32_ps(_mm256_sqrt_ps(fPower), i32LaneOrder);
+            _mm256_storeu_ps(pfOutput + uIndex, fMagnitude);
+        }
+        ComplexMagnitude_Scalar(pfInterleaved + 2 * uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    void PhaseDifference_AVX2(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength)
+    {
+        const __m256i i32LaneOrder = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+        const __m256 fSignMask = _mm256_set1_ps(-0.0f);
+        const __m256 fZero = _mm256_setzero_ps();
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m256 fFirstA = _mm256_loadu_ps(pfFirst + 2 * uIndex);
+            __m256 fFirstB = _mm256_loadu_ps(pfFirst + 2 * uIndex + 8);
+            __m256 fSecondA = _mm256_loadu_ps(pfSecond + 2 * uIndex);
+            __m256 fSecondB = _mm256_loadu_ps(pfSecond + 2 * uIndex + 8);
+            __m256 fFirstReal = _mm256_shuffle_ps(fFirstA, fFirstB, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 fFirstImag = _mm256_shuffle_ps(fFirstA, fFirstB, _MM_SHUFFLE(3, 1, 3, 1));
+            __m256 fSecondReal = _mm256_shuffle_ps(fSecondA, fSecondB, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 fSecondImag = _mm256_shuffle_ps(fSecondA, fSecondB, _MM_SHUFFLE(3, 1, 3, 1));
+
+            __m256 fReal = _mm256_add_ps(_mm256_mul_ps(fFirstReal, fSecondReal), _mm256_mul_ps(fFirstImag, fSecondImag));
+            __m256 fImag = _mm256_sub_ps(_mm256_mul_ps(fFirstImag, fSecondReal), _mm256_mul_ps(fFirstReal, fSecondImag));
+
+            __m256 fAbsReal = _mm256_andnot_ps(fSignMask, fReal);
+            __m256 fAbsImag = _mm256_andnot_ps(fSignMask, fImag);
+            __m256 fMax = _mm256_max_ps(fAbsReal, fAbsImag);
+            __m256 fRatio = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(fAbsReal, fAbsImag), fMax), _mm256_cmp_ps(fMax, fZero, _CMP_GT_OQ));
+            __m256 fRatioSquared = _mm256_mul_ps(fRatio, fRatio);
+
+            __m256 fPolynomial = _mm256_set1_ps(fAtan11);
+            for (float fCoefficient : { fAtan9, fAtan7, fAtan5, fAtan3, fAtan1 })
+                fPolynomial = _mm256_add_ps(_mm256_mul_ps(fPolynomial, fRatioSquared), _mm256_set1_ps(fCoefficient));
+            __m256 fAngle = _mm256_mul_ps(fPolynomial, fRatio);
+
+            fAngle = _mm256_blendv_ps(fAngle, _mm256_sub_ps(_mm256_set1_ps(fHalfPi), fAngle), _mm256_cmp_ps(fAbsImag, fAbsReal, _CMP_GT_OQ));
+            fAngle = _mm256_blendv_ps(fAngle, _mm256_sub_ps(_mm256_set1_ps(fPi), fAngle), _mm256_cmp_ps(fReal, fZero, _CMP_LT_OQ));
+            fAngle = _mm256_or_ps(fAngle, _mm256_and_ps(fImag, fSignMask));
+            _mm256_storeu_ps(pfOutput + uIndex, _mm256_permutevar8x32_ps(fAngle, i32LaneOrder));
+        }
+        PhaseDifference_Scalar(pfFirst + 2 * uIndex, pfSecond + 2 * uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+    __attribute__((target("avx2")))
+    void ArcSine_AVX2(const float* pfInput, float* pfOutput, size_t uLength)
+    {
+        const __m256 fSignMask = _mm256_set1_ps(-0.0f);
+        const __m256 fOne = _mm256_set1_ps(1.0f);
+        size_t uIndex = 0;
+        for (; uIndex + 8 <= uLength; uIndex += 8)
+        {
+            __m256 fInput = _mm256_loadu_ps(pfInput + uIndex);
+            __m256 fAbs = _mm256_min_ps(_mm256_andnot_ps(fSignMask, fInput), fOne);
+
+            __m256 fPolynomial = _mm256_set1_ps(fAsin7);
+            for (float fCoefficient : { fAsin6, fAsin5, fAsin4, fAsin3, fAsin2, fAsin1, fAsin0 })
+                fPolynomial = _mm256_add_ps(_mm256_mul_ps(fPolynomial, fAbs), _mm256_set1_ps(fCoefficient));
+
+            __m256 fAngle = _mm256_sub_ps(_mm256_set1_ps(fHalfPi), _mm256_mul_ps(_mm256_sqrt_ps(_mm256_sub_ps(fOne, fAbs)), fPolynomial));
+            _mm256_storeu_ps(pfOutput + uIndex, _mm256_or_ps(fAngle, _mm256_and_ps(fInput, fSignMask)));
+        }
+        ArcSine_Scalar(pfInput + uIndex, pfOutput + uIndex, uLength - uIndex);
+    }
+
+#endif
+}
+
+std::atomic<VectorKernelUtility::InstructionSet> VectorKernelUtility::s_ActiveInstructionSet = VectorKernelUtility::GetSupportedInstructionSet();
+
+VectorKernelUtility::InstructionSet VectorKernelUtility::GetSupportedInstructionSet()
+{
+#ifdef VECTOR_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return InstructionSet::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return InstructionSet::SSE2;
+#endif
+    return InstructionSet::Scalar;
+}
+
+void VectorKernelUtility::SetInstructionSet(InstructionSet InstructionSetToUse)
+{
+    if (InstructionSetToUse > GetSupportedInstructionSet())
+        throw std::runtime_error(std::string(__FUNCTION__) + ": " + GetInstructionSetName(InstructionSetToUse) + " is not supported on this CPU");
+
+    s_ActiveInstructionSet = InstructionSetToUse;
+}
+
+std::string VectorKernelUtility::GetInstructionSetName(InstructionSet InstructionSetToName)
+{
+    switch (InstructionSetToName)
+    {
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::SSE2:
+        return "SSE2";
+    default:
+        return "Scalar";
+    }
+}
+
+void VectorKernelUtility::ConvertInt16ToFloat(const int16_t* pi16Input, float* pfOutput, size_t uLength)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return ConvertInt16ToFloat_AVX2(pi16Input, pfOutput, uLength);
+    case InstructionSet::SSE2:
+        return ConvertInt16ToFloat_SSE2(pi16Input, pfOutput, uLength);
+#endif
+    default:
+        return ConvertInt16ToFloat_Scalar(pi16Input, pfOutput, uLength);
+    }
+}
+
+void VectorKernelUtility::ConvertFloatToInt16(const float* pfInput, int16_t* pi16Output, size_t uLength)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return ConvertFloatToInt16_AVX2(pfInput, pi16Output, uLength);
+    case InstructionSet::SSE2:
+        return ConvertFloatToInt16_SSE2(pfInput, pi16Output, uLength);
+#endif
+    default:
+        return ConvertFloatToInt16_Scalar(pfInput, pi16Output, uLength);
+    }
+}
+
+void VectorKernelUtility::Scale(float* pfData, size_t uLength, float fGain)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return Scale_AVX2(pfData, uLength, fGain);
+    case InstructionSet::SSE2:
+        return Scale_SSE2(pfData, uLength, fGain);
+#endif
+    default:
+        return Scale_Scalar(pfData, uLength, fGain);
+    }
+}
+
+void VectorKernelUtility::Multiply(const float* pfFirst, const float* pfSecond, float* pfOutput, size_t uLength)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return Multiply_AVX2(pfFirst, pfSecond, pfOutput, uLength);
+    case InstructionSet::SSE2:
+        return Multiply_SSE2(pfFirst, pfSecond, pfOutput, uLength);
+#endif
+    default:
+        return Multiply_Scalar(pfFirst, pfSecond, pfOutput, uLength);
+    }
+}
+
+float VectorKernelUtility::SquareAndSum(const float* pfInput, float* pfOutput, size_t uLength)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return SquareAndSum_AVX2(pfInput, pfOutput, uLength);
+    case InstructionSet::SSE2:
+        return SquareAndSum_SSE2(pfInput, pfOutput, uLength);
+#endif
+    default:
+        return SquareAndSum_Scalar(pfInput, pfOutput, uLength);
+    }
+}
+
+size_t VectorKernelUtility::FindIndicesAbove(const float* pfInput, size_t uLength, float fThreshold, uint32_t* puIndices)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return FindIndicesAbove_AVX2(pfInput, uLength, fThreshold, puIndices);
+    case InstructionSet::SSE2:
+        return FindIndicesAbove_SSE2(pfInput, uLength, fThreshold, puIndices);
+#endif
+    default:
+        return FindIndicesAbove_Scalar(pfInput, 0, uLength, fThreshold, puIndices);
+    }
+}
+
+size_t VectorKernelUtility::FindIndicesAboveReference(const float* pfInput, const float* pfReference, float fRatio, size_t uLength, uint32_t* puIndices)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return FindIndicesAboveReference_AVX2(pfInput, pfReference, fRatio, uLength, puIndices);
+    case InstructionSet::SSE2:
+        return FindIndicesAboveReference_SSE2(pfInput, pfReference, fRatio, uLength, puIndices);
+#endif
+    default:
+        return FindIndicesAboveReference_Scalar(pfInput, pfReference, fRatio, 0, uLength, puIndices);
+    }
+}
+
+void VectorKernelUtility::MultiplyAccumulate(const float* pfInput, float fGain, float* pfAccumulator, size_t uLength)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return MultiplyAccumulate_AVX2(pfInput, fGain, pfAccumulator, uLength);
+    case InstructionSet::SSE2:
+        return MultiplyAccumulate_SSE2(pfInput, fGain, pfAccumulator, uLength);
+#endif
+    default:
+        return MultiplyAccumulate_Scalar(pfInput, fGain, pfAccumulator, uLength);
+    }
+}
+
+float VectorKernelUtility::DotProduct(const float* pfFirst, const float* pfSecond, size_t uLength)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return DotProduct_AVX2(pfFirst, pfSecond, uLength);
+    case InstructionSet::SSE2:
+        return DotProduct_SSE2(pfFirst, pfSecond, uLength);
+#endif
+    default:
+        return DotProduct_Scalar(pfFirst, pfSecond, uLength);
+    }
+}
+
+void VectorKernelUtility::ComplexMagnitude(const std::complex<float>* pcfInput, float* pfOutput, size_t uLength)
+{
+    // std::complex is guaranteed to be laid out as real, imaginary pairs
+    const float* pfInterleaved = reinterpret_cast<const float*>(pcfInput);
+
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return ComplexMagnitude_AVX2(pfInterleaved, pfOutput, uLength);
+    case InstructionSet::SSE2:
+        return ComplexMagnitude_SSE2(pfInterleaved, pfOutput, uLength);
+#endif
+    default:
+        return ComplexMagnitude_Scalar(pfInterleaved, pfOutput, uLength);
+    }
+}
+
+void VectorKernelUtility::PhaseDifference(const std::complex<float>* pcfFirst, const std::complex<float>* pcfSecond, float* pfOutput, size_t uLength)
+{
+    const float* pfFirst = reinterpret_cast<const float*>(pcfFirst);
+    const float* pfSecond = reinterpret_cast<const float*>(pcfSecond);
+
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return PhaseDifference_AVX2(pfFirst, pfSecond, pfOutput, uLength);
+    case InstructionSet::SSE2:
+        return PhaseDifference_SSE2(pfFirst, pfSecond, pfOutput, uLength);
+#endif
+    default:
+        return PhaseDifference_Scalar(pfFirst, pfSecond, pfOutput, uLength);
+    }
+}
+
+void VectorKernelUtility::ArcSine(const float* pfInput, float* pfOutput, size_t uLength)
+{
+    switch (s_ActiveInstructionSet.load(std::memory_order_relaxed))
+    {
+#ifdef VECTOR_KERNELS_X86
+    case InstructionSet::AVX2:
+        return ArcSine_AVX2(pfInput, pfOutput, uLength);
+    case InstructionSet::SSE2:
+        return ArcSine_SSE2(pfInput, pfOutput, uLength);
+#endif
+    default:
+        return ArcSine_Scalar(pfInput, pfOutput, uLength);
+    }
+}
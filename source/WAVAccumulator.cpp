@@ -37,7 +37,7 @@ void WAVAccumulator::Accumuluate(
 }
 
 bool WAVAccumulator::VerifyTimeContinuity(
-    std::shared_ptr<WAVChunk> pCurrentWAVChunk,
+    uint32_t u32SourceIndex, std::shared_ptr<WAVChunk> pCurrentWAVChunk,
     std::shared_ptr<WAVChunk> pAccumulatedWAVChunk) {
   // Lets start by gettinvg how much time has passed since this chunk was taken
   // (delta = fs*samples)
@@ -49,7 +49,7 @@ bool WAVAccumulator::VerifyTimeContinuity(
   uint64_t u64MircoAccumulatedPeriod = (uint64_t)(dAccumulatedPeriod * 1e6);
   // And then calcualte the expected time stamp
   uint64_t u64ExpectedCurrentTimeStamp =
-      m_i64PreviousTimeStamps[pCurrentWAVChunk->GetSourceIdentifier()] +
+      m_i64PreviousTimeStamps[u32SourceIndex] +
       u64MircoAccumulatedPeriod;
 
   // Lets then see what the difference between the true and expected timestamp
@@ -70,7 +70,7 @@ bool WAVAccumulator::VerifyTimeContinuity(
   // return bool whether within bound or not
   // Now that we have completed all the checks we can update the previous
   // timestamp to current for future checks
-  m_i64PreviousTimeStamps[pCurrentWAVChunk->GetSourceIdentifier()] =
+  m_i64PreviousTimeStamps[u32SourceIndex] =
       pCurrentWAVChunk->m_i64TimeStamp;
 
   if (!bContinuous) {
@@ -107,19 +107,21 @@ bool WAVAccumulator::WAVHeaderChanged(
 }
 
 void WAVAccumulator::AccumulateWAVChunk(std::shared_ptr<WAVChunk> pWAVChunk) {
-  auto vu8SourceIdentifier = pWAVChunk->GetSourceIdentifier();
+  uint32_t u32SourceIndex =
+      m_SourceIndexCache.Intern(pWAVChunk->GetSourceIdentifier());
 
   // Check if current MAC is being accumulated and store
-  if (m_mAccumulatedWAVChunks[vu8SourceIdentifier] == nullptr) {
-    m_mAccumulatedWAVChunks[vu8SourceIdentifier] = pWAVChunk;
-    m_i64PreviousTimeStamps[vu8SourceIdentifier] = pWAVChunk->m_i64TimeStamp;
+  if (m_mAccumulatedWAVChunks[u32SourceIndex] == nullptr) {
+    m_mAccumulatedWAVChunks[u32SourceIndex] = pWAVChunk;
+    m_i64PreviousTimeStamps[u32SourceIndex] = pWAVChunk->m_i64TimeStamp;
     return;
   }
 
   // Try accumulate data if data is continuous and unchanged
   auto pAccumulatedWAVChunk = std::static_pointer_cast<WAVChunk>(
-      m_mAccumulatedWAVChunks[vu8SourceIdentifier]);
-  bool bChunkContinuous = VerifyTimeContinuity(pWAVChunk, pAccumulatedWAVChunk);
+      m_mAccumulatedWAVChunks[u32SourceIndex]);
+  bool bChunkContinuous =
+      VerifyTimeContinuity(u32SourceIndex, pWAVChunk, pAccumulatedWAVChunk);
   bool bWAVHeaderChanged = !WAVHeaderChanged(pAccumulatedWAVChunk, pWAVChunk);
 
   if (bChunkContinuous || bWAVHeaderChanged)
@@ -130,7 +132,7 @@ void WAVAccumulator::AccumulateWAVChunk(std::shared_ptr<WAVChunk> pWAVChunk) {
     PLOG_WARNING << strWarning;
 
     TryPassChunk(std::move(pAccumulatedWAVChunk));
-    m_mAccumulatedWAVChunks[vu8SourceIdentifier] = nullptr;
+    m_mAccumulatedWAVChunks[u32SourceIndex] = nullptr;
     return;
   }
 
@@ -138,7 +140,7 @@ void WAVAccumulator::AccumulateWAVChunk(std::shared_ptr<WAVChunk> pWAVChunk) {
   bool bPassData = CheckMaxTimeThreshold(pAccumulatedWAVChunk);
   if (bPassData) {
     TryPassChunk(std::move(pAccumulatedWAVChunk));
-    m_mAccumulatedWAVChunks[vu8SourceIdentifier] = nullptr;
+    m_mAccumulatedWAVChunks[u32SourceIndex] = nullptr;
     return;
   }
 }
@@ -0,0 +1,87 @@
+#include "WindowFunctionUtility.h"
+
+#define _USE_MATH_DEFINES // Allows the use of math constants
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+std::vector<float> WindowFunctionUtility::GenerateWindow(const std::string& strWindowType, unsigned uLength)
+{
+    std::vector<float> vfWindow(uLength, 1.0f);
+
+    for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+    {
+        // Periodic form so that overlapping frames tile without a repeated end point
+        double dPhase = 2.0 * M_PI * uIndex / uLength;
+
+        if (strWindowType == "Rectangular")
+            vfWindow[uIndex] = 1.0f;
+        else if (strWindowType == "Hann")
+            vfWindow[uIndex] = 0.5 - 0.5 * std::cos(dPhase);
+        else if (strWindowType == "Blackman")
+            vfWindow[uIndex] = 0.42 - 0.5 * std::cos(dPhase) + 0.08 * std::cos(2.0 * dPhase);
+        else
+            throw std::runtime_error(std::string(__FUNCTION__) + ": " + strWindowType + " must be either Rectangular, Hann or Blackman");
+    }
+
+    return vfWindow;
+}
+
+float WindowFunctionUtility::CalculateCoherentGain(const std::vector<float>& vfWindow)
+{
+    if (vfWindow.empty())
+        return 1.0f;
+
+    return std::accumulate(vfWindow.begin(), vfWindow.end(), 0.0) / vfWindow.size();
+}
+
+std::vector<float> WindowFunctionUtility::DesignLowPassFIR(unsigned uNumTaps, float fCutoff, const std::string& strWindowType)
+{
+    if (uNumTaps == 0 || fCutoff <= 0 || fCutoff > 0.5)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Filter requires taps and a cutoff between 0 and 0.5");
+
+    // A symmetric window is the periodic window one shorter with its first point repeated at the end
+    std::vector<float> vfWindow = GenerateWindow(strWindowType, uNumTaps - 1);
+    vfWindow.push_back(uNumTaps > 1 ? vfWindow.front() : 1.0f);
+
+    std::vector<float> vfTaps(uNumTaps);
+    double dCentre = (uNumTaps - 1) / 2.0;
+    double dTapSum = 0;
+    for (unsigned uIndex = 0; uIndex < uNumTaps; uIndex++)
+    {
+        double dOffset = uIndex - dCentre;
+        double dSinc = (dOffset == 0) ? 2.0 * fCutoff : std::sin(2.0 * M_PI * fCutoff * dOffset) / (M_PI * dOffset);
+        vfTaps[uIndex] = dSinc * vfWindow[uIndex];
+        dTapSum += vfTaps[uIndex];
+    }
+
+    for (auto& fTap : vfTaps)
+        fTap /= dTapSum;
+
+    return vfTaps;
+}
+
+std::vector<float> WindowFunctionUtility::DesignFractionalDelayFIR(unsigned uNumTaps, float fFraction)
+{
+    if (uNumTaps == 0 || uNumTaps % 2 != 0 || fFraction < 0 || fFraction > 1)
+        throw std::runtime_error(std::string(__FUNCTION__) + ": Filter requires an even number of taps and a fraction between 0 and 1");
+
+    // The window is centred on the point being read rather than on the taps so every fraction has the same shape
+    std::vector<float> vfTaps(uNumTaps);
+    double dCentre = uNumTaps / 2 - 1 + fFraction;
+    double dTapSum = 0;
+    for (unsigned uIndex = 0; uIndex < uNumTaps; uIndex++)
+    {
+        double dOffset = uIndex - dCentre;
+        double dSinc = (std::abs(dOffset) < 1e-9) ? 1.0 : std::sin(M_PI * dOffset) / (M_PI * dOffset);
+        double dPhase = 2.0 * M_PI * dOffset / uNumTaps;
+        double dWindow = std::abs(dOffset) >= uNumTaps / 2.0 ? 0.0 : 0.42 + 0.5 * std::cos(dPhase) + 0.08 * std::cos(2.0 * dPhase);
+        vfTaps[uIndex] = dSinc * dWindow;
+        dTapSum += vfTaps[uIndex];
+    }
+
+    for (auto& fTap : vfTaps)
+        fTap /= dTapSum;
+
+    return vfTaps;
+}
@@ -0,0 +1,52 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned uNumWorkers)
+{
+    if (uNumWorkers == 0)
+        uNumWorkers = 1;
+
+    for (unsigned uWorkerIndex = 0; uWorkerIndex < uNumWorkers; uWorkerIndex++)
+        m_vWorkerThreads.emplace_back([this, uWorkerIndex]() { RunWorker(uWorkerIndex); });
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> TaskLock(m_TaskMutex);
+        m_bShutDown = true;
+    }
+    m_cvTaskAvailable.notify_all();
+
+    for (auto& WorkerThread : m_vWorkerThreads)
+        WorkerThread.join();
+}
+
+void WorkerPool::Submit(std::function<void(unsigned uWorkerIndex)> Task)
+{
+    {
+        std::unique_lock<std::mutex> TaskLock(m_TaskMutex);
+        m_dqTasks.emplace_back(std::move(Task));
+    }
+    m_cvTaskAvailable.notify_one();
+}
+
+void WorkerPool::RunWorker(unsigned uWorkerIndex)
+{
+    while (true)
+    {
+        std::function<void(unsigned)> Task;
+        {
+            std::unique_lock<std::mutex> TaskLock(m_TaskMutex);
+            m_cvTaskAvailable.wait(TaskLock, [this] { return (!m_dqTasks.empty() || m_bShutDown); });
+
+            // Queued work is always completed so callers waiting on it are released
+            if (m_dqTasks.empty())
+                return;
+
+            Task = std::move(m_dqTasks.front());
+            m_dqTasks.pop_front();
+        }
+
+        Task(uWorkerIndex);
+    }
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "ArrayDOAEngine.h"
+
+class TestArrayDOAEngine : public ::testing::Test {
+protected:
+    void SetUp() override {
+
+        // Half wavelength spaced line array at the frequency of the test bin
+        double dWavelength_m = dVelocity_mps / (uBin * dBinWidth_Hz);
+        for (unsigned uElementIndex = 0; uElementIndex < uNumElements; uElementIndex++)
+            vvdElementPositions_m.push_back({ 0.5 * dWavelength_m * uElementIndex, 0 });
+    }
+
+    // Snapshots of plane waves with random phases from each angle, plus a little uncorrelated noise
+    void AccumulateSnapshots(ArrayDOAEngine& Engine, const std::vector<double>& vdAngles_deg, ArrayDOAEngine::CrossSpectra& Spectra) {
+        std::mt19937 Generator(7);
+        std::uniform_real_distribution<double> PhaseDistribution(0, 2 * M_PI);
+        std::normal_distribution<float> NoiseDistribution(0, 0.05f);
+        double dWaveNumber = 2 * M_PI * uBin * dBinWidth_Hz / dVelocity_mps;
+
+        for (unsigned uSnapshot = 0; uSnapshot < 32; uSnapshot++)
+        {
+            std::vector<std::vector<std::complex<float>>> vvcfChannels(uNumElements, std::vector<std::complex<float>>(uNumBins));
+            for (double dAngle_deg : vdAngles_deg)
+            {
+                double dPhase = PhaseDistribution(Generator);
+                for (unsigned uElementIndex = 0; uElementIndex < uNumElements; uElementIndex++)
+                    vvcfChannels[uElementIndex][uBin] += (std::complex<float>)std::polar(1.0, dPhase - dWaveNumber * vvdElementPositions_m[uElementIndex][0] * std::sin(dAngle_deg * M_PI / 180));
+            }
+            for (auto& vcfChannel : vvcfChannels)
+                vcfChannel[uBin] += std::complex<float>(NoiseDistribution(Generator), NoiseDistribution(Generator));
+
+            Engine.Accumulate(vvcfChannels, Spectra);
+        }
+    }
+
+    // Angles of the local maxima of a spectrum, strongest first
+    std::vector<double> FindPeaks(ArrayDOAEngine& Engine, const std::vector<float>& vfSpectrum) {
+        std::vector<std::pair<float, double>> vPeaks;
+        for (unsigned uIndex = 1; uIndex + 1 < vfSpectrum.size(); uIndex++)
+            if (vfSpectrum[uIndex] > vfSpectrum[uIndex - 1] && vfSpectrum[uIndex] >= vfSpectrum[uIndex + 1])
+                vPeaks.emplace_back(vfSpectrum[uIndex], Engine.GetAngle_deg(uIndex));
+        std::sort(vPeaks.rbegin(), vPeaks.rend());
+
+        std::vector<double> vdAngles_deg;
+        for (auto& Peak : vPeaks)
+            vdAngles_deg.push_back(Peak.second);
+        return vdAngles_deg;
+    }
+
+    const unsigned uNumElements = 6;
+    const unsigned uNumBins = 65;
+    const uint16_t uBin = 20;
+    const double dBinWidth_Hz = 125;
+    const double dVelocity_mps = 343;
+    std::vector<std::vector<double>> vvdElementPositions_m;
+};
+
+// Every estimator points at a single source
+TEST_F(TestArrayDOAEngine, TestSingleSource) {
+    for (std::string strMethod : { "Bartlett", "MVDR", "MUSIC" })
+    {
+        ArrayDOAEngine Engine(vvdElementPositions_m, dVelocity_mps, strMethod, -90, 90, 361);
+        ArrayDOAEngine::CrossSpectra Spectra;
+        AccumulateSnapshots(Engine, { 23.5 }, Spectra);
+
+        std::vector<float> vfSpectrum;
+        Engine.ScanBins(Spectra, { uBin }, dBinWidth_Hz, vfSpectrum);
+        ASSERT_EQ(vfSpectrum.size(), Engine.GetNumAngles());
+        EXPECT_NEAR(FindPeaks(Engine, vfSpectrum).at(0), 23.5, 0.5) << " Testing " << strMethod;
+
+        // Steering vectors are reused once computed
+        Engine.ScanBins(Spectra, { uBin, uBin }, dBinWidth_Hz, vfSpectrum);
+        EXPECT_EQ(Engine.GetSteeringVectorCount(), 1) << " Testing " << strMethod << " steering vector caching";
+    }
+}
+
+// Subspace estimation separates two sources closer than the conventional beamwidth
+TEST_F(TestArrayDOAEngine, TestMUSICResolvesTwoSources) {
+    ArrayDOAEngine Engine(vvdElementPositions_m, dVelocity_mps, "MUSIC", -90, 90, 361, 2);
+    ArrayDOAEngine::CrossSpectra Spectra;
+    AccumulateSnapshots(Engine, { -5, 8 }, Spectra);
+
+    std::vector<float> vfSpectrum;
+    Engine.ScanBins(Spectra, { uBin }, dBinWidth_Hz, vfSpectrum);
+    auto vdPeaks_deg = FindPeaks(Engine, vfSpectrum);
+    ASSERT_GE(vdPeaks_deg.size(), 2);
+    std::sort(vdPeaks_deg.begin(), vdPeaks_deg.begin() + 2);
+    EXPECT_NEAR(vdPeaks_deg[0], -5, 1);
+    EXPECT_NEAR(vdPeaks_deg[1], 8, 1);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "ByteFragmentChunk.h"
+
+class TestByteFragmentChunk : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto pvcBytes = std::make_shared<std::vector<char>>(1000);
+        std::iota(pvcBytes->begin(), pvcBytes->end(), 0);
+        pvcPayload = pvcBytes;
+    }
+
+    std::shared_ptr<const std::vector<char>> pvcPayload;
+    const std::vector<char> vcHeader = { 'H', 'D', 'R' };
+};
+
+// Contiguous bytes of a fragment are its header followed by its slice of the payload
+TEST_F(TestByteFragmentChunk, TestMaterialise) {
+    ByteFragmentChunk Fragment(pvcPayload, 100, 50);
+    Fragment.AppendHeader(vcHeader.data(), vcHeader.size());
+    EXPECT_EQ(Fragment.m_uChunkLength, 53u) << " Testing chunk length covers header and payload";
+    EXPECT_TRUE(Fragment.m_vcDataChunk.empty()) << " Testing payload is not copied on creation";
+
+    std::vector<char> vcExpected = vcHeader;
+    vcExpected.insert(vcExpected.end(), pvcPayload->begin() + 100, pvcPayload->begin() + 150);
+    auto pFragment = std::make_shared<ByteFragmentChunk>(Fragment);
+    EXPECT_EQ(*ByteFragmentChunk::CopyBytes(pFragment), vcExpected);
+    EXPECT_TRUE(pFragment->m_vcDataChunk.empty()) << " Testing copying bytes leaves the fragment unchanged";
+
+    Fragment.Materialise();
+    EXPECT_EQ(Fragment.m_vcDataChunk, vcExpected);
+
+    EXPECT_THROW(ByteFragmentChunk(pvcPayload, 990, 20), std::runtime_error) << " Testing slices past the payload are rejected";
+    std::vector<char> vcLargeHeader(ByteFragmentChunk::m_uMaxHeaderSize + 1);
+    EXPECT_THROW(Fragment.AppendHeader(vcLargeHeader.data(), vcLargeHeader.size()), std::runtime_error);
+}
+
+// Fragments and plain byte chunks arrive on a socket as the same byte stream
+TEST_F(TestByteFragmentChunk, TestWriteToSocket) {
+    int aiSockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiSockets), 0);
+
+    auto pFragment = std::make_shared<ByteFragmentChunk>(pvcPayload, 0, pvcPayload->size());
+    pFragment->AppendHeader(vcHeader.data(), vcHeader.size());
+    auto pByteChunk = std::make_shared<ByteChunk>(vcHeader.size());
+    pByteChunk->m_vcDataChunk = vcHeader;
+
+    EXPECT_TRUE(ByteFragmentChunk::WriteToSocket(aiSockets[0], pFragment));
+    EXPECT_TRUE(ByteFragmentChunk::WriteToSocket(aiSockets[0], pByteChunk));
+    close(aiSockets[0]);
+
+    std::vector<char> vcReceived;
+    char acBuffer[256];
+    ssize_t iBytesRead;
+    while ((iBytesRead = read(aiSockets[1], acBuffer, sizeof(acBuffer))) > 0)
+        vcReceived.insert(vcReceived.end(), acBuffer, acBuffer + iBytesRead);
+    close(aiSockets[1]);
+
+    std::vector<char> vcExpected = vcHeader;
+    vcExpected.insert(vcExpected.end(), pvcPayload->begin(), pvcPayload->end());
+    vcExpected.insert(vcExpected.end(), vcHeader.begin(), vcHeader.end());
+    EXPECT_EQ(vcReceived, vcExpected);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include "ChunkToBytesModule.h"
+
+/**
+ * @brief ChunkToBytesModule which processes its queued chunks on a thread owned by the test
+ */
+class ChunkToBytesTestModule : public ChunkToBytesModule {
+public:
+    ChunkToBytesTestModule(unsigned uBufferSize, unsigned uTransmissionSize) : ChunkToBytesModule(uBufferSize, uTransmissionSize) {}
+
+    void StartTestProcessing() { m_TestThread = std::thread([this]() { ContinuouslyTryProcess(); }); }
+
+    void StopTestProcessing()
+    {
+        m_bShutDown = true;
+        if (m_TestThread.joinable())
+            m_TestThread.join();
+    }
+
+private:
+    std::thread m_TestThread;
+};
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class ByteCollectorModule : public BaseModule {
+public:
+    ByteCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "ByteCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+/**
+ * @brief Splits a chunk into transmissions the way ChunkToBytesModule did before it sent fragments
+ * @param pBaseChunk Chunk to split
+ * @param uTransmissionSize Size of each transmission in bytes
+ * @param Session Session state of the chunk's source and type, advanced as the module advances its own
+ */
+std::vector<std::vector<char>> SplitIntoTransmissions(std::shared_ptr<BaseChunk> pBaseChunk, unsigned uTransmissionSize, SessionController& Session)
+{
+    auto pvcByteData = pBaseChunk->Serialise();
+    uint16_t uSessionDataHeaderSize = 2;
+    uint16_t uSessionTransmissionSize = uTransmissionSize;
+    uint16_t uDataBytesToTransmit = uTransmissionSize - uSessionDataHeaderSize - Session.GetSize();
+    size_t uDataBytesTransmitted = 0;
+    bool bTransmit = true;
+
+    std::vector<std::vector<char>> vvcTransmissions;
+    while (bTransmit)
+    {
+        if (uDataBytesTransmitted + uDataBytesToTransmit >= pvcByteData->size())
+        {
+            uDataBytesToTransmit = pvcByteData->size() - uDataBytesTransmitted;
+            uSessionTransmissionSize = uDataBytesToTransmit + uSessionDataHeaderSize + Session.GetSize();
+            Session.m_cTransmissionState = 1;
+            bTransmit = false;
+        }
+
+        std::vector<char> vcTransmission(uSessionTransmissionSize);
+        memcpy(&vcTransmission[0], &uSessionTransmissionSize, uSessionDataHeaderSize);
+        auto pHeaderBytes = Session.Serialise();
+        memcpy(&vcTransmission[uSessionDataHeaderSize], pHeaderBytes->data(), Session.GetSize());
+        memcpy(&vcTransmission[uSessionDataHeaderSize + Session.GetSize()], pvcByteData->data() + uDataBytesTransmitted, uDataBytesToTransmit);
+        vvcTransmissions.push_back(vcTransmission);
+
+        uDataBytesTransmitted += uDataBytesToTransmit;
+        Session.IncrementSequence();
+    }
+
+    Session.IncrementSession();
+    return vvcTransmissions;
+}
+
+// Fragments must put the same bytes on the wire as the copied transmissions they replaced
+TEST(TestChunkToBytesModule, TestWireBytesMatchCopiedTransmissions) {
+    const unsigned uTransmissionSize = 512;
+    const std::vector<uint8_t> vu8SourceIdentifier = { 0xD0, 0x01, 0x02 };
+
+    // A chunk which spans several transmissions and ends part way through one, sent twice to move on the session
+    auto pInputChunk = std::make_shared<ByteChunk>(3000);
+    pInputChunk->m_vcDataChunk.resize(3000);
+    for (size_t uByteIndex = 0; uByteIndex < pInputChunk->m_vcDataChunk.size(); uByteIndex++)
+        pInputChunk->m_vcDataChunk[uByteIndex] = (char)(uByteIndex * 37);
+    pInputChunk->SetSourceIdentifier(vu8SourceIdentifier);
+
+    SessionController ExpectedSession;
+    ExpectedSession.m_u32uChunkType = ChunkTypesNamingUtility::ToU32(ChunkType::ByteChunk);
+    for (size_t i = 0; i < vu8SourceIdentifier.size(); i++)
+        ExpectedSession.m_usUID[i] = vu8SourceIdentifier[i];
+    std::vector<std::vector<char>> vvcExpected;
+    for (unsigned uRepeat = 0; uRepeat < 2; uRepeat++)
+    {
+        auto vvcTransmissions = SplitIntoTransmissions(pInputChunk, uTransmissionSize, ExpectedSession);
+        vvcExpected.insert(vvcExpected.end(), vvcTransmissions.begin(), vvcTransmissions.end());
+    }
+    ASSERT_GT(vvcExpected.size(), 4u) << " Testing the chunk is split into several transmissions";
+
+    auto pChunkToBytesModule = std::make_shared<ChunkToBytesTestModule>(10, uTransmissionSize);
+    auto pCollector = std::make_shared<ByteCollectorModule>(100);
+    pChunkToBytesModule->SetNextModule(pCollector);
+    pChunkToBytesModule->TakeChunkFromModule(pInputChunk);
+    pChunkToBytesModule->TakeChunkFromModule(pInputChunk);
+    pChunkToBytesModule->StartTestProcessing();
+
+    std::vector<std::shared_ptr<ByteChunk>> vpByteChunks;
+    auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (vpByteChunks.size() < vvcExpected.size() && std::chrono::steady_clock::now() < Deadline)
+    {
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        if (pCollector->TakeFromBuffer(pOutputChunk))
+            vpByteChunks.push_back(std::static_pointer_cast<ByteChunk>(pOutputChunk));
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pChunkToBytesModule->StopTestProcessing();
+    ASSERT_EQ(vpByteChunks.size(), vvcExpected.size()) << " Testing one fragment per transmission";
+
+    int aiSockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiSockets), 0);
+    std::vector<char> vcExpectedStream;
+    for (size_t uFragmentIndex = 0; uFragmentIndex < vpByteChunks.size(); uFragmentIndex++)
+    {
+        auto& pByteChunk = vpByteChunks[uFragmentIndex];
+        EXPECT_EQ(pByteChunk->m_uChunkLength, vvcExpected[uFragmentIndex].size()) << " Testing length of fragment " << uFragmentIndex;
+        EXPECT_EQ(*ByteFragmentChunk::CopyBytes(pByteChunk), vvcExpected[uFragmentIndex]) << " Testing bytes of fragment " << uFragmentIndex;
+        EXPECT_TRUE(ByteFragmentChunk::WriteToSocket(aiSockets[0], pByteChunk));
+        vcExpectedStream.insert(vcExpectedStream.end(), vvcExpected[uFragmentIndex].begin(), vvcExpected[uFragmentIndex].end());
+    }
+    close(aiSockets[0]);
+
+    std::vector<char> vcReceived;
+    char acBuffer[1024];
+    ssize_t iBytesRead;
+    while ((iBytesRead = read(aiSockets[1], acBuffer, sizeof(acBuffer))) > 0)
+        vcReceived.insert(vcReceived.end(), acBuffer, acBuffer + iBytesRead);
+    close(aiSockets[1]);
+    EXPECT_EQ(vcReceived, vcExpectedStream) << " Testing the socket stream matches the copied transmissions";
+}
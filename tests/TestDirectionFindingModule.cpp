@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "DirectionFindingModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class DirectionCollectorModule : public BaseModule {
+public:
+    DirectionCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "DirectionCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+/**
+ * @brief Direction finding module which also records the bins and angles of every estimate it passes on
+ */
+class DirectionRecordingModule : public DirectionFindingModule {
+public:
+    using DirectionFindingModule::DirectionFindingModule;
+
+    std::vector<std::vector<uint16_t>> vvu16Bins;
+    std::vector<std::vector<float>> vvfAngles_deg;
+
+protected:
+    void PassDirections(const std::shared_ptr<FFTChunk>& pFFTChunk, const std::vector<uint16_t>& vu16Bins, const std::vector<float>& vfAngleOfArrivals_deg) override {
+        vvu16Bins.push_back(vu16Bins);
+        vvfAngles_deg.push_back(vfAngleOfArrivals_deg);
+        DirectionFindingModule::PassDirections(pFFTChunk, vu16Bins, vfAngleOfArrivals_deg);
+    }
+};
+
+class TestDirectionFindingModule : public ::testing::Test {
+protected:
+    void SetUp() override {
+        pDirectionFindingModule = std::make_shared<DirectionRecordingModule>(10, 343, 0.1);
+        pCollector = std::make_shared<DirectionCollectorModule>(10);
+        pDirectionFindingModule->SetNextModule(pCollector);
+    }
+
+    std::shared_ptr<FFTChunk> MakeFFTChunk(uint8_t u8Source, uint64_t u64TimeStamp) {
+        auto pFFTChunk = std::make_shared<FFTChunk>(65, 16000, u64TimeStamp, 2);
+        pFFTChunk->m_vvcfFFTChunks.assign(2, std::vector<std::complex<float>>(65, 1));
+        pFFTChunk->SetSourceIdentifier({ u8Source });
+        return pFFTChunk;
+    }
+
+    std::shared_ptr<DetectionBinChunk> MakeDetectionChunk(uint8_t u8Source, uint64_t u64TimeStamp) {
+        auto pDetectionBinChunk = std::make_shared<TimeStampedDetectionBinChunk>(u64TimeStamp);
+        pDetectionBinChunk->SetDetectionBins({ { 10 }, { 10 } });
+        pDetectionBinChunk->SetSourceIdentifier({ u8Source });
+        return pDetectionBinChunk;
+    }
+
+    std::vector<std::shared_ptr<DirectionBinChunk>> CollectDirectionChunks() {
+        std::vector<std::shared_ptr<DirectionBinChunk>> vpDirectionChunks;
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::DirectionBinChunk)
+                vpDirectionChunks.push_back(std::static_pointer_cast<DirectionBinChunk>(pOutputChunk));
+        return vpDirectionChunks;
+    }
+
+    std::vector<std::vector<uint8_t>> CollectDirectionSources() {
+        std::vector<std::vector<uint8_t>> vvu8Sources;
+        for (auto& pDirectionChunk : CollectDirectionChunks())
+            vvu8Sources.push_back(pDirectionChunk->GetSourceIdentifier());
+        return vvu8Sources;
+    }
+
+    std::shared_ptr<DirectionRecordingModule> pDirectionFindingModule;
+    std::shared_ptr<DirectionCollectorModule> pCollector;
+};
+
+// Detections are only applied to the FFT chunk of the same source and timestamp, in either arrival order
+TEST_F(TestDirectionFindingModule, TestJoinBySourceAndTimeStamp) {
+    pDirectionFindingModule->Process(MakeDetectionChunk(1, 100));
+    pDirectionFindingModule->Process(MakeFFTChunk(2, 100));
+    EXPECT_TRUE(CollectDirectionSources().empty()) << " Testing other sources are not paired";
+
+    pDirectionFindingModule->Process(MakeFFTChunk(1, 100));
+    pDirectionFindingModule->Process(MakeDetectionChunk(2, 100));
+    EXPECT_EQ(CollectDirectionSources(), std::vector<std::vector<uint8_t>>({ { 1 }, { 2 } }));
+    EXPECT_EQ(pDirectionFindingModule->GetUnmatchedEvictionCount(), 0);
+}
+
+// Unmatched chunks are dropped once the pending limit or maximum age is exceeded
+TEST_F(TestDirectionFindingModule, TestUnmatchedEviction) {
+    pDirectionFindingModule->SetJoinLimits(2, 1.0);
+
+    for (uint64_t u64TimeStamp : { 100, 200, 300 })
+        pDirectionFindingModule->Process(MakeFFTChunk(1, u64TimeStamp));
+    EXPECT_EQ(pDirectionFindingModule->GetUnmatchedEvictionCount(), 1) << " Testing pending limit";
+
+    pDirectionFindingModule->Process(MakeFFTChunk(1, 2000000));
+    EXPECT_EQ(pDirectionFindingModule->GetUnmatchedEvictionCount(), 3) << " Testing maximum age";
+
+    pDirectionFindingModule->Process(MakeDetectionChunk(1, 2000000));
+    EXPECT_EQ(CollectDirectionSources().size(), 1) << " Testing newest chunk is still paired";
+}
+
+// Detections are passed on untouched for later modules, whether or not they were paired
+TEST_F(TestDirectionFindingModule, TestForwardedDetectionsKeepTheirBins) {
+    pDirectionFindingModule->Process(MakeFFTChunk(1, 100));
+    pDirectionFindingModule->Process(MakeDetectionChunk(1, 100));
+    pDirectionFindingModule->Process(MakeDetectionChunk(1, 200));
+
+    unsigned uNumDetectionChunks = 0;
+    std::shared_ptr<BaseChunk> pOutputChunk;
+    while (pCollector->TakeFromBuffer(pOutputChunk))
+    {
+        if (pOutputChunk->GetChunkType() != ChunkType::DetectionBinChunk)
+            continue;
+        uNumDetectionChunks++;
+        auto pDetectionBinChunk = std::static_pointer_cast<DetectionBinChunk>(pOutputChunk);
+        EXPECT_EQ(*pDetectionBinChunk->GetDetectionBins(), std::vector<std::vector<uint16_t>>({ { 10 }, { 10 } })) << " Testing forwarded chunk still holds its bins";
+    }
+    EXPECT_EQ(uNumDetectionChunks, 2u);
+}
+
+// Detections which lost their timestamp, such as after a network hop, pair with the oldest waiting spectrum of their source
+TEST_F(TestDirectionFindingModule, TestDetectionsWithoutTimeStampJoinInArrivalOrder) {
+    auto MakePlainDetectionChunk = [](uint8_t u8Source) {
+        auto pDetectionBinChunk = std::make_shared<DetectionBinChunk>();
+        pDetectionBinChunk->SetDetectionBins({ { 10 }, { 10 } });
+        pDetectionBinChunk->SetSourceIdentifier({ u8Source });
+        return pDetectionBinChunk;
+    };
+
+    pDirectionFindingModule->Process(MakeFFTChunk(1, 100));
+    pDirectionFindingModule->Process(MakeFFTChunk(1, 200));
+    pDirectionFindingModule->Process(MakePlainDetectionChunk(2));
+    EXPECT_TRUE(CollectDirectionSources().empty()) << " Testing other sources are not paired";
+
+    pDirectionFindingModule->Process(MakePlainDetectionChunk(1));
+    pDirectionFindingModule->Process(MakePlainDetectionChunk(1));
+    EXPECT_EQ(CollectDirectionSources().size(), 2u) << " Testing each waiting spectrum is paired once";
+
+    pDirectionFindingModule->Process(MakeFFTChunk(2, 100));
+    EXPECT_EQ(CollectDirectionSources(), std::vector<std::vector<uint8_t>>({ { 2 } })) << " Testing queued detections pair with the next spectrum";
+}
+
+// Array mode averages the configured snapshots and reports the peak angle of each detected bin
+TEST_F(TestDirectionFindingModule, TestArrayProcessingFindsPlaneWaveAngle) {
+
+    // Half wavelength spaced line array at bin 10, 1250 Hz with 65 bins at 16 kHz
+    const unsigned uNumElements = 4;
+    const double dVelocity_mps = 343;
+    const double dWaveNumber = 2 * M_PI * 1250 / dVelocity_mps;
+    std::vector<std::vector<double>> vvdElementPositions_m;
+    for (unsigned uElementIndex = 0; uElementIndex < uNumElements; uElementIndex++)
+        vvdElementPositions_m.push_back({ 0.5 * (2 * M_PI / dWaveNumber) * uElementIndex, 0 });
+    pDirectionFindingModule->EnableArrayProcessing(vvdElementPositions_m, "Bartlett", 4);
+
+    auto MakeSnapshot = [&](uint64_t u64TimeStamp) {
+        auto pFFTChunk = std::make_shared<FFTChunk>(65, 16000, u64TimeStamp, uNumElements);
+        pFFTChunk->m_vvcfFFTChunks.assign(uNumElements, std::vector<std::complex<float>>(65, 0));
+        double dPhase = 0.7 * u64TimeStamp;
+        for (unsigned uElementIndex = 0; uElementIndex < uNumElements; uElementIndex++)
+            pFFTChunk->m_vvcfFFTChunks[uElementIndex][10] = (std::complex<float>)std::polar(1.0, dPhase - dWaveNumber * vvdElementPositions_m[uElementIndex][0] * std::sin(30 * M_PI / 180));
+        pFFTChunk->SetSourceIdentifier({ 1 });
+        return pFFTChunk;
+    };
+
+    for (uint64_t u64TimeStamp = 1; u64TimeStamp <= 8; u64TimeStamp++)
+    {
+        pDirectionFindingModule->Process(MakeDetectionChunk(1, u64TimeStamp));
+        pDirectionFindingModule->Process(MakeSnapshot(u64TimeStamp));
+        auto vpDirectionChunks = CollectDirectionChunks();
+        ASSERT_EQ(vpDirectionChunks.size(), u64TimeStamp % 4 == 0 ? 1u : 0u) << " Testing one estimate per four snapshots";
+        if (vpDirectionChunks.empty())
+            continue;
+
+        // The scan behind the peak is passed on with the angles it covers
+        auto pAngleSpectrumChunk = std::dynamic_pointer_cast<AngleSpectrumDirectionBinChunk>(vpDirectionChunks[0]);
+        ASSERT_TRUE(pAngleSpectrumChunk) << " Testing array estimates carry their angle spectra";
+        ASSERT_EQ(pAngleSpectrumChunk->m_vfAngleGrid_deg.size(), 181u);
+        EXPECT_FLOAT_EQ(pAngleSpectrumChunk->m_vfAngleGrid_deg.front(), -90);
+        EXPECT_FLOAT_EQ(pAngleSpectrumChunk->m_vfAngleGrid_deg.back(), 90);
+        ASSERT_EQ(pAngleSpectrumChunk->m_vvfAngleSpectra.size(), 1u) << " Testing one spectrum per detected bin";
+        const auto& vfSpectrum = pAngleSpectrumChunk->m_vvfAngleSpectra[0];
+        ASSERT_EQ(vfSpectrum.size(), pAngleSpectrumChunk->m_vfAngleGrid_deg.size());
+        size_t uPeakIndex = std::max_element(vfSpectrum.begin(), vfSpectrum.end()) - vfSpectrum.begin();
+        EXPECT_NEAR(pAngleSpectrumChunk->m_vfAngleGrid_deg[uPeakIndex], 30, 1) << " Testing the spectrum peaks at the arrival angle";
+        EXPECT_LT(vfSpectrum[0], vfSpectrum[uPeakIndex]) << " Testing the spectrum is not flat";
+    }
+
+    ASSERT_EQ(pDirectionFindingModule->vvfAngles_deg.size(), 2u);
+    for (size_t uEstimateIndex = 0; uEstimateIndex < pDirectionFindingModule->vvfAngles_deg.size(); uEstimateIndex++)
+    {
+        ASSERT_EQ(pDirectionFindingModule->vvu16Bins[uEstimateIndex], std::vector<uint16_t>({ 10 }));
+        ASSERT_EQ(pDirectionFindingModule->vvfAngles_deg[uEstimateIndex].size(), 1u);
+        EXPECT_NEAR(pDirectionFindingModule->vvfAngles_deg[uEstimateIndex][0], 30, 1) << " Testing peak of the scan is the arrival angle";
+    }
+}
+
+// Phase offsets between the two channels give sin(angle) = wavelength x phase / (2 pi baseline)
+TEST_F(TestDirectionFindingModule, TestPhaseDifferenceAngles) {
+
+    // Bins are 125 Hz wide, angles chosen so every phase offset stays within +-pi on the 0.1 m baseline
+    const std::vector<uint16_t> vu16Bins = { 5, 10, 15 };
+    const std::vector<double> vdAngles_deg = { -30, 20, 45 };
+
+    auto pFFTChunk = MakeFFTChunk(1, 100);
+    for (size_t uIndex = 0; uIndex < vu16Bins.size(); uIndex++)
+    {
+        double dWavelength_m = 343 / (vu16Bins[uIndex] * 125.0);
+        double dPhaseOffset = 2 * M_PI * 0.1 * std::sin(vdAngles_deg[uIndex] * M_PI / 180) / dWavelength_m;
+        pFFTChunk->m_vvcfFFTChunks[0][vu16Bins[uIndex]] = (std::complex<float>)std::polar(2.0, 0.3 + dPhaseOffset);
+        pFFTChunk->m_vvcfFFTChunks[1][vu16Bins[uIndex]] = (std::complex<float>)std::polar(0.5, 0.3);
+    }
+
+    // Bin 40 has no phase reference on the second channel so has no angle
+    pFFTChunk->m_vvcfFFTChunks[1][40] = 0;
+
+    auto pDetectionBinChunk = MakeDetectionChunk(1, 100);
+    pDetectionBinChunk->SetDetectionBins({ { 5, 10, 15, 40 }, { 5, 10, 15, 40 } });
+    pDirectionFindingModule->Process(pDetectionBinChunk);
+    pDirectionFindingModule->Process(pFFTChunk);
+
+    ASSERT_EQ(pDirectionFindingModule->vvu16Bins.size(), 1u);
+    EXPECT_EQ(pDirectionFindingModule->vvu16Bins[0], vu16Bins) << " Testing bins without a reference are dropped";
+    ASSERT_EQ(pDirectionFindingModule->vvfAngles_deg[0].size(), vdAngles_deg.size());
+    for (size_t uIndex = 0; uIndex < vdAngles_deg.size(); uIndex++)
+        EXPECT_NEAR(pDirectionFindingModule->vvfAngles_deg[0][uIndex], vdAngles_deg[uIndex], 0.1) << " Testing angle of bin " << vu16Bins[uIndex];
+}
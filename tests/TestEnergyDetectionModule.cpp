@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "EnergyDetectionModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class DetectionCollectorModule : public BaseModule {
+public:
+    DetectionCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "DetectionCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+class TestEnergyDetectionModule : public ::testing::Test {
+protected:
+    // You can use SetUp and TearDown for initialization and cleanup.
+    void SetUp() override {
+
+        pEnergyDetectionModule = std::make_shared<EnergyDetectionModule>(10, 10);
+        pCollector = std::make_shared<DetectionCollectorModule>(10);
+        pEnergyDetectionModule->SetNextModule(pCollector);
+
+        // Unit noise floor, a weak tone at bin 30 and a strong tone at bin 100
+        pFFTMagnitudeChunk = std::make_shared<FFTMagnitudeChunk>(257, 16000, 0, 1);
+        pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks.resize(1);
+        pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0].assign(257, 1.0f);
+        pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0][30] = 4;
+        pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0][100] = 1000;
+        pFFTMagnitudeChunk->SetSourceIdentifier({1});
+    }
+
+    void TearDown() override {
+
+    }
+
+    std::vector<uint16_t> DetectFirstChannel() {
+        pEnergyDetectionModule->CallChunkCallbackFunction(pFFTMagnitudeChunk);
+
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::DetectionBinChunk)
+                return (*std::static_pointer_cast<DetectionBinChunk>(pOutputChunk)->GetDetectionBins())[0];
+
+        return {};
+    }
+
+    std::shared_ptr<EnergyDetectionModule> pEnergyDetectionModule;
+    std::shared_ptr<DetectionCollectorModule> pCollector;
+    std::shared_ptr<FFTMagnitudeChunk> pFFTMagnitudeChunk;
+};
+
+// Threshold is in dB relative to the mean linear power (magnitude squared) of all bins in the channel
+TEST_F(TestEnergyDetectionModule, TestThresholdIsDecibelsAboveMeanBinPower) {
+
+    // Unit power floor with tones of power 8 and 13, a mean of 276/257 puts them 8.7 dB and 10.8 dB above it
+    auto pTwoToneChunk = std::make_shared<FFTMagnitudeChunk>(257, 16000, 0, 2);
+    pTwoToneChunk->m_vvfFFTMagnitudeChunks.resize(2);
+    for (auto& vfMagnitudes : pTwoToneChunk->m_vvfFFTMagnitudeChunks)
+    {
+        vfMagnitudes.assign(257, 1.0f);
+        vfMagnitudes[50] = std::sqrt(8.0f);
+        vfMagnitudes[150] = std::sqrt(13.0f);
+    }
+    pTwoToneChunk->SetSourceIdentifier({7});
+
+    auto DetectBins = [this, &pTwoToneChunk]() {
+        pEnergyDetectionModule->CallChunkCallbackFunction(pTwoToneChunk);
+        std::shared_ptr<DetectionBinChunk> pDetectionBinChunk;
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::DetectionBinChunk)
+                pDetectionBinChunk = std::static_pointer_cast<DetectionBinChunk>(pOutputChunk);
+        return pDetectionBinChunk;
+    };
+
+    auto pDetectionBinChunk = DetectBins();
+    ASSERT_TRUE(pDetectionBinChunk) << " Testing detections are passed on";
+    EXPECT_EQ(pDetectionBinChunk->GetSourceIdentifier(), std::vector<uint8_t>({7})) << " Testing detections keep their source";
+    auto vvu16DetectionBins = *pDetectionBinChunk->GetDetectionBins();
+    ASSERT_EQ(vvu16DetectionBins.size(), 2u) << " Testing every channel is reported";
+    for (const auto& vu16DetectionBins : vvu16DetectionBins)
+        EXPECT_EQ(vu16DetectionBins, std::vector<uint16_t>({ 150 })) << " Testing 10 dB passes only the tone 10.8 dB above the mean power";
+
+    pEnergyDetectionModule->SetThresholdAboveNoiseFoor(8);
+    vvu16DetectionBins = *DetectBins()->GetDetectionBins();
+    for (const auto& vu16DetectionBins : vvu16DetectionBins)
+        EXPECT_EQ(vu16DetectionBins, std::vector<uint16_t>({ 50, 150 })) << " Testing 8 dB also passes the tone 8.7 dB above the mean power";
+
+    pEnergyDetectionModule->SetThresholdAboveNoiseFoor(11);
+    vvu16DetectionBins = *DetectBins()->GetDetectionBins();
+    for (const auto& vu16DetectionBins : vvu16DetectionBins)
+        EXPECT_TRUE(vu16DetectionBins.empty()) << " Testing 11 dB passes neither tone";
+}
+
+// A strong tone raises the channel mean so weak tones elsewhere are missed
+TEST_F(TestEnergyDetectionModule, TestMeanFloorMissesWeakTone) {
+    EXPECT_EQ(DetectFirstChannel(), std::vector<uint16_t>({ 100 })) << " Testing channel mean threshold";
+}
+
+// Local estimates find the weak tone while the strong tone stays detected
+TEST_F(TestEnergyDetectionModule, TestCellAveragingCFAR) {
+    pEnergyDetectionModule->EnableCFAR("CellAveraging", 3, 8);
+    EXPECT_EQ(DetectFirstChannel(), std::vector<uint16_t>({ 30, 100 })) << " Testing cell averaging CFAR";
+}
+
+TEST_F(TestEnergyDetectionModule, TestOrderedStatisticCFAR) {
+    pEnergyDetectionModule->EnableCFAR("OrderedStatistic", 1, 8);
+    EXPECT_EQ(DetectFirstChannel(), std::vector<uint16_t>({ 30, 100 })) << " Testing ordered statistic CFAR";
+}
+
+// The sliding rank tree must pick the same percentile as sorting each truncated training window
+TEST_F(TestEnergyDetectionModule, TestOrderedStatisticCFARMatchesSortedWindows) {
+    auto& vfMagnitudes = pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0];
+    for (size_t uBinIndex = 0; uBinIndex < vfMagnitudes.size(); uBinIndex++)
+        vfMagnitudes[uBinIndex] = 1.0f + ((uBinIndex * 7919) % 97) / 20.0f + ((uBinIndex % 41 == 0) ? 30.0f : 0.0f);
+    vfMagnitudes[60] = vfMagnitudes[61];
+
+    for (auto [uGuardCells, uTrainingCells] : std::vector<std::pair<unsigned, unsigned>>{ { 0, 1 }, { 1, 8 }, { 3, 16 }, { 2, 200 } })
+    {
+        std::vector<uint16_t> vu16ExpectedBins;
+        int64_t i64NumBins = vfMagnitudes.size();
+        for (int64_t i64BinIndex = 0; i64BinIndex < i64NumBins; i64BinIndex++)
+        {
+            std::vector<float> vfTrainingPowers;
+            for (int64_t i64Offset = uGuardCells + 1; i64Offset <= uGuardCells + uTrainingCells; i64Offset++)
+                for (int64_t i64Cell : { i64BinIndex - i64Offset, i64BinIndex + i64Offset })
+                    if (i64Cell >= 0 && i64Cell < i64NumBins)
+                        vfTrainingPowers.push_back(vfMagnitudes[i64Cell] * vfMagnitudes[i64Cell]);
+            std::sort(vfTrainingPowers.begin(), vfTrainingPowers.end());
+            if (vfMagnitudes[i64BinIndex] * vfMagnitudes[i64BinIndex] > 10.0f * vfTrainingPowers[(vfTrainingPowers.size() * 3) / 4])
+                vu16ExpectedBins.push_back(i64BinIndex);
+        }
+
+        pEnergyDetectionModule->EnableCFAR("OrderedStatistic", uGuardCells, uTrainingCells);
+        EXPECT_EQ(DetectFirstChannel(), vu16ExpectedBins) << " Testing " << uGuardCells << " guard and " << uTrainingCells << " training cells";
+    }
+}
+
+// A floor learnt from a quiet chunk is not raised by the strong tone, so the weak tone is found too
+TEST_F(TestEnergyDetectionModule, TestExponentialNoiseFloorTracking) {
+    pEnergyDetectionModule->EnableNoiseFloorTracking("Exponential", 0.1f);
+
+    auto vfTones = pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0];
+    pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0].assign(257, 1.0f);
+    EXPECT_TRUE(DetectFirstChannel().empty()) << " Testing seeding from a quiet chunk";
+
+    pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0] = vfTones;
+    EXPECT_EQ(DetectFirstChannel(), std::vector<uint16_t>({ 30, 100 })) << " Testing tracked floor threshold";
+}
+
+// Persistent tones stay detected until their bins' minimum window has passed
+TEST_F(TestEnergyDetectionModule, TestMinimumStatisticsNoiseFloorTracking) {
+    pEnergyDetectionModule->EnableNoiseFloorTracking("MinimumStatistics", 0.5f, 4);
+
+    auto vfTones = pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0];
+    pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0].assign(257, 1.0f);
+    EXPECT_TRUE(DetectFirstChannel().empty()) << " Testing seeding from a quiet chunk";
+
+    pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0] = vfTones;
+    for (unsigned uChunk = 0; uChunk < 3; uChunk++)
+        EXPECT_EQ(DetectFirstChannel(), std::vector<uint16_t>({ 30, 100 })) << " Testing minimum statistics threshold in chunk " << uChunk;
+}
+
+// A wideband emitter becomes one event with its peak refined between bins
+TEST_F(TestEnergyDetectionModule, TestEventClustering) {
+    pEnergyDetectionModule->EnableEventClustering(1);
+
+    // Gaussian power profile peaking between bins 64 and 65, for which log parabolic interpolation is exact
+    auto& vfMagnitudes = pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0];
+    for (unsigned uBinIndex = 0; uBinIndex < vfMagnitudes.size(); uBinIndex++)
+        vfMagnitudes[uBinIndex] = std::max(1.0, std::sqrt(1000 * std::exp(-std::pow(uBinIndex - 64.3, 2) / 8)));
+
+    pEnergyDetectionModule->CallChunkCallbackFunction(pFFTMagnitudeChunk);
+
+    std::shared_ptr<BaseChunk> pOutputChunk;
+    ASSERT_TRUE(pCollector->TakeFromBuffer(pOutputChunk));
+    ASSERT_EQ(pOutputChunk->GetChunkType(), ChunkType::DetectionEventChunk);
+    auto pDetectionEventChunk = std::static_pointer_cast<DetectionEventChunk>(pOutputChunk);
+
+    ASSERT_EQ(pDetectionEventChunk->m_vDetectionEvents.size(), 1) << " Testing contiguous bins merge";
+    auto& Event = pDetectionEventChunk->m_vDetectionEvents[0];
+    EXPECT_EQ(Event.u16PeakBin, 64);
+    EXPECT_LT(Event.u16StartBin, 64);
+    EXPECT_GT(Event.u16EndBin, 65);
+    EXPECT_NEAR(Event.fPeakBin, 64.3, 1e-3) << " Testing sub bin interpolation";
+    EXPECT_NEAR(Event.fPeakPower, 1000, 1) << " Testing interpolated peak power";
+    EXPECT_NEAR(Event.fPeakFrequency_Hz, 64.3 * 16000 / 512, 0.1);
+    EXPECT_NEAR(Event.fBandwidth_Hz, (Event.u16EndBin - Event.u16StartBin + 1) * 16000.0 / 512, 1e-3);
+}
+
+// A bin passes once seen in 2 of 3 frames and is reported lost once it no longer is
+TEST_F(TestEnergyDetectionModule, TestPersistenceGating) {
+    pEnergyDetectionModule->EnablePersistenceGating(2, 3);
+
+    EXPECT_TRUE(DetectFirstChannel().empty()) << " Testing first sighting is held back";
+    EXPECT_EQ(DetectFirstChannel(), std::vector<uint16_t>({ 100 })) << " Testing second sighting passes";
+
+    pFFTMagnitudeChunk->m_vvfFFTMagnitudeChunks[0].assign(257, 1.0f);
+    EXPECT_TRUE(DetectFirstChannel().empty()) << " Testing quiet frame while still persisting";
+
+    pEnergyDetectionModule->CallChunkCallbackFunction(pFFTMagnitudeChunk);
+    std::vector<DetectionEvent> vLostEvents;
+    std::shared_ptr<BaseChunk> pOutputChunk;
+    while (pCollector->TakeFromBuffer(pOutputChunk))
+        if (pOutputChunk->GetChunkType() == ChunkType::DetectionEventChunk)
+            vLostEvents = std::static_pointer_cast<DetectionEventChunk>(pOutputChunk)->m_vDetectionEvents;
+
+    ASSERT_EQ(vLostEvents.size(), 1) << " Testing lost event is emitted once";
+    EXPECT_EQ(vLostEvents[0].State, DetectionEventState::Lost);
+    EXPECT_EQ(vLostEvents[0].u16StartBin, 100);
+    EXPECT_EQ(vLostEvents[0].u16EndBin, 100);
+}
+
+// Events of every channel, active and lost, survive serialisation unchanged and in order
+TEST_F(TestEnergyDetectionModule, TestDetectionEventChunkRoundTrip) {
+
+    DetectionEventChunk InputChunk(16000, 123456, 3, 257);
+    InputChunk.SetSourceIdentifier({1, 2, 3});
+    InputChunk.m_vDetectionEvents = {
+        { 0, 10, 14, 12, 12.25f, 382.8f, 375.0f, 156.25f, 900.5f, DetectionEventState::Active },
+        { 1, 40, 40, 40, 40.0f, 1250.0f, 1250.0f, 31.25f, 12.5f, DetectionEventState::Active },
+        { 2, 100, 130, 117, 116.75f, 3648.4f, 3593.75f, 968.75f, 4e6f, DetectionEventState::Active },
+        { 1, 70, 72, 71, 71.0f, 2218.75f, 2218.75f, 93.75f, 0.0f, DetectionEventState::Lost },
+    };
+
+    auto pvBytes = InputChunk.Serialise();
+    EXPECT_EQ(pvBytes->size(), InputChunk.GetSize()) << " Testing serialised size matches GetSize";
+
+    DetectionEventChunk OutputChunk(0, 0, 0, 0);
+    OutputChunk.Deserialise(pvBytes);
+    EXPECT_EQ(OutputChunk.m_dSampleRate, InputChunk.m_dSampleRate);
+    EXPECT_EQ(OutputChunk.m_i64TimeStamp, InputChunk.m_i64TimeStamp);
+    EXPECT_EQ(OutputChunk.m_uNumChannels, 3u);
+    EXPECT_EQ(OutputChunk.m_uNumBins, 257u);
+    ASSERT_EQ(OutputChunk.m_vDetectionEvents.size(), InputChunk.m_vDetectionEvents.size());
+    for (size_t uEventIndex = 0; uEventIndex < InputChunk.m_vDetectionEvents.size(); uEventIndex++)
+    {
+        auto& Expected = InputChunk.m_vDetectionEvents[uEventIndex];
+        auto& Event = OutputChunk.m_vDetectionEvents[uEventIndex];
+        EXPECT_EQ(Event.u16ChannelIndex, Expected.u16ChannelIndex) << " Testing channel of event " << uEventIndex;
+        EXPECT_EQ(Event.u16StartBin, Expected.u16StartBin);
+        EXPECT_EQ(Event.u16EndBin, Expected.u16EndBin);
+        EXPECT_EQ(Event.u16PeakBin, Expected.u16PeakBin);
+        EXPECT_EQ(Event.fPeakBin, Expected.fPeakBin);
+        EXPECT_EQ(Event.fPeakFrequency_Hz, Expected.fPeakFrequency_Hz);
+        EXPECT_EQ(Event.fCentreFrequency_Hz, Expected.fCentreFrequency_Hz);
+        EXPECT_EQ(Event.fBandwidth_Hz, Expected.fBandwidth_Hz);
+        EXPECT_EQ(Event.fPeakPower, Expected.fPeakPower);
+        EXPECT_EQ(Event.State, Expected.State) << " Testing state of event " << uEventIndex;
+    }
+    EXPECT_EQ(OutputChunk.m_vDetectionEvents.back().State, DetectionEventState::Lost) << " Testing the lost event keeps its state";
+
+    // An empty spectrum serialises to just its description
+    DetectionEventChunk EmptyChunk(16000, 7, 1, 65);
+    DetectionEventChunk EmptyOutputChunk(0, 0, 0, 0);
+    EmptyOutputChunk.Deserialise(EmptyChunk.Serialise());
+    EXPECT_EQ(EmptyOutputChunk.m_i64TimeStamp, 7u);
+    EXPECT_TRUE(EmptyOutputChunk.m_vDetectionEvents.empty());
+}
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+#include "FFTModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class ChunkCollectorModule : public BaseModule {
+public:
+    ChunkCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "ChunkCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+class TestFFTModule : public ::testing::Test {
+protected:
+    // You can use SetUp and TearDown for initialization and cleanup.
+    void SetUp() override {
+
+        pFFTModule = std::make_shared<FFTModule>(10);
+
+        double dChunkSize = 512;
+        double dSampleRate = 16000;
+        uint64_t i64TimeStamp = 0;
+        unsigned uBits = 16;
+        unsigned uNumBytes = 2;
+        unsigned uNumChannels = 2;
+
+        pTimeChunk = std::make_shared<TimeChunk>(dChunkSize, dSampleRate, i64TimeStamp, uBits, uNumBytes, uNumChannels);
+        pTimeChunk->m_vvi16TimeChunks.resize(uNumChannels);
+        for (auto& vi16ChannelData : pTimeChunk->m_vvi16TimeChunks)
+            vi16ChannelData.assign(dChunkSize, 100);
+        pTimeChunk->SetSourceIdentifier({1});
+
+        pLargerTimeChunk = std::make_shared<TimeChunk>(2*dChunkSize, dSampleRate, i64TimeStamp, uBits, uNumBytes, uNumChannels);
+        pLargerTimeChunk->m_vvi16TimeChunks.resize(uNumChannels);
+        for (auto& vi16ChannelData : pLargerTimeChunk->m_vvi16TimeChunks)
+            vi16ChannelData.assign(2*dChunkSize, 100);
+        pLargerTimeChunk->SetSourceIdentifier({1});
+    }
+
+    void TearDown() override {
+
+    }
+
+    std::shared_ptr<FFTModule> pFFTModule;
+    std::shared_ptr<TimeChunk> pTimeChunk;
+    std::shared_ptr<TimeChunk> pLargerTimeChunk;
+};
+
+// Plans and scratch buffers should only be allocated the first time a chunk size is seen
+TEST_F(TestFFTModule, TestSteadyStateMakesNoFFTAllocations) {
+
+    pFFTModule->CallChunkCallbackFunction(pTimeChunk);
+    auto u64AllocationsAfterFirstChunk = pFFTModule->GetFFTPathAllocationCount();
+    EXPECT_EQ(u64AllocationsAfterFirstChunk, 2) << " Testing first chunk allocates one plan and one scratch buffer";
+
+    for (unsigned uChunkIndex = 0; uChunkIndex < 10; uChunkIndex++)
+        pFFTModule->CallChunkCallbackFunction(pTimeChunk);
+    EXPECT_EQ(pFFTModule->GetFFTPathAllocationCount(), u64AllocationsAfterFirstChunk) << " Testing repeated chunks reuse plans and scratch";
+
+    pFFTModule->CallChunkCallbackFunction(pLargerTimeChunk);
+    EXPECT_EQ(pFFTModule->GetFFTPathAllocationCount(), u64AllocationsAfterFirstChunk + 2) << " Testing a new chunk size allocates a new plan";
+
+    pFFTModule->CallChunkCallbackFunction(pTimeChunk);
+    EXPECT_EQ(pFFTModule->GetFFTPathAllocationCount(), u64AllocationsAfterFirstChunk + 2) << " Testing returning to a cached size allocates nothing";
+}
+
+// Spreading channels over workers must not change results or their order
+TEST_F(TestFFTModule, TestParallelMatchesSerial) {
+
+    // Distinct data per source, channel and chunk so any mix up is visible
+    std::vector<std::shared_ptr<TimeChunk>> vpTimeChunks;
+    for (unsigned uChunkIndex = 0; uChunkIndex < 8; uChunkIndex++)
+    {
+        auto pInputChunk = std::make_shared<TimeChunk>(512, 16000, uChunkIndex, 16, 2, 4);
+        pInputChunk->m_vvi16TimeChunks.resize(4);
+        for (unsigned uChannelIndex = 0; uChannelIndex < 4; uChannelIndex++)
+            for (unsigned uSampleIndex = 0; uSampleIndex < 512; uSampleIndex++)
+                pInputChunk->m_vvi16TimeChunks[uChannelIndex].push_back(((uSampleIndex + 1) * (uChannelIndex + 3) * (uChunkIndex + 7)) % 2000 - 1000);
+        pInputChunk->SetSourceIdentifier({(uint8_t)(uChunkIndex % 2)});
+        vpTimeChunks.push_back(pInputChunk);
+    }
+
+    auto ProcessAll = [&vpTimeChunks](unsigned uNumWorkers) {
+        auto pModule = std::make_shared<FFTModule>(100);
+        auto pCollector = std::make_shared<ChunkCollectorModule>(100);
+        pModule->SetNextModule(pCollector);
+        pModule->SetParallelWorkerCount(uNumWorkers);
+
+        for (auto& pInputChunk : vpTimeChunks)
+            pModule->CallChunkCallbackFunction(pInputChunk);
+
+        std::vector<std::shared_ptr<BaseChunk>> vpOutputChunks;
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            vpOutputChunks.push_back(pOutputChunk);
+        return vpOutputChunks;
+    };
+
+    auto vpSerialChunks = ProcessAll(1);
+    auto vpParallelChunks = ProcessAll(4);
+    ASSERT_EQ(vpSerialChunks.size(), vpParallelChunks.size()) << " Testing the same number of chunks are produced";
+
+    for (size_t uChunkIndex = 0; uChunkIndex < vpSerialChunks.size(); uChunkIndex++)
+    {
+        EXPECT_EQ(vpSerialChunks[uChunkIndex]->GetChunkType(), vpParallelChunks[uChunkIndex]->GetChunkType()) << " Testing chunk order is kept";
+        if (vpSerialChunks[uChunkIndex]->GetChunkType() != ChunkType::FFTChunk)
+            continue;
+
+        auto pSerialFFTChunk = std::static_pointer_cast<FFTChunk>(vpSerialChunks[uChunkIndex]);
+        auto pParallelFFTChunk = std::static_pointer_cast<FFTChunk>(vpParallelChunks[uChunkIndex]);
+        EXPECT_EQ(pSerialFFTChunk->m_i64TimeStamp, pParallelFFTChunk->m_i64TimeStamp) << " Testing chunk order is kept";
+        EXPECT_EQ(pSerialFFTChunk->m_vvcfFFTChunks, pParallelFFTChunk->m_vvcfFFTChunks) << " Testing parallel bins are bit identical";
+    }
+}
+
+/**
+ * @brief FFT module whose input buffer is drained by the test, so chunks stay in flight as they would on its processing thread
+ */
+class BufferedFFTModule : public FFTModule {
+public:
+    BufferedFFTModule(unsigned uBufferSize) : FFTModule(uBufferSize) {}
+    using BaseModule::TakeFromBuffer;
+
+    void ProcessBufferedChunks(size_t uNumChunks) {
+        std::shared_ptr<BaseChunk> pBaseChunk;
+        for (size_t uChunkIndex = 0; uChunkIndex < uNumChunks && TakeFromBuffer(pBaseChunk); uChunkIndex++)
+            CallChunkCallbackFunction(pBaseChunk);
+    }
+
+    void StopProcessingOnTestThread() {
+        m_bShutDown = true;
+        ContinuouslyTryProcess();
+    }
+};
+
+// Chunks of many sources queued behind each other keep their order and none are lost, including those in flight on shut down
+TEST_F(TestFFTModule, TestParallelKeepsOrderWithJobsInFlight) {
+
+    std::vector<std::shared_ptr<TimeChunk>> vpTimeChunks;
+    for (unsigned uChunkIndex = 0; uChunkIndex < 30; uChunkIndex++)
+    {
+        auto pInputChunk = std::make_shared<TimeChunk>(256, 16000, uChunkIndex, 16, 2, 4);
+        pInputChunk->m_vvi16TimeChunks.resize(4);
+        for (unsigned uChannelIndex = 0; uChannelIndex < 4; uChannelIndex++)
+            for (unsigned uSampleIndex = 0; uSampleIndex < 256; uSampleIndex++)
+                pInputChunk->m_vvi16TimeChunks[uChannelIndex].push_back(((uSampleIndex + 1) * (uChannelIndex + 3) * (uChunkIndex + 7)) % 2000 - 1000);
+        pInputChunk->SetSourceIdentifier({(uint8_t)(uChunkIndex % 3)});
+        vpTimeChunks.push_back(pInputChunk);
+    }
+
+    auto CollectFFTChunks = [](std::shared_ptr<ChunkCollectorModule> pCollector) {
+        std::vector<std::shared_ptr<FFTChunk>> vpFFTChunks;
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::FFTChunk)
+                vpFFTChunks.push_back(std::static_pointer_cast<FFTChunk>(pOutputChunk));
+        return vpFFTChunks;
+    };
+
+    // Reference results from the serial path
+    auto pSerialCollector = std::make_shared<ChunkCollectorModule>(100);
+    pFFTModule->SetNextModule(pSerialCollector);
+    for (auto& pInputChunk : vpTimeChunks)
+        pFFTModule->CallChunkCallbackFunction(pInputChunk);
+    auto vpSerialChunks = CollectFFTChunks(pSerialCollector);
+
+    auto CheckMatchesSerial = [&vpSerialChunks](const std::vector<std::shared_ptr<FFTChunk>>& vpParallelChunks) {
+        for (size_t uChunkIndex = 0; uChunkIndex < vpParallelChunks.size(); uChunkIndex++)
+        {
+            EXPECT_EQ(vpParallelChunks[uChunkIndex]->m_i64TimeStamp, uChunkIndex) << " Testing chunks leave in submission order";
+            EXPECT_EQ(vpParallelChunks[uChunkIndex]->GetSourceIdentifier(), vpSerialChunks[uChunkIndex]->GetSourceIdentifier());
+            EXPECT_EQ(vpParallelChunks[uChunkIndex]->m_vvcfFFTChunks, vpSerialChunks[uChunkIndex]->m_vvcfFFTChunks) << " Testing chunk " << uChunkIndex << " matches the serial result";
+        }
+    };
+
+    // Every chunk is queued before processing starts so later chunks are submitted while earlier ones are in flight
+    {
+        auto pParallelModule = std::make_shared<BufferedFFTModule>(100);
+        auto pCollector = std::make_shared<ChunkCollectorModule>(100);
+        pParallelModule->SetNextModule(pCollector);
+        pParallelModule->SetParallelWorkerCount(4);
+        for (auto& pInputChunk : vpTimeChunks)
+            pParallelModule->TakeChunkFromModule(pInputChunk);
+
+        pParallelModule->ProcessBufferedChunks(vpTimeChunks.size());
+        auto vpParallelChunks = CollectFFTChunks(pCollector);
+        ASSERT_EQ(vpParallelChunks.size(), vpTimeChunks.size()) << " Testing every chunk is passed on once the buffer runs dry";
+        CheckMatchesSerial(vpParallelChunks);
+    }
+
+    // Stopping while chunks are still queued behind in flight ones must not drop the in flight ones
+    {
+        auto pParallelModule = std::make_shared<BufferedFFTModule>(100);
+        auto pCollector = std::make_shared<ChunkCollectorModule>(100);
+        pParallelModule->SetNextModule(pCollector);
+        pParallelModule->SetParallelWorkerCount(4);
+        for (auto& pInputChunk : vpTimeChunks)
+            pParallelModule->TakeChunkFromModule(pInputChunk);
+
+        pParallelModule->ProcessBufferedChunks(20);
+        pParallelModule->StopProcessingOnTestThread();
+        auto vpParallelChunks = CollectFFTChunks(pCollector);
+        ASSERT_EQ(vpParallelChunks.size(), 20u) << " Testing in flight chunks are passed on when processing stops";
+        CheckMatchesSerial(vpParallelChunks);
+
+        pParallelModule.reset();
+        EXPECT_TRUE(CollectFFTChunks(pCollector).empty()) << " Testing nothing is passed on from the destructor";
+    }
+}
+
+// Welch averaging should emit one magnitude chunk per averaging period, stamped at the start of its first frame
+TEST_F(TestFFTModule, TestWelchEmitsOneChunkPerPeriod) {
+
+    auto pCollector = std::make_shared<ChunkCollectorModule>(100);
+    pFFTModule->SetNextModule(pCollector);
+    pFFTModule->EnableWelchMode(256, 128, "Hann", 4);
+
+    // A tone centred on bin 32 of a 256 point FFT
+    for (unsigned uChunkIndex = 0; uChunkIndex < 6; uChunkIndex++)
+    {
+        auto pToneChunk = std::make_shared<TimeChunk>(512, 16000, uChunkIndex * 32000, 16, 2, 1);
+        pToneChunk->m_vvi16TimeChunks.resize(1);
+        pToneChunk->m_vvi16TimeChunks[0].resize(512);
+        for (unsigned uSampleIndex = 0; uSampleIndex < 512; uSampleIndex++)
+            pToneChunk->m_vvi16TimeChunks[0][uSampleIndex] = (int16_t)(1000 * std::cos(2 * M_PI * 32 * (uChunkIndex * 512 + uSampleIndex) / 256.0));
+        pToneChunk->SetSourceIdentifier({1});
+        pFFTModule->CallChunkCallbackFunction(pToneChunk);
+    }
+
+    std::vector<std::shared_ptr<FFTMagnitudeChunk>> vpWelchChunks;
+    std::shared_ptr<BaseChunk> pOutputChunk;
+    while (pCollector->TakeFromBuffer(pOutputChunk))
+        if (pOutputChunk->GetChunkType() == ChunkType::FFTMagnitudeChunk)
+            vpWelchChunks.push_back(std::static_pointer_cast<FFTMagnitudeChunk>(pOutputChunk));
+
+    // 3 frames in the first chunk then 4 per chunk, 23 frames in total
+    ASSERT_EQ(vpWelchChunks.size(), 5) << " Testing one chunk is emitted per 4 frames";
+    for (unsigned uPeriodIndex = 0; uPeriodIndex < vpWelchChunks.size(); uPeriodIndex++)
+    {
+        EXPECT_EQ(vpWelchChunks[uPeriodIndex]->m_i64TimeStamp, uPeriodIndex * 32000) << " Testing period timestamps";
+        EXPECT_NEAR(vpWelchChunks[uPeriodIndex]->m_vvfFFTMagnitudeChunks[0][32], 1000, 10) << " Testing averaged tone magnitude";
+    }
+}
+
+// Frames are emitted once a hop of new samples has arrived, stamped with the time of their first sample
+TEST_F(TestFFTModule, TestSTFTFrameCountAndHop) {
+
+    auto pCollector = std::make_shared<ChunkCollectorModule>(100);
+    pFFTModule->SetNextModule(pCollector);
+    pFFTModule->EnableSTFTMode(256, 128, "Hann");
+
+    // A tone centred on bin 32 of a 256 point FFT
+    for (unsigned uChunkIndex = 0; uChunkIndex < 3; uChunkIndex++)
+    {
+        auto pToneChunk = std::make_shared<TimeChunk>(512, 16000, uChunkIndex * 32000, 16, 2, 1);
+        pToneChunk->m_vvi16TimeChunks.resize(1);
+        pToneChunk->m_vvi16TimeChunks[0].resize(512);
+        for (unsigned uSampleIndex = 0; uSampleIndex < 512; uSampleIndex++)
+            pToneChunk->m_vvi16TimeChunks[0][uSampleIndex] = (int16_t)(1000 * std::cos(2 * M_PI * 32 * (uChunkIndex * 512 + uSampleIndex) / 256.0));
+        pToneChunk->SetSourceIdentifier({1});
+        pFFTModule->CallChunkCallbackFunction(pToneChunk);
+    }
+
+    std::vector<std::shared_ptr<SpectrogramChunk>> vpSpectrogramChunks;
+    std::shared_ptr<BaseChunk> pOutputChunk;
+    while (pCollector->TakeFromBuffer(pOutputChunk))
+        if (pOutputChunk->GetChunkType() == ChunkType::SpectrogramChunk)
+            vpSpectrogramChunks.push_back(std::static_pointer_cast<SpectrogramChunk>(pOutputChunk));
+
+    // The first chunk fills one frame then a hop at a time, 3 frames, every later chunk completes 4
+    ASSERT_EQ(vpSpectrogramChunks.size(), 3u) << " Testing one spectrogram per chunk";
+    const std::vector<unsigned> vuExpectedFrames = { 3, 4, 4 };
+    const std::vector<uint64_t> vu64ExpectedTimeStamps = { 0, 24000, 56000 };
+    for (unsigned uChunkIndex = 0; uChunkIndex < vpSpectrogramChunks.size(); uChunkIndex++)
+    {
+        auto& pSpectrogramChunk = vpSpectrogramChunks[uChunkIndex];
+        EXPECT_EQ(pSpectrogramChunk->m_uNumFrames, vuExpectedFrames[uChunkIndex]) << " Testing frames due in chunk " << uChunkIndex;
+        EXPECT_EQ(pSpectrogramChunk->m_uHopLength, 128u);
+        EXPECT_EQ(pSpectrogramChunk->m_uNumBins, 129u);
+        EXPECT_EQ(pSpectrogramChunk->m_i64TimeStamp, vu64ExpectedTimeStamps[uChunkIndex]) << " Testing first frame of chunk " << uChunkIndex << " starts a hop after the last frame of the previous";
+        for (unsigned uFrameIndex = 0; uFrameIndex < pSpectrogramChunk->m_uNumFrames; uFrameIndex++)
+            EXPECT_NEAR(pSpectrogramChunk->GetFrame(0, uFrameIndex)[32], 1000, 10) << " Testing tone magnitude of frame " << uFrameIndex;
+    }
+}
+
+TEST_F(TestFFTModule, TestSpectrogramChunkRoundTrip) {
+
+    SpectrogramChunk InputChunk(16000, 123456, 2, 3, 5, 8, 4);
+    InputChunk.SetSourceIdentifier({1, 2, 3});
+    for (size_t uIndex = 0; uIndex < InputChunk.m_vfMagnitudes.size(); uIndex++)
+        InputChunk.m_vfMagnitudes[uIndex] = 0.5f * uIndex;
+
+    auto pvBytes = InputChunk.Serialise();
+    EXPECT_EQ(pvBytes->size(), InputChunk.GetSize()) << " Testing serialised size matches GetSize";
+
+    SpectrogramChunk OutputChunk(0, 0, 0, 0, 0, 0, 0);
+    OutputChunk.Deserialise(pvBytes);
+    EXPECT_EQ(OutputChunk.m_dSampleRate, InputChunk.m_dSampleRate);
+    EXPECT_EQ(OutputChunk.m_i64TimeStamp, InputChunk.m_i64TimeStamp);
+    EXPECT_EQ(OutputChunk.m_uNumChannels, 2u);
+    EXPECT_EQ(OutputChunk.m_uNumFrames, 3u);
+    EXPECT_EQ(OutputChunk.m_uNumBins, 5u);
+    EXPECT_EQ(OutputChunk.m_uFFTLength, 8u);
+    EXPECT_EQ(OutputChunk.m_uHopLength, 4u);
+    EXPECT_EQ(OutputChunk.m_vfMagnitudes, InputChunk.m_vfMagnitudes);
+    EXPECT_EQ(OutputChunk.GetFrame(1, 2)[4], InputChunk.GetFrame(1, 2)[4]) << " Testing frame layout survives the round trip";
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "FIRFilterModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class FilteredCollectorModule : public BaseModule {
+public:
+    FilteredCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "FilteredCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+// Overlap-save output should match direct form convolution of the whole stream, whatever the chunk sizes
+TEST(TestFIRFilterModule, TestMatchesDirectFormAcrossChunks) {
+
+    // 31 taps gives a 128 point block, so chunks both span several steps and end part way through one
+    std::vector<float> vfFilterCoefficients(31);
+    for (size_t uTapIndex = 0; uTapIndex < vfFilterCoefficients.size(); uTapIndex++)
+        vfFilterCoefficients[uTapIndex] = 0.05f * std::cos(0.3f * uTapIndex) + 0.01f * (uTapIndex % 3);
+
+    nlohmann::json jsonConfig;
+    jsonConfig["FilterCoefficients"] = vfFilterCoefficients;
+    auto pFIRFilterModule = std::make_shared<FIRFilterModule>(10, jsonConfig);
+    auto pCollector = std::make_shared<FilteredCollectorModule>(100);
+    pFIRFilterModule->SetNextModule(pCollector);
+
+    const std::vector<unsigned> vuChunkSizes = { 100, 37, 250, 98, 1, 300 };
+    const unsigned uNumChannels = 2;
+    std::vector<std::vector<int16_t>> vvi16Stream(uNumChannels);
+    uint64_t u64TimeStamp = 0;
+    for (unsigned uChunkSize : vuChunkSizes)
+    {
+        auto pTimeChunk = std::make_shared<TimeChunk>(uChunkSize, 16000, u64TimeStamp, 16, 2, uNumChannels);
+        pTimeChunk->m_vvi16TimeChunks.resize(uNumChannels);
+        for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels; uChannelIndex++)
+        {
+            auto& vi16ChannelData = pTimeChunk->m_vvi16TimeChunks[uChannelIndex];
+            vi16ChannelData.resize(uChunkSize);
+            for (unsigned uSampleIndex = 0; uSampleIndex < uChunkSize; uSampleIndex++)
+            {
+                size_t uStreamIndex = vvi16Stream[uChannelIndex].size();
+                vi16ChannelData[uSampleIndex] = (int16_t)(3000 * std::sin(0.05 * uStreamIndex * (uChannelIndex + 1)) + ((uStreamIndex * 7919) % 1000) - 500);
+                vvi16Stream[uChannelIndex].push_back(vi16ChannelData[uSampleIndex]);
+            }
+        }
+        pTimeChunk->SetSourceIdentifier({1});
+        pFIRFilterModule->CallChunkCallbackFunction(pTimeChunk);
+        u64TimeStamp += 1000;
+    }
+
+    std::vector<std::vector<int16_t>> vvi16Filtered(uNumChannels);
+    std::shared_ptr<BaseChunk> pOutputChunk;
+    unsigned uChunkIndex = 0;
+    while (pCollector->TakeFromBuffer(pOutputChunk))
+    {
+        auto pFilteredChunk = std::static_pointer_cast<TimeChunk>(pOutputChunk);
+        ASSERT_LT(uChunkIndex, vuChunkSizes.size());
+        EXPECT_EQ(pFilteredChunk->m_dChunkSize, vuChunkSizes[uChunkIndex]) << " Testing metadata is kept";
+        EXPECT_EQ(pFilteredChunk->m_i64TimeStamp, 1000u * uChunkIndex) << " Testing metadata is kept";
+        EXPECT_EQ(pFilteredChunk->GetSourceIdentifier(), std::vector<uint8_t>({1}));
+        for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels; uChannelIndex++)
+        {
+            ASSERT_EQ(pFilteredChunk->m_vvi16TimeChunks[uChannelIndex].size(), vuChunkSizes[uChunkIndex]);
+            vvi16Filtered[uChannelIndex].insert(vvi16Filtered[uChannelIndex].end(), pFilteredChunk->m_vvi16TimeChunks[uChannelIndex].begin(), pFilteredChunk->m_vvi16TimeChunks[uChannelIndex].end());
+        }
+        uChunkIndex++;
+    }
+    ASSERT_EQ(uChunkIndex, vuChunkSizes.size()) << " Testing one output per input chunk";
+
+    for (unsigned uChannelIndex = 0; uChannelIndex < uNumChannels; uChannelIndex++)
+    {
+        const auto& vi16Input = vvi16Stream[uChannelIndex];
+        for (size_t uSampleIndex = 0; uSampleIndex < vi16Input.size(); uSampleIndex++)
+        {
+            double dExpected = 0;
+            for (size_t uTapIndex = 0; uTapIndex < vfFilterCoefficients.size() && uTapIndex <= uSampleIndex; uTapIndex++)
+                dExpected += vfFilterCoefficients[uTapIndex] * vi16Input[uSampleIndex - uTapIndex];
+            ASSERT_NEAR(vvi16Filtered[uChannelIndex][uSampleIndex], dExpected, 1.0) << " Testing sample " << uSampleIndex << " of channel " << uChannelIndex;
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "GoertzelFilterBankModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class TonePowerCollectorModule : public BaseModule {
+public:
+    TonePowerCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "TonePowerCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+class TestGoertzelFilterBankModule : public ::testing::Test {
+protected:
+    const double dSampleRate = 8000;
+    const unsigned uChunkSize = 256;
+    const unsigned uBlockLength = 400;
+
+    std::vector<std::shared_ptr<TonePowerChunk>> ProcessTones(const std::vector<float>& vfTargetFrequencies_Hz, const std::vector<std::pair<double, double>>& vToneFrequenciesAndAmplitudes, unsigned uNumChunks) {
+        nlohmann::json jsonConfig;
+        jsonConfig["TargetFrequencies_Hz"] = vfTargetFrequencies_Hz;
+        jsonConfig["BlockLength"] = uBlockLength;
+        auto pGoertzelModule = std::make_shared<GoertzelFilterBankModule>(10, jsonConfig);
+        auto pCollector = std::make_shared<TonePowerCollectorModule>(100);
+        pGoertzelModule->SetNextModule(pCollector);
+
+        // Chunks are deliberately shorter than and unaligned with the blocks
+        for (unsigned uChunkIndex = 0; uChunkIndex < uNumChunks; uChunkIndex++)
+        {
+            auto pTimeChunk = std::make_shared<TimeChunk>(uChunkSize, dSampleRate, (uint64_t)(1e6 * uChunkIndex * uChunkSize / dSampleRate), 16, 2, 1);
+            pTimeChunk->m_vvi16TimeChunks.resize(1);
+            pTimeChunk->m_vvi16TimeChunks[0].resize(uChunkSize);
+            for (unsigned uSampleIndex = 0; uSampleIndex < uChunkSize; uSampleIndex++)
+            {
+                double dTime = (uChunkIndex * uChunkSize + uSampleIndex) / dSampleRate;
+                double dSample = 0;
+                for (const auto& [dFrequency, dAmplitude] : vToneFrequenciesAndAmplitudes)
+                    dSample += dAmplitude * std::cos(2 * M_PI * dFrequency * dTime);
+                pTimeChunk->m_vvi16TimeChunks[0][uSampleIndex] = (int16_t)std::round(dSample);
+            }
+            pTimeChunk->SetSourceIdentifier({1});
+            pGoertzelModule->CallChunkCallbackFunction(pTimeChunk);
+        }
+
+        std::vector<std::shared_ptr<TonePowerChunk>> vpTonePowerChunks;
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::TonePowerChunk)
+                vpTonePowerChunks.push_back(std::static_pointer_cast<TonePowerChunk>(pOutputChunk));
+        return vpTonePowerChunks;
+    }
+};
+
+// A tone of amplitude A centred on the filter should read A^2 in every block, stamped at the block start
+TEST_F(TestGoertzelFilterBankModule, TestKnownSinusoidPower) {
+
+    auto vpTonePowerChunks = ProcessTones({ 1000 }, { { 1000, 1000 } }, 5);
+
+    // 1280 samples complete three blocks, in the chunks ending at samples 512, 1024 and 1280
+    ASSERT_EQ(vpTonePowerChunks.size(), 3u);
+    const std::vector<uint64_t> vu64ExpectedTimeStamps = { 0, 50000, 100000 };
+    for (unsigned uChunkIndex = 0; uChunkIndex < vpTonePowerChunks.size(); uChunkIndex++)
+    {
+        auto& pTonePowerChunk = vpTonePowerChunks[uChunkIndex];
+        ASSERT_EQ(pTonePowerChunk->m_uNumBlocks, 1u);
+        EXPECT_EQ(pTonePowerChunk->m_uBlockLength, uBlockLength);
+        EXPECT_EQ(pTonePowerChunk->m_i64TimeStamp, vu64ExpectedTimeStamps[uChunkIndex]) << " Testing blocks are stamped with their first sample";
+        EXPECT_NEAR(pTonePowerChunk->GetBlock(0, 0)[0], 1e6, 1e4) << " Testing tone power in block " << uChunkIndex;
+    }
+}
+
+// Each filter of a bank should only respond to its own tone
+TEST_F(TestGoertzelFilterBankModule, TestMultiToneBank) {
+
+    const std::vector<float> vfTargetFrequencies_Hz = { 500, 1000, 1500, 2000 };
+    auto vpTonePowerChunks = ProcessTones(vfTargetFrequencies_Hz, { { 1000, 1000 }, { 2000, 300 } }, 5);
+
+    ASSERT_FALSE(vpTonePowerChunks.empty());
+    for (auto& pTonePowerChunk : vpTonePowerChunks)
+    {
+        ASSERT_EQ(pTonePowerChunk->m_vfFrequencies_Hz, vfTargetFrequencies_Hz);
+        const float* pfPowers = pTonePowerChunk->GetBlock(0, 0);
+        EXPECT_NEAR(pfPowers[0], 0, 1) << " Testing absent tone at 500 Hz";
+        EXPECT_NEAR(pfPowers[1], 1e6, 1e4) << " Testing tone at 1000 Hz";
+        EXPECT_NEAR(pfPowers[2], 0, 1) << " Testing absent tone at 1500 Hz";
+        EXPECT_NEAR(pfPowers[3], 9e4, 1e3) << " Testing tone at 2000 Hz";
+    }
+}
+
+TEST_F(TestGoertzelFilterBankModule, TestTonePowerChunkRoundTrip) {
+
+    TonePowerChunk InputChunk(8000, 123456, 2, 3, 400, { 500, 1000 });
+    InputChunk.SetSourceIdentifier({1, 2, 3});
+    for (size_t uIndex = 0; uIndex < InputChunk.m_vfPowers.size(); uIndex++)
+        InputChunk.m_vfPowers[uIndex] = 1.5f * uIndex;
+
+    auto pvBytes = InputChunk.Serialise();
+    EXPECT_EQ(pvBytes->size(), InputChunk.GetSize()) << " Testing serialised size matches GetSize";
+
+    TonePowerChunk OutputChunk(0, 0, 0, 0, 0, {});
+    OutputChunk.Deserialise(pvBytes);
+    EXPECT_EQ(OutputChunk.m_dSampleRate, InputChunk.m_dSampleRate);
+    EXPECT_EQ(OutputChunk.m_i64TimeStamp, InputChunk.m_i64TimeStamp);
+    EXPECT_EQ(OutputChunk.m_uNumChannels, 2u);
+    EXPECT_EQ(OutputChunk.m_uNumBlocks, 3u);
+    EXPECT_EQ(OutputChunk.m_uBlockLength, 400u);
+    EXPECT_EQ(OutputChunk.m_vfFrequencies_Hz, InputChunk.m_vfFrequencies_Hz);
+    EXPECT_EQ(OutputChunk.m_vfPowers, InputChunk.m_vfPowers);
+    EXPECT_EQ(OutputChunk.GetBlock(1, 2)[1], InputChunk.GetBlock(1, 2)[1]) << " Testing block layout survives the round trip";
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "MultilaterationModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class PositionCollectorModule : public BaseModule {
+public:
+    PositionCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "PositionCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+class TestMultilaterationModule : public ::testing::Test {
+protected:
+    // You can use SetUp and TearDown for initialization and cleanup.
+    void SetUp() override {
+        pMultilaterationModule = std::make_shared<MultilaterationModule>(10, dPropagationVelocity_mps);
+        pCollector = std::make_shared<PositionCollectorModule>(10);
+        pMultilaterationModule->SetNextModule(pCollector);
+    }
+
+    void TearDown() override {
+
+    }
+
+    // Small offsets in metres from a fixed point using the WGS84 radii of curvature there
+    static std::pair<double, double> Offset(double dEast_m, double dNorth_m) {
+        double dEccentricitySquared = 6.69437999014e-3;
+        double dSinLatitude = std::sin(dReferenceLatitude * M_PI / 180);
+        double dPrimeVerticalRadius_m = 6378137.0 / std::sqrt(1 - dEccentricitySquared * dSinLatitude * dSinLatitude);
+        double dMeridianRadius_m = dPrimeVerticalRadius_m * (1 - dEccentricitySquared) / (1 - dEccentricitySquared * dSinLatitude * dSinLatitude);
+        double dLatitude = dReferenceLatitude + dNorth_m / dMeridianRadius_m * 180 / M_PI;
+        double dLongitude = dReferenceLongitude + dEast_m / (dPrimeVerticalRadius_m * std::cos(dReferenceLatitude * M_PI / 180)) * 180 / M_PI;
+        return { dLatitude, dLongitude };
+    }
+
+    std::shared_ptr<TDOAEstimateChunk> MakeEstimate(double dEmitterEast_m, double dEmitterNorth_m) {
+        unsigned uNumSensors = vSensorPositions_m.size();
+        auto pTDOAEstimateChunk = std::make_shared<TDOAEstimateChunk>(16000, 100, uNumSensors);
+        for (unsigned uFirstSensor = 0; uFirstSensor < uNumSensors; uFirstSensor++)
+        {
+            auto [dLatitude, dLongitude] = Offset(vSensorPositions_m[uFirstSensor].first, vSensorPositions_m[uFirstSensor].second);
+            pTDOAEstimateChunk->m_vdLatitudes[uFirstSensor] = dLatitude;
+            pTDOAEstimateChunk->m_vdLongitudes[uFirstSensor] = dLongitude;
+
+            for (unsigned uSecondSensor = 0; uSecondSensor < uNumSensors; uSecondSensor++)
+            {
+                double dFirstRange_m = std::hypot(dEmitterEast_m - vSensorPositions_m[uFirstSensor].first, dEmitterNorth_m - vSensorPositions_m[uFirstSensor].second);
+                double dSecondRange_m = std::hypot(dEmitterEast_m - vSensorPositions_m[uSecondSensor].first, dEmitterNorth_m - vSensorPositions_m[uSecondSensor].second);
+                pTDOAEstimateChunk->m_vfDelays_s[uFirstSensor * uNumSensors + uSecondSensor] = (dSecondRange_m - dFirstRange_m) / dPropagationVelocity_mps;
+                pTDOAEstimateChunk->m_vfConfidences[uFirstSensor * uNumSensors + uSecondSensor] = 1;
+            }
+        }
+        return pTDOAEstimateChunk;
+    }
+
+    std::shared_ptr<PositionChunk> CollectPosition() {
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        std::shared_ptr<PositionChunk> pPositionChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::PositionChunk)
+                pPositionChunk = std::static_pointer_cast<PositionChunk>(pOutputChunk);
+        return pPositionChunk;
+    }
+
+    static constexpr double dReferenceLatitude = -33.92;
+    static constexpr double dReferenceLongitude = 18.42;
+    const double dPropagationVelocity_mps = 343;
+    const std::vector<std::pair<double, double>> vSensorPositions_m = { { 0, 0 }, { 120, 10 }, { 60, 140 }, { -40, 90 }, { 30, -80 } };
+    std::shared_ptr<MultilaterationModule> pMultilaterationModule;
+    std::shared_ptr<PositionCollectorModule> pCollector;
+};
+
+// Emitters inside and outside the array are located from exact delays, reusing the local frame
+TEST_F(TestMultilaterationModule, TestPositionFix) {
+    for (auto [dEmitterEast_m, dEmitterNorth_m] : std::vector<std::pair<double, double>>{ { 45, 60 }, { -150, 220 }, { 400, -300 } })
+    {
+        pMultilaterationModule->Process_TDOAEstimateChunk(MakeEstimate(dEmitterEast_m, dEmitterNorth_m));
+        auto pPositionChunk = CollectPosition();
+        ASSERT_NE(pPositionChunk, nullptr) << " Testing a fix is produced";
+
+        auto [dExpectedLatitude, dExpectedLongitude] = Offset(dEmitterEast_m, dEmitterNorth_m);
+        EXPECT_NEAR(pPositionChunk->m_dLatitude, dExpectedLatitude, 2e-6) << " Testing latitude of emitter at " << dEmitterEast_m << ", " << dEmitterNorth_m;
+        EXPECT_NEAR(pPositionChunk->m_dLongitude, dExpectedLongitude, 2e-6) << " Testing longitude of emitter at " << dEmitterEast_m << ", " << dEmitterNorth_m;
+        EXPECT_EQ(pPositionChunk->m_u32NumMeasurements, 10u) << " Testing every pair is used";
+        EXPECT_GT(pPositionChunk->m_adCovariance_m2[0], 0) << " Testing east variance is positive";
+        EXPECT_GT(pPositionChunk->m_adCovariance_m2[3], 0) << " Testing north variance is positive";
+    }
+
+    EXPECT_EQ(pMultilaterationModule->GetGeometryUpdateCount(), 1u) << " Testing the local frame is only computed once for fixed sensors";
+}
+
+// Pairs below the confidence threshold are left out and too few pairs give no fix
+TEST_F(TestMultilaterationModule, TestWeakPairsRejected) {
+    auto pTDOAEstimateChunk = MakeEstimate(45, 60);
+    std::fill(pTDOAEstimateChunk->m_vfConfidences.begin(), pTDOAEstimateChunk->m_vfConfidences.end(), 0.05f);
+    pTDOAEstimateChunk->m_vfConfidences[0 * 5 + 1] = 1;
+    pMultilaterationModule->Process_TDOAEstimateChunk(pTDOAEstimateChunk);
+    EXPECT_EQ(CollectPosition(), nullptr) << " Testing one confident pair gives no fix";
+}
+
+// Every field of a fix, including the covariance, survives serialisation unchanged
+TEST_F(TestMultilaterationModule, TestPositionChunkRoundTrip) {
+
+    PositionChunk InputChunk(123456);
+    InputChunk.SetSourceIdentifier({ 1, 2, 3 });
+    InputChunk.m_dLatitude = -33.9187;
+    InputChunk.m_dLongitude = 18.4233;
+    InputChunk.m_dReferenceLatitude = dReferenceLatitude;
+    InputChunk.m_dReferenceLongitude = dReferenceLongitude;
+    InputChunk.m_dEast_m = 123.5;
+    InputChunk.m_dNorth_m = -45.25;
+    InputChunk.m_adCovariance_m2 = { 4.0, -0.5, -0.5, 9.0 };
+    InputChunk.m_dResidual_m = 0.75;
+    InputChunk.m_u32NumMeasurements = 10;
+
+    auto pvBytes = InputChunk.Serialise();
+    EXPECT_EQ(pvBytes->size(), InputChunk.GetSize()) << " Testing serialised size matches GetSize";
+
+    PositionChunk OutputChunk(0);
+    OutputChunk.Deserialise(pvBytes);
+    EXPECT_EQ(OutputChunk.m_i64TimeStamp, InputChunk.m_i64TimeStamp);
+    EXPECT_EQ(OutputChunk.m_dLatitude, InputChunk.m_dLatitude);
+    EXPECT_EQ(OutputChunk.m_dLongitude, InputChunk.m_dLongitude);
+    EXPECT_EQ(OutputChunk.m_dReferenceLatitude, InputChunk.m_dReferenceLatitude);
+    EXPECT_EQ(OutputChunk.m_dReferenceLongitude, InputChunk.m_dReferenceLongitude);
+    EXPECT_EQ(OutputChunk.m_dEast_m, InputChunk.m_dEast_m);
+    EXPECT_EQ(OutputChunk.m_dNorth_m, InputChunk.m_dNorth_m);
+    EXPECT_EQ(OutputChunk.m_adCovariance_m2, InputChunk.m_adCovariance_m2) << " Testing covariance keeps its row major layout";
+    EXPECT_EQ(OutputChunk.m_dResidual_m, InputChunk.m_dResidual_m);
+    EXPECT_EQ(OutputChunk.m_u32NumMeasurements, InputChunk.m_u32NumMeasurements);
+}
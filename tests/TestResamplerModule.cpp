@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "ResamplerModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class ResampledCollectorModule : public BaseModule {
+public:
+    ResampledCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "ResampledCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+// Resampling 48 kHz to 32 kHz should re-chunk at the new rate and pass a tone well inside the band unchanged, in phase with its timestamps
+TEST(TestResamplerModule, TestRateLengthAndPassbandAmplitude) {
+
+    nlohmann::json jsonConfig;
+    jsonConfig["InterpolationFactor"] = 2;
+    jsonConfig["DecimationFactor"] = 3;
+    jsonConfig["TapsPerPhase"] = 32;
+    jsonConfig["OutputChunkSize"] = 256;
+    auto pResamplerModule = std::make_shared<ResamplerModule>(10, jsonConfig);
+    auto pCollector = std::make_shared<ResampledCollectorModule>(100);
+    pResamplerModule->SetNextModule(pCollector);
+
+    const double dInputSampleRate = 48000;
+    const double dToneFrequency = 1000;
+    const double dToneAmplitude = 10000;
+    const unsigned uInputChunkSize = 480;
+    const unsigned uNumChunks = 20;
+    const uint64_t u64StartTimeStamp = 1000000;
+    for (unsigned uChunkIndex = 0; uChunkIndex < uNumChunks; uChunkIndex++)
+    {
+        auto pTimeChunk = std::make_shared<TimeChunk>(uInputChunkSize, dInputSampleRate, u64StartTimeStamp + uChunkIndex * 10000, 16, 2, 2);
+        pTimeChunk->m_vvi16TimeChunks.resize(2);
+        for (unsigned uChannelIndex = 0; uChannelIndex < 2; uChannelIndex++)
+        {
+            pTimeChunk->m_vvi16TimeChunks[uChannelIndex].resize(uInputChunkSize);
+            for (unsigned uSampleIndex = 0; uSampleIndex < uInputChunkSize; uSampleIndex++)
+            {
+                double dTime = (uChunkIndex * uInputChunkSize + uSampleIndex) / dInputSampleRate;
+                pTimeChunk->m_vvi16TimeChunks[uChannelIndex][uSampleIndex] = (int16_t)std::round(dToneAmplitude * std::sin(2 * M_PI * dToneFrequency * dTime + uChannelIndex));
+            }
+        }
+        pTimeChunk->SetSourceIdentifier({1});
+        pResamplerModule->CallChunkCallbackFunction(pTimeChunk);
+    }
+
+    std::vector<std::shared_ptr<TimeChunk>> vpResampledChunks;
+    std::shared_ptr<BaseChunk> pOutputChunk;
+    while (pCollector->TakeFromBuffer(pOutputChunk))
+        vpResampledChunks.push_back(std::static_pointer_cast<TimeChunk>(pOutputChunk));
+
+    // 9600 input samples give 6400 output samples, which fill 25 chunks of 256
+    ASSERT_EQ(vpResampledChunks.size(), 25u) << " Testing output length follows the 2/3 rate change";
+    for (unsigned uChunkIndex = 0; uChunkIndex < vpResampledChunks.size(); uChunkIndex++)
+    {
+        auto& pResampledChunk = vpResampledChunks[uChunkIndex];
+        EXPECT_EQ(pResampledChunk->m_dSampleRate, 32000) << " Testing output sample rate";
+        EXPECT_EQ(pResampledChunk->m_dChunkSize, 256);
+        EXPECT_EQ(pResampledChunk->GetSourceIdentifier(), std::vector<uint8_t>({1}));
+        // 64 taps at 96 kHz delay the output by 63/2 upsampled samples, 328.125 us
+        EXPECT_NEAR((double)pResampledChunk->m_i64TimeStamp, u64StartTimeStamp + uChunkIndex * 8000.0 - 328.125, 1) << " Testing chunks are stamped at the output rate less the filter delay";
+        ASSERT_EQ(pResampledChunk->m_vvi16TimeChunks.size(), 2u);
+        ASSERT_EQ(pResampledChunk->m_vvi16TimeChunks[0].size(), 256u);
+    }
+
+    // Skip the first chunk while the filter fills, 256 samples at 32 kHz hold exactly 8 periods of the tone
+    for (unsigned uChunkIndex = 1; uChunkIndex < vpResampledChunks.size(); uChunkIndex++)
+        for (unsigned uChannelIndex = 0; uChannelIndex < 2; uChannelIndex++)
+        {
+            double dSumOfSquares = 0;
+            for (int16_t i16Sample : vpResampledChunks[uChunkIndex]->m_vvi16TimeChunks[uChannelIndex])
+                dSumOfSquares += (double)i16Sample * i16Sample;
+            double dAmplitude = std::sqrt(2 * dSumOfSquares / 256);
+            EXPECT_NEAR(dAmplitude, dToneAmplitude, 0.01 * dToneAmplitude) << " Testing passband tone amplitude of chunk " << uChunkIndex << " channel " << uChannelIndex;
+
+            // Each sample should hold the tone at the time its timestamp gives it, which only holds once the filter delay is removed
+            double dMaxError = 0;
+            for (unsigned uSampleIndex = 0; uSampleIndex < 256; uSampleIndex++)
+            {
+                double dTime = (vpResampledChunks[uChunkIndex]->m_i64TimeStamp - (double)u64StartTimeStamp) * 1e-6 + uSampleIndex / 32000.0;
+                double dExpected = dToneAmplitude * std::sin(2 * M_PI * dToneFrequency * dTime + uChannelIndex);
+                dMaxError = std::max(dMaxError, std::abs(vpResampledChunks[uChunkIndex]->m_vvi16TimeChunks[uChannelIndex][uSampleIndex] - dExpected));
+            }
+            EXPECT_LT(dMaxError, 0.02 * dToneAmplitude) << " Testing tone phase matches the timestamp of chunk " << uChunkIndex << " channel " << uChannelIndex;
+        }
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include "RingBuffer.h"
+
+// Returns every stored element from oldest to newest
+static std::vector<int> ReadAll(const RingBuffer<int>& Buffer)
+{
+    std::vector<int> viElements;
+    for (size_t uIndex = 0; uIndex < Buffer.Size(); uIndex++)
+        viElements.push_back(Buffer[uIndex]);
+    return viElements;
+}
+
+// Elements pushed past the end of storage wrap to its start and still read back in order
+TEST(TestRingBuffer, TestWrapAround) {
+
+    RingBuffer<int> Buffer(8);
+    std::vector<int> viData(20);
+    std::iota(viData.begin(), viData.end(), 0);
+
+    EXPECT_EQ(Buffer.Push(viData.data(), 6), 0u);
+    Buffer.Consume(4);
+    EXPECT_EQ(Buffer.Size(), 2u);
+
+    // Head is now 4 so these five wrap around the end of storage
+    EXPECT_EQ(Buffer.Push(viData.data() + 6, 5), 0u) << " Testing nothing is evicted below capacity";
+    EXPECT_EQ(ReadAll(Buffer), std::vector<int>({ 4, 5, 6, 7, 8, 9, 10 }));
+    EXPECT_FALSE(Buffer.Full());
+
+    Buffer.Consume(100);
+    EXPECT_TRUE(Buffer.Empty()) << " Testing consume is clamped to the size";
+}
+
+// Pushing into a full buffer overwrites the oldest elements and reports how many
+TEST(TestRingBuffer, TestOverwriteReportsEvictions) {
+
+    RingBuffer<int> Buffer(8);
+    std::vector<int> viData(30);
+    std::iota(viData.begin(), viData.end(), 0);
+
+    EXPECT_EQ(Buffer.Push(viData.data(), 6), 0u);
+    EXPECT_EQ(Buffer.Push(viData.data() + 6, 5), 3u) << " Testing a partial overwrite";
+    EXPECT_TRUE(Buffer.Full());
+    EXPECT_EQ(ReadAll(Buffer), std::vector<int>({ 3, 4, 5, 6, 7, 8, 9, 10 }));
+
+    // More than capacity at once keeps only the newest
+    EXPECT_EQ(Buffer.Push(viData.data() + 11, 10), 10u) << " Testing every old element and the front of the push are evicted";
+    EXPECT_EQ(ReadAll(Buffer), std::vector<int>({ 13, 14, 15, 16, 17, 18, 19, 20 }));
+
+    RingBuffer<int> EmptyBuffer;
+    EXPECT_EQ(EmptyBuffer.Push(viData.data(), 4), 4u) << " Testing a zero capacity buffer drops everything";
+}
+
+// Views are split in two only when they cross the end of storage, and copies join them back up
+TEST(TestRingBuffer, TestPeekAndCopyTo) {
+
+    RingBuffer<int> Buffer(8);
+    std::vector<int> viData(12);
+    std::iota(viData.begin(), viData.end(), 0);
+    Buffer.Push(viData.data(), 6);
+
+    auto [FirstSpan, SecondSpan] = Buffer.Peek(1, 4);
+    EXPECT_EQ(std::vector<int>(FirstSpan.begin(), FirstSpan.end()), std::vector<int>({ 1, 2, 3, 4 }));
+    EXPECT_TRUE(SecondSpan.empty()) << " Testing a contiguous view is a single span";
+
+    // Head at 5 with 7 elements stored, so the view wraps after three
+    Buffer.Consume(5);
+    Buffer.Push(viData.data() + 6, 6);
+    auto [WrappedFirstSpan, WrappedSecondSpan] = Buffer.Peek(0, 7);
+    EXPECT_EQ(std::vector<int>(WrappedFirstSpan.begin(), WrappedFirstSpan.end()), std::vector<int>({ 5, 6, 7 }));
+    EXPECT_EQ(std::vector<int>(WrappedSecondSpan.begin(), WrappedSecondSpan.end()), std::vector<int>({ 8, 9, 10, 11 }));
+
+    std::vector<int> viCopy(5);
+    Buffer.CopyTo(2, 5, viCopy.data());
+    EXPECT_EQ(viCopy, std::vector<int>({ 7, 8, 9, 10, 11 })) << " Testing a copy across the wrap";
+
+    auto [EmptyFirstSpan, EmptySecondSpan] = Buffer.Peek(3, 0);
+    EXPECT_TRUE(EmptyFirstSpan.empty() && EmptySecondSpan.empty());
+
+    Buffer.Clear();
+    EXPECT_TRUE(Buffer.Empty());
+    EXPECT_EQ(Buffer.Capacity(), 8u) << " Testing clear keeps storage";
+}
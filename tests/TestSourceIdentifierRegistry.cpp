@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "DenseIndexMap.h"
+#include "SourceIdentifierRegistry.h"
+
+TEST(TestSourceIdentifierRegistry, TestInterning) {
+    auto& Registry = SourceIdentifierRegistry::GetInstance();
+    std::vector<uint8_t> vu8First = { 0xA0, 0x01, 0x02, 0x03, 0x04, 0x05 };
+    std::vector<uint8_t> vu8Second = { 0xA0, 0x01, 0x02, 0x03, 0x04, 0x06 };
+
+    uint32_t u32First = Registry.Intern(vu8First);
+    uint32_t u32Second = Registry.Intern(vu8Second);
+    EXPECT_NE(u32First, u32Second) << " Testing distinct identifiers get distinct indices";
+    EXPECT_EQ(Registry.Intern(vu8First), u32First) << " Testing an identifier keeps its index";
+    EXPECT_EQ(Registry.GetSourceIdentifier(u32Second), vu8Second) << " Testing an index maps back to its identifier";
+    EXPECT_LT(std::max(u32First, u32Second), Registry.GetSize()) << " Testing indices are dense";
+    EXPECT_THROW(Registry.GetSourceIdentifier(Registry.GetSize()), std::runtime_error);
+}
+
+// Module threads intern the same identifiers concurrently and must agree on their indices
+TEST(TestSourceIdentifierRegistry, TestConcurrentInterning) {
+    auto& Registry = SourceIdentifierRegistry::GetInstance();
+    std::vector<std::vector<uint32_t>> vvu32Indices(4, std::vector<uint32_t>(64));
+
+    std::vector<std::thread> vThreads;
+    for (size_t uThread = 0; uThread < vvu32Indices.size(); uThread++)
+        vThreads.emplace_back([&, uThread]() {
+            for (uint8_t u8Source = 0; u8Source < 64; u8Source++)
+                vvu32Indices[uThread][u8Source] = Registry.Intern({ 0xB0, u8Source });
+        });
+    for (auto& Thread : vThreads)
+        Thread.join();
+
+    for (const auto& vu32Indices : vvu32Indices)
+        EXPECT_EQ(vu32Indices, vvu32Indices[0]) << " Testing every thread sees the same indices";
+}
+
+TEST(TestSourceIdentifierRegistry, TestDenseIndexMap) {
+    DenseIndexMap<int> mValues;
+    mValues[5] = 50;
+    mValues[2] = 20;
+    EXPECT_EQ(mValues.size(), 2u);
+    EXPECT_EQ(mValues.count(3), 0u) << " Testing empty slots below the largest index are absent";
+    EXPECT_TRUE(mValues.find(7) == mValues.end());
+
+    std::vector<std::pair<uint32_t, int>> vEntries;
+    for (const auto& [u32Index, iValue] : mValues)
+        vEntries.emplace_back(u32Index, iValue);
+    EXPECT_EQ(vEntries, (std::vector<std::pair<uint32_t, int>>{ { 2, 20 }, { 5, 50 } })) << " Testing iteration is in index order";
+
+    EXPECT_EQ(mValues.erase(2), 1u);
+    EXPECT_EQ(mValues.begin()->first, 5u) << " Testing erased entries are skipped";
+    mValues.clear();
+    EXPECT_TRUE(mValues.empty());
+    EXPECT_EQ(mValues[5], 0) << " Testing cleared entries are default constructed again";
+}
+
+// Alternating sources must still map to the registry's indices when the cached identifier changes
+TEST(TestSourceIdentifierRegistry, TestSourceIndexCache) {
+    auto& Registry = SourceIdentifierRegistry::GetInstance();
+    std::vector<uint8_t> vu8First = { 0xC0, 0x01 };
+    std::vector<uint8_t> vu8Second = { 0xC0, 0x02 };
+
+    SourceIndexCache Cache;
+    for (unsigned uRepeat = 0; uRepeat < 3; uRepeat++)
+    {
+        EXPECT_EQ(Cache.Intern(vu8First), Registry.Intern(vu8First));
+        EXPECT_EQ(Cache.Intern(vu8First), Registry.Intern(vu8First)) << " Testing a repeated source hits the cache";
+        EXPECT_EQ(Cache.Intern(vu8Second), Registry.Intern(vu8Second));
+    }
+}
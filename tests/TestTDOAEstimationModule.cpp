@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "TDOAEstimationModule.h"
+
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class TDOACollectorModule : public BaseModule {
+public:
+    TDOACollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "TDOACollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
+class TestTDOAEstimationModule : public ::testing::Test {
+protected:
+    void SetUp() override {
+
+        // White noise arriving at each sensor after a different delay
+        std::mt19937 Generator(7);
+        std::normal_distribution<float> Noise(0, 2000);
+        std::vector<int16_t> vi16Source(uWindowLength + 2 * uMargin);
+        for (auto& i16Sample : vi16Source)
+            i16Sample = (int16_t)Noise(Generator);
+
+        pTDOAChunk = std::make_shared<TDOAChunk>(dSampleRate, 0, uWindowLength);
+        for (unsigned uSensorIndex = 0; uSensorIndex < viDelays_samples.size(); uSensorIndex++)
+        {
+            auto itStart = vi16Source.begin() + uMargin - viDelays_samples[uSensorIndex];
+            std::vector<std::vector<int16_t>> vvi16SensorData = { std::vector<int16_t>(itStart, itStart + uWindowLength) };
+            pTDOAChunk->AddData(0, 0, { (uint8_t)uSensorIndex }, vvi16SensorData);
+        }
+    }
+
+    std::shared_ptr<TDOAEstimateChunk> Estimate(unsigned uNumWorkers) {
+        auto pTDOAEstimationModule = std::make_shared<TDOAEstimationModule>(10, uNumWorkers);
+        auto pCollector = std::make_shared<TDOACollectorModule>(10);
+        pTDOAEstimationModule->SetNextModule(pCollector);
+        pTDOAEstimationModule->Process_TDOAChunk(pTDOAChunk);
+
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (pCollector->TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::TDOAEstimateChunk)
+                return std::static_pointer_cast<TDOAEstimateChunk>(pOutputChunk);
+        return nullptr;
+    }
+
+    const unsigned uWindowLength = 256;
+    const unsigned uMargin = 40;
+    const double dSampleRate = 16000;
+    const std::vector<int> viDelays_samples = { 0, 7, -12, 25 };
+    std::shared_ptr<TDOAChunk> pTDOAChunk;
+};
+
+TEST_F(TestTDOAEstimationModule, TestTransformLength) {
+    EXPECT_EQ(TDOAEstimationModule::GetTransformLength(256), 512u) << " Testing powers of two are kept";
+    EXPECT_EQ(TDOAEstimationModule::GetTransformLength(160000), 320000u) << " Testing ten seconds at 16 kHz is already fast";
+    EXPECT_EQ(TDOAEstimationModule::GetTransformLength(77), 160u) << " Testing lengths round up to 2^a 3^b 5^c";
+}
+
+// Every pair recovers its delay, and running the pairs over workers gives the same matrix
+TEST_F(TestTDOAEstimationModule, TestPairwiseDelays) {
+    auto pSerialEstimate = Estimate(1);
+    ASSERT_NE(pSerialEstimate, nullptr) << " Testing an estimate is produced";
+    ASSERT_EQ(pSerialEstimate->m_uNumSensors, viDelays_samples.size());
+
+    for (unsigned uFirstSensor = 0; uFirstSensor < viDelays_samples.size(); uFirstSensor++)
+    {
+        for (unsigned uSecondSensor = 0; uSecondSensor < viDelays_samples.size(); uSecondSensor++)
+        {
+            double dExpectedDelay_s = (viDelays_samples[uSecondSensor] - viDelays_samples[uFirstSensor]) / dSampleRate;
+            EXPECT_NEAR(pSerialEstimate->GetDelay_s(uFirstSensor, uSecondSensor), dExpectedDelay_s, 0.1 / dSampleRate) << " Testing delay of pair " << uFirstSensor << ", " << uSecondSensor;
+            EXPECT_GT(pSerialEstimate->GetConfidence(uFirstSensor, uSecondSensor), 0.5f) << " Testing shared signal gives a strong peak";
+        }
+    }
+
+    auto pParallelEstimate = Estimate(3);
+    ASSERT_NE(pParallelEstimate, nullptr);
+    EXPECT_EQ(pParallelEstimate->m_vfDelays_s, pSerialEstimate->m_vfDelays_s) << " Testing workers give identical delays";
+    EXPECT_EQ(pParallelEstimate->m_vfConfidences, pSerialEstimate->m_vfConfidences) << " Testing workers give identical confidences";
+}
+
+// Delays between samples are recovered by the parabola through the correlation peak rather than rounded
+TEST_F(TestTDOAEstimationModule, TestFractionalDelays) {
+
+    // Band limited noise as a sum of tones so every sensor can be delayed exactly by a fraction of a sample
+    const std::vector<double> vdDelays_samples = { 0, 3.3, -5.75, 10.5 };
+    std::mt19937 Generator(11);
+    std::uniform_real_distribution<double> Frequency(100, 6000);
+    std::uniform_real_distribution<double> Phase(0, 2 * M_PI);
+    std::vector<std::pair<double, double>> vTones(200);
+    for (auto& [dFrequency, dPhase] : vTones)
+    {
+        dFrequency = Frequency(Generator);
+        dPhase = Phase(Generator);
+    }
+
+    pTDOAChunk = std::make_shared<TDOAChunk>(dSampleRate, 0, uWindowLength);
+    for (unsigned uSensorIndex = 0; uSensorIndex < vdDelays_samples.size(); uSensorIndex++)
+    {
+        std::vector<std::vector<int16_t>> vvi16SensorData(1, std::vector<int16_t>(uWindowLength));
+        for (unsigned uSample = 0; uSample < uWindowLength; uSample++)
+        {
+            double dTime_s = (uSample - vdDelays_samples[uSensorIndex]) / dSampleRate;
+            double dSample = 0;
+            for (const auto& [dFrequency, dPhase] : vTones)
+                dSample += 200 * std::cos(2 * M_PI * dFrequency * dTime_s + dPhase);
+            vvi16SensorData[0][uSample] = (int16_t)std::lround(dSample);
+        }
+        pTDOAChunk->AddData(0, 0, { (uint8_t)uSensorIndex }, vvi16SensorData);
+    }
+
+    // A parabola is pulled towards the nearest sample on the sharp PHAT peak, but well within the half sample rounding would lose
+    auto pEstimate = Estimate(1);
+    ASSERT_NE(pEstimate, nullptr) << " Testing an estimate is produced";
+    for (unsigned uFirstSensor = 0; uFirstSensor < vdDelays_samples.size(); uFirstSensor++)
+    {
+        for (unsigned uSecondSensor = uFirstSensor + 1; uSecondSensor < vdDelays_samples.size(); uSecondSensor++)
+        {
+            double dExpectedDelay_samples = vdDelays_samples[uSecondSensor] - vdDelays_samples[uFirstSensor];
+            EXPECT_NEAR(pEstimate->GetDelay_s(uFirstSensor, uSecondSensor) * dSampleRate, dExpectedDelay_samples, 0.2) << " Testing delay of pair " << uFirstSensor << ", " << uSecondSensor;
+        }
+    }
+}
+
+// Windows made of runs of shared blocks are read in place and estimate exactly as their contiguous copies do
+TEST_F(TestTDOAEstimationModule, TestWindowChunkBlocks) {
+    auto pContiguousEstimate = Estimate(1);
+    ASSERT_NE(pContiguousEstimate, nullptr);
+
+    // Each sensor is split into runs of a few blocks, the first starting part way into its block
+    auto vvvi16TimeData = TDOAChunkAccessUtility::CopyTimeData(*pTDOAChunk);
+    auto pWindowChunk = std::make_shared<TDOAWindowChunk>(dSampleRate, 0, uWindowLength);
+    for (unsigned uSensorIndex = 0; uSensorIndex < vvvi16TimeData.size(); uSensorIndex++)
+    {
+        const auto& vi16Samples = vvvi16TimeData[uSensorIndex][0];
+        auto pvi16Padded = std::make_shared<std::vector<int16_t>>(10, 0);
+        pvi16Padded->insert(pvi16Padded->end(), vi16Samples.begin(), vi16Samples.begin() + 100);
+        auto pvi16Middle = std::make_shared<std::vector<int16_t>>(vi16Samples.begin() + 100, vi16Samples.begin() + 200);
+        auto pvi16End = std::make_shared<std::vector<int16_t>>(vi16Samples.begin() + 200, vi16Samples.end());
+        std::vector<TDOASampleBlock> vBlocks = { { pvi16Padded, 10, 100 }, { pvi16Middle, 0, 100 }, { pvi16End, 0, pvi16End->size() } };
+        pWindowChunk->AddWindow(0, 0, { (uint8_t)uSensorIndex }, { vBlocks });
+    }
+    EXPECT_EQ(TDOAChunkAccessUtility::CopyTimeData(*pWindowChunk), vvvi16TimeData) << " Testing runs read back as the contiguous window";
+
+    pTDOAChunk = pWindowChunk;
+    auto pBlockEstimate = Estimate(2);
+    ASSERT_NE(pBlockEstimate, nullptr);
+    EXPECT_EQ(pBlockEstimate->m_vfDelays_s, pContiguousEstimate->m_vfDelays_s) << " Testing blocks give identical delays";
+    EXPECT_EQ(pBlockEstimate->m_vfConfidences, pContiguousEstimate->m_vfConfidences) << " Testing blocks give identical confidences";
+
+    pWindowChunk->Materialise();
+    EXPECT_EQ(TDOAChunkAccessUtility::GetTimeData(*pWindowChunk), vvvi16TimeData) << " Testing materialised windows hold the same samples";
+    TDOASampleBlock OverrunBlock = { std::make_shared<std::vector<int16_t>>(4), 2, 3 };
+    EXPECT_THROW(pWindowChunk->AddWindow(0, 0, { 9 }, { { OverrunBlock } }), std::runtime_error) << " Testing runs past their block are rejected";
+}
+
+// Sensors with identifiers of different lengths survive serialisation unchanged
+TEST_F(TestTDOAEstimationModule, TestTDOAEstimateChunkRoundTrip) {
+
+    TDOAEstimateChunk InputChunk(16000, 123456, 3);
+    InputChunk.SetSourceIdentifier({ 9 });
+    InputChunk.m_vvu8SourceIdentifiers = { { 1 }, {}, { 2, 3, 4, 5, 6 } };
+    InputChunk.m_vdLongitudes = { 18.42, 18.43, 18.44 };
+    InputChunk.m_vdLatitudes = { -33.92, -33.91, -33.90 };
+    for (size_t uIndex = 0; uIndex < InputChunk.m_vfDelays_s.size(); uIndex++)
+    {
+        InputChunk.m_vfDelays_s[uIndex] = 1e-4f * ((int)uIndex - 4);
+        InputChunk.m_vfConfidences[uIndex] = 0.1f * uIndex;
+    }
+
+    auto pvBytes = InputChunk.Serialise();
+    EXPECT_EQ(pvBytes->size(), InputChunk.GetSize()) << " Testing serialised size matches GetSize";
+
+    TDOAEstimateChunk OutputChunk(0, 0, 0);
+    OutputChunk.Deserialise(pvBytes);
+    EXPECT_EQ(OutputChunk.m_dSampleRate, InputChunk.m_dSampleRate);
+    EXPECT_EQ(OutputChunk.m_i64TimeStamp, InputChunk.m_i64TimeStamp);
+    ASSERT_EQ(OutputChunk.m_uNumSensors, 3u);
+    EXPECT_EQ(OutputChunk.m_vvu8SourceIdentifiers, InputChunk.m_vvu8SourceIdentifiers) << " Testing variable length identifiers";
+    EXPECT_EQ(OutputChunk.m_vdLongitudes, InputChunk.m_vdLongitudes);
+    EXPECT_EQ(OutputChunk.m_vdLatitudes, InputChunk.m_vdLatitudes);
+    EXPECT_EQ(OutputChunk.m_vfDelays_s, InputChunk.m_vfDelays_s);
+    EXPECT_EQ(OutputChunk.m_vfConfidences, InputChunk.m_vfConfidences);
+    EXPECT_EQ(OutputChunk.GetDelay_s(2, 1), InputChunk.GetDelay_s(2, 1)) << " Testing matrix layout survives the round trip";
+}
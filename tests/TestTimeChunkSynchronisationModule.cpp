@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
+#include <functional>
+#include "TDOAChunkAccessUtility.h"
 #include "TimeChunkSynchronisationModule.h"
 
+/**
+ * @brief Terminal module which holds on to every chunk passed to it
+ */
+class TimeSyncCollectorModule : public BaseModule {
+public:
+    TimeSyncCollectorModule(unsigned uBufferSize) : BaseModule(uBufferSize) {}
+    std::string GetModuleType() override { return "TimeSyncCollectorModule"; }
+    using BaseModule::TakeFromBuffer;
+};
+
 class TestTimeSyncClass : public ::testing::Test {
 protected:
     // You can use SetUp and TearDown for initialization and cleanup.
@@ -42,6 +54,41 @@ protected:
         
     }
 
+    // Gives sources a position so windows are only held back by their data
+    void SendPositions(TimeChunkSynchronisationModule& Module, const std::vector<uint8_t>& vu8Sources) {
+        for (uint8_t u8Source : vu8Sources)
+        {
+            auto pGPSChunk = std::make_shared<GPSChunk>(0, 0, 0, true);
+            pGPSChunk->SetSourceIdentifier({ u8Source });
+            Module.CallChunkCallbackFunction(pGPSChunk);
+        }
+    }
+
+    // Sends a single channel chunk whose samples are given by their index in the chunk
+    void SendChunk(TimeChunkSynchronisationModule& Module, uint8_t u8Source, uint64_t u64TimeStamp_us, const std::function<double(unsigned)>& Sample, double dSampleRate = 16000, unsigned uChunkSize = 512) {
+        auto pTimeChunk = std::make_shared<TimeChunk>(uChunkSize, dSampleRate, u64TimeStamp_us, 16, 2, 1);
+        pTimeChunk->SetSourceIdentifier({ u8Source });
+        pTimeChunk->m_vvi16TimeChunks.assign(1, std::vector<int16_t>(uChunkSize));
+        for (unsigned uSample = 0; uSample < uChunkSize; uSample++)
+            pTimeChunk->m_vvi16TimeChunks[0][uSample] = (int16_t)std::lround(Sample(uSample));
+        Module.CallChunkCallbackFunction(pTimeChunk);
+    }
+
+    // Sends the uChunkIndex'th 32 ms chunk of a ramp which counts samples, so a window's first sample says where it starts
+    void SendRampChunk(TimeChunkSynchronisationModule& Module, uint8_t u8Source, unsigned uChunkIndex) {
+        SendChunk(Module, u8Source, uChunkIndex * 32000, [uChunkIndex](unsigned uSample) { return (uChunkIndex * 512 + uSample) % 30000; });
+    }
+
+    // Returns the windows a collector has been passed, in order
+    std::vector<std::shared_ptr<TDOAChunk>> TakeWindows(TimeSyncCollectorModule& Collector) {
+        std::vector<std::shared_ptr<TDOAChunk>> vpTDOAChunks;
+        std::shared_ptr<BaseChunk> pOutputChunk;
+        while (Collector.TakeFromBuffer(pOutputChunk))
+            if (pOutputChunk->GetChunkType() == ChunkType::TDOAChunk)
+                vpTDOAChunks.push_back(std::static_pointer_cast<TDOAChunk>(pOutputChunk));
+        return vpTDOAChunks;
+    }
+
     std::shared_ptr<TimeChunkSynchronisationModule> pTimeChunkSynchronisationModule;
     std::shared_ptr<TimeChunk> pTimeChunkTwoChannel;
     std::shared_ptr<GPSChunk> pGPSChunkTwoChannel;
@@ -116,3 +163,279 @@ TEST_F(TestTimeSyncClass, TestGPSWithTimeData) {
     EXPECT_EQ(bResult, true) << " Testing we fail GPS check with 2 time and GPS sources";
 
 }
+
+// Sources starting a fraction of a sample apart are interpolated onto the same sample times
+TEST_F(TestTimeSyncClass, TestFractionalDelayCorrection) {
+
+    auto pCollector = std::make_shared<TimeSyncCollectorModule>(10);
+    pTimeChunkSynchronisationModule->SetNextModule(pCollector);
+    pTimeChunkSynchronisationModule->EnableFractionalDelayCorrection(32, 64);
+
+    // Source 2 starts 31 us (about half a sample) after sources 1 and 3
+    const double dSampleRate = 16000;
+    const std::vector<uint64_t> vu64StartTimes_us = { 0, 31, 0 };
+    auto Signal = [](double dTime_s) { return 10000 * std::sin(2 * M_PI * 200 * dTime_s); };
+
+    SendPositions(*pTimeChunkSynchronisationModule, { 1, 2, 3 });
+    for (unsigned uChunkIndex = 0; uChunkIndex < 320; uChunkIndex++)
+    {
+        for (uint8_t u8Source = 1; u8Source <= 3; u8Source++)
+        {
+            uint64_t u64TimeStamp_us = vu64StartTimes_us[u8Source - 1] + uChunkIndex * 32000;
+            SendChunk(*pTimeChunkSynchronisationModule, u8Source, u64TimeStamp_us, [&](unsigned uSample) { return Signal(u64TimeStamp_us / 1e6 + uSample / dSampleRate); });
+        }
+    }
+
+    auto vpTDOAChunks = TakeWindows(*pCollector);
+    ASSERT_FALSE(vpTDOAChunks.empty()) << " Testing a synchronised window is produced";
+
+    // Every source reads the common start time plus the interpolator delay of 15 samples
+    double dStartTime_s = 31e-6 + 15 / dSampleRate;
+    for (const auto& vvi16SourceData : TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks.front()))
+    {
+        ASSERT_EQ(vvi16SourceData[0].size(), 160000u);
+        for (unsigned uSample = 0; uSample < vvi16SourceData[0].size(); uSample += 97)
+            ASSERT_NEAR(vvi16SourceData[0][uSample], Signal(dStartTime_s + uSample / dSampleRate), 4) << " Testing sample " << uSample << " lines up";
+    }
+}
+
+// Interpolated windows are built from blocks made a hop at a time, which must join up without a seam
+TEST_F(TestTimeSyncClass, TestFractionalDelaySlidingWindows) {
+
+    auto pCollector = std::make_shared<TimeSyncCollectorModule>(100);
+    pTimeChunkSynchronisationModule->SetNextModule(pCollector);
+    pTimeChunkSynchronisationModule->EnableFractionalDelayCorrection(32, 64);
+    pTimeChunkSynchronisationModule->SetTDOAWindow(1, 0.25);
+
+    const double dSampleRate = 16000;
+    const std::vector<uint64_t> vu64StartTimes_us = { 0, 31, 0 };
+    auto Signal = [](double dTime_s) { return 10000 * std::sin(2 * M_PI * 200 * dTime_s); };
+
+    SendPositions(*pTimeChunkSynchronisationModule, { 1, 2, 3 });
+    for (unsigned uChunkIndex = 0; uChunkIndex < 64; uChunkIndex++)
+    {
+        for (uint8_t u8Source = 1; u8Source <= 3; u8Source++)
+        {
+            uint64_t u64TimeStamp_us = vu64StartTimes_us[u8Source - 1] + uChunkIndex * 32000;
+            SendChunk(*pTimeChunkSynchronisationModule, u8Source, u64TimeStamp_us, [&](unsigned uSample) { return Signal(u64TimeStamp_us / 1e6 + uSample / dSampleRate); });
+        }
+    }
+
+    auto vpTDOAChunks = TakeWindows(*pCollector);
+    ASSERT_GE(vpTDOAChunks.size(), 4u) << " Testing overlapping interpolated windows are produced";
+    for (unsigned uWindowIndex = 0; uWindowIndex < vpTDOAChunks.size(); uWindowIndex++)
+    {
+        double dStartTime_s = 31e-6 + 15 / dSampleRate + 0.25 * uWindowIndex;
+        for (const auto& vvi16SourceData : TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks[uWindowIndex]))
+        {
+            ASSERT_EQ(vvi16SourceData[0].size(), 16000u);
+            for (unsigned uSample = 0; uSample < vvi16SourceData[0].size(); uSample += 37)
+                ASSERT_NEAR(vvi16SourceData[0][uSample], Signal(dStartTime_s + uSample / dSampleRate), 4) << " Testing sample " << uSample << " of window " << uWindowIndex;
+        }
+    }
+}
+
+// A source whose sample clock runs fast is measured and resampled onto the nominal sample times
+TEST_F(TestTimeSyncClass, TestDriftCorrection) {
+
+    auto pCollector = std::make_shared<TimeSyncCollectorModule>(10);
+    pTimeChunkSynchronisationModule->SetNextModule(pCollector);
+    pTimeChunkSynchronisationModule->EnableDriftCorrection(64, 500);
+
+    // Source 2 samples 200 ppm faster than its nominal rate
+    const double dSampleRate = 16000;
+    const unsigned uChunkSize = 512;
+    const std::vector<double> vdClockRates = { 1.0, 1.0002, 1.0 };
+    auto Signal = [](double dTime_s) { return 10000 * std::sin(2 * M_PI * 50 * dTime_s); };
+
+    SendPositions(*pTimeChunkSynchronisationModule, { 1, 2, 3 });
+    for (unsigned uChunkIndex = 0; uChunkIndex < 320; uChunkIndex++)
+    {
+        for (uint8_t u8Source = 1; u8Source <= 3; u8Source++)
+        {
+            double dTrueRate = dSampleRate * vdClockRates[u8Source - 1];
+            uint64_t u64TimeStamp_us = std::llround(1e6 * uChunkIndex * uChunkSize / dTrueRate);
+            SendChunk(*pTimeChunkSynchronisationModule, u8Source, u64TimeStamp_us, [&](unsigned uSample) { return Signal((uChunkIndex * uChunkSize + uSample) / dTrueRate); });
+        }
+    }
+
+    EXPECT_NEAR(pTimeChunkSynchronisationModule->GetEstimatedDrift_ppm({ 2 }), 200, 2) << " Testing the fast clock is measured";
+    EXPECT_NEAR(pTimeChunkSynchronisationModule->GetEstimatedDrift_ppm({ 1 }), 0, 2) << " Testing a nominal clock is measured";
+
+    auto vpTDOAChunks = TakeWindows(*pCollector);
+    ASSERT_FALSE(vpTDOAChunks.empty()) << " Testing a synchronised window is produced";
+
+    // Without correction the fast source would be 32 samples ahead by the end of the window.
+    // The first chunk arrives before the clock can be fitted so is stored at the nominal rate.
+    for (const auto& vvi16SourceData : TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks.front()))
+        for (unsigned uSample = uChunkSize; uSample < vvi16SourceData[0].size(); uSample += 97)
+            ASSERT_NEAR(vvi16SourceData[0][uSample], Signal(uSample / dSampleRate), 4) << " Testing sample " << uSample << " is on the nominal grid";
+}
+
+// Overlapping windows start a hop apart and repeat the samples they share
+TEST_F(TestTimeSyncClass, TestSlidingWindows) {
+
+    auto pCollector = std::make_shared<TimeSyncCollectorModule>(10);
+    pTimeChunkSynchronisationModule->SetNextModule(pCollector);
+    pTimeChunkSynchronisationModule->SetTDOAWindow(0.5, 0.125);
+
+    // One second of a ramp on every source
+    SendPositions(*pTimeChunkSynchronisationModule, { 1, 2, 3 });
+    for (unsigned uChunkIndex = 0; uChunkIndex < 32; uChunkIndex++)
+        for (uint8_t u8Source = 1; u8Source <= 3; u8Source++)
+            SendRampChunk(*pTimeChunkSynchronisationModule, u8Source, uChunkIndex);
+
+    // Windows end every hop from 0.5 s up to the 1.024 s received
+    auto vpTDOAChunks = TakeWindows(*pCollector);
+    ASSERT_EQ(vpTDOAChunks.size(), 5u) << " Testing a window is produced every hop";
+    for (unsigned uWindowIndex = 0; uWindowIndex < vpTDOAChunks.size(); uWindowIndex++)
+    {
+        EXPECT_EQ(vpTDOAChunks[uWindowIndex]->m_i64TimeStamp, uWindowIndex * 125000u) << " Testing windows start a hop apart";
+        for (const auto& vvi16SourceData : TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks[uWindowIndex]))
+        {
+            ASSERT_EQ(vvi16SourceData[0].size(), 8000u);
+            EXPECT_EQ(vvi16SourceData[0].front(), (int16_t)(uWindowIndex * 2000)) << " Testing window " << uWindowIndex << " starts a hop after the last";
+            EXPECT_EQ(vvi16SourceData[0].back(), (int16_t)(uWindowIndex * 2000 + 7999)) << " Testing window " << uWindowIndex << " is contiguous";
+        }
+    }
+
+    // Consecutive windows read the samples they share from the same memory rather than each holding a copy
+    auto GetSampleAddress = [](const std::vector<std::span<const int16_t>>& vSpans, size_t uSampleIndex) {
+        for (const auto& Span : vSpans)
+        {
+            if (uSampleIndex < Span.size())
+                return Span.data() + uSampleIndex;
+            uSampleIndex -= Span.size();
+        }
+        return (const int16_t*)nullptr;
+    };
+    std::vector<std::span<const int16_t>> vPreviousSpans, vSpans;
+    for (unsigned uWindowIndex = 1; uWindowIndex < vpTDOAChunks.size(); uWindowIndex++)
+    {
+        TDOAChunkAccessUtility::GetChannelSpans(*vpTDOAChunks[uWindowIndex - 1], 0, 0, vPreviousSpans);
+        TDOAChunkAccessUtility::GetChannelSpans(*vpTDOAChunks[uWindowIndex], 0, 0, vSpans);
+        for (size_t uSampleIndex = 0; uSampleIndex < 6000; uSampleIndex += 1000)
+            EXPECT_EQ(GetSampleAddress(vSpans, uSampleIndex), GetSampleAddress(vPreviousSpans, uSampleIndex + 2000)) << " Testing window " << uWindowIndex << " shares sample " << uSampleIndex;
+        EXPECT_EQ(vSpans.back().size(), 2000u) << " Testing only the hop is copied";
+    }
+}
+
+// A stalled source is dropped so the rest of the array keeps producing, and rejoins aligned when it returns
+TEST_F(TestTimeSyncClass, TestStalledSourceDoesNotStallArray) {
+
+    auto pCollector = std::make_shared<TimeSyncCollectorModule>(100);
+    pTimeChunkSynchronisationModule->SetNextModule(pCollector);
+    pTimeChunkSynchronisationModule->SetTDOAWindow(0.5, 0.125);
+    pTimeChunkSynchronisationModule->SetStalledSourceTimeout(0.25);
+
+    // Source 3 goes quiet for longer than the continuity tolerance of a second
+    SendPositions(*pTimeChunkSynchronisationModule, { 1, 2, 3, 4 });
+    for (unsigned uChunkIndex = 0; uChunkIndex < 80; uChunkIndex++)
+    {
+        for (uint8_t u8Source = 1; u8Source <= 4; u8Source++)
+        {
+            if (u8Source == 3 && uChunkIndex >= 16 && uChunkIndex < 56)
+                continue;
+            SendRampChunk(*pTimeChunkSynchronisationModule, u8Source, uChunkIndex);
+        }
+    }
+
+    EXPECT_EQ(pTimeChunkSynchronisationModule->GetSourceResetCount(), 1u) << " Testing only the stalled source is reset";
+    EXPECT_GT(pTimeChunkSynchronisationModule->GetBufferedBytes(), 0u) << " Testing buffered bytes are reported";
+
+    // A window every hop from 0.5 s to the 2.56 s received, less those lost while source 3 was judged stalled
+    auto vpTDOAChunks = TakeWindows(*pCollector);
+    ASSERT_GE(vpTDOAChunks.size(), 12u) << " Testing windows continue while a source is away";
+    bool bSawThreeSources = false;
+    for (unsigned uWindowIndex = 0; uWindowIndex < vpTDOAChunks.size(); uWindowIndex++)
+    {
+        const auto& vvvi16TimeData = TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks[uWindowIndex]);
+        bSawThreeSources |= vvvi16TimeData.size() == 3;
+        for (const auto& vvi16SourceData : vvvi16TimeData)
+            EXPECT_EQ(vvi16SourceData[0].front(), vvvi16TimeData[0][0].front()) << " Testing window " << uWindowIndex << " is aligned across sources";
+    }
+    EXPECT_TRUE(bSawThreeSources) << " Testing the remaining sources produced windows on their own";
+    EXPECT_EQ(TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks.back()).size(), 4u) << " Testing the stalled source rejoined";
+}
+
+// Capped buffers drop and count their oldest samples, and a gap on one source restarts only that source
+TEST_F(TestTimeSyncClass, TestMemoryLimitAndSingleSourceReset) {
+
+    // 16000 bytes hold 8000 single channel samples, less than the 9024 the window would size the buffers to
+    pTimeChunkSynchronisationModule->SetTDOAWindow(0.25, 0.25);
+    pTimeChunkSynchronisationModule->SetSourceMemoryLimit(16000);
+
+    // Source 3 has no position so nothing is extracted and every buffer fills
+    SendPositions(*pTimeChunkSynchronisationModule, { 1, 2 });
+    const unsigned uNumChunks = 40;
+    for (unsigned uChunkIndex = 0; uChunkIndex < uNumChunks; uChunkIndex++)
+        for (uint8_t u8Source = 1; u8Source <= 3; u8Source++)
+            SendRampChunk(*pTimeChunkSynchronisationModule, u8Source, uChunkIndex);
+
+    EXPECT_EQ(pTimeChunkSynchronisationModule->GetBufferedBytes(), 3u * 16000) << " Testing each source is held to its limit";
+    EXPECT_EQ(pTimeChunkSynchronisationModule->GetEvictedSampleCount(), 3u * (uNumChunks * 512 - 8000)) << " Testing every dropped sample is counted";
+    EXPECT_EQ(pTimeChunkSynchronisationModule->GetSourceResetCount(), 0u) << " Testing full buffers do not restart sources";
+
+    // Source 2 jumps two seconds ahead, beyond the continuity tolerance
+    SendRampChunk(*pTimeChunkSynchronisationModule, 2, uNumChunks + 62);
+    EXPECT_EQ(pTimeChunkSynchronisationModule->GetSourceResetCount(), 1u) << " Testing the gap restarts a source";
+    EXPECT_EQ(pTimeChunkSynchronisationModule->GetBufferedBytes(), 2u * 16000 + 512 * sizeof(int16_t)) << " Testing only the faulty source lost its data";
+}
+
+// Buffers that overflow while waiting for positions drop their oldest samples, the window timestamp must follow them exactly
+TEST_F(TestTimeSyncClass, TestEvictionAdvancesTimeStamp) {
+
+    auto pCollector = std::make_shared<TimeSyncCollectorModule>(10);
+    pTimeChunkSynchronisationModule->SetNextModule(pCollector);
+    pTimeChunkSynchronisationModule->SetTDOAWindow(0.1, 0.1);
+
+    // 400 samples at 44.1 kHz is not a whole number of microseconds so truncating each advance would drift
+    const double dSampleRate = 44100;
+    const unsigned uChunkSize = 400;
+    const std::vector<uint8_t> vu8Sources = { 7, 8, 9 };
+    auto SendCountingChunk = [&](uint8_t u8Source, unsigned uChunkIndex)
+    {
+        SendChunk(*pTimeChunkSynchronisationModule, u8Source, std::llround(1e6 * uChunkIndex * uChunkSize / dSampleRate), [&](unsigned uSample) { return uChunkIndex * uChunkSize + uSample; }, dSampleRate, uChunkSize);
+    };
+
+    // Without positions nothing is extracted so every buffer wraps many times
+    const unsigned uNumChunks = 70;
+    for (unsigned uChunkIndex = 0; uChunkIndex < uNumChunks; uChunkIndex++)
+        for (uint8_t u8Source : vu8Sources)
+            SendCountingChunk(u8Source, uChunkIndex);
+    EXPECT_GT(pTimeChunkSynchronisationModule->GetEvictedSampleCount(), 40u * uChunkSize) << " Testing buffers overflowed";
+
+    SendPositions(*pTimeChunkSynchronisationModule, vu8Sources);
+    SendCountingChunk(vu8Sources[0], uNumChunks);
+
+    auto vpTDOAChunks = TakeWindows(*pCollector);
+    ASSERT_FALSE(vpTDOAChunks.empty()) << " Testing a window is produced once positions arrive";
+
+    // The ramp gives the index of the first sample, the source which triggered extraction is not shifted by alignment
+    int16_t i16FirstSample = TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks.front())[0][0].front();
+    EXPECT_NEAR((double)vpTDOAChunks.front()->m_i64TimeStamp, 1e6 * i16FirstSample / dSampleRate, 1.0) << " Testing the timestamp is that of the first sample";
+}
+
+// Windows are extracted every hop even when sources are only realigned every few seconds
+TEST_F(TestTimeSyncClass, TestExtractionDoesNotWaitForSyncInterval) {
+
+    auto pSlowSyncModule = std::make_shared<TimeChunkSynchronisationModule>(10, 10, 5000000000);
+    auto pCollector = std::make_shared<TimeSyncCollectorModule>(100);
+    pSlowSyncModule->SetNextModule(pCollector);
+    pSlowSyncModule->SetTDOAWindow(0.5, 0.125);
+
+    // Two seconds of a ramp, well inside the five second sync interval
+    SendPositions(*pSlowSyncModule, { 1, 2, 3 });
+    for (unsigned uChunkIndex = 0; uChunkIndex < 64; uChunkIndex++)
+        for (uint8_t u8Source = 1; u8Source <= 3; u8Source++)
+            SendRampChunk(*pSlowSyncModule, u8Source, uChunkIndex);
+
+    EXPECT_EQ(pSlowSyncModule->GetEvictedSampleCount(), 0u) << " Testing buffers drain between syncs";
+
+    // Windows end every hop from 0.5 s up to the 2.048 s received
+    auto vpTDOAChunks = TakeWindows(*pCollector);
+    ASSERT_EQ(vpTDOAChunks.size(), 13u) << " Testing a window is produced every hop";
+    for (unsigned uWindowIndex = 0; uWindowIndex < vpTDOAChunks.size(); uWindowIndex++)
+        for (const auto& vvi16SourceData : TDOAChunkAccessUtility::CopyTimeData(*vpTDOAChunks[uWindowIndex]))
+            EXPECT_EQ(vvi16SourceData[0].front(), (int16_t)(uWindowIndex * 2000)) << " Testing window " << uWindowIndex << " starts a hop after the last";
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "VectorKernelUtility.h"
+
+class TestVectorKernelUtility : public ::testing::Test {
+protected:
+    // You can use SetUp and TearDown for initialization and cleanup.
+    void SetUp() override {
+
+        // Odd length so the scalar tails of every variant are exercised
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+        {
+            vi16Samples.push_back((int16_t)((uIndex * 2731) % 65536 - 32768));
+            vfValues.push_back(0.37f * uIndex - 41.0f);
+            vcfBins.emplace_back(0.5f * uIndex - 20.0f, 30.0f - 0.25f * uIndex);
+        }
+
+        vInstructionSets.push_back(VectorKernelUtility::InstructionSet::Scalar);
+        if (VectorKernelUtility::GetSupportedInstructionSet() >= VectorKernelUtility::InstructionSet::SSE2)
+            vInstructionSets.push_back(VectorKernelUtility::InstructionSet::SSE2);
+        if (VectorKernelUtility::GetSupportedInstructionSet() >= VectorKernelUtility::InstructionSet::AVX2)
+            vInstructionSets.push_back(VectorKernelUtility::InstructionSet::AVX2);
+    }
+
+    void TearDown() override {
+        VectorKernelUtility::SetInstructionSet(VectorKernelUtility::GetSupportedInstructionSet());
+    }
+
+    const unsigned uLength = 1027;
+    std::vector<int16_t> vi16Samples;
+    std::vector<float> vfValues;
+    std::vector<std::complex<float>> vcfBins;
+    std::vector<VectorKernelUtility::InstructionSet> vInstructionSets;
+};
+
+// Every variant must match the plain loops it replaces
+TEST_F(TestVectorKernelUtility, TestVariantsMatchReference) {
+
+    for (auto InstructionSet : vInstructionSets)
+    {
+        VectorKernelUtility::SetInstructionSet(InstructionSet);
+        std::string strName = VectorKernelUtility::GetInstructionSetName(InstructionSet);
+
+        std::vector<float> vfConverted(uLength);
+        VectorKernelUtility::ConvertInt16ToFloat(vi16Samples.data(), vfConverted.data(), uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_EQ(vfConverted[uIndex], (float)vi16Samples[uIndex]) << " Testing " << strName << " int16 conversion";
+
+        std::vector<float> vfToConvert = vfValues;
+        VectorKernelUtility::Scale(vfToConvert.data(), uLength, 123.4f);
+        std::vector<int16_t> vi16Converted(uLength);
+        VectorKernelUtility::ConvertFloatToInt16(vfToConvert.data(), vi16Converted.data(), uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_EQ(vi16Converted[uIndex], (int16_t)std::nearbyint(std::clamp(vfToConvert[uIndex], -32768.0f, 32767.0f))) << " Testing " << strName << " saturating int16 conversion";
+
+        std::vector<float> vfScaled = vfValues;
+        VectorKernelUtility::Scale(vfScaled.data(), uLength, 0.125f);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_EQ(vfScaled[uIndex], vfValues[uIndex] * 0.125f) << " Testing " << strName << " scaling";
+
+        std::vector<float> vfSquared(uLength);
+        VectorKernelUtility::Multiply(vfValues.data(), vfValues.data(), vfSquared.data(), uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_EQ(vfSquared[uIndex], vfValues[uIndex] * vfValues[uIndex]) << " Testing " << strName << " multiplication";
+
+        std::vector<float> vfFusedSquares(uLength);
+        float fSumOfSquares = VectorKernelUtility::SquareAndSum(vfValues.data(), vfFusedSquares.data(), uLength);
+        EXPECT_EQ(vfFusedSquares, vfSquared) << " Testing " << strName << " fused squaring";
+        EXPECT_NEAR(fSumOfSquares, std::accumulate(vfSquared.begin(), vfSquared.end(), 0.0), 1e-5 * fSumOfSquares) << " Testing " << strName << " fused sum";
+
+        std::vector<uint32_t> vuIndices(uLength);
+        vuIndices.resize(VectorKernelUtility::FindIndicesAbove(vfSquared.data(), uLength, 5000.0f, vuIndices.data()));
+        std::vector<uint32_t> vuExpectedIndices;
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            if (vfSquared[uIndex] > 5000.0f)
+                vuExpectedIndices.push_back(uIndex);
+        EXPECT_EQ(vuIndices, vuExpectedIndices) << " Testing " << strName << " threshold indices";
+
+        std::vector<uint32_t> vuReferenceIndices(uLength);
+        vuReferenceIndices.resize(VectorKernelUtility::FindIndicesAboveReference(vfSquared.data(), vfFusedSquares.data() + 1, 1.5f, uLength - 1, vuReferenceIndices.data()));
+        std::vector<uint32_t> vuExpectedReferenceIndices;
+        for (unsigned uIndex = 0; uIndex < uLength - 1; uIndex++)
+            if (vfSquared[uIndex] > 1.5f * vfFusedSquares[uIndex + 1])
+                vuExpectedReferenceIndices.push_back(uIndex);
+        EXPECT_EQ(vuReferenceIndices, vuExpectedReferenceIndices) << " Testing " << strName << " reference threshold indices";
+
+        std::vector<float> vfAccumulated = vfValues;
+        VectorKernelUtility::MultiplyAccumulate(vfSquared.data(), -0.5f, vfAccumulated.data(), uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_EQ(vfAccumulated[uIndex], vfValues[uIndex] + -0.5f * vfSquared[uIndex]) << " Testing " << strName << " multiply accumulate";
+
+        double dExpectedDotProduct = 0;
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            dExpectedDotProduct += (double)vfValues[uIndex] * vfSquared[uIndex];
+        float fDotProduct = VectorKernelUtility::DotProduct(vfValues.data(), vfSquared.data(), uLength);
+        EXPECT_NEAR(fDotProduct, dExpectedDotProduct, 1e-5 * std::abs(dExpectedDotProduct)) << " Testing " << strName << " dot product";
+        VectorKernelUtility::SetInstructionSet(VectorKernelUtility::InstructionSet::Scalar);
+        EXPECT_EQ(fDotProduct, VectorKernelUtility::DotProduct(vfValues.data(), vfSquared.data(), uLength)) << " Testing " << strName << " dot product rounds as the scalar variant";
+        VectorKernelUtility::SetInstructionSet(InstructionSet);
+
+        std::vector<float> vfMagnitudes(uLength);
+        VectorKernelUtility::ComplexMagnitude(vcfBins.data(), vfMagnitudes.data(), uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_NEAR(vfMagnitudes[uIndex], std::abs(vcfBins[uIndex]), 1e-5f * std::abs(vcfBins[uIndex])) << " Testing " << strName << " complex magnitude";
+
+        // Reversed bins give phase differences covering every quadrant
+        std::vector<std::complex<float>> vcfReversed(vcfBins.rbegin(), vcfBins.rend());
+        std::vector<float> vfPhases(uLength);
+        VectorKernelUtility::PhaseDifference(vcfBins.data(), vcfReversed.data(), vfPhases.data(), uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_NEAR(vfPhases[uIndex], std::arg(vcfBins[uIndex] * std::conj(vcfReversed[uIndex])), 1e-5f) << " Testing " << strName << " phase difference";
+
+        std::vector<float> vfSines(uLength);
+        std::vector<float> vfArcSines(uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            vfSines[uIndex] = -1.0f + 2.0f * uIndex / (uLength - 1);
+        VectorKernelUtility::ArcSine(vfSines.data(), vfArcSines.data(), uLength);
+        for (unsigned uIndex = 0; uIndex < uLength; uIndex++)
+            ASSERT_NEAR(vfArcSines[uIndex], std::asin(vfSines[uIndex]), 1e-5f) << " Testing " << strName << " arc sine";
+    }
+}